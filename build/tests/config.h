@@ -0,0 +1,2573 @@
+/*
+ *
+ * Automatically generated file; DO NOT EDIT.
+ * coreboot configuration
+ *
+ */
+#define CONFIG_SUPERIO_ITE_ENV_CTRL_5FANS 0
+#define CONFIG_SOC_AMD_COMMON 0
+#define CONFIG_POWER_BUTTON_IS_OPTIONAL 0
+#define CONFIG_EC_GOOGLE_WILCO 0
+#define CONFIG_SMM_RESERVED_SIZE 0
+#define CONFIG_MICROCODE_BLOB_NOT_HOOKED_UP 0
+#define CONFIG_VARIANT_SPECIFIC_OPTIONS_NOCTURNE 0
+#define CONFIG_BOARD_GOOGLE_DROBIT 0
+#define CONFIG_DEPTHCHARGE_REVISION 0
+#define CONFIG_ENABLE_DDR_2X_REFRESH 0
+#define CONFIG_MTC_ADDRESS 0
+#define CONFIG_BOARD_GOOGLE_WOOMAX 0
+#define CONFIG_CHROMEOS_DRAM_PART_NUMBER_IN_CBI 0
+#define CONFIG_BOARD_INTEL_WHISKEYLAKE_RVP 0
+#define CONFIG_DRIVERS_INTEL_DPTF 0
+#define CONFIG_BOARD_GOOGLE_FALCO 0
+#define CONFIG_BOOTSPLASH 0
+#define CONFIG_VBOOT_HASH_BLOCK_SIZE 0
+#define CONFIG_BOARD_GOOGLE_BOB 0
+#define CONFIG_NORTHBRIDGE_INTEL_SANDYBRIDGE 0
+#define CONFIG_BILBY_IOMUX_USE_EMMC 0
+#define CONFIG_BOOT_DEVICE_SPI_FLASH 1
+#define CONFIG_BOARD_GIGABYTE_GA_G41M_ES2L 0
+#define CONFIG_SOC_UCB_RISCV 0
+#define CONFIG_EC_PURISM_LIBREM 0
+#define CONFIG_BOARD_GOOGLE_KUKUI 0
+#define CONFIG_BOARD_HP_SNB_IVB_LAPTOPS 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_HPET 0
+#define CONFIG_MAINBOARD_POWER_FAILURE_STATE 0
+#define CONFIG_SAMPLING_PROFILER 0
+#define CONFIG_ENABLE_HSUART 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_SMM 0
+#define CONFIG_ONBOARD_MEM_SAMSUNG 0
+#define CONFIG_PCIE_DEBUG_INFO 0
+#define CONFIG_HWBASE_DEFAULT_MMCONF 0
+#define CONFIG_DRIVERS_I2C_DESIGNWARE_DEBUG 0
+#define CONFIG_SOUTHBRIDGE_INTEL_I82801GX 0
+#define CONFIG_TIANOCORE_DEBUG 0
+#define CONFIG_IPMI_OCP 0
+#define CONFIG_BOARD_GOOGLE_CERISE 0
+#define CONFIG_PAYLOAD_FIT_SUPPORT 0
+#define CONFIG_PCIEXP_COMMON_CLOCK 0
+#define CONFIG_ENABLE_BUILTIN_COM1 0
+#define CONFIG_NYAN_BLAZE_BCT_CFG_EMMC 0
+#define CONFIG_NORTHBRIDGE_SPECIFIC_OPTIONS 0
+#define CONFIG_TTB_SIZE_MB 0
+#define CONFIG_IOAPIC_INTERRUPTS_ON_FSB 1
+#define CONFIG_UART_OVERRIDE_INPUT_CLOCK_DIVIDER 0
+#define CONFIG_DRIVERS_LENOVO_HYBRID_GRAPHICS 0
+#define CONFIG_PXE_HAS_HTTPS 0
+#define CONFIG_CAVIUM_BDK 0
+#define CONFIG_DEBUG_PMIC 0
+#define CONFIG_SOUTHBRIDGE_AMD_PI_AVALON 0
+#define CONFIG_BOARD_GOOGLE_OCTOPUS 0
+#define CONFIG_REG_SCRIPT 0
+#define CONFIG_CPU_AMD_AGESA_OPENSOURCE_MEM_CUSTOM 0
+#define CONFIG_INTEL_GMA_BCLV_WIDTH 16
+#define CONFIG_NVRAMCUI_SECONDARY_PAYLOAD 0
+#define CONFIG_SRCLKEN_RC_SUPPORT 0
+#define CONFIG_BOARD_GOOGLE_TREMBYLE 0
+#define CONFIG_GRUB2_MASTER 0
+#define CONFIG_DRIVER_TI_TPS65090 0
+#define CONFIG_EFS_SPI_SPEED 0
+#define CONFIG_DRIVERS_UART_8250MEM_32 0
+#define CONFIG_SMM_TSEG 0
+#define CONFIG_EC_KONTRON_IT8516E 0
+#define CONFIG_IPQ_QFN_PART 0
+#define CONFIG_GOOGLE_SMBIOS_MAINBOARD_VERSION 0
+#define CONFIG_COREBOOT_BUILD 1
+#define CONFIG_BOARD_GOOGLE_GNAWTY 0
+#define CONFIG_NYAN_BLAZE_BCT_CFG_SPI 0
+#define CONFIG_MAX_REBOOT_CNT 3
+#define CONFIG_CUSTOM_SPD_CASHI 0
+#define CONFIG_SOC_INTEL_CRASHLOG 0
+#define CONFIG_BOARD_GOOGLE_SETZER 0
+#define CONFIG_CBFS_FILE_HASH_CHECK 0
+#define CONFIG_SET_MSR_AESNI_LOCK_BIT 0
+#define CONFIG_POWER_STATE_OFF_AFTER_FAILURE 0
+#define CONFIG_BOARD_PORTWELL_M107 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_S3 0
+#define CONFIG_MEMTEST_STABLE 0
+#define CONFIG_BOARD_SIEMENS_BASEBOARD_MC_APL1 0
+#define CONFIG_TIANOCORE_RELEASE 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_10A 0
+#define CONFIG_BOARD_GOOGLE_JECHT 0
+#define CONFIG_VARIANT_SPECIFIC_OPTIONS_POPPY 0
+#define CONFIG_NHLT_DMIC_2CH 0
+#define CONFIG_FUNCTION_TRACE 0
+#define CONFIG_PCIEXP_L1_SUB_STATE 0
+#define CONFIG_BOOTBLOCK_CONSOLE 1
+#define CONFIG_LINUXBOOT_KERNEL_BZIMAGE 0
+#define CONFIG_SA_ENABLE_DPR 0
+#define CONFIG_SUPERIO_ITE_ENV_CTRL_NO_ONOFF 0
+#define CONFIG_EC_BASE_HOST_DATA 0
+#define CONFIG_BOOTBLOCK_CUSTOM 0
+#define CONFIG_DATA_BUS_WIDTH 0
+#define CONFIG_VENDOR_FACEBOOK 0
+#define CONFIG_PAYLOAD_UBOOT 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SGX_PRMRR_SIZE_64MB 0
+#define CONFIG_BOARD_SIEMENS_CHILI_CHILI_OPTIONS 0
+#define CONFIG_ARCH_ROMSTAGE_ARMV4 0
+#define CONFIG_SUPERIO_NSC_PC87392 0
+#define CONFIG_EFS_SPI_READ_MODE 0
+#define CONFIG_DRIVERS_USB_ACPI 0
+#define CONFIG_BOARD_AMD_THATCHER 0
+#define CONFIG_HEAP_BUMP_ALLOCATOR 1
+#define CONFIG_POWER_OFF_ON_CR50_UPDATE 0
+#define CONFIG_NO_POST 0
+#define CONFIG_HAVE_MRC 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_GRAPHICS 0
+#define CONFIG_VENDOR_EXAMPLE 0
+#define CONFIG_VARIANT_HAS_MIPI_CAMERA 0
+#define CONFIG_DEBUG_INTEL_ME 0
+#define CONFIG_EM100 0
+#define CONFIG_CUSTOM_SPD_TRP 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_PD_FIRMWARE_BUILTIN 0
+#define CONFIG_SPI_FLASH_DONT_INCLUDE_ALL_DRIVERS 0
+#define CONFIG_FSP_STATUS_GLOBAL_RESET_REQUIRED_7 0
+#define CONFIG_EARLY_CBMEM_LIST 0
+#define CONFIG_SUPPORT_CPU_UCODE_IN_CBFS 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_RESET 1
+#define CONFIG_ACPI_BERT 0
+#define CONFIG_ACPI_ENABLE_THERMAL_ZONE 0
+#define CONFIG_INTEL_TXT 0
+#define CONFIG_EARLY_TCSS_DISPLAY 0
+#define CONFIG_RISCV_USE_ARCH_TIMER 0
+#define CONFIG_BOARD_EMULATION_QEMU_RISCV_RV64 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_256 1
+#define CONFIG_BOOT_DEVICE_SPI_FLASH_RW_NOMMAP_EARLY 0
+#define CONFIG_H8_FN_KEY_AS_VBOOT_RECOVERY_SW 0
+#define CONFIG_NORTHBRIDGE_INTEL_X4X 0
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL 7
+#define CONFIG_SB800_FWM_AT_FFF20000 0
+#define CONFIG_BOARD_FACEBOOK_MONOLITH 0
+#define CONFIG_VPD 0
+#define CONFIG_VENDOR_PURISM 0
+#define CONFIG_GENERATE_MP_TABLE 0
+#define CONFIG_NO_FMAP_CACHE 0
+#define CONFIG_BOARD_GOOGLE_HATCH 0
+#define CONFIG_ARCH_VERSTAGE_RISCV 0
+#define CONFIG_DISABLE_ACPI_HIBERNATE 0
+#define CONFIG_DRAM_SIZE_MB 0
+#define CONFIG_NHLT_DMIC_1CH 0
+#define CONFIG_PAYLOAD_OPTIONS ""
+#define CONFIG_MANDOLIN_IOMUX_USE_EMMC 0
+#define CONFIG_SECUNET_DMI 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_FIRMWARE_NONE 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_KAHLEE 0
+#define CONFIG_SOC_INTEL_COMMON_LPSS_UART_CLK_M_VAL 0
+#define CONFIG_ENABLE_MRC_CACHE 0
+#define CONFIG_CUSTOM_SPD_TCK 0
+#define CONFIG_STORAGE_ERASE 0
+#define CONFIG_BOARD_GOOGLE_BOTEN 0
+#define CONFIG_ARCH_RAMSTAGE_RISCV 0
+#define CONFIG_BOARD_ASROCK_G41M_VS3_R2_0 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SPI 0
+#define CONFIG_INTEL_INT15 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_SPI_WAKEUP_DELAY_US 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_105 0
+#define CONFIG_BOOTMEDIA_LOCK_WPRO_VBOOT_RO 0
+#define CONFIG_SSE 0
+#define CONFIG_BOARD_GOOGLE_ASURADA_COMMON 0
+#define CONFIG_DEBUG_TPM 0
+#define CONFIG_MAX_PCIE_CLOCKS 0
+#define CONFIG_TPM_MEASURED_BOOT 0
+#define CONFIG_SOC_AMD_PICASSO 0
+#define CONFIG_DEBUG_CONSOLE_INIT 0
+#define CONFIG_TIANOCORE_BOOTSPLASH_IMAGE 0
+#define CONFIG_ENABLE_MSATA 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_DSP 0
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL_6 0
+#define CONFIG_VENDOR_ASUS 0
+#define CONFIG_BOARD_GOOGLE_DELBIN 0
+#define CONFIG_HAVE_INTEL_FSP_REPO 0
+#define CONFIG_SOC_ESPI 0
+#define CONFIG_MRC_RMT 0
+#define CONFIG_VENDOR_PCENGINES 0
+#define CONFIG_SMSC_SIO1036_BASE_164E 0
+#define CONFIG_VENDOR_PRODRIVE 0
+#define CONFIG_YABEL_VIRTMEM_LOCATION 0
+#define CONFIG_BOARD_COMPULAB_INTENSE_PC 0
+#define CONFIG_VERSTAGE_ADDR 0x2000000
+#define CONFIG_GENERIC_LINEAR_FRAMEBUFFER 0
+#define CONFIG_PADMELON_PRAIRIE_FALCON 0
+#define CONFIG_UNLOCK_FLASH_REGIONS 0
+#define CONFIG_UNKNOWN_TSC_RATE 1
+#define CONFIG_BOARD_HP_2570P 0
+#define CONFIG_DRIVER_MAXIM_MAX77686 0
+#define CONFIG_DRIVER_PARADE_PS8640 0
+#define CONFIG_BOARD_SAPPHIRE_PUREPLATINUMH61 0
+#define CONFIG_COLLECT_TIMESTAMPS 1
+#define CONFIG_AMD_SOC_CONSOLE_UART 0
+#define CONFIG_BOARD_FACEBOOK_FBG1701 0
+#define CONFIG_SOC_INTEL_ELKHARTLAKE 0
+#define CONFIG_SUPERIO_ITE_IT8728F 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_LPSS 0
+#define CONFIG_SOC_INTEL_BAYTRAIL 0
+#define CONFIG_DRIVERS_I2C_CK505 0
+#define CONFIG_DEBUG_FUNC 0
+#define CONFIG_BOARD_GOOGLE_VEYRON 0
+#define CONFIG_PCIEXP_PLUGIN_SUPPORT 1
+#define CONFIG_ENABLE_FSP_MEMORY_DOWN 0
+#define CONFIG_SUPERIO_ITE_ENV_CTRL_8BIT_PWM 0
+#define CONFIG_FLASH_DUAL_READ 0
+#define CONFIG_MMX 0
+#define CONFIG_SYSTEM_TYPE_TABLET 0
+#define CONFIG_BOARD_GOOGLE_BRYA0 0
+#define CONFIG_BOARD_GOOGLE_LULU 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_UART 0
+#define CONFIG_ALWAYS_RUN_OPROM 0
+#define CONFIG_BOARD_GOOGLE_DRATINI 0
+#define CONFIG_SOUTHBRIDGE_AMD_PI_BOLTON 0
+#define CONFIG_ARM64_USE_SECURE_OS 0
+#define CONFIG_DRAM_PART_NUM_NOT_ALWAYS_IN_CBI 0
+#define CONFIG_SPI_FLASH_SST 0
+#define CONFIG_BOARD_PURISM_LIBREM15_V4 0
+#define CONFIG_BOARD_INTEL_COFFEELAKE_RVP8 0
+#define CONFIG_SOC_TI_AM335X 0
+#define CONFIG_SUPERIO_NUVOTON_COMMON_COM_A 0
+#define CONFIG_ARCH_PPC64 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SGX_PRMRR_SIZE_128MB 0
+#define CONFIG_MMCONF_SUPPORT 0
+#define CONFIG_BOARD_GOOGLE_ARCADA 0
+#define CONFIG_RK3399_SPREAD_SPECTRUM_DDR 0
+#define CONFIG_COMPRESS_PRERAM_STAGES 0
+#define CONFIG_BOARD_ASUS_P5GC_MX 0
+#define CONFIG_LINUXBOOT_KERNEL_LONGTERM 0
+#define CONFIG_SUPERIO_SMSC_KBC1100 0
+#define CONFIG_ARCH_VERSTAGE_ARM 0
+#define CONFIG_CBFS_SIZE 0x00040000
+#define CONFIG_X86EMU_DEBUG_PMM 0
+#define CONFIG_S3_DATA_SIZE 0
+#define CONFIG_LINUXBOOT_UROOT_BB 0
+#define CONFIG_SUPERIO_WINBOND_W83627HF 0
+#define CONFIG_TIANOCORE_UEFIPAYLOAD 0
+#define CONFIG_BOARD_GOOGLE_DAMU 0
+#define CONFIG_BOARD_ASUS_P5G41T_M_LX 0
+#define CONFIG_NHLT_DA7219 0
+#define CONFIG_VERIFY_HOBS 0
+#define CONFIG_X86EMU_DEBUG_JMP 0
+#define CONFIG_MRC_STASH_TO_CBMEM 0
+#define CONFIG_BOARD_ASUS_P8Z77_V_LX2 0
+#define CONFIG_DRIVERS_UART 1
+#define CONFIG_BOARD_KONTRON_COME_MAL10 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_TCO_ENABLE_THROUGH_SMBUS 0
+#define CONFIG_BOOTMEDIA_LOCK_IN_VERSTAGE 0
+#define CONFIG_SOC_INTEL_COMETLAKE_S 0
+#define CONFIG_BOARD_GOOGLE_LAZOR 0
+#define CONFIG_DISPLAY_VBT 0
+#define CONFIG_SETUP_XIP_CACHE 0
+#define CONFIG_BOARD_GOOGLE_PALKIA 0
+#define CONFIG_BOARD_LENOVO_T430S 0
+#define CONFIG_DRIVERS_UART_PL011 0
+#define CONFIG_BOARD_GOOGLE_VEYRON_JERRY 0
+#define CONFIG_AMD_SB_CIMX 0
+#define CONFIG_CPU_INTEL_MODEL_206AX 0
+#define CONFIG_AMD_APU_PRAIRIEFALCON 0
+#define CONFIG_BAP_E20_DDR3_800 0
+#define CONFIG_ELOG_DEBUG 0
+#define CONFIG_SOC_CAVIUM_COMMON 0
+#define CONFIG_ARCH_VERSTAGE_ARMV8_64 0
+#define CONFIG_BOARD_SUPERMICRO_X9SCL 0
+#define CONFIG_DRIVERS_UART_8250_TX_FIFO_SIZE 16
+#define CONFIG_SEABIOS_SERCON_PORT_ADDR 0
+#define CONFIG_SEABIOS_VGA_COREBOOT 0
+#define CONFIG_GRUB2_STABLE 0
+#define CONFIG_DRIVERS_GENESYSLOGIC_GL9755 0
+#define CONFIG_BOOTMEDIA_LOCK_CONTROLLER 0
+#define CONFIG_SOUTHBRIDGE_INTEL_I82371EB 1
+#define CONFIG_DISPLAY_FSP_HEADER 0
+#define CONFIG_BOARD_AMD_GARDENIA 0
+#define CONFIG_MICROCODE_BLOB_NOT_IN_BLOB_REPO 0
+#define CONFIG_ARCH_ROMSTAGE_PPC64 0
+#define CONFIG_SOC_INTEL_COMETLAKE_2 0
+#define CONFIG_PI_AGESA_CAR_HEAP_BASE 0
+#define CONFIG_SUPERIO_WINBOND_W83977TF 0
+#define CONFIG_ACPI_LPIT 0
+#define CONFIG_HAVE_PSP_WHITELIST_FILE 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_4096 0
+#define CONFIG_BOARD_EMULATION_QEMU_X86_Q35 0
+#define CONFIG_LINUXBOOT_KERNEL_CUSTOM 0
+#define CONFIG_MULTIPLE_VGA_ADAPTERS 0
+#define CONFIG_BOARD_INTEL_COFFEELAKE_RVP11 0
+#define CONFIG_HUDSON_UART 0
+#define CONFIG_HAVE_DISPLAY_MTRRS 0
+#define CONFIG_FSP_BUILD_TYPE_RELEASE 0
+#define CONFIG_DRIVER_TPM_SPI_BUS 0
+#define CONFIG_BOARD_GOOGLE_PHASER 0
+#define CONFIG_VBOOT_WITH_CRYPTO_SHIELD 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_10B 0
+#define CONFIG_SOC_QC_IPQ40XX 0
+#define CONFIG_PCR_BASE_ADDRESS 0
+#define CONFIG_CONSOLE_CBMEM_DUMP_TO_UART 0
+#define CONFIG_MICROCODE_UPDATE_PRE_RAM 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_110 0
+#define CONFIG_BOARD_PACKARDBELL_MS2290 0
+#define CONFIG_BOARD_SIEMENS_MC_APL3 0
+#define CONFIG_ARCH_RISCV_PMP 0
+#define CONFIG_DCACHE_RAM_SIZE 0x90000
+#define CONFIG_BOARD_OCP_TIOGAPASS 0
+#define CONFIG_BOARD_GOOGLE_NYAN 0
+#define CONFIG_MT8192_DRAM_DVFS 0
+#define CONFIG_VENDOR_SYSTEM76 0
+#define CONFIG_APU2_PINMUX_OFF_C 0
+#define CONFIG_NO_BOOTBLOCK_CONSOLE 0
+#define CONFIG_LINUXBOOT_KERNEL_UIMAGE 0
+#define CONFIG_VARIANT_MIN_BOARD_ID_V3_6_SCHEMATICS 0
+#define CONFIG_ARCH_ROMSTAGE_ARMV7 0
+#define CONFIG_STM 0
+#define CONFIG_TTYS0_BAUD 115200
+#define CONFIG_SB800_NO_FAN_CONTROL 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_11B 0
+#define CONFIG_BOARD_GOOGLE_STERN 0
+#define CONFIG_ARCH_POSTCAR_X86_32 1
+#define CONFIG_MANDOLIN_HAVE_MCHP_FW 0
+#define CONFIG_INTEL_DDI 0
+#define CONFIG_SEABIOS_MASTER 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_TREMBYLE 0
+#define CONFIG_CAR_CQOS 0
+#define CONFIG_VENDOR_BIOSTAR 0
+#define CONFIG_STONEYRIDGE_LEGACY_FREE 0
+#define CONFIG_BOARD_GOOGLE_STRYKE 0
+#define CONFIG_VENDOR_IBASE 0
+#define CONFIG_FSP_STATUS_GLOBAL_RESET_REQUIRED_4 0
+#define CONFIG_SUPERIO_NUVOTON_NCT6776 0
+#define CONFIG_BOARD_LENOVO_X220 0
+#define CONFIG_MP_SERVICES_PPI 0
+#define CONFIG_SOC_EXAMPLE_MIN86 0
+#define CONFIG_BOARD_GOOGLE_KAISA 0
+#define CONFIG_COLLECT_TIMESTAMPS_TSC 1
+#define CONFIG_BOARD_PROTECTLI_FW4B 0
+#define CONFIG_NORTHBRIDGE_INTEL_COMMON 0
+#define CONFIG_DEBUG_BOOT_STATE 0
+#define CONFIG_DRAM_PART_IN_CBI_BOARD_ID_MIN 0
+#define CONFIG_NORTHBRIDGE_AMD_AGESA_FAMILY14 0
+#define CONFIG_BOARD_LENOVO_T520 0
+#define CONFIG_FSP_T_ADDR 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_XDCI 0
+#define CONFIG_BOARD_GOOGLE_BANJO 0
+#define CONFIG_HAVE_ROMSTAGE 1
+#define CONFIG_BOOT_DEVICE_NOT_SPI_FLASH 0
+#define CONFIG_CPU_AMD_AGESA_OPENSOURCE_MEM_JEDEC 0
+#define CONFIG_BOARD_GOOGLE_NAMI 0
+#define CONFIG_SUPERIO_WANTS_14MHZ_CLOCK 0
+#define CONFIG_DRIVERS_I2C_RX6110SA 0
+#define CONFIG_USE_INTEL_FSP_MP_INIT 0
+#define CONFIG_BOARD_INTEL_CEDARISLAND_CRB 0
+#define CONFIG_CONSOLE_SERIAL_UART_ADDRESS 0
+#define CONFIG_DRIVERS_GFX_GENERIC 0
+#define CONFIG_HAVE_GBE_BIN 0
+#define CONFIG_BOARD_GOOGLE_CANDY 0
+#define CONFIG_CBFS_READAHEAD_SIZE 0x0
+#define CONFIG_STM_TTYS0_BASE 0
+#define CONFIG_LINUXBOOT_UROOT_V3_0_0 0
+#define CONFIG_POWER_STATE_ON_AFTER_FAILURE 0
+#define CONFIG_BOARD_LENOVO_X60 0
+#define CONFIG_DRIVERS_I2C_MAX98373 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_PD_FIRMWARE_NONE 0
+#define CONFIG_BOARD_GOOGLE_VOXEL 0
+#define CONFIG_MAINBOARD_HAS_SPI_TPM_CR50 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_DEDEDE 0
+#define CONFIG_BOARD_GOOGLE_KARMA 0
+#define CONFIG_BOARD_ROMSIZE_KB_1024 0
+#define CONFIG_SDHCI_CONTROLLER 0
+#define CONFIG_ARCH_RAMSTAGE_ARMV8_64 0
+#define CONFIG_INTEL_PCH_UART_CONSOLE_NUMBER 0
+#define CONFIG_STM_HEAPSIZE 0
+#define CONFIG_SOC_INTEL_COMMON_FSP_RESET 0
+#define CONFIG_VBOOT_ENABLE_CBFS_FALLBACK 0
+#define CONFIG_ARCH_RISCV_S 0
+#define CONFIG_BOARD_AMD_PERSIMMON 0
+#define CONFIG_VENDORCODE_ELTAN_MBOOT 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_RTC 0
+#define CONFIG_VGA_ROM_RUN_DEFAULT 0
+#define CONFIG_VBOOT_DISABLE_DEV_ON_RECOVERY 0
+#define CONFIG_BOARD_ASUS_F2A85_M 0
+#define CONFIG_REALMODE_DEBUG 0
+#define CONFIG_PXE 0
+#define CONFIG_ARCH_ROMSTAGE_X86_32 1
+#define CONFIG_ARCH_VERSTAGE_X86_32 1
+#define CONFIG_BOARD_LENOVO_X220I 0
+#define CONFIG_COMPILER_LLVM_CLANG 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_106 0
+#define CONFIG_BOARD_ASUS_P5QC 0
+#define CONFIG_BOARD_INTEL_KBLRVP11 0
+#define CONFIG_CHROMEOS_DSM_CALIB 0
+#define CONFIG_SUPERIO_ASPEED_USE_UART_DELAY_WORKAROUND 0
+#define CONFIG_CPU_INTEL_SOCKET_M 0
+#define CONFIG_TIANOCORE_COREBOOTPAYLOAD 0
+#define CONFIG_PMIC_BUS 0
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL_3 0
+#define CONFIG_PAYLOAD_CONFIGFILE ""
+#define CONFIG_SOUTHBRIDGE_INTEL_I82801JX 0
+#define CONFIG_SMM_STUB_STACK_SIZE 0
+#define CONFIG_PICASSO_FW_A_POSITION 0
+#define CONFIG_IPMI_KCS_TIMEOUT_MS 0
+#define CONFIG_BOARD_KONTRON_T10_TNI 0
+#define CONFIG_DRIVERS_ASPEED_AST_COMMON 0
+#define CONFIG_SPI_FLASH_SMM 0
+#define CONFIG_NORTHBRIDGE_INTEL_E7505 0
+#define CONFIG_MAINBOARD_USES_FSP2_0 0
+#define CONFIG_DRIVERS_SPI_ACPI 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_10240 0
+#define CONFIG_GRU_BASEBOARD_SCARLET 0
+#define CONFIG_COMPRESS_BOOTBLOCK 0
+#define CONFIG_DISPLAY_UPD_DATA 0
+#define CONFIG_BOARD_LENOVO_T400 0
+#define CONFIG_ENABLE_IDE_COMBINED_MODE 0
+#define CONFIG_BOARD_GOOGLE_COPANO 0
+#define CONFIG_BOARD_ASUS_F2A85_M_LE 0
+#define CONFIG_MRC_SETTINGS_PROTECT 0
+#define CONFIG_VBT_DATA_SIZE_KB 8
+#define CONFIG_VENDOR_LIBRETREND 0
+#define CONFIG_PXE_SERIAL_CONSOLE 0
+#define CONFIG_VENDOR_ACER 0
+#define CONFIG_SUBSYSTEM_VENDOR_ID 0x0000
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GSPI 0
+#define CONFIG_CBFS_PREFIX_NORMAL 0
+#define CONFIG_LINUXBOOT_INITRAMFS_COMPRESSION_NONE 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_IOMMU 0
+#define CONFIG_SYSTEM_TYPE_DETACHABLE 0
+#define CONFIG_RISCV_OPENSBI 0
+#define CONFIG_LINUXBOOT_KERNEL_MAINLINE 0
+#define CONFIG_SUPERIO_ITE_IT8718F 0
+#define CONFIG_BOARD_ASUS_A88XM_E 0
+#define CONFIG_UART_OVERRIDE_REFCLK 0
+#define CONFIG_BOARD_GOOGLE_CAVE 0
+#define CONFIG_HAVE_LINEAR_FRAMEBUFFER 1
+#define CONFIG_VBOOT_KEYBLOCK_VERSION 0
+#define CONFIG_FLATTENED_DEVICE_TREE 0
+#define CONFIG_BOARD_PURISM_LIBREM15_V3 0
+#define CONFIG_LOGICAL_CPUS 1
+#define CONFIG_BOARD_GOOGLE_TREEYA 0
+#define CONFIG_SOC_INTEL_KABYLAKE 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_SPI 0
+#define CONFIG_BOARD_APPLE_MACBOOK11 0
+#define CONFIG_PI_AGESA_TEMP_RAM_BASE 0
+#define CONFIG_BOARD_GOOGLE_VOLTEER 0
+#define CONFIG_MB_HAS_ACTIVE_HIGH_SD_PWR_ENABLE 0
+#define CONFIG_SPI_SDCARD 0
+#define CONFIG_BOARD_INTEL_GALILEO 0
+#define CONFIG_BOOTROM_SDRAM_INIT 0
+#define CONFIG_BOARD_GOOGLE_FLAPJACK 0
+#define CONFIG_INTEL_CBNT_SUPPORT 0
+#define CONFIG_SUPERIO_WINBOND_WPCD376I 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_USER 0
+#define CONFIG_NO_SMM 1
+#define CONFIG_CUSTOM_SPD_TRAS 0
+#define CONFIG_BOARD_LENOVO_R60 0
+#define CONFIG_CONSOLE_SERIAL_921600 0
+#define CONFIG_GBB_FLAG_DISABLE_PD_SOFTWARE_SYNC 0
+#define CONFIG_CONSOLE_NE2K 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_5120 0
+#define CONFIG_DRIVERS_I2C_NAU8825 0
+#define CONFIG_SEABIOS_REVISION 0
+#define CONFIG_CBFS_HASH_SHA256 0
+#define CONFIG_PAGING_IN_CACHE_AS_RAM 0
+#define CONFIG_VENDORCODE_ELTAN_OEM_MANIFEST_ITEMS 0
+#define CONFIG_TPM_CR50 0
+#define CONFIG_CHIPSET_DEVICETREE ""
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_HDA 0
+#define CONFIG_ADD_FSP_BINARIES 0
+#define CONFIG_BOARD_INTEL_LEAFHILL 0
+#define CONFIG_BOARD_INTEL_D510MO 0
+#define CONFIG_BOARD_GOOGLE_ASUKA 0
+#define CONFIG_BOARD_EMULATION_QEMU_ARMV7 0
+#define CONFIG_CPU_QEMU_X86 1
+#define CONFIG_STM_STMPE_ENABLED 0
+#define CONFIG_SOC_INTEL_COMMON_NHLT 0
+#define CONFIG_VENDOR_ADLINK 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE 0
+#define CONFIG_BOARD_ASUS_P8H61_M_LX3_R2_0 0
+#define CONFIG_DISPLAY_FSP_CALLS_AND_STATUS 0
+#define CONFIG_ALWAYS_LOAD_OPROM 0
+#define CONFIG_SOC_CAVIUM_CN81XX 0
+#define CONFIG_ARCH_X86_64_PGTBL_LOC 0
+#define CONFIG_MAINBOARD_HAS_CRB_TPM 0
+#define CONFIG_VENDOR_RAZER 0
+#define CONFIG_BOARD_GOOGLE_EDGAR 0
+#define CONFIG_DEBUG_COVERAGE 0
+#define CONFIG_BOARD_GOOGLE_CAROLINE 0
+#define CONFIG_BOARD_PCENGINES_APU5 0
+#define CONFIG_FOSTER_BCT_CFG_SPI 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_HDA 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_HECI_DISABLE_IN_SMM 0
+#define CONFIG_DRIVER_TPM_I2C_BUS 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SMM_TCO_ENABLE 0
+#define CONFIG_MEMTEST_SECONDARY_PAYLOAD 0
+#define CONFIG_BOARD_ASUS_H61M_CS 0
+#define CONFIG_PXE_NO_PROMPT 0
+#define CONFIG_MP_SERVICES_PPI_V2 0
+#define CONFIG_TPM_DEACTIVATE 0
+#define CONFIG_COMPRESS_SECONDARY_PAYLOAD 1
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_CNVI 0
+#define CONFIG_AMD_APU_MERLINFALCON 0
+#define CONFIG_BOARD_HP_280_G2 0
+#define CONFIG_RESOURCE_ALLOCATOR_V3 0
+#define CONFIG_CMOS_POST_OFFSET 0
+#define CONFIG_SOUTHBRIDGE_AMD_AGESA_YANGTZE 0
+#define CONFIG_DISPLAY_FSP_VERSION_INFO 0
+#define CONFIG_CPU_AMD_PI_00630F01 0
+#define CONFIG_DEBUG_RAM_SETUP 0
+#define CONFIG_FSP_COMPRESS_FSP_S_LZMA 0
+#define CONFIG_INTEL_ADD_TOP_SWAP_BOOTBLOCK 0
+#define CONFIG_POWER_BUTTON_FORCE_DISABLE 0
+#define CONFIG_BOARD_GOOGLE_WYVERN 0
+#define CONFIG_INTEL_DESCRIPTOR_MODE_REQUIRED 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_CSE 0
+#define CONFIG_SOC_INTEL_COMETLAKE 0
+#define CONFIG_VENDOR_AMD 0
+#define CONFIG_BOARD_HP_8770W 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_HATCH 0
+#define CONFIG_BOARD_INTEL_D945GCLF 0
+#define CONFIG_BOARD_AMD_PARMER 0
+#define CONFIG_BOARD_GOOGLE_AURON_PAINE 0
+#define CONFIG_USE_DENVERTON_NS_FSP_CAR 0
+#define CONFIG_BOARD_GOOGLE_NIGHTFURY 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GSPI_CLOCK_MHZ 0
+#define CONFIG_CPU_INTEL_MODEL_67X 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_PD 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_117 0
+#define CONFIG_BASEBOARD_OCTOPUS_LAPTOP 0
+#define CONFIG_SOC_INTEL_ALDERLAKE_DEBUG_CONSENT 0
+#define CONFIG_SKIP_FSP_CAR 0
+#define CONFIG_FORCE_AM1_SOCKET_SUPPORT 0
+#define CONFIG_HWM_PORT 0
+#define CONFIG_INTEL_CAR_CQOS 0
+#define CONFIG_BOARD_EMULATION_QEMU_RISCV 0
+#define CONFIG_CPU_INTEL_FIRMWARE_INTERFACE_TABLE 0
+#define CONFIG_X86_AMD_INIT_SIPI 0
+#define CONFIG_MAX_PIRQ_LINKS 0
+#define CONFIG_BOARD_EMULATION_QEMU_X86_I440FX 1
+#define CONFIG_PCIEXP_HOTPLUG_PREFETCH_MEM_ABOVE_4G 0
+#define CONFIG_APU2_PINMUX_OFF_D 0
+#define CONFIG_STORAGE_WRITE 0
+#define CONFIG_EC_SMSC_MEC1308 0
+#define CONFIG_BOARD_ASUS_P8H61_M_PRO 0
+#define CONFIG_BOARD_GOOGLE_SQUAWKS 0
+#define CONFIG_ANY_TOOLCHAIN 0
+#define CONFIG_BOARD_ROMSIZE_KB_10240 0
+#define CONFIG_DISABLE_SPI_FLASH_ROM_SHARING 0
+#define CONFIG_SDHC_DEBUG 0
+#define CONFIG_SOUTHBRIDGE_INTEL_LYNXPOINT 0
+#define CONFIG_CACHE_QOS_SIZE_PER_BIT 0
+#define CONFIG_INCLUDE_NHLT_BLOBS 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GPIO_DUAL_ROUTE_SUPPORT 0
+#define CONFIG_NO_MMCONF_SUPPORT 1
+#define CONFIG_NORTHBRIDGE_INTEL_SUBTYPE_I945GM 0
+#define CONFIG_SOC_INTEL_JASPERLAKE_DEBUG_CONSENT 0
+#define CONFIG_ENABLE_DEBUG_LED_SOC_EARLY_INIT_ENTRY 0
+#define CONFIG_BOARD_RODA_RV11 0
+#define CONFIG_BOARD_LENOVO_Z61T 0
+#define CONFIG_COMPRESSED_PAYLOAD_LZ4 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_DATA_FABRIC 0
+#define CONFIG_DRIVERS_I2C_RT5663 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_11A 0
+#define CONFIG_BOARD_GOOGLE_KATSU 0
+#define CONFIG_BOARD_PURISM_BASEBOARD_LIBREM_SKL 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_RCBA_PIRQ 0
+#define CONFIG_ARCH_RISCV_RV64 0
+#define CONFIG_RT8168_SET_LED_MODE 0
+#define CONFIG_STONEYRIDGE_SATA_MODE 0
+#define CONFIG_VBOOT_SLOTS_RW_AB 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_DRALLION 0
+#define CONFIG_CONSOLE_SERIAL_TEGRA210_UARTD 0
+#define CONFIG_SKYLAKE_SOC_PCH_H 0
+#define CONFIG_BOARD_ASUS_P2B_F 0
+#define CONFIG_EHCI_BAR 0
+#define CONFIG_USE_CPU_MICROCODE_CBFS_BINS 0
+#define CONFIG_BOARD_SPECIFIC_OPTIONS 1
+#define CONFIG_ARCH_X86 1
+#define CONFIG_BOARD_HP_REVOLVE_810_G1 0
+#define CONFIG_BOARD_GOOGLE_TERRADOR 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SMM 0
+#define CONFIG_EC_QUANTA_IT8518 0
+#define CONFIG_EARLYRAM_BSP_STACK_SIZE 0
+#define CONFIG_BOARD_RAZER_BLADE_STEALTH_KBL 0
+#define CONFIG_USE_OPTION_TABLE 0
+#define CONFIG_SMBIOS_PROVIDED_BY_MOBO 0
+#define CONFIG_BOARD_GOOGLE_GENESIS 0
+#define CONFIG_CBFS_CHUNKED_PARALLEL 0
+#define CONFIG_BOARD_CLEVO_L140CU 0
+#define CONFIG_VBOOT_SEPARATE_VERSTAGE 0
+#define CONFIG_PARALLEL_DEV_INIT 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_2048 0
+#define CONFIG_CAVIUM_BDK_VERBOSE_QLM 0
+#define CONFIG_X86EMU_DEBUG_INTERRUPTS 0
+#define CONFIG_DRIVERS_I2C_WW_RING 0
+#define CONFIG_BOARD_GOOGLE_WILLOW 0
+#define CONFIG_RMU_LOC 0
+#define CONFIG_ACPI_AMD_HARDWARE_SLEEP_VALUES 0
+#define CONFIG_S3_VGA_ROM_RUN 0
+#define CONFIG_ARCH_RAMSTAGE_ARMV4 0
+#define CONFIG_VENDOR_GIGABYTE 0
+#define CONFIG_TEGRA124_MODEL_CD580M 0
+#define CONFIG_SUBSYSTEM_DEVICE_ID 0x0000
+#define CONFIG_CBFS_HASH_SHA512 0
+#define CONFIG_UDK_2013_VERSION 0
+#define CONFIG_ARCH_RAMSTAGE_ARMV7_R 0
+#define CONFIG_CPU_QEMU_POWER8 0
+#define CONFIG_BILBY_SMSC_SIO1036_BASE_4E 0
+#define CONFIG_VBOOT_VBNV_FLASH 0
+#define CONFIG_EC_HP_KBC1126_GPE 0
+#define CONFIG_COMMONLIB_STORAGE_MMC 0
+#define CONFIG_INTEL_CAR_NEM 0
+#define CONFIG_SOC_INTEL_COFFEELAKE 0
+#define CONFIG_SB800_SATA_IDE 0
+#define CONFIG_UBOOT_MASTER 0
+#define CONFIG_BOARD_INTEL_ICELAKE_RVPU 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_PSP_GEN1 0
+#define CONFIG_BOARD_HP_Z220_SFF_WORKSTATION 0
+#define CONFIG_XHCI_UTILS 0
+#define CONFIG_EC_SYSTEM76_EC 0
+#define CONFIG_BOARD_GOOGLE_PEACH_PIT 0
+#define CONFIG_ARCH_POSTCAR_X86_64 0
+#define CONFIG_USE_OEM_BIN 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_103 0
+#define CONFIG_IPMI_OCP_MANU_ID 0
+#define CONFIG_LINUXBOOT_INITRAMFS_COMPRESSION_XZ 0
+#define CONFIG_DRIVERS_UART_OXPCIE 0
+#define CONFIG_SPI_FLASH_AMIC 0
+#define CONFIG_DO_NOT_TOUCH_DESCRIPTOR_REGION 0
+#define CONFIG_BOARD_LENOVO_T60 0
+#define CONFIG_HUDSON_AHCI_ROM 0
+#define CONFIG_AGESA_USE_1_0_0_4_HEADER 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_WATCHDOG 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_ACPI_LPIT 0
+#define CONFIG_PCI_SET_BUS_MASTER_PCI_BRIDGES 1
+#define CONFIG_POWER_BUTTON_FORCE_ENABLE 0
+#define CONFIG_PAYLOAD_TIANOCORE 0
+#define CONFIG_VBOOT_WIPEOUT_SUPPORTED 0
+#define CONFIG_DRIVERS_GENERIC_MAX98357A 0
+#define CONFIG_PCR_COMMON_IOSF_1_0 0
+#define CONFIG_INTEL_GMA_BCLM_OFFSET 0xc8256
+#define CONFIG_FRAMEBUFFER_VESA_MODE_10E 0
+#define CONFIG_APL_SET_MIN_CLOCK_RATIO 0
+#define CONFIG_BOARD_GOOGLE_VEYRON_MICKEY 0
+#define CONFIG_IOAPIC 0
+#define CONFIG_NO_EARLY_BOOTBLOCK_POSTCODES 0
+#define CONFIG_HAVE_INTEL_CHIPSET_LOCKDOWN 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_119 0
+#define CONFIG_BOARD_GOOGLE_TERRA 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_PIRQ_ACPI_GEN 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_16384 0
+#define CONFIG_BOARD_SIEMENS_MC_APL4 0
+#define CONFIG_BOARD_CLEVO_N130WU 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_FAST_SPI 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_POPPY 0
+#define CONFIG_CAR_NEM 0
+#define CONFIG_CONFIGURABLE_RAMSTAGE 0
+#define CONFIG_BOARD_LENOVO_X301 0
+#define CONFIG_BOARD_ASUS_F2A85_M_DDR3_VOLT_VAL 0
+#define CONFIG_BOARD_LIPPERT_TOUCAN_AF 0
+#define CONFIG_FSP_USES_CB_STACK 0
+#define CONFIG_BOARD_INTEL_SKLSDLBRK 0
+#define CONFIG_BOARD_AMD_PADMELON 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_AOAC 0
+#define CONFIG_DRIVERS_GENERIC_BAYHUB_LV2 0
+#define CONFIG_BOARD_GOOGLE_GARG 0
+#define CONFIG_CUSTOM_SPD_TRFC_LO 0
+#define CONFIG_FIXED_BOOTBLOCK_SIZE 0
+#define CONFIG_RISCV_WORKING_HARTID 0
+#define CONFIG_MRC_WRITE_NV_LATE 0
+#define CONFIG_YABITS_STABLE 0
+#define CONFIG_UDK_202005_VERSION 0
+#define CONFIG_BOARD_ROMSIZE_KB_8192 0
+#define CONFIG_DEBUG_GPIO 0
+#define CONFIG_BOARD_INTEL_STRAGO 0
+#define CONFIG_BOARD_GOOGLE_PUFF 0
+#define CONFIG_DRIVERS_INTEL_SOUNDWIRE 0
+#define CONFIG_CONSOLE_VGA_MULTI 0
+#define CONFIG_BOARD_GOOGLE_DUFFY 0
+#define CONFIG_POST_IO_PORT 0x80
+#define CONFIG_FIXED_MCHBAR_MMIO_BASE 0
+#define CONFIG_SUPERIO_FINTEK_F71869AD 0
+#define CONFIG_FSP_STATUS_GLOBAL_RESET_REQUIRED_3 0
+#define CONFIG_BOARD_GOOGLE_DRAWCIA 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_ACPI_CPPC 0
+#define CONFIG_VPD_SMBIOS_VERSION 0
+#define CONFIG_HUDSON_IMC_ENABLE 0
+#define CONFIG_BOARD_DELL_OPTIPLEX_9010 0
+#define CONFIG_ARCH_BOOTBLOCK_ARMV7 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_SARIEN 0
+#define CONFIG_CUSTOM_SPD_TRC 0
+#define CONFIG_DRIVERS_GENERIC_CBFS_SERIAL 0
+#define CONFIG_MAINBOARD_VENDOR "Emulation"
+#define CONFIG_MAINBOARD_HAS_LPC_TPM 0
+#define CONFIG_RT8168_GET_MAC_FROM_VPD 0
+#define CONFIG_NUM_THREADS 0
+#define CONFIG_ARCH_ROMSTAGE_ARM 0
+#define CONFIG_UDK_2017_BINDING 0
+#define CONFIG_H8_HAS_BAT_TRESHOLDS_IMPL 0
+#define CONFIG_USE_APOLLOLAKE_FSP_CAR 0
+#define CONFIG_BOOT_DEVICE_MEMORY_MAPPED 1
+#define CONFIG_BOARD_GOOGLE_KEVIN 0
+#define CONFIG_BOARD_GOOGLE_BERKNIP 0
+#define CONFIG_CPU_SPECIFIC_OPTIONS 0
+#define CONFIG_SEABIOS_PS2_TIMEOUT 0
+#define CONFIG_VENDOR_AOPEN 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_SPI 0
+#define CONFIG_PCIEXP_HOTPLUG 0
+#define CONFIG_IPMI_FRU_SINGLE_RW_SZ 0
+#define CONFIG_AMD_FWM_POSITION_INDEX 0
+#define CONFIG_BOARD_LIBRETREND_LT1000 0
+#define CONFIG_COMPRESS_RAMSTAGE 1
+#define CONFIG_CONSOLE_SERIAL_38400 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_TSC_FAM17H_19H 0
+#define CONFIG_HAVE_ASAN_IN_ROMSTAGE 1
+#define CONFIG_HAVE_DEBUG_CAR 0
+#define CONFIG_COMPILER_GCC 1
+#define CONFIG_DRIVERS_GENERIC_BH720 0
+#define CONFIG_SUPERIO_SMSC_SIO1007 0
+#define CONFIG_NO_FSP_TEMP_RAM_EXIT 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_8192 0
+#define CONFIG_BOARD_GOOGLE_QUAWKS 0
+#define CONFIG_YABITS_MASTER 0
+#define CONFIG_DRIVERS_AS3722_RTC_BUS 0
+#define CONFIG_DEBUG_PMIC_WRAP 0
+#define CONFIG_SUPERIO_ITE_IT8712F 0
+#define CONFIG_SB800_FWM_AT_FFE20000 0
+#define CONFIG_ENABLE_DEBUG_LED_SOC_EARLY_INIT_EXIT 0
+#define CONFIG_SUPERIO_ASPEED_AST2400 0
+#define CONFIG_BOARD_GOOGLE_BANON 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_109 0
+#define CONFIG_BOARD_GOOGLE_COACHZ 0
+#define CONFIG_X86EMU_DEBUG_VBE 0
+#define CONFIG_BOARD_LENOVO_X200 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SRAM 0
+#define CONFIG_LINEAR_FRAMEBUFFER_MAX_WIDTH 0
+#define CONFIG_BOARD_KONTRON_986LCD_M 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_SPI_BUS 0
+#define CONFIG_DEBUG_ADA_CODE 0
+#define CONFIG_MAJOLICA_HAVE_MCHP_FW 0
+#define CONFIG_BOARD_ASROCK_G41M_S3 0
+#define CONFIG_BOARD_GOOGLE_HALVOR 0
+#define CONFIG_SEABIOS_ADD_SERCON_PORT_FILE 0
+#define CONFIG_LZMA_STREAM_WINDOW_SIZE 0x1000
+#define CONFIG_BOARD_RODA_RK886EX 0
+#define CONFIG_ENABLE_VMX 0
+#define CONFIG_BOARD_PRODRIVE_HERMES_BASEBOARD 0
+#define CONFIG_SPD_LOC 0
+#define CONFIG_VARIANT_HAS_CAMERA_ACPI 0
+#define CONFIG_TSC_SYNC_LFENCE 0
+#define CONFIG_BOARD_GOOGLE_FIZZ 0
+#define CONFIG_BOARD_51NB_X210 0
+#define CONFIG_POST_DEVICE_LPC 0
+#define CONFIG_MAINBOARD_DIR "emulation/qemu-i440fx"
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_BRYA 0
+#define CONFIG_COMPRESS_RAMSTAGE_BCJ 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_USB4 0
+#define CONFIG_BOARD_GOOGLE_KUKUI_COMMON 0
+#define CONFIG_VENDOR_CAVIUM 0
+#define CONFIG_TIANOCORE_TARGET_X64 0
+#define CONFIG_OVERRIDE_UART_FOR_CONSOLE 0
+#define CONFIG_CPU_AMD_PI 0
+#define CONFIG_ARCH_ARMV8_EXTENSION 0
+#define CONFIG_CAVIUM_BDK_VERBOSE_PCIE_CONFIG 0
+#define CONFIG_DRIVERS_SOUNDWIRE_ALC1308 0
+#define CONFIG_BOARD_GOOGLE_MADOO 0
+#define CONFIG_DRIVERS_GENESYSLOGIC_GL9763E 0
+#define CONFIG_VENDOR_APPLE 0
+#define CONFIG_VENDOR_GIZMOSPHERE 0
+#define CONFIG_BOARD_LENOVO_R500 0
+#define CONFIG_HAVE_POWER_STATE_AFTER_FAILURE 0
+#define CONFIG_BOARD_INTEL_BASKING_RIDGE 0
+#define CONFIG_VBOOT_VBNV_EC 0
+#define CONFIG_FSP_M_XIP 0
+#define CONFIG_HASWELL_HIDE_PEG_FROM_MRC 0
+#define CONFIG_BOARD_GOOGLE_AMBASSADOR 0
+#define CONFIG_APU2_PINMUX_GPIO0 0
+#define CONFIG_VENDOR_LIPPERT 0
+#define CONFIG_BOOTBLOCK_SIMPLE 1
+#define CONFIG_SOC_INTEL_COMMON_PCH_LOCKDOWN 0
+#define CONFIG_DRIVERS_RICOH_RCE822 0
+#define CONFIG_DEBUG_SMI 0
+#define CONFIG_EC_BASE_PACKET 0
+#define CONFIG_BOARD_GOOGLE_MUSHU 0
+#define CONFIG_BOARD_GOOGLE_KEFKA 0
+#define CONFIG_BOARD_GIZMOSPHERE_GIZMO 0
+#define CONFIG_SUPERIO_ITE_IT8786E 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_ME 0
+#define CONFIG_SOC_INTEL_COMMON_BASECODE 0
+#define CONFIG_BOARD_AMD_BILBY 0
+#define CONFIG_CONSOLE_CBMEM 1
+#define CONFIG_VBOOT_VBNV_CMOS 0
+#define CONFIG_ENABLE_DEBUG_LED 0
+#define CONFIG_UART_D_RS485 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_GUYBRUSH 0
+#define CONFIG_CPU_QEMU_X86_32 1
+#define CONFIG_BOARD_INTEL_KBLRVP3 0
+#define CONFIG_SOCKET_SPECIFIC_OPTIONS 0
+#define CONFIG_SOUTHBRIDGE_INTEL_I82870 0
+#define CONFIG_SOC_INTEL_ELKHARTLAKE_DEBUG_CONSENT 0
+#define CONFIG_GLK_CHROME_EC 0
+#define CONFIG_PCIEXP_HOTPLUG_PREFETCH_MEM_BELOW_4G 0
+#define CONFIG_BOARD_CAVIUM_CN8100_SFF_EVB 0
+#define CONFIG_CONSOLE_SERIAL_TEGRA210_UARTC 0
+#define CONFIG_DRIVERS_INTEL_ISH 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_TIMER 0
+#define CONFIG_SUPERIO_FINTEK_COMMON_PRE_RAM 0
+#define CONFIG_CONSOLE_USB 0
+#define CONFIG_BOARD_GOOGLE_STOUT 0
+#define CONFIG_CPU_ADDR_BITS 36
+#define CONFIG_HEAP_SIZE 0x4000
+#define CONFIG_BOARD_GOOGLE_MONROE 0
+#define CONFIG_INTEL_GMA_HAVE_VBT 0
+#define CONFIG_BOARD_PURISM_LIBREM13_V1 0
+#define CONFIG_COREBOOT_ROMSIZE_KB 256
+#define CONFIG_DRIVERS_GENERIC_IOAPIC 0
+#define CONFIG_VENDOR_HP 0
+#define CONFIG_EC_BASE_HOST_COMMAND 0
+#define CONFIG_BOOTMEDIA_SPI_LOCK_PERMANENT 0
+#define CONFIG_BOARD_GOOGLE_KAPPA 0
+#define CONFIG_BOARD_INTEL_DG43GT 0
+#define CONFIG_BOARD_TI_BEAGLEBONE 0
+#define CONFIG_FSP_COMPRESS_FSP_M_LZ4 0
+#define CONFIG_APU2_PINMUX_UART_D 0
+#define CONFIG_BOARD_LENOVO_BASEBOARD_T520 0
+#define CONFIG_BOARD_GOOGLE_REKS 0
+#define CONFIG_CARDBUS_PLUGIN_SUPPORT 1
+#define CONFIG_SMMSTORE_SIZE 0
+#define CONFIG_BOARD_BIOSTAR_A68N5200 0
+#define CONFIG_MAINBOARD_HAS_CHROMEOS 0
+#define CONFIG_SMM_LAPIC_REMAP_MITIGATION 0
+#define CONFIG_CONSOLE_SYSTEM76_EC 0
+#define CONFIG_INTEL_EDID 0
+#define CONFIG_CONSOLE_SERIAL_115200 1
+#define CONFIG_FOSTER_BCT_CFG_EMMC 0
+#define CONFIG_X86_SMM_LOADER_VERSION2 0
+#define CONFIG_BOARD_ASROCK_E350M1 0
+#define CONFIG_SB800_SATA_RAID 0
+#define CONFIG_BOARD_GOOGLE_EZKINIL 0
+#define CONFIG_BOARD_GOOGLE_WHEELIE 0
+#define CONFIG_ACPI_CONSOLE 0
+#define CONFIG_MMCONF_LENGTH 0
+#define CONFIG_CONSOLE_SERIAL_230400 0
+#define CONFIG_DRIVERS_TI_TPS65913_RTC 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_PUFF 0
+#define CONFIG_TEGRA124_MODEL_CD570M 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SGX 0
+#define CONFIG_GBB_FLAG_FORCE_DEV_SWITCH_ON 0
+#define CONFIG_HWBASE_DIRECT_PCIDEV 0
+#define CONFIG_STACK_SIZE 0x1000
+#define CONFIG_VBOOT_ALWAYS_ENABLE_DISPLAY 0
+#define CONFIG_FSP_DEBUG_ALL 0
+#define CONFIG_BASEBOARD_DEDEDE_LAPTOP 0
+#define CONFIG_BOARD_GOOGLE_GLADOS 0
+#define CONFIG_SUPERIO_NUVOTON_WPCM450 0
+#define CONFIG_CPU_QEMU_X86_LAPIC_INIT 1
+#define CONFIG_BOARD_GOOGLE_JINLON 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_12288 0
+#define CONFIG_SECURITY_CLEAR_DRAM_ON_REGULAR_BOOT 0
+#define CONFIG_LINUXBOOT_COMPILE_KERNEL 0
+#define CONFIG_PMC_IPC_ACPI_INTERFACE 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_10F 0
+#define CONFIG_INCLUDE_NHLT_BLOBS_KARMA 0
+#define CONFIG_ARCH_ROMSTAGE_ARM64 0
+#define CONFIG_GFX_GMA_IGNORE_PRESENCE_STRAPS 0
+#define CONFIG_BOARD_HP_8460P 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GPIO_IOSTANDBY 0
+#define CONFIG_NO_MONOTONIC_TIMER 0
+#define CONFIG_USBDEBUG_HCD_INDEX 0
+#define CONFIG_MEMTEST_MASTER 0
+#define CONFIG_IPMI_KCS 0
+#define CONFIG_LINUXBOOT_ARM64 0
+#define CONFIG_CPU_MICROCODE_CBFS_LEN 0
+#define CONFIG_BOARD_SAMSUNG_LUMPY 0
+#define CONFIG_BOARD_GOOGLE_TRICKY 0
+#define CONFIG_SYSTEM_TYPE_LAPTOP 0
+#define CONFIG_BOARD_GOOGLE_AKEMI 0
+#define CONFIG_STORAGE_EARLY_ERASE 0
+#define CONFIG_NON_LEGACY_UART_MODE 0
+#define CONFIG_SAMPLING_PROFILER_SAMPLES 0
+#define CONFIG_USE_GOOGLE_FSP 0
+#define CONFIG_NO_UART_ON_SUPERIO 0
+#define CONFIG_VENDOR_OPENCELLULAR 0
+#define CONFIG_ARCH_RAMSTAGE_X86_32 1
+#define CONFIG_USBDEBUG_OPTIONAL_HUB_PORT 0
+#define CONFIG_DISPLAY_ESRAM_LAYOUT 0
+#define CONFIG_BOARD_GOOGLE_HAYATO 0
+#define CONFIG_CHROMEOS_DISABLE_PLATFORM_HIERARCHY_ON_RESUME 0
+#define CONFIG_INTEL_TME 0
+#define CONFIG_MMA 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_LPC 0
+#define CONFIG_ARCH_VERSTAGE_PPC64 0
+#define CONFIG_RESUME_PATH_SAME_AS_BOOT 0
+#define CONFIG_SA_ENABLE_IMR 0
+#define CONFIG_CUSTOM_SPD_CASLO 0
+#define CONFIG_VBOOT_KEYBLOCK_PREAMBLE_FLAGS 0
+#define CONFIG_BOARD_ASUS_P2B_DS 0
+#define CONFIG_BOARD_SIEMENS_CHILI_BASE 0
+#define CONFIG_BOARD_LENOVO_T431S 0
+#define CONFIG_VBOOT_STARTS_IN_BOOTBLOCK 0
+#define CONFIG_SOC_INTEL_CSE_LITE_SKU 0
+#define CONFIG_BAP_E20_DDR3_1066 0
+#define CONFIG_POST_IO 1
+#define CONFIG_ARCH_BOOTBLOCK_ARMV4 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GRAPHICS 0
+#define CONFIG_DCACHE_RAM_MRC_VAR_SIZE 0
+#define CONFIG_CPU_AMD_PI_00730F01 0
+#define CONFIG_BOARD_KONTRON_BSL6_OPTIONS 0
+#define CONFIG_NATIVE_RAMINIT_IGNORE_XMP_MAX_DIMMS 0
+#define CONFIG_BOARD_GOOGLE_SUMO 0
+#define CONFIG_BOARD_ROMSIZE_KB_256 1
+#define CONFIG_BOARD_HP_FOLIO_9480M 0
+#define CONFIG_BOARD_GOOGLE_KAKADU 0
+#define CONFIG_BOARD_GOOGLE_SWANKY 0
+#define CONFIG_GBB_FLAG_DEFAULT_DEV_BOOT_ALTFW 0
+#define CONFIG_NYAN_BIG_BCT_CFG_SPI 0
+#define CONFIG_USE_INTEL_FSP_TO_CALL_COREBOOT_PUBLISH_MP_PPI 0
+#define CONFIG_BOARD_GOOGLE_LEON 0
+#define CONFIG_BOARD_EMULATION_QEMU_AARCH64 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_CAR 0
+#define CONFIG_BOARD_HP_FOLIO_9470M 0
+#define CONFIG_SUPERIO_SMSC_LPC47N227 0
+#define CONFIG_CONSOLE_NE2K_IO_PORT 0
+#define CONFIG_VARIANT_MIN_BOARD_ID_WIFI_POWER_ACTIVE_LOW 0
+#define CONFIG_LINEAR_FRAMEBUFFER_MAX_HEIGHT 0
+#define CONFIG_SOC_INTEL_APOLLOLAKE 0
+#define CONFIG_CPU_INTEL_SOCKET_FCBGA559 0
+#define CONFIG_EXCLUDE_NATIVE_SD_INTERFACE 0
+#define CONFIG_GALILEO_GEN2 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SCS 0
+#define CONFIG_HPET_ADDRESS_OVERRIDE 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GSPI_VERSION_2 0
+#define CONFIG_BOARD_INTEL_ADLRVP_P_EXT_EC 0
+#define CONFIG_MAX_PCIE_CLOCK_SRC 0
+#define CONFIG_VENDOR_ASROCK 0
+#define CONFIG_TIMER_QUEUE 0
+#define CONFIG_GBB_FLAG_ENABLE_UDC 0
+#define CONFIG_SUPERIO_ITE_IT8623E 0
+#define CONFIG_SPI_FLASH_INCLUDE_ALL_DRIVERS 0
+#define CONFIG_DRIVERS_AMD_PI 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_I2C_TUNNEL 0
+#define CONFIG_CAVIUM_BDK_DDR_TUNE_HW_OFFSETS 0
+#define CONFIG_SOC_INTEL_JASPERLAKE 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_GPIO 0
+#define CONFIG_PMC_GLOBAL_RESET_ENABLE_LOCK 0
+#define CONFIG_BOARD_PCENGINES_APU3 0
+#define CONFIG_MEMTEST_REVISION 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_SMBUS 1
+#define CONFIG_BOARD_BIOSTAR_TH61_ITX 0
+#define CONFIG_CONSOLE_SERIAL_NONBLOCKING 0
+#define CONFIG_VENDOR_PROTECTLI 0
+#define CONFIG_VGA_ROM_RUN 0
+#define CONFIG_ARCH_RAMSTAGE_X86_64 0
+#define CONFIG_COMPRESSED_PAYLOAD_LZMA 1
+#define CONFIG_SPI_FLASH_NO_FAST_READ 0
+#define CONFIG_GBB_FLAG_DEV_SCREEN_SHORT_DELAY 0
+#define CONFIG_SUPERIO_ITE_COMMON_PRE_RAM 0
+#define CONFIG_DIMM_MAX 4
+#define CONFIG_SUPERIO_NUVOTON_NCT6779D 0
+#define CONFIG_SOC_INTEL_GEMINILAKE 0
+#define CONFIG_MT8183_DRAM_EMCP 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_I2C_BUS 0
+#define CONFIG_VENDOR_BAP 0
+#define CONFIG_X86EMU_DEBUG_CHECK_VMEM_ACCESS 0
+#define CONFIG_BOARD_GOOGLE_BLIPPER 0
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL_7 1
+#define CONFIG_MAINBOARD_HAS_TPM2 0
+#define CONFIG_RTC 0
+#define CONFIG_CONSOLE_SERIAL_19200 0
+#define CONFIG_NO_GFX_INIT 0
+#define CONFIG_MMCONF_BUS_NUMBER 0
+#define CONFIG_SPKMODEM 0
+#define CONFIG_MAINBOARD_HAS_I2C_TPM_CR50 0
+#define CONFIG_VENDOR_BOSTENTECH 0
+#define CONFIG_CRB_TPM_BASE_ADDRESS 0xfed40000
+#define CONFIG_BOARD_GOOGLE_KRANE 0
+#define CONFIG_ACPI_BERT_SIZE 0
+#define CONFIG_PAYLOAD_DEPTHCHARGE 0
+#define CONFIG_CONSOLE_SPI_FLASH 0
+#define CONFIG_DRIVERS_I2C_PCF8523 0
+#define CONFIG_DISPLAY_FSP_ENTRY_POINTS 0
+#define CONFIG_CPU_INTEL_COMMON 0
+#define CONFIG_BOARD_GOOGLE_CAREENA 0
+#define CONFIG_C_ENV_BOOTBLOCK_SIZE 0x10000
+#define CONFIG_EC_GOOGLE_CHROMEEC_PD_FIRMWARE_EXTERNAL 0
+#define CONFIG_BOARD_KONTRON_BSL6 0
+#define CONFIG_INTEL_LPSS_UART_FOR_CONSOLE 0
+#define CONFIG_VBOOT_HAS_REC_HASH_SPACE 0
+#define CONFIG_MAINBOARD_SUPPORTS_KABYLAKE_DUAL 0
+#define CONFIG_EXT_BIOS_WIN_SIZE 0
+#define CONFIG_PAYLOAD_FILE "payloads/external/SeaBIOS/seabios/out/bios.bin.elf"
+#define CONFIG_UDK_2015_VERSION 0
+#define CONFIG_BASEBOARD_BRYA_LAPTOP 0
+#define CONFIG_RAMTOP 0x1000000
+#define CONFIG_FSP_ESRAM_LOC 0
+#define CONFIG_GIC 0
+#define CONFIG_MAINBOARD_USE_LIBGFXINIT 0
+#define CONFIG_LINUXBOOT_UROOT_V2_0_0 0
+#define CONFIG_SUPERIO_NUVOTON_NCT5539D 0
+#define CONFIG_UEFI_2_4_BINDING 0
+#define CONFIG_PSP_LOAD_MP2_FW 0
+#define CONFIG_UTIL_GENPARSER 0
+#define CONFIG_RUN_FSP_GOP 0
+#define CONFIG_BOOTMEDIA_LOCK_NONE 1
+#define CONFIG_ARCH_BOOTBLOCK_X86_32 1
+#define CONFIG_BOARD_ASUS_AM1I_A 0
+#define CONFIG_ARCH_VERSTAGE_ARMV7_M 0
+#define CONFIG_HUDSON_LEGACY_FREE 0
+#define CONFIG_DRIVERS_I2C_MAX98390 0
+#define CONFIG_NORTHBRIDGE_INTEL_SUBTYPE_I945GC 0
+#define CONFIG_MT8183_DRAM_DVFS 0
+#define CONFIG_PAYLOAD_BOOTBOOT 0
+#define CONFIG_ONBOARD_SAMSUNG_MEM 0
+#define CONFIG_BOARD_GOOGLE_PARROT 0
+#define CONFIG_EC_51NB_NPCE985LA0DX 0
+#define CONFIG_DRIVERS_I2C_DESIGNWARE_CLOCK_MHZ 0
+#define CONFIG_CHROMEOS_CAMERA 0
+#define CONFIG_BOARD_GOOGLE_ELEMI 0
+#define CONFIG_BOARD_EXAMPLE_MIN86 0
+#define CONFIG_EC_SYSTEM76_EC_BAT_THRESHOLDS 0
+#define CONFIG_GBB_FLAG_DISABLE_FW_ROLLBACK_CHECK 0
+#define CONFIG_BOARD_GOOGLE_CASTA 0
+#define CONFIG_HUDSON_XHCI_ENABLE 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_CYAN 0
+#define CONFIG_SUPERIO_NSC_PC87382 0
+#define CONFIG_TIANOCORE_BOOT_TIMEOUT 0
+#define CONFIG_STORAGE_EARLY_WRITE 0
+#define CONFIG_INTEL_TXT_BIOSACM_ALIGNMENT 0
+#define CONFIG_ONBOARD_MEM_KINGSTON 0
+#define CONFIG_CBFS_MCACHE_RW_PERCENTAGE 0
+#define CONFIG_SUPERIO_FINTEK_F71863FG 0
+#define CONFIG_CPU_INTEL_SOCKET_BGA956 0
+#define CONFIG_DRIVERS_I2C_NCT7802Y 0
+#define CONFIG_VENDOR_51NB 0
+#define CONFIG_TPM_PPI 0
+#define CONFIG_APU2_PINMUX_UART_C 0
+#define CONFIG_SDHCI_ADMA_IN_ROMSTAGE 0
+#define CONFIG_WANT_LINEAR_FRAMEBUFFER 0
+#define CONFIG_H8_HAS_PRIMARY_FN_KEYS 0
+#define CONFIG_BOARD_SYSTEM76_ORYP5 0
+#define CONFIG_SIEMENS_CHILI_DEBUG_USB 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_PMBASE 0
+#define CONFIG_CPU_INTEL_COMMON_VOLTAGE 0
+#define CONFIG_VERSTAGE_SIZE 0
+#define CONFIG_TPM_TIS_BASE_ADDRESS 0
+#define CONFIG_ACPI_SSDT_PSD_INDEPENDENT 0
+#define CONFIG_VENDOR_INTEL 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_BOARDID 0
+#define CONFIG_SOC_INTEL_CONFIGURE_DDI_A_4_LANES 0
+#define CONFIG_ARCH_RAMSTAGE_ARM64 0
+#define CONFIG_TPM_PIRQ 0
+#define CONFIG_NATIVE_RAMINIT_IGNORE_MAX_MEM_FUSES 0
+#define CONFIG_MAX_ROOT_PORTS 0
+#define CONFIG_DRIVERS_PS2_KEYBOARD 0
+#define CONFIG_BOARD_GOOGLE_OAK 0
+#define CONFIG_MAINBOARD_NO_FSP_GOP 0
+#define CONFIG_SUPERIO_ITE_ENV_CTRL 0
+#define CONFIG_HAVE_EM100_SUPPORT 0
+#define CONFIG_BOARD_GOOGLE_GUYBRUSH 0
+#define CONFIG_CPU_AMD_AGESA_FAMILY15_TN 0
+#define CONFIG_BOARD_CLEVO_N130WU_OPTIONS 0
+#define CONFIG_NORTHBRIDGE_INTEL_HASWELL 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GPIO_ITSS_POL_CFG 0
+#define CONFIG_SOC_NVIDIA_TEGRA124 0
+#define CONFIG_VBOOT_EC_EFS 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SGX_PRMRR_SIZE_32MB 0
+#define CONFIG_DRIVERS_WIFI_GENERIC 1
+#define CONFIG_BOARD_GOOGLE_JACUZZI 0
+#define CONFIG_SB800_MANUAL_FAN_CONTROL 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_1024 0
+#define CONFIG_INTEL_DESCRIPTOR_MODE_CAPABLE 0
+#define CONFIG_NHLT_NAU88L25 0
+#define CONFIG_SOC_INTEL_CANNONLAKE_BASE 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_AUDIO_CODEC 0
+#define CONFIG_MRC_SETTINGS_VARIABLE_DATA 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_REEF 0
+#define CONFIG_BOARD_GOOGLE_MEEP 0
+#define CONFIG_VENDOR_SAPPHIRE 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_10C 0
+#define CONFIG_SB800_FWM_AT_FFFA0000 0
+#define CONFIG_SUPERIO_ITE_IT8783EF 0
+#define CONFIG_DRIVER_PARADE_PS8625 0
+#define CONFIG_PSP_APOB_DRAM_ADDRESS 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_113 0
+#define CONFIG_APU1_PINMUX_OFF_D 0
+#define CONFIG_BOARD_SIEMENS_MC_APL2 0
+#define CONFIG_MAXIMUM_SUPPORTED_FREQUENCY 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_THERMAL 0
+#define CONFIG_AMD_APU_PKG_FT4 0
+#define CONFIG_SOC_INTEL_ICELAKE 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_DTT 0
+#define CONFIG_USE_SAR 0
+#define CONFIG_VENDOR_PORTWELL 0
+#define CONFIG_BOARD_MSI_MS7707 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_ACPI 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SMBUS 0
+#define CONFIG_DRIVERS_INTEL_WIFI 1
+#define CONFIG_FSP_COMPRESS_FSP_S_LZ4 0
+#define CONFIG_BOARD_ASROCK_G41M_GS 0
+#define CONFIG_MEMORY_TEST 0
+#define CONFIG_USBDEBUG_DONGLE_BEAGLEBONE 0
+#define CONFIG_WARNINGS_ARE_ERRORS 1
+#define CONFIG_BOARD_FOXCONN_D41S 0
+#define CONFIG_SUPERIO_ITE_IT8720F 0
+#define CONFIG_BOARD_GOOGLE_RAMMUS 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_LPC 0
+#define CONFIG_DEBUG_I2C 0
+#define CONFIG_SOC_INTEL_COMMON_ACPI_WAKE_SOURCE 0
+#define CONFIG_BOARD_SIEMENS_CHILI_COMMON 0
+#define CONFIG_POSTCAR_CONSOLE 1
+#define CONFIG_DRIVERS_I2C_GPIO_MUX 0
+#define CONFIG_CONFIGURABLE_CBFS_PREFIX 0
+#define CONFIG_BOARD_GOOGLE_GALTIC 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_AURON 0
+#define CONFIG_FSP_TEMP_RAM_SIZE 0
+#define CONFIG_CPU_INTEL_SOCKET_MPGA604 0
+#define CONFIG_FSP_TYPE_2_0 0
+#define CONFIG_FSP_STATUS_GLOBAL_RESET_REQUIRED_5 0
+#define CONFIG_NORTHBRIDGE_AMD_PI_00730F01 0
+#define CONFIG_DEBUG_PERIODIC_SMI 0
+#define CONFIG_SOC_INTEL_CSE_RW_UPDATE 0
+#define CONFIG_CONSOLE_SERIAL 1
+#define CONFIG_INCLUDE_NHLT_BLOBS_ATLAS 0
+#define CONFIG_UDELAY_LAPIC 0
+#define CONFIG_LINUXBOOT_UROOT_CUSTOM 0
+#define CONFIG_VENDORCODE_ELTAN_VBOOT_KEY_LOCATION 0
+#define CONFIG_CONSOLE_SERIAL_BACKLOG 0
+#define CONFIG_EARLY_PCI_BRIDGE_DEVICE 0
+#define CONFIG_CRB_TPM 0
+#define CONFIG_CUSTOM_SPD_TRTP 0
+#define CONFIG_SOC_INTEL_COMMON_MMC_OVERRIDE 0
+#define CONFIG_DIGITIZER_ABSENT 0
+#define CONFIG_PCIEXP_HOTPLUG_PREFETCH_MEM 0
+#define CONFIG_BOARD_LIPPERT_FRONTRUNNER_AF 0
+#define CONFIG_INTEL_HAS_TOP_SWAP 0
+#define CONFIG_CBFS_PREFIX "fallback"
+#define CONFIG_DIMM_SPD_SIZE 256
+#define CONFIG_COVERAGE 0
+#define CONFIG_SPI_FLASH_GIGADEVICE 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_32768 0
+#define CONFIG_PADMELON_MERLIN_FALCON 0
+#define CONFIG_USBDEBUG_DONGLE_FTDI_FT232H_BAUD 0
+#define CONFIG_BOARD_GOOGLE_SMAUG 0
+#define CONFIG_ROMSTAGE_SIZE 0
+#define CONFIG_SUPERIO_FINTEK_F81803A 0
+#define CONFIG_XEON_SP_COMMON_BASE 0
+#define CONFIG_MAINBOARD_SMBIOS_MANUFACTURER "Emulation"
+#define CONFIG_PLATFORM_USES_FSP2_0 0
+#define CONFIG_SD_MMC_DEBUG 0
+#define CONFIG_OVERRIDE_CLOCK_DISABLE 0
+#define CONFIG_BOARD_LENOVO_L520 0
+#define CONFIG_MAINBOARD_HAS_NATIVE_VGA_INIT 1
+#define CONFIG_BOARD_SUPERMICRO_X11SSH_TF 0
+#define CONFIG_SOUTHBRIDGE_SPECIFIC_OPTIONS 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_6144 0
+#define CONFIG_DRIVERS_ASPEED_AST2050 0
+#define CONFIG_CUSTOM_SPD_TWTR 0
+#define CONFIG_BOARD_VARIANT_AP148 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_DALBOZ 0
+#define CONFIG_BOARD_GOOGLE_NEFARIO 0
+#define CONFIG_S3_DATA_POS 0
+#define CONFIG_BOARD_SDRAM_TABLE_OFFSET 0
+#define CONFIG_GENERIC_GPIO_LIB 0
+#define CONFIG_BOARD_GOOGLE_KRACKO 0
+#define CONFIG_SPI_FLASH_STMICRO 0
+#define CONFIG_CPU_INTEL_SOCKET_P 0
+#define CONFIG_SOC_INTEL_DISABLE_IGD 0
+#define CONFIG_RESET_VECTOR_IN_RAM 0
+#define CONFIG_MAINBOARD_USES_IFD_GBE_REGION 0
+#define CONFIG_TPM_TIS_ACPI_INTERRUPT 0
+#define CONFIG_BOARD_GOOGLE_FOOB 0
+#define CONFIG_COOP_MULTITASKING 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_107 0
+#define CONFIG_PAYLOAD_SEABIOS 1
+#define CONFIG_BOARD_GOOGLE_JUNIPER 0
+#define CONFIG_RAMPAYLOAD 0
+#define CONFIG_BILBY_IOMUX_USE_LPC 0
+#define CONFIG_ON_DEVICE_ROM_LOAD 0
+#define CONFIG_CUSTOM_SPD_DIVISOR 0
+#define CONFIG_EC_LENOVO_H8 0
+#define CONFIG_USER_TPM1 0
+#define CONFIG_USES_MICROCODE_HEADER_FILES 0
+#define CONFIG_BOARD_HP_2560P 0
+#define CONFIG_DRIVER_TIS_DEFAULT 0
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL_0 0
+#define CONFIG_VENDORCODE_ELTAN_VBOOT_USE_SHA512 0
+#define CONFIG_MISSING_BOARD_RESET 0
+#define CONFIG_ELOG_CBMEM 0
+#define CONFIG_TROGDOR_REV0 0
+#define CONFIG_LINUXBOOT_RISCV 0
+#define CONFIG_CONSOLE_SERIAL_TEGRA210_UART_ADDRESS 0
+#define CONFIG_CR50_IMMEDIATELY_COMMIT_FW_SECDATA 0
+#define CONFIG_RAMBASE 0xe00000
+#define CONFIG_BOARD_LENOVO_THINKPAD_T440P 0
+#define CONFIG_BOARD_GOOGLE_VEYRON_MINNIE 0
+#define CONFIG_SB_SUPERIO_HWM 0
+#define CONFIG_SOUTHBRIDGE_INTEL_C216 0
+#define CONFIG_PRERAM_CBMEM_CONSOLE_SIZE 0xc00
+#define CONFIG_TEGRA124_MODEL_TD570D 0
+#define CONFIG_GENERATE_SMBIOS_TABLES 1
+#define CONFIG_BOARD_GOOGLE_GALE 0
+#define CONFIG_FSP_TYPE_2_0_PEI 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_ACPI_MADT 0
+#define CONFIG_DRIVERS_GENERIC_GPIO_KEYS 0
+#define CONFIG_INCLUDE_NHLT_BLOBS_NOCTURNE 0
+#define CONFIG_AMDFW_OUTSIDE_CBFS 0
+#define CONFIG_MANDOLIN_LPC 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_SMU 0
+#define CONFIG_CPU_QEMU_X86_NO_SMM 0
+#define CONFIG_BILBY_SMSC_SIO1036_BASE_164E 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GPIO_PADCFG_PADTOL 0
+#define CONFIG_GBB_FLAG_DISABLE_FWMP 0
+#define CONFIG_CPU_AMD_AGESA_OPENSOURCE_MEM_XMP_2 0
+#define CONFIG_SIPI_VECTOR_IN_ROM 0
+#define CONFIG_BILBY_LPC 0
+#define CONFIG_VENDOR_OCP 0
+#define CONFIG_VALIDATE_INTEL_DESCRIPTOR 0
+#define CONFIG_EC_KONTRON_KEMPLD 0
+#define CONFIG_OPENSBI_TEXT_START 0
+#define CONFIG_UART_C_RS485 0
+#define CONFIG_SOC_QC_IPQ806X 0
+#define CONFIG_EM100PRO_SPI_CONSOLE 0
+#define CONFIG_DEBUG_SPI_FLASH 0
+#define CONFIG_TIANOCORE_USE_8254_TIMER 0
+#define CONFIG_SB800_SATA_MODE 0
+#define CONFIG_AGESA_BINARY_PI_LOCATION 0
+#define CONFIG_VENDOR_TI 0
+#define CONFIG_BOARD_PURISM_LIBREM15_V2 0
+#define CONFIG_SOC_INTEL_CANNONLAKE_PCH_H 0
+#define CONFIG_WIFI_SAR_CBFS 0
+#define CONFIG_X86_AMD_FIXED_MTRRS 0
+#define CONFIG_NHLT_DMIC_2CH_16B 0
+#define CONFIG_PCI 1
+#define CONFIG_BOARD_GOOGLE_ALEENA 0
+#define CONFIG_VARIANT_SPECIFIC_OPTIONS_ATLAS 0
+#define CONFIG_CPU_MICROCODE_CBFS_EXTERNAL_BINS 0
+#define CONFIG_BOARD_LENOVO_T500 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_USE_ESPI 0
+#define CONFIG_CPU_AMD_AGESA_FAMILY16_KB 0
+#define CONFIG_BOARD_GOOGLE_STORM 0
+#define CONFIG_CPU_MICROCODE_CBFS_DEFAULT_BINS 0
+#define CONFIG_HAVE_EM100PRO_SPI_CONSOLE_SUPPORT 0
+#define CONFIG_PAYLOAD_LINUXBOOT 0
+#define CONFIG_BOARD_ROMSIZE_KB_32768 0
+#define CONFIG_GFXUMA 0
+#define CONFIG_FSP_T_RESERVED_SIZE 0
+#define CONFIG_ARCH_RISCV 0
+#define CONFIG_BOARD_GOOGLE_SCARLET 0
+#define CONFIG_FW_CONFIG_SOURCE_CHROMEEC_CBI 0
+#define CONFIG_NYAN_BCT_CFG_EMMC 0
+#define CONFIG_BOARD_ASUS_P5QL_EM 0
+#define CONFIG_ARCH_ROMSTAGE_ARMV7_R 0
+#define CONFIG_VENDOR_SIEMENS 0
+#define CONFIG_VENDOR_JETWAY 0
+#define CONFIG_BOARD_GOOGLE_SENTRY 0
+#define CONFIG_CPU_INTEL_COMMON_SMM 0
+#define CONFIG_BOARD_GOOGLE_OAK_COMMON 0
+#define CONFIG_VENDOR_FOXCONN 0
+#define CONFIG_UDELAY_TSC 1
+#define CONFIG_SOC_INTEL_COMMON_SKYLAKE_BASE 0
+#define CONFIG_BOARD_LENOVO_W530 0
+#define CONFIG_W83977TF_HAVE_SEPARATE_IR_DEVICE 0
+#define CONFIG_GLK_INTEL_EC 0
+#define CONFIG_MMCONF_BASE_ADDRESS 0
+#define CONFIG_VBOOT_SHA256_CPU_ACCEL 0
+#define CONFIG_BOARD_PCENGINES_APU4 0
+#define CONFIG_BOARD_INTEL_DCP847SKE 0
+#define CONFIG_MAINBOARD_HAS_I2C_TPM_GENERIC 0
+#define CONFIG_PCIEXP_CLK_PM 0
+#define CONFIG_GFX_GMA_PANEL_1_ON_LVDS 0
+#define CONFIG_EC_BASE_ACPI_DATA 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SMM_IO_TRAP 0
+#define CONFIG_BOARD_GOOGLE_DOOLY 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_SMBUS 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SGX_LOCK_MEMORY 0
+#define CONFIG_CUSTOM_SPD_TAA 0
+#define CONFIG_BOARD_GOOGLE_POPPY 0
+#define CONFIG_CAVIUM_BDK_VERBOSE_DRAM 0
+#define CONFIG_BOARD_GOOGLE_KOHAKU 0
+#define CONFIG_NUM_IPI_STARTS 2
+#define CONFIG_HAS_RECOVERY_MRC_CACHE 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_VOLTEER 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_MEC 0
+#define CONFIG_VARIANT_SPECIFIC_OPTIONS_RAMMUS 0
+#define CONFIG_BOARD_GOOGLE_CORAL 0
+#define CONFIG_BOARD_RAZER_BLADE_STEALTH_KBL_16GB 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_ACPI_MEMMAP 0
+#define CONFIG_BOARD_ASUS_F2A85_M_DDR3_VOLT_150 0
+#define CONFIG_ARCH_BOOTBLOCK_ARMV7_R 0
+#define CONFIG_STM_CONSOLE_RELEASE 0
+#define CONFIG_UART_OVERRIDE_BAUDRATE 0
+#define CONFIG_ARCH_ROMSTAGE_RISCV 0
+#define CONFIG_SPI_FLASH 0
+#define CONFIG_ARCH_RISCV_M_DISABLED 0
+#define CONFIG_INTEL_GMA_BCLV_OFFSET 0xc8254
+#define CONFIG_BOARD_GOOGLE_BLOOG 0
+#define CONFIG_PLATFORM_USES_FSP2_X86_32 0
+#define CONFIG_HASWELL_VBOOT_IN_BOOTBLOCK 0
+#define CONFIG_SUPERIO_SMSC_SCH5545 0
+#define CONFIG_ENABLE_BUILTIN_HSUART0 0
+#define CONFIG_SLOT_SPECIFIC_OPTIONS 0
+#define CONFIG_BOARD_LENOVO_T420 0
+#define CONFIG_CPU_INTEL_HASWELL 0
+#define CONFIG_BOARD_GOOGLE_SAMUS 0
+#define CONFIG_GBB_FLAG_DISABLE_EC_SOFTWARE_SYNC 0
+#define CONFIG_AGESA_SPLIT_MEMORY_FILES 0
+#define CONFIG_VENDORCODE_ELTAN_VBOOT 0
+#define CONFIG_SOC_AMD_PSP_SELECTABLE_SMU_FW 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_FIRMWARE_EXTERNAL 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_116 0
+#define CONFIG_PAVP 0
+#define CONFIG_PAYLOAD_SPECIFIC_OPTIONS 0
+#define CONFIG_SOUTHBRIDGE_TI_PCIXX12 0
+#define CONFIG_PAYLOAD_YABITS 0
+#define CONFIG_CONSOLE_SPI_FLASH_BUFFER_SIZE 0
+#define CONFIG_GBB_FLAG_ENTER_TRIGGERS_TONORM 0
+#define CONFIG_ENABLE_POWER_BUTTON 0
+#define CONFIG_CPU_INTEL_MODEL_F2X 0
+#define CONFIG_BOARD_LENOVO_R400 0
+#define CONFIG_INCLUDE_NHLT_BLOBS_NAMI 0
+#define CONFIG_DRIVERS_MC146818 1
+#define CONFIG_ACPI_SOC_NVS 0
+#define CONFIG_DEPTHCHARGE_STABLE 0
+#define CONFIG_TPM_RDRESP_NEED_DELAY 0
+#define CONFIG_BOARD_ACER_G43T_AM3 0
+#define CONFIG_BOOTMEDIA_SPI_LOCK_REBOOT 0
+#define CONFIG_NORTHBRIDGE_AMD_AGESA 0
+#define CONFIG_COMMONLIB_STORAGE 0
+#define CONFIG_BOARD_PURISM_LIBREM13_V2 0
+#define CONFIG_ACPI_HAS_DEVICE_NVS 0
+#define CONFIG_PCI_ALLOW_BUS_MASTER_ANY_DEVICE 1
+#define CONFIG_IPMI_KCS_ROMSTAGE 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_UCODE_SIZE 0
+#define CONFIG_HWBASE_DEBUG_CB 1
+#define CONFIG_VBOOT_NO_BOARD_SUPPORT 0
+#define CONFIG_CPU_MICROCODE_CBFS_NONE 0
+#define CONFIG_USE_CANNONLAKE_CAR_NEM_ENHANCED 0
+#define CONFIG_SUPERIO_ITE_IT8721F 0
+#define CONFIG_BOARD_INTEL_KBLRVP7 0
+#define CONFIG_BOARD_GIGABYTE_GA_B75_D3V 0
+#define CONFIG_HAVE_VBE_LINEAR_FRAMEBUFFER 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SGX_PRMRR_SIZE 0
+#define CONFIG_UART_FOR_CONSOLE 0
+#define CONFIG_ASAN_IN_RAMSTAGE 0
+#define CONFIG_CPU_INTEL_MODEL_1067X 0
+#define CONFIG_EC_SYSTEM76_EC_OLED 0
+#define CONFIG_YABEL_PCI_FAKE_WRITING_OTHER_DEVICES_CONFIG 0
+#define CONFIG_X86EMU_DEBUG_IO 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_SPI_CHIP 0
+#define CONFIG_DRAM_RESET_GATE_GPIO 0
+#define CONFIG_VBE_LINEAR_FRAMEBUFFER 0
+#define CONFIG_USE_WATCHDOG_ON_BOOT 0
+#define CONFIG_USE_GENERIC_FSP_CAR_INC 0
+#define CONFIG_BOARD_ODE_E20XX 0
+#define CONFIG_DEBUG_CBFS 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_FIRMWARE_BUILTIN 0
+#define CONFIG_BOARD_AMD_OLIVEHILL 0
+#define CONFIG_BOARD_GOOGLE_HELI 0
+#define CONFIG_DEVICETREE "devicetree.cb"
+#define CONFIG_USBDEBUG_IN_PRE_RAM 0
+#define CONFIG_MSEG_SIZE 0
+#define CONFIG_X86EMU_DEBUG_MEM 0
+#define CONFIG_STONEYRIDGE_XHCI_ENABLE 0
+#define CONFIG_VBOOT_LIB 0
+#define CONFIG_USE_BLOBS 1
+#define CONFIG_BOARD_GOOGLE_VEYRON_SPEEDY 0
+#define CONFIG_NO_STAGE_CACHE 1
+#define CONFIG_INTEL_GMA_ADD_VBT 0
+#define CONFIG_CONSOLE_QEMU_DEBUGCON 1
+#define CONFIG_UART_USE_REFCLK_AS_INPUT_CLOCK 0
+#define CONFIG_BOARD_GOOGLE_CYAN 0
+#define CONFIG_VGA_BIOS_DGPU 0
+#define CONFIG_ARCH_RAMSTAGE_ARMV7 0
+#define CONFIG_DRIVERS_I2C_PCA9538 0
+#define CONFIG_PS2M_EISAID "PNP0F13"
+#define CONFIG_ACPI_NO_PCAT_8259 0
+#define CONFIG_INCLUDE_SMSC_SCH5545_EC_FW 0
+#define CONFIG_BOARD_PROTECTLI_FW6 0
+#define CONFIG_HAVE_ASAN_IN_RAMSTAGE 1
+#define CONFIG_ADD_RMU_FILE 0
+#define CONFIG_ARCH_RAMSTAGE_PPC64 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_PI 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_PCR 0
+#define CONFIG_BOARD_GOOGLE_NINJA 0
+#define CONFIG_BOARD_GOOGLE_HELIOS_DISKSWAP 0
+#define CONFIG_FIXED_SMBUS_IO_BASE 0x400
+#define CONFIG_LP_DEFCONFIG_OVERRIDE 0
+#define CONFIG_BOARD_INTEL_GLKRVP 0
+#define CONFIG_HAVE_FSP_BIN 0
+#define CONFIG_PS2K_EISAID "PNP0303"
+#define CONFIG_NHLT_DMIC_4CH 0
+#define CONFIG_BOARD_GOOGLE_ELM 0
+#define CONFIG_ARCH_VERSTAGE_ARMV7 0
+#define CONFIG_SANDYBRIDGE_VBOOT_IN_ROMSTAGE 0
+#define CONFIG_BOARD_BIOSTAR_AM1ML 0
+#define CONFIG_CONSOLE_POST 0
+#define CONFIG_DRIVER_TPM_DISPLAY_TIS_BYTES 0
+#define CONFIG_SEABIOS_HARDWARE_IRQ 1
+#define CONFIG_NEED_IFWI 0
+#define CONFIG_BUILD_IPXE 0
+#define CONFIG_TIMESTAMPS_PER_CPU_ENTRIES 0
+#define CONFIG_FUNCTION_TRACE_ENTRIES 0
+#define CONFIG_ARCH_RISCV_U 0
+#define CONFIG_VENDOR_SUPERMICRO 0
+#define CONFIG_DRIVERS_SOUNDWIRE_MAX98373 0
+#define CONFIG_BOARD_GOOGLE_FLEEX 0
+#define CONFIG_BOARD_GOOGLE_VOEMA 0
+#define CONFIG_BOARD_SYSTEM76_LEMP9 0
+#define CONFIG_MAX_CPUS 4
+#define CONFIG_BOOT_DEVICE_SPI_FLASH_BUS 0
+#define CONFIG_ARCH_RAMSTAGE_ARM 0
+#define CONFIG_CONSOLE_SERIAL_9600 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_PSP_GEN2 0
+#define CONFIG_COMMONLIB_STORAGE_SD 0
+#define CONFIG_USBDEBUG_DEFAULT_PORT 0
+#define CONFIG_CAVIUM_BDK_VERBOSE_DRAM_TEST 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_100 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_I2C 0
+#define CONFIG_CPU_INTEL_MODEL_6BX 0
+#define CONFIG_ARCH_ALL_STAGES_X86_32 1
+#define CONFIG_COMPRESSED_PAYLOAD_NONE 0
+#define CONFIG_BOARD_GOOGLE_BUBS 0
+#define CONFIG_SOC_INTEL_COMMON 0
+#define CONFIG_USER_TPM2 0
+#define CONFIG_PAYLOAD_FIT 0
+#define CONFIG_BOARD_GOOGLE_VILBOZ 0
+#define CONFIG_HUDSON_GEC_FWM 0
+#define CONFIG_ATHEROS_ATL1E_SETMAC 0
+#define CONFIG_COS_MAPPED_TO_MSB 0
+#define CONFIG_BOARD_GOOGLE_GLIMMER 0
+#define CONFIG_PCI_OPTION_ROM_RUN_YABEL 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_PCIE_RTD3 0
+#define CONFIG_BOARD_INTEL_JASPERLAKE_RVP 0
+#define CONFIG_SUPERIO_SMSC_SIO10N268 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_118 0
+#define CONFIG_RCBA_LENGTH 0x4000
+#define CONFIG_SMAUG_BCT_CFG_EMMC 0
+#define CONFIG_BOARD_GOOGLE_CELES 0
+#define CONFIG_DEBUG_PIRQ 0
+#define CONFIG_BOARD_SIEMENS_CHILI_BASE_OPTIONS 0
+#define CONFIG_STONEYRIDGE_XHCI_FWM 0
+#define CONFIG_COMMON_CBFS_SPI_WRAPPER 0
+#define CONFIG_GBB_FLAG_RUNNING_FAFT 0
+#define CONFIG_HPET_ADDRESS 0xfed00000
+#define CONFIG_BOARD_GOOGLE_NOCTURNE 0
+#define CONFIG_EXT_BIOS_WIN_BASE 0
+#define CONFIG_NHLT_SSM4567 0
+#define CONFIG_CPU_INTEL_NUM_FIT_ENTRIES 0
+#define CONFIG_ARCH_VERSTAGE_ARMV7_R 0
+#define CONFIG_MAINBOARD_SUPPORTS_KABYLAKE_CPU 0
+#define CONFIG_ADL_CHROME_EC 0
+#define CONFIG_BOOTMEDIA_LOCK_CHIP 0
+#define CONFIG_BOARD_GOOGLE_ULTIMA 0
+#define CONFIG_TPM_INIT 0
+#define CONFIG_PAYLOAD_FILO 0
+#define CONFIG_CONSOLE_SERIAL_57600 0
+#define CONFIG_BOARD_LENOVO_X230T 0
+#define CONFIG_CPU_AMD_AGESA_OPENSOURCE_MEM_XMP_1 0
+#define CONFIG_GEO_SAR_ENABLE 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_USB4_XHCI 0
+#define CONFIG_BOARD_GIGABYTE_GA_B75M_D3V 0
+#define CONFIG_LINUXBOOT_UROOT_V1_0_0 0
+#define CONFIG_VBOOT_MOCK_SECDATA 0
+#define CONFIG_BOARD_SUPERMICRO_X11SSH_F 0
+#define CONFIG_PMC_INVALID_READ_AFTER_WRITE 0
+#define CONFIG_VENDOR_DELL 0
+#define CONFIG_PC80_SYSTEM 1
+#define CONFIG_EC_GOOGLE_CHROMEEC_RTC 0
+#define CONFIG_BOARD_LENOVO_T530 0
+#define CONFIG_FW_CONFIG 0
+#define CONFIG_MAINBOARD_SUPPORTS_KABYLAKE_QUAD 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_PSP 0
+#define CONFIG_DRIVERS_EMULATION_QEMU_BOCHS 1
+#define CONFIG_SUPERIO_RENESAS_M3885X 0
+#define CONFIG_MP_MEMTEST 0
+#define CONFIG_IS_GLK_RVP_1 0
+#define CONFIG_BOARD_GOOGLE_RELM 0
+#define CONFIG_ENABLE_DEBUG_LED_ESRAM 0
+#define CONFIG_HAVE_CONFIGURABLE_RAMSTAGE 0
+#define CONFIG_BOARD_GOOGLE_BUDDY 0
+#define CONFIG_DRIVERS_AS3722_RTC 0
+#define CONFIG_MAX_PCH_ROOT_PORTS 0
+#define CONFIG_SMMSTORE 0
+#define CONFIG_HAVE_VGA_TEXT_FRAMEBUFFER 1
+#define CONFIG_SOC_AMD_COMMON_BLOCK_ACPIMMIO 0
+#define CONFIG_INTEL_GMA_ACPI 0
+#define CONFIG_ENABLE_SD_TESTING 0
+#define CONFIG_SD_MMC_TRACE 0
+#define CONFIG_INTEL_CAR_NEM_ENHANCED 0
+#define CONFIG_INCLUDE_NHLT_BLOBS_NAUTILUS 0
+#define CONFIG_BOARD_GOOGLE_SPHERION 0
+#define CONFIG_GFX_GMA_ANALOG_I2C_HDMI_B 0
+#define CONFIG_FILO_STABLE 0
+#define CONFIG_BOARD_KONTRON_BOXER26_OPTIONS 0
+#define CONFIG_HWBASE_DYNAMIC_MMIO 0
+#define CONFIG_BOARD_RODA_RW11 0
+#define CONFIG_NORTHBRIDGE_INTEL_I440BX 0
+#define CONFIG_VBOOT_ALWAYS_ALLOW_UDC 0
+#define CONFIG_SOC_INTEL_COMETLAKE_V 0
+#define CONFIG_VBOOT_LID_SWITCH 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SMM_S5_DELAY_MS 0
+#define CONFIG_CPU_INTEL_MODEL_6XX 0
+#define CONFIG_GFX_GMA_PANEL_1_ON_EDP 0
+#define CONFIG_RISCV_HAS_OPENSBI 0
+#define CONFIG_NHLT_RT5514 0
+#define CONFIG_BOARD_GOOGLE_VOLTEER2 0
+#define CONFIG_BOARD_HP_ABM 0
+#define CONFIG_IPXE_MASTER 0
+#define CONFIG_HAVE_MTC 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_LPC_MIRROR_TO_DMI 0
+#define CONFIG_X86EMU_DEBUG_INT10 0
+#define CONFIG_PAYLOAD_NONE 0
+#define CONFIG_BOARD_LENOVO_T420S 0
+#define CONFIG_BOARD_GOOGLE_PYRO 0
+#define CONFIG_BOARD_LENOVO_X201 0
+#define CONFIG_SOC_MEDIATEK_MT8183 0
+#define CONFIG_ELOG_GSMI 0
+#define CONFIG_PROVIDES_ROM_SHARING 0
+#define CONFIG_BOARD_GOOGLE_DOOD 0
+#define CONFIG_FSP_M_SIZE 0
+#define CONFIG_BOARD_INTEL_ICELAKE_RVPY 0
+#define CONFIG_MAINBOARD_HAS_SPI_TPM 0
+#define CONFIG_TSEG_STAGE_CACHE 0
+#define CONFIG_DRIVERS_TI_TPS65913_RTC_BUS 0
+#define CONFIG_CPU_AMD_AGESA 0
+#define CONFIG_BOARD_SUPERMICRO_BASEBOARD_X11_LGA1151_SERIES 0
+#define CONFIG_DRIVER_INTEL_I210 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_USB4_PCIE 0
+#define CONFIG_USE_ME_CLEANER 0
+#define CONFIG_CONSOLE_SERIAL_460800 0
+#define CONFIG_DIMMS_PER_CHANNEL 0
+#define CONFIG_ARCH_BOOTBLOCK_ARM64 0
+#define CONFIG_ENABLE_DEBUG_LED_BOOTBLOCK_ENTRY 0
+#define CONFIG_CPU_INTEL_MODEL_65X 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_IPU 0
+#define CONFIG_RAMSTAGE_LIBHWBASE 0
+#define CONFIG_PSP_UNLOCK_SECURE_DEBUG 0
+#define CONFIG_BOARD_VARIANT_DK01 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SMM_ESPI_DISABLE 0
+#define CONFIG_SOUTHBRIDGE_RICOH_RL5C476 0
+#define CONFIG_HAVE_RAMSTAGE 1
+#define CONFIG_COREBOOT_ROMSIZE_KB_65536 0
+#define CONFIG_SOC_INTEL_COOPERLAKE_SP 0
+#define CONFIG_SOC_INTEL_SKYLAKE_SP 0
+#define CONFIG_BOARD_ROMSIZE_KB_4096 0
+#define CONFIG_NORTHBRIDGE_AMD_AGESA_FAMILY15_TN 0
+#define CONFIG_COMPRESSED_PAYLOAD_ZSTD 0
+#define CONFIG_LINUXBOOT_UROOT_SOURCE 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_CAR 0
+#define CONFIG_VENDOR_CLEVO 0
+#define CONFIG_HAVE_REGULATORY_DOMAIN 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_115 0
+#define CONFIG_BOARD_GOOGLE_HELIOS 0
+#define CONFIG_PI_AGESA_HEAP_SIZE 0
+#define CONFIG_BOARD_GOOGLE_DELTAUR 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_INCLUDE_SSFC_IN_FW_CONFIG 0
+#define CONFIG_BOARD_GOOGLE_SHUBOZ 0
+#define CONFIG_MAINBOARD_PART_NUMBER "QEMU x86 i440fx/piix4"
+#define CONFIG_OCP_DMI 0
+#define CONFIG_STORAGE_TEST 0
+#define CONFIG_BOARD_GOOGLE_TROGDOR 0
+#define CONFIG_BOOT_DEVICE_SPI_FLASH_NO_EARLY_WRITES 0
+#define CONFIG_HAVE_CF9_RESET_PREPARE 0
+#define CONFIG_BOARD_AMD_MANDOLIN 0
+#define CONFIG_CBFS_ACCESS_TRACE_SIZE 0
+#define CONFIG_SMP 1
+#define CONFIG_NC_FPGA_NOTIFY_CB_READY 0
+#define CONFIG_FSP_M_RC_HEAP_SIZE 0
+#define CONFIG_DRIVERS_UART_8250IO_SKIP_INIT 0
+#define CONFIG_BOARD_UP_SQUARED 0
+#define CONFIG_BOARD_GOOGLE_ASURADA 0
+#define CONFIG_INTEL_LYNXPOINT_LP 0
+#define CONFIG_EC_LENOVO_PMH7 0
+#define CONFIG_INTEL_TXT_LOGGING 0
+#define CONFIG_VENDOR_SIFIVE 0
+#define CONFIG_CBFS_AUTOGEN_ATTRIBUTES 0
+#define CONFIG_SUPERIO_NUVOTON_NCT5104D 0
+#define CONFIG_SOC_INTEL_CANNONLAKE_DEBUG_CONSENT 0
+#define CONFIG_CONSOLE_UART_BASE_ADDRESS 0
+#define CONFIG_AMD_LPC_DEBUG_CARD 0
+#define CONFIG_HECI_DISABLE_USING_SMM 0
+#define CONFIG_DRIVER_TPM_SPI_CHIP 0
+#define CONFIG_SUPERIO_SMSC_FDC37N972 0
+#define CONFIG_ELOG_BOOT_COUNT_CMOS_OFFSET 0
+#define CONFIG_SUPERIO_SMSC_LPC47N217 0
+#define CONFIG_HAVE_USBDEBUG_OPTIONS 0
+#define CONFIG_BOARD_PURISM_BASEBOARD_LIBREM_BDW 0
+#define CONFIG_BOARD_GOOGLE_WIZPIG 0
+#define CONFIG_CONSOLE_SERIAL_TEGRA210_UARTB 0
+#define CONFIG_BOARD_ASUS_P2B_D 0
+#define CONFIG_RT8168_SUPPORT_LEGACY_VPD_MAC 0
+#define CONFIG_CPU_AMD_AGESA_FAMILY14 0
+#define CONFIG_NO_XIP_EARLY_STAGES 0
+#define CONFIG_SOUTHBRIDGE_AMD_AGESA_HUDSON 0
+#define CONFIG_CPU_ARMLTD_CORTEX_A9 0
+#define CONFIG_BOARD_GOOGLE_LIARA 0
+#define CONFIG_DPTF_USE_EISA_HID 0
+#define CONFIG_GDB_WAIT 0
+#define CONFIG_PCI_OPTION_ROM_RUN_REALMODE 0
+#define CONFIG_FSP_BUILD_TYPE_DEBUG 0
+#define CONFIG_VARIANT_MAX_BOARD_ID_BROKEN_FMPCU_POWER 0
+#define CONFIG_PRE_GRAPHICS_DELAY_MS 0
+#define CONFIG_HIDE_MEI_ON_ERROR 0
+#define CONFIG_BOARD_GOOGLE_NAUTILUS 0
+#define CONFIG_BOARD_GOOGLE_HATCH_COMMON 0
+#define CONFIG_BOARD_GOOGLE_SAND 0
+#define CONFIG_BOARD_GOOGLE_POMPOM 0
+#define CONFIG_NORTHBRIDGE_INTEL_I945 0
+#define CONFIG_BOARD_LENOVO_S230U 0
+#define CONFIG_CHECK_ME 0
+#define CONFIG_MAINBOARD_DO_SOR_INIT 0
+#define CONFIG_BOARD_LENOVO_X1_CARBON_GEN1 0
+#define CONFIG_ACPI_NHLT 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_UCODE 0
+#define CONFIG_BOARD_PURISM_BASEBOARD_LIBREM_CNL 0
+#define CONFIG_SYSTEM_TYPE_CONVERTIBLE 0
+#define CONFIG_SOC_INTEL_BROADWELL 0
+#define CONFIG_FSP_T_XIP 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_FINALIZE 0
+#define CONFIG_SOC_INTEL_COMMON_LPSS_UART_CLK_N_VAL 0
+#define CONFIG_DSAR_ENABLE 0
+#define CONFIG_MAX_PCIE_CLOCK_REQ 0
+#define CONFIG_CONSOLE_OVERRIDE_LOGLEVEL 0
+#define CONFIG_ARCH_VERSTAGE_ARMV4 0
+#define CONFIG_VEYRON_FORCE_BINARY_RAM_CODE 0
+#define CONFIG_FSP_COMPRESS_FSP_M_LZMA 0
+#define CONFIG_PCIEXP_AER 0
+#define CONFIG_USER_NO_TPM 1
+#define CONFIG_USBDEBUG_DONGLE_FTDI_FT232H 0
+#define CONFIG_PARALLEL_MP_AP_WORK 0
+#define CONFIG_BOARD_LENOVO_G505S 0
+#define CONFIG_LOCALVERSION ""
+#define CONFIG_ARCH_BOOTBLOCK_X86_64 0
+#define CONFIG_CONSOLE_CBMEM_DEFERRED_FORMAT 0
+#define CONFIG_CHROMEOS_CSE_BOARD_RESET_OVERRIDE 0
+#define CONFIG_SDHCI_BOUNCE_BUFFER 0
+#define CONFIG_SUPERIO_FINTEK_F71859 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_SPI_ICH7 0
+#define CONFIG_VARIANT_SUPPORTS_PRE_V3_SCHEMATICS 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GPIO_MULTI_ACPI_DEVICES 0
+#define CONFIG_HAVE_CF9_RESET 1
+#define CONFIG_SAMPLING_PROFILER_CALL_STACKS 0
+#define CONFIG_CBFS_HASH_SHA1 0
+#define CONFIG_TPM1 0
+#define CONFIG_H8_FLASH_LEDS_ON_DEATH 0
+#define CONFIG_POWER_BUTTON_DEFAULT_DISABLE 0
+#define CONFIG_INTEL_TXT_TEST_BIOS_ACM_CALLING_CODE 0
+#define CONFIG_BOARD_GOOGLE_DALBOZ 0
+#define CONFIG_DIGITIZER_PRESENT 0
+#define CONFIG_GBB_FLAG_DISABLE_LID_SHUTDOWN 0
+#define CONFIG_GBB_FLAG_FORCE_DEV_BOOT_ALTFW 0
+#define CONFIG_PCI_IO_CFG_EXT 0
+#define CONFIG_CUSTOM_SPD_UPPER_TFAW 0
+#define CONFIG_BOARD_OVERRIDE_LCM_ID 0
+#define CONFIG_USE_SIEMENS_HWILIB 0
+#define CONFIG_GBB_FLAG_ENABLE_ALTERNATE_OS 0
+#define CONFIG_BOARD_GOOGLE_MORPHIUS 0
+#define CONFIG_BOARD_MSI_H81M_P33 0
+#define CONFIG_BOARD_GOOGLE_GANDOF 0
+#define CONFIG_BOARD_LENOVO_X1 0
+#define CONFIG_VBOOT_RETURN_FROM_VERSTAGE 0
+#define CONFIG_SOFTWARE_I2C 0
+#define CONFIG_ARCH_BOOTBLOCK_ARM 0
+#define CONFIG_BOARD_SIEMENS_MC_APL6 0
+#define CONFIG_SOC_MEDIATEK_MT8192 0
+#define CONFIG_VBOOT_STARTS_IN_ROMSTAGE 0
+#define CONFIG_NHLT_RT5682 0
+#define CONFIG_SMM_MODULE_STACK_SIZE 0
+#define CONFIG_USE_NATIVE_RAMINIT 0
+#define CONFIG_BOARD_GOOGLE_BOBBA 0
+#define CONFIG_GENERATE_PIRQ_TABLE 1
+#define CONFIG_PAYLOAD_LINUX 0
+#define CONFIG_USE_MARCH_586 0
+#define CONFIG_IDT_IN_EVERY_STAGE 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_RTC 1
+#define CONFIG_BOARD_GOOGLE_MALEFOR 0
+#define CONFIG_NHLT_DMIC_1CH_16B 0
+#define CONFIG_DEFAULT_POST_ON_LPC 0
+#define CONFIG_AP_IN_SIPI_WAIT 0
+#define CONFIG_CPU_INTEL_SLOT_1 0
+#define CONFIG_DRIVERS_SOUNDWIRE_ALC711 0
+#define CONFIG_BOARD_LENOVO_X230S 0
+#define CONFIG_BOARD_GIGABYTE_GA_H61MA_D3V 0
+#define CONFIG_VENDOR_PINE64 0
+#define CONFIG_BOARD_GOOGLE_EVE 0
+#define CONFIG_DRIVERS_SOUNDWIRE_ALC5682 0
+#define CONFIG_BOARD_GOOGLE_GRUNT 0
+#define CONFIG_ROMSTAGE_DEBUG_SPINLOOP 0
+#define CONFIG_CPU_AMD_AGESA_OPENSOURCE 0
+#define CONFIG_DEPTHCHARGE_MASTER 0
+#define CONFIG_PLATFORM_USES_FSP1_1 0
+#define CONFIG_TROGDOR_HAS_FINGERPRINT 0
+#define CONFIG_EC_ACPI 0
+#define CONFIG_AMD_APU_STONEYRIDGE 0
+#define CONFIG_EARLY_RESERVED_DRAM_BASE 0
+#define CONFIG_BOARD_GOOGLE_AMPTON 0
+#define CONFIG_MT8192_DRAM_EMCP 0
+#define CONFIG_NHLT_DMIC_4CH_16B 0
+#define CONFIG_BOARD_GOOGLE_DRALLION 0
+#define CONFIG_X86_TOP4G_BOOTMEDIA_MAP 1
+#define CONFIG_SB800_AHCI_ROM 0
+#define CONFIG_TPM_ON_FAST_SPI 0
+#define CONFIG_FIXED_EPBAR_MMIO_BASE 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_ACPI_USB_PORT_POWER 0
+#define CONFIG_SOC_AMD_PI 0
+#define CONFIG_BOARD_ROMSIZE_KB_12288 0
+#define CONFIG_ACPI_CPU_STRING "\\_SB.CP%02d"
+#define CONFIG_APU1_PINMUX_GPIO0 0
+#define CONFIG_SUPERIO_FINTEK_FAN_API_CALL 0
+#define CONFIG_STONEYRIDGE_GEC_FWM 0
+#define CONFIG_GFX_GMA_DYN_CPU 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_SKUID 0
+#define CONFIG_BOARD_CLEVO_CMLU_COMMON 0
+#define CONFIG_DEBUG_CAR 0
+#define CONFIG_SOC_INTEL_SKYLAKE 0
+#define CONFIG_DISABLE_HPET 0
+#define CONFIG_VBOOT_SLOTS_RW_A 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_GLADOS 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_TCO 0
+#define CONFIG_BOARD_PURISM_LIBREM_MINI_V2 0
+#define CONFIG_X86EMU_DEBUG_TRACE 0
+#define CONFIG_IPXE_STABLE 0
+#define CONFIG_I2C_DEBUG 0
+#define CONFIG_MAINBOARD_SMBIOS_PRODUCT_NAME "QEMU x86 i440fx/piix4"
+#define CONFIG_EC_GOOGLE_CHROMEEC_I2C 0
+#define CONFIG_DEBUG_SOC_DRIVER 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_PCI_MMCONF 0
+#define CONFIG_EC_51NB_NPCE985LA0DX_FIRMWARE 0
+#define CONFIG_BASEBOARD_REEF_LAPTOP 0
+#define CONFIG_BOARD_LENOVO_T410 0
+#define CONFIG_CBFS_PREFIX_DIY 0
+#define CONFIG_FW_CONFIG_SOURCE_CBFS 0
+#define CONFIG_BOARD_ELMEX_PCM205401 0
+#define CONFIG_HAVE_OPTION_TABLE 1
+#define CONFIG_VARIANT_SUPPORTS_PRE_V3_6_SCHEMATICS 0
+#define CONFIG_FSP_STATUS_GLOBAL_RESET 0
+#define CONFIG_HAVE_MP_TABLE 0
+#define CONFIG_H8_BEEP_ON_DEATH 0
+#define CONFIG_SPI_FLASH_ATMEL 0
+#define CONFIG_PSP_SHAREDMEM_BASE 0
+#define CONFIG_SUPERIO_FINTEK_FAN_CONTROL 0
+#define CONFIG_SUPERIO_NUVOTON_COMMON_PRE_RAM 0
+#define CONFIG_BOARD_GOOGLE_WOLF 0
+#define CONFIG_HAVE_INTEL_FIRMWARE 0
+#define CONFIG_ACPI_INTEL_HARDWARE_SLEEP_VALUES 1
+#define CONFIG_LINUXBOOT_X86_64 0
+#define CONFIG_BOARD_PCENGINES_APU2 0
+#define CONFIG_SUPERIO_ITE_IT8772F 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_LPC 0
+#define CONFIG_SPI_FLASH_HAS_VOLATILE_GROUP 0
+#define CONFIG_BOARD_HP_PAVILION_M6_1035DX 0
+#define CONFIG_SUPERIO_NUVOTON_NPCD378 0
+#define CONFIG_SMM_ASEG 0
+#define CONFIG_BOARD_GOOGLE_CLAPPER 0
+#define CONFIG_HAVE_BOOTBLOCK 1
+#define CONFIG_BOARD_INTEL_HARCUVAR 0
+#define CONFIG_DISPLAY_FSP_VERSION_INFO_2 0
+#define CONFIG_USE_QC_BLOBS 0
+#define CONFIG_BOARD_GOOGLE_GUMBOZ 0
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL_4 0
+#define CONFIG_MAINBOARD_HAS_TPM1 0
+#define CONFIG_CBFS_CHUNKED_PARALLEL_WORKERS 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_CPU_MPINIT 0
+#define CONFIG_TSC_SYNC_MFENCE 0
+#define CONFIG_BOARD_GOOGLE_MCCLOUD 0
+#define CONFIG_FSP_LOC 0
+#define CONFIG_HAVE_ME_BIN 0
+#define CONFIG_BOARD_GOOGLE_REEF 0
+#define CONFIG_BOARD_GOOGLE_DAISY 0
+#define CONFIG_UDK_VERSION 0
+#define CONFIG_SERIALIZED_SMM_INITIALIZATION 0
+#define CONFIG_ARCH_RISCV_RV32 0
+#define CONFIG_SDHC_TRACE 0
+#define CONFIG_SPI_FLASH_ADESTO 0
+#define CONFIG_VENDOR_COMPULAB 0
+#define CONFIG_H8_SUPPORT_BT_ON_WIFI 0
+#define CONFIG_BOARD_ROMSIZE_KB_5120 0
+#define CONFIG_HAVE_POWER_STATE_PREVIOUS_AFTER_FAILURE 0
+#define CONFIG_INTEL_TXT_HEAP_SIZE 0
+#define CONFIG_BOARD_GIGABYTE_GA_B75M_D3H 0
+#define CONFIG_PCH_SPECIFIC_OPTIONS 0
+#define CONFIG_VENDOR_LENOVO 0
+#define CONFIG_ARM_LPAE 0
+#define CONFIG_DRIVER_LENOVO_SERIALS 0
+#define CONFIG_DRIVERS_EMULATION_QEMU_BOCHS_XRES 0
+#define CONFIG_LBP2_FROM_IFWI 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GSPI_MAX 0
+#define CONFIG_CHROMEOS 0
+#define CONFIG_VENDORCODE_ELTAN_VBOOT_KEY_SIZE 0
+#define CONFIG_EC_HP_KBC1126_ECFW_IN_CBFS 0
+#define CONFIG_UDELAY_LAPIC_FIXED_FSB 0
+#define CONFIG_NEED_LBP2 0
+#define CONFIG_CPU_SAMSUNG_EXYNOS5420 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_DELTAUR 0
+#define CONFIG_DRIVERS_I2C_PTN3460 0
+#define CONFIG_CHECK_REV_IN_OPROM_NAME 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_CRASHLOG 0
+#define CONFIG_BOARD_GIGABYTE_GA_945GCM_S2C 0
+#define CONFIG_CPU_INTEL_MODEL_2065X 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_GPIO 0
+#define CONFIG_SOUTHBRIDGE_AMD_PI_KERN 0
+#define CONFIG_CBMEM_STAGE_CACHE 0
+#define CONFIG_ARM64_A53_ERRATUM_843419 0
+#define CONFIG_DRIVERS_AMD_I2S_MACHINE_DEV 0
+#define CONFIG_DRIVERS_I2C_MAX98927 0
+#define CONFIG_BOARD_GOOGLE_MISTRAL_COMMON 0
+#define CONFIG_USBDEBUG_DONGLE_STD 0
+#define CONFIG_DISPLAY_SPD_DATA 0
+#define CONFIG_INTEL_GMA_SSC_ALTERNATE_REF 0
+#define CONFIG_BOARD_GOOGLE_METAKNIGHT 0
+#define CONFIG_DISABLE_UART_ON_TESTPADS 0
+#define CONFIG_X86EMU_DEBUG_DISK 0
+#define CONFIG_SEC_COMPONENT_SIZE_MB 0
+#define CONFIG_MAINBOARD_VERSION "1.0"
+#define CONFIG_SOUTHBRIDGE_TI_PCI7420 0
+#define CONFIG_GFX_GMA 0
+#define CONFIG_CONSOLE_SERIAL_TEGRA210_UARTA 0
+#define CONFIG_AZALIA_PLUGIN_SUPPORT 0
+#define CONFIG_BOTTOMIO_POSITION 0
+#define CONFIG_CAVIUM_BDK_DDR_TUNE_ECC_ENABLE 0
+#define CONFIG_HAVE_DEBUG_SMBUS 1
+#define CONFIG_CHROMEOS_USE_EC_WATCHDOG_FLAG 0
+#define CONFIG_ELOG_BOOT_COUNT 0
+#define CONFIG_HUDSON_IMC_FWM 0
+#define CONFIG_RELOCATABLE_MODULES 1
+#define CONFIG_MAX_SOCKET 0
+#define CONFIG_SOC_SPECIFIC_OPTIONS 0
+#define CONFIG_BOARD_GOOGLE_LICK 0
+#define CONFIG_BOARD_ROMSIZE_KB_512 0
+#define CONFIG_BOARD_OCP_DELTALAKE 0
+#define CONFIG_BOARD_ASROCK_G41C_GS 0
+#define CONFIG_SSE2 0
+#define CONFIG_REALTEK_8168_RESET 0
+#define CONFIG_BOARD_LENOVO_X230 0
+#define CONFIG_SOC_INTEL_COMMON_RESET 0
+#define CONFIG_SUPERIO_FINTEK_F81866D 0
+#define CONFIG_SUPERIO_WINBOND_W83627DHG 0
+#define CONFIG_DRIVERS_ASMEDIA_ASPM_BLACKLIST 0
+#define CONFIG_APU1_PINMUX_UART_C 0
+#define CONFIG_BOARD_GOOGLE_LINDAR 0
+#define CONFIG_I2C_TPM 0
+#define CONFIG_BOARD_ASROCK_H81M_HDS 0
+#define CONFIG_HSUART_DEV 0
+#define CONFIG_UNCOMPRESSED_RAMSTAGE 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_UART 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_PCIE 0
+#define CONFIG_USE_LEGACY_8254_TIMER 0
+#define CONFIG_HAVE_CMOS_DEFAULT 1
+#define CONFIG_FIXED_UART_FOR_CONSOLE 0
+#define CONFIG_SB800_FWM_AT_FFC20000 0
+#define CONFIG_BOARD_ROMSIZE_KB_16384 0
+#define CONFIG_RESOURCE_ALLOCATOR_V4 1
+#define CONFIG_DRIVERS_IPMI_SUPERMICRO_OEM 0
+#define CONFIG_NORTHBRIDGE_AMD_PI_00630F01 0
+#define CONFIG_DEBUG_SMBUS 0
+#define CONFIG_CUSTOM_SPD_TRCD 0
+#define CONFIG_POWER_STATE_DEFAULT_ON_AFTER_FAILURE 0
+#define CONFIG_MRC_CHANNEL_WIDTH 0
+#define CONFIG_LINUXBOOT_X86 0
+#define CONFIG_DRIVERS_I2C_DESIGNWARE 0
+#define CONFIG_FMDFILE ""
+#define CONFIG_BOARD_HP_8470P 0
+#define CONFIG_BOARD_AMD_CEREME 0
+#define CONFIG_ARCH_ALL_STAGES_X86_64 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_CPU 0
+#define CONFIG_TSC_MONOTONIC_TIMER 1
+#define CONFIG_DRIVERS_EMULATION_QEMU_BOCHS_YRES 0
+#define CONFIG_VENDOR_MSI 0
+#define CONFIG_BOARD_GOOGLE_TRONDO 0
+#define CONFIG_SDHCI_ADMA_IN_BOOTBLOCK 0
+#define CONFIG_SUPERIO_WINBOND_W83627UHG 0
+#define CONFIG_DRIVERS_INTEL_PMC 0
+#define CONFIG_DRIVERS_TI_TPS65913_RTC_ADDR 0
+#define CONFIG_LINUXBOOT_UROOT 0
+#define CONFIG_BOARD_GIGABYTE_GA_H61M_DS2V 0
+#define CONFIG_BOARD_GOOGLE_NASHER 0
+#define CONFIG_SUPERIO_FINTEK_F81865F 0
+#define CONFIG_DRIVERS_UART_SIFIVE 0
+#define CONFIG_HAVE_MONOTONIC_TIMER 1
+#define CONFIG_BOARD_GOOGLE_YORP 0
+#define CONFIG_SUPERIO_FINTEK_F71808A 0
+#define CONFIG_BOARD_GOOGLE_SASUKE 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_112 0
+#define CONFIG_APU1_PINMUX_OFF_C 0
+#define CONFIG_SOC_NVIDIA_TEGRA210 0
+#define CONFIG_BOARD_SIEMENS_MC_APL1 0
+#define CONFIG_USBDEBUG 0
+#define CONFIG_HAVE_ACPI_TABLES 1
+#define CONFIG_NORTHBRIDGE_AMD_PI 0
+#define CONFIG_PCIEXP_HOTPLUG_BUSES 0
+#define CONFIG_POST_DEVICE_PCI_PCIE 0
+#define CONFIG_SOC_INTEL_COMMON_EARLY_MMC_WAKE 0
+#define CONFIG_MRC_SETTINGS_CACHE_SIZE 0
+#define CONFIG_ARCH_BOOTBLOCK_RISCV 0
+#define CONFIG_FSP_USE_REPO 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_CHIP_CONFIG 0
+#define CONFIG_DEBUG_MALLOC 0
+#define CONFIG_FRAMEBUFFER_SET_VESA_MODE 0
+#define CONFIG_BOARD_GOOGLE_NYAN_BLAZE 0
+#define CONFIG_MEMLAYOUT_LD_FILE "src/arch/x86/memlayout.ld"
+#define CONFIG_HUDSON_SATA_MODE 0
+#define CONFIG_ARCH_ARM 0
+#define CONFIG_BOARD_APPLE_MACBOOKAIR4_2 0
+#define CONFIG_CAVIUM_BDK_DDR_TUNE_WRITE_OFFSETS 0
+#define CONFIG_HAVE_REFCODE_BLOB 0
+#define CONFIG_VENDORCODE_ELTAN_VBOOT_SIGNED_MANIFEST 0
+#define CONFIG_DRIVER_I2C_TPM_ACPI 0
+#define CONFIG_ONBOARD_MEM_MICRON 0
+#define CONFIG_SOC_SETS_MSRS 0
+#define CONFIG_BOARD_LENOVO_BASEBOARD_T530 0
+#define CONFIG_SUPERIO_SMSC_MEC1308 0
+#define CONFIG_FSP_STATUS_GLOBAL_RESET_REQUIRED_6 0
+#define CONFIG_INTEL_TOP_SWAP_BOOTBLOCK_SIZE 0
+#define CONFIG_CPU_MICROCODE_CBFS_LOC 0
+#define CONFIG_CBFS_MCACHE_SIZE 0x2000
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_RAMBI 0
+#define CONFIG_SUPERIO_SERVERENGINES_PILOT 0
+#define CONFIG_IPMI_KCS_REGISTER_SPACING 0
+#define CONFIG_DRIVERS_I2C_RT1011 0
+#define CONFIG_BOARD_INTEL_ADLRVP_M 0
+#define CONFIG_PCIEXP_HOTPLUG_MEM 0
+#define CONFIG_BOARD_GETAC_P470 0
+#define CONFIG_CPU_INTEL_MODEL_68X 0
+#define CONFIG_HPET_MIN_TICKS 0
+#define CONFIG_SPI_FLASH_SPANSION 0
+#define CONFIG_NORTHBRIDGE_AMD_AGESA_FAMILY16_KB 0
+#define CONFIG_MICROCODE_BLOB_UNDISCLOSED 0
+#define CONFIG_USE_PM_ACPI_TIMER 0
+#define CONFIG_NORTHBRIDGE_INTEL_IRONLAKE 0
+#define CONFIG_BOARD_GOOGLE_NUWANI 0
+#define CONFIG_BOARD_ASROCK_IMB_A180 0
+#define CONFIG_BOARD_GOOGLE_WINKY 0
+#define CONFIG_SOC_AMD_SMU_FANNED 0
+#define CONFIG_SUPERIO_ITE_ENV_CTRL_7BIT_SLOPE_REG 0
+#define CONFIG_NHLT_MAX98927 0
+#define CONFIG_HAVE_DEBUG_GPIO 0
+#define CONFIG_IDE_COMBINED_MODE 0
+#define CONFIG_GBB_FLAG_FORCE_MANUAL_RECOVERY 0
+#define CONFIG_BOARD_GOOGLE_RIKKU 0
+#define CONFIG_BOARD_GOOGLE_GRU_COMMON 0
+#define CONFIG_PLATFORM_HAS_DRAM_CLEAR 1
+#define CONFIG_BOARD_ROMSIZE_KB_65536 0
+#define CONFIG_PLATFORM_USES_FSP2_1 0
+#define CONFIG_BOARD_ASUS_F2A85_M_PRO 0
+#define CONFIG_EC_QUANTA_ENE_KB3940Q 0
+#define CONFIG_BOARD_KONTRON_KTQM77 0
+#define CONFIG_BOARD_GOOGLE_AURON_YUNA 0
+#define CONFIG_INTEL_GMA_SWSMISCI 0
+#define CONFIG_TTYS0_BASE 0x3f8
+#define CONFIG_IQAT_ENABLE 0
+#define CONFIG_INTEL_CHIPSET_LOCKDOWN 0
+#define CONFIG_DEBUG_SMM_RELOCATION 0
+#define CONFIG_CAVIUM_BDK_VERBOSE_PCIE 0
+#define CONFIG_USE_FSP2_0_DRIVER 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_ESPI 0
+#define CONFIG_BOARD_GOOGLE_PANTHER 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_PMC 0
+#define CONFIG_BOARD_ASROCK_B75PRO3_M 0
+#define CONFIG_DEVICE_TIMING 0
+#define CONFIG_VARIANT_SPECIFIC_OPTIONS_SORAKA 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_104 0
+#define CONFIG_EC_COMPAL_ENE932 0
+#define CONFIG_BOARD_INTEL_WTM2 0
+#define CONFIG_MANDOLIN_IOMUX_USE_LPC 0
+#define CONFIG_FIXED_DMIBAR_MMIO_BASE 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_BANKED_GPIOS 0
+#define CONFIG_BOARD_GOOGLE_TROGDOR_COMMON 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_POWER_LIMIT 0
+#define CONFIG_SUPERIO_ASPEED_HAS_UART_DELAY_WORKAROUND 0
+#define CONFIG_EC_GOOGLE_COMMON_MEC 0
+#define CONFIG_AZ_PIN 0
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL_1 0
+#define CONFIG_MAINBOARD_USES_IFD_EC_REGION 0
+#define CONFIG_ARCH_BOOTBLOCK_ARMV7_M 0
+#define CONFIG_TTYS0_LCS 3
+#define CONFIG_BOARD_CLEVO_L140CU_OPTIONS 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_HDA_VERB 0
+#define CONFIG_SPI_TPM 0
+#define CONFIG_MAX_ACPI_TABLE_SIZE_KB 144
+#define CONFIG_BOARD_PURISM_LIBREM_MINI 0
+#define CONFIG_LINUXBOOT_UROOT_MASTER 0
+#define CONFIG_VARIANT_SUPPORTS_WIFI_POWER_ACTIVE_HIGH 0
+#define CONFIG_BOARD_BOSTENTECH_GBYT4 0
+#define CONFIG_SOC_INTEL_I2C_DEV_MAX 0
+#define CONFIG_BOARD_SIEMENS_CHILI_CHILI 0
+#define CONFIG_FILO_MASTER 0
+#define CONFIG_DRIVERS_LENOVO_WACOM 0
+#define CONFIG_AMD_APU_PKG_FP4 0
+#define CONFIG_BOARD_SUPERMICRO_X11SSM_F 0
+#define CONFIG_SC7180_QSPI 0
+#define CONFIG_BOARD_GOOGLE_VEYRON_JAQ 0
+#define CONFIG_BOARD_GOOGLE_NYAN_BIG 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_SMM 0
+#define CONFIG_TRUSTZONE_CARVEOUT_SIZE_MB 0
+#define CONFIG_ASAN 0
+#define CONFIG_DEBUG_RESOURCES 0
+#define CONFIG_BOARD_INTEL_COMETLAKE_RVPU 0
+#define CONFIG_BASE_ASUS_P2B_D 0
+#define CONFIG_HAVE_EC_BIN 0
+#define CONFIG_L2_CACHE_SIZE 0
+#define CONFIG_CPU_INTEL_MODEL_6FX 0
+#define CONFIG_BOARD_SCALEWAY_TAGADA 0
+#define CONFIG_SUPERIO_ITE_ENV_CTRL_EXT_ANY_TMPIN 0
+#define CONFIG_TGL_INTEL_EC 0
+#define CONFIG_PM_ACPI_TIMER_OPTIONAL 0
+#define CONFIG_SUPERIO_SMSC_SMSCSUPERIO 0
+#define CONFIG_DRIVERS_I2C_SX9310 0
+#define CONFIG_X86EMU_DEBUG_PNP 0
+#define CONFIG_BOARD_ASUS_MAXIMUS_IV_GENE_Z 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_SATA 0
+#define CONFIG_BOARD_GOOGLE_CHELL 0
+#define CONFIG_SOC_INTEL_TIGERLAKE_DEBUG_CONSENT 0
+#define CONFIG_BOARD_ID_ADJUSTMENT 0
+#define CONFIG_BOARD_PRODRIVE_HERMES 0
+#define CONFIG_BOARD_INTEL_DG41WV 0
+#define CONFIG_SB800_IMC_FAN_CONTROL 0
+#define CONFIG_BOARD_INTEL_COFFEELAKE_RVPU 0
+#define CONFIG_VGA_BIOS_SECOND 0
+#define CONFIG_PXE_ADD_SCRIPT 0
+#define CONFIG_SDRAMPWR_4DIMM 0
+#define CONFIG_TIMESTAMPS_ON_CONSOLE 0
+#define CONFIG_STM_CONSOLE_DEBUG 0
+#define CONFIG_SUPERIO_ASPEED_COMMON_PRE_RAM 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_ACPI 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SGX_ENABLE 0
+#define CONFIG_BOARD_HP_PROBOOK_6360B 0
+#define CONFIG_SEABIOS_THREAD_OPTIONROMS 0
+#define CONFIG_NORTHBRIDGE_INTEL_GM45 0
+#define CONFIG_GRU_HAS_TPM2 0
+#define CONFIG_HAVE_INTEL_PTT 0
+#define CONFIG_BOARD_GOOGLE_ATLAS 0
+#define CONFIG_BOARD_GOOGLE_FOSTER 0
+#define CONFIG_ASAN_IN_ROMSTAGE 0
+#define CONFIG_VBOOT_VBNV_OFFSET 0x2c
+#define CONFIG_SUPERIO_NSC_PC87384 0
+#define CONFIG_VPD_FMAP_SIZE 0
+#define CONFIG_TIMESTAMPS_PER_CPU 0
+#define CONFIG_INCLUDE_CONFIG_FILE 1
+#define CONFIG_BOOTMEDIA_SPI_LOCK_PIN 0
+#define CONFIG_LAPIC_MONOTONIC_TIMER 0
+#define CONFIG_GRUB2_REVISION 0
+#define CONFIG_FMD_GENPARSER 0
+#define CONFIG_BOARD_GOOGLE_GRU 0
+#define CONFIG_BOOTSPLASH_IMAGE 0
+#define CONFIG_USE_VENDORCODE_ELTAN 0
+#define CONFIG_UPDATE_IMAGE 0
+#define CONFIG_BOARD_ROMSIZE_KB_6144 0
+#define CONFIG_VENDOR_GETAC 0
+#define CONFIG_SOUTHBRIDGE_TI_PCI1X2X 0
+#define CONFIG_BOARD_ASUS_P5QL_PRO 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SA 0
+#define CONFIG_DRIVERS_AS3722_RTC_ADDR 0
+#define CONFIG_LINUXBOOT_KERNEL_ARCH_DEFAULT_CONFIG 0
+#define CONFIG_BOARD_GOOGLE_HOMESTAR 0
+#define CONFIG_ONBOARD_VGA_IS_PRIMARY 0
+#define CONFIG_MAINBOARD_HAS_I2C_TPM_ATMEL 0
+#define CONFIG_BOARD_AMD_MAJOLICA 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_SPI_SILVERMONT 0
+#define CONFIG_APU1_PINMUX_UART_D 0
+#define CONFIG_BOARD_INTEL_SHADOWMOUNTAIN 0
+#define CONFIG_INCLUDE_SND_MAX98357_DA7219_NHLT 0
+#define CONFIG_SOUTHBRIDGE_INTEL_BD82X6X 0
+#define CONFIG_SUPERIO_NSC_PC87417 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SGX_PRMRR_SIZE_256MB 0
+#define CONFIG_COLLECT_TIMESTAMPS_NO_TSC 0
+#define CONFIG_USE_PSPSECUREOS 0
+#define CONFIG_SOC_INTEL_DEBUG_CONSENT 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_HAS_ESPI 0
+#define CONFIG_ROMSTAGE_SPD_CBFS 0
+#define CONFIG_HUDSON_XHCI_FWM 0
+#define CONFIG_SUPERIO_SMSC_LPC47M10X 0
+#define CONFIG_BOARD_INTEL_BASEBOARD_GLKRVP 0
+#define CONFIG_BMC_INFO_LOC 0
+#define CONFIG_CPU_INTEL_SOCKET_441 0
+#define CONFIG_FSP_HYPERTHREADING 0
+#define CONFIG_LINUXBOOT_BUILD_INITRAMFS 0
+#define CONFIG_SOC_INTEL_COMETLAKE_1 0
+#define CONFIG_BOARD_PINE64_ROCKPRO64 0
+#define CONFIG_CONSOLE_CBMEM_DEFERRED_BUFFER_SIZE 0
+#define CONFIG_BOARD_GOOGLE_ENGUARDE 0
+#define CONFIG_EC_HP_KBC1126 0
+#define CONFIG_VENDOR_EMULATION 1
+#define CONFIG_CAVIUM_BDK_VERBOSE_INIT 0
+#define CONFIG_BOARD_HP_COMPAQ_8200_ELITE_SFF_PC 0
+#define CONFIG_SB800_SATA_AHCI 0
+#define CONFIG_SOC_AMD_STONEYRIDGE 0
+#define CONFIG_TINT_SECONDARY_PAYLOAD 0
+#define CONFIG_BOARD_RODA_RK9 0
+#define CONFIG_CUSTOM_SPD_TRFC_HI 0
+#define CONFIG_BOARD_GOOGLE_MAGOLOR 0
+#define CONFIG_HAVE_FSP_GOP 0
+#define CONFIG_BOARD_GOOGLE_FAFFY 0
+#define CONFIG_ENABLE_BUILTIN_HSUART1 0
+#define CONFIG_DRIVERS_USB_PCI_XHCI 0
+#define CONFIG_SUPERIO_NUVOTON_NCT5572D 0
+#define CONFIG_AGESA_EXTRA_TIMESTAMPS 0
+#define CONFIG_FIXED_RCBA_MMIO_BASE 0xfed1c000
+#define CONFIG_SET_IA32_FC_LOCK_BIT 0
+#define CONFIG_INTEL_GMA_LIBGFXINIT_EDID 0
+#define CONFIG_RAMSTAGE_ADA 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_111 0
+#define CONFIG_SUPERIO_NSC_COMMON_PRE_RAM 0
+#define CONFIG_DEBUG_DRAM 0
+#define CONFIG_GBB_FLAG_FORCE_DEV_BOOT_USB 0
+#define CONFIG_NHLT_RT5663 0
+#define CONFIG_PCI_ALLOW_BUS_MASTER 1
+#define CONFIG_BOARD_GOOGLE_ESCHE 0
+#define CONFIG_SOUTHBRIDGE_AMD_CIMX_SB800 0
+#define CONFIG_RAMINIT_ALWAYS_ALLOW_DLL_OFF 0
+#define CONFIG_NUM_OF_IOAPICS 0
+#define CONFIG_HAVE_DEBUG_RAM_SETUP 0
+#define CONFIG_COREINFO_SECONDARY_PAYLOAD 0
+#define CONFIG_PSP_SHAREDMEM_SIZE 0
+#define CONFIG_BOARD_GOOGLE_HANA 0
+#define CONFIG_BOARD_GIGABYTE_GA_H61M_S2PV 0
+#define CONFIG_BOARD_ASUS_P5QPL_AM 0
+#define CONFIG_SUPERIO_SMSC_LPC47M15X 0
+#define CONFIG_NUM_CAR_PAGE_TABLE_PAGES 0
+#define CONFIG_VENDOR_SCALEWAY 0
+#define CONFIG_TOCTOU_SAFETY 0
+#define CONFIG_FSP_FULL_FD 0
+#define CONFIG_BOARD_GIGABYTE_GA_945GCM_S2L 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SGX_PRMRR_SIZE_MAX 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_I2C_CHIP 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_I2C_PROTO3 0
+#define CONFIG_BOARD_GOOGLE_MISTRAL 0
+#define CONFIG_BOARD_SIEMENS_BOXER26 0
+#define CONFIG_UBOOT_STABLE 0
+#define CONFIG_SOC_INTEL_BRASWELL 0
+#define CONFIG_SPI_FLASH_MACRONIX 0
+#define CONFIG_DRIVER_SIEMENS_NC_FPGA 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_EARLY_SMBUS 0
+#define CONFIG_PCIEXP_ASPM 0
+#define CONFIG_BOARD_GOOGLE_KAISA_LEGACY 0
+#define CONFIG_BOARD_GOOGLE_FENNEL 0
+#define CONFIG_BOARD_GOOGLE_SASUKETTE 0
+#define CONFIG_SOC_INTEL_QUARK 0
+#define CONFIG_FAST_SPI_SUPPORTS_EXT_BIOS_WINDOW 0
+#define CONFIG_BOARD_PURISM_LIBREM13_V4 0
+#define CONFIG_VBOOT_VBNV_CMOS_BACKUP_TO_FLASH 0
+#define CONFIG_BOARD_GOOGLE_SNAPPY 0
+#define CONFIG_BOARD_INTEL_ADLRVP_P 0
+#define CONFIG_PMC_LOW_POWER_MODE_PROGRAM 0
+#define CONFIG_BOARD_GOOGLE_PEPPY 0
+#define CONFIG_CUSTOM_SPD_UPPER_TRC 0
+#define CONFIG_HUDSON_ACPI_IO_BASE 0
+#define CONFIG_MAINBOARD_SERIAL_NUMBER "123456789"
+#define CONFIG_BOARD_GOOGLE_SORAKA 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_XHCI_ELOG 0
+#define CONFIG_SMBIOS_SERIAL_FROM_VPD 0
+#define CONFIG_VBOOT_STARTS_BEFORE_BOOTBLOCK 0
+#define CONFIG_CPU_INTEL_TURBO_NOT_PACKAGE_SCOPED 0
+#define CONFIG_BOARD_INTEL_TGLRVP_UP4 0
+#define CONFIG_STORAGE_LOG 0
+#define CONFIG_CAVIUM_BDK_VERBOSE_PHY 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_JECHT 0
+#define CONFIG_BOARD_AMD_SOUTHSTATION 0
+#define CONFIG_SUPERIO_WINBOND_COMMON_PRE_RAM 0
+#define CONFIG_VGA_BIOS 0
+#define CONFIG_FSP_S_ADDR 0
+#define CONFIG_BOARD_GOOGLE_WADDLEDEE 0
+#define CONFIG_DRIVERS_UART_8250MEM 0
+#define CONFIG_BOARD_GOOGLE_SARIEN 0
+#define CONFIG_PLATFORM_USES_FSP2_2 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_ALINK 0
+#define CONFIG_BOARD_GOOGLE_LANTIS 0
+#define CONFIG_GRU_HAS_CENTERLOG_PWM 0
+#define CONFIG_X86EMU_DEBUG 0
+#define CONFIG_FATAL_ASSERTS 0
+#define CONFIG_ARCH_VERSTAGE_X86_64 0
+#define CONFIG_AGESA_BINARY_PI_AS_STAGE 0
+#define CONFIG_BOARD_LENOVO_W500 0
+#define CONFIG_BOARD_LENOVO_THINKCENTRE_A58 0
+#define CONFIG_BOARD_GOOGLE_TIDUS 0
+#define CONFIG_CPU_INTEL_MODEL_106CX 0
+#define CONFIG_MAINBOARD_FORCE_NATIVE_VGA_INIT 1
+#define CONFIG_CUSTOM_SPD_DIVIDENT 0
+#define CONFIG_MAINBOARD_POWER_RESTORE 0
+#define CONFIG_CPU_INTEL_MODEL_F4X 0
+#define CONFIG_VARIANT_MIN_BOARD_ID_V3_SCHEMATICS 0
+#define CONFIG_EC_BASE_ADDRESS 0
+#define CONFIG_BOARD_EMULATION_SPIKE_RISCV 0
+#define CONFIG_YABEL_PCI_ACCESS_OTHER_DEVICES 0
+#define CONFIG_EC_SUPPORTS_DPTF_TEVT 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_101 0
+#define CONFIG_BOOTBLOCK_NORMAL 0
+#define CONFIG_FAST_SPI_DISABLE_WRITE_STATUS 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_DMI 0
+#define CONFIG_FSP_M_ADDR 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_LPC_COMB_ENABLE 0
+#define CONFIG_UART_PCI_ADDR 0x0
+#define CONFIG_FINALIZE_USB_ROUTE_XHCI 0
+#define CONFIG_DRIVERS_I2C_DA7219 0
+#define CONFIG_ARCH_VERSTAGE_ARM64 0
+#define CONFIG_BOARD_INTEL_APOLLOLAKE_RVP1 0
+#define CONFIG_SECURITY_CLEAR_DRAM_PARALLEL 0
+#define CONFIG_HAVE_SMI_HANDLER 0
+#define CONFIG_ARCH_BOOTBLOCK_PPC64 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_PCI 0
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL_2 0
+#define CONFIG_BOARD_AMD_UNIONSTATION 0
+#define CONFIG_VENDOR_KONTRON 0
+#define CONFIG_ADL_INTEL_EC 0
+#define CONFIG_HWBASE_DEBUG_NULL 0
+#define CONFIG_MRC_SAVE_HASH_IN_TPM 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_USB_DEBUG 0
+#define CONFIG_SEABIOS_BOOTORDER_FILE ""
+#define CONFIG_CCACHE 0
+#define CONFIG_VENDORCODE_ELTAN_OEM_MANIFEST_ITEM_SIZE 0
+#define CONFIG_ROM_SIZE 0x00040000
+#define CONFIG_DRIVER_TPM_I2C_ADDR 0
+#define CONFIG_BOARD_LENOVO_THINKPAD_T430 0
+#define CONFIG_NO_CBFS_MCACHE 0
+#define CONFIG_BOARD_GOOGLE_VOLTEER2_TI50 0
+#define CONFIG_BOARD_GOOGLE_GUADO 0
+#define CONFIG_BOOTMEDIA_LOCK_WHOLE_NO_ACCESS 0
+#define CONFIG_PCIEXP_HOTPLUG_IO 0
+#define CONFIG_BOARD_GIZMOSPHERE_GIZMO2 0
+#define CONFIG_DCACHE_BSP_STACK_SIZE 0x4000
+#define CONFIG_SUPERIO_SMSC_LPC47N207 0
+#define CONFIG_ME_REGION_ALLOW_CPU_READ_ACCESS 0
+#define CONFIG_UDK_202005_BINDING 0
+#define CONFIG_BOARD_ASUS_P8H61_M_LX 0
+#define CONFIG_ARM64_USE_ARM_TRUSTED_FIRMWARE 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_NONCAR 0
+#define CONFIG_BOARD_SIFIVE_HIFIVE_UNLEASHED 0
+#define CONFIG_INCLUDE_SND_MAX98373_NHLT 0
+#define CONFIG_INCLUDE_NHLT_BLOBS_RAMMUS 0
+#define CONFIG_MINIMAL_PCI_SCANNING 0
+#define CONFIG_BOOTMEDIA_LOCK_WHOLE_RO 0
+#define CONFIG_GBB_FLAG_LOAD_OPTION_ROMS 0
+#define CONFIG_CPU_BCLK_MHZ 0
+#define CONFIG_SOC_INTEL_ALDERLAKE_PCH_M 0
+#define CONFIG_SOC_INTEL_COMMON_PCH_BASE 0
+#define CONFIG_ROMSTAGE_ADDR 0x2000000
+#define CONFIG_BOARD_ASUS_P2B_LS 0
+#define CONFIG_BOARD_ASUS_P8Z77_M_PRO 0
+#define CONFIG_APL_SKIP_SET_POWER_LIMITS 0
+#define CONFIG_SPI_FLASH_EON 0
+#define CONFIG_SEABIOS_STABLE 1
+#define CONFIG_ESPI_DEBUG 0
+#define CONFIG_VGA 1
+#define CONFIG_HAVE_VERSTAGE 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_SPI 0
+#define CONFIG_NO_DEFAULT_PAYLOAD 0
+#define CONFIG_CBFS_ACCESS_ORDER_FILE ""
+#define CONFIG_ELOG 0
+#define CONFIG_DCACHE_RAM_BASE 0x10000
+#define CONFIG_BASEBOARD_GLKRVP_LAPTOP 0
+#define CONFIG_CBFS_ACCESS_TRACE 0
+#define CONFIG_SOC_AMD_SMU_NOTFANLESS 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_FIZZ 0
+#define CONFIG_BIOS_RESOURCE_LIST_SIZE 0
+#define CONFIG_BOARD_GOOGLE_STORO 0
+#define CONFIG_PIRQ_ROUTE 0
+#define CONFIG_CMOS_DEFAULT_FILE "src/mainboard/$(MAINBOARDDIR)/cmos.default"
+#define CONFIG_BOARD_GOOGLE_DELTAN 0
+#define CONFIG_SUPERIO_ITE_IT8528E 0
+#define CONFIG_POSTCAR_STAGE 1
+#define CONFIG_SOC_MEDIATEK_MT8173 0
+#define CONFIG_SMAUG_BCT_CFG_SPI 0
+#define CONFIG_MAINBOARD_SUPPORTS_SKYLAKE_CPU 0
+#define CONFIG_SPD_READ_BY_WORD 0
+#define CONFIG_SAR_ENABLE 0
+#define CONFIG_X86EMU_DEBUG_TIMINGS 0
+#define CONFIG_GFX_GMA_ANALOG_I2C_HDMI_C 0
+#define CONFIG_CHROMEOS_RAMOOPS 0
+#define CONFIG_CR50_USE_LONG_INTERRUPT_PULSES 0
+#define CONFIG_LOCK_MANAGEMENT_ENGINE 0
+#define CONFIG_BOARD_INTEL_ADLRVP_M_EXT_EC 0
+#define CONFIG_VENDOR_RODA 0
+#define CONFIG_CONSOLE_QEMU_DEBUGCON_PORT 0x402
+#define CONFIG_SOC_INTEL_DENVERTON_NS 0
+#define CONFIG_VGA_TEXT_FRAMEBUFFER 1
+#define CONFIG_SKIP_MAX_REBOOT_CNT_CLEAR 0
+#define CONFIG_VENDOR_PACKARDBELL 0
+#define CONFIG_BOARD_KONTRON_BSL6_COMMON 0
+#define CONFIG_VERSTAGE_DEBUG_SPINLOOP 0
+#define CONFIG_BOARD_GOOGLE_KODAMA 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_SPI_DEBUG 0
+#define CONFIG_FSP_PLATFORM_MEMORY_SETTINGS_VERSIONS 0
+#define CONFIG_BOARD_GOOGLE_VEYRON_RIALTO 0
+#define CONFIG_PLLX_KHZ 0
+#define CONFIG_MAX_CPU_ROOT_PORTS 0
+#define CONFIG_BOOTBLOCK_DEBUG_SPINLOOP 0
+#define CONFIG_INTEL_GMA_PANEL_2 0
+#define CONFIG_BOARD_GOOGLE_LINK 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_SPI_ICH9 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_P2SB 0
+#define CONFIG_PARALLEL_MP 0
+#define CONFIG_GDB_STUB 0
+#define CONFIG_SUPERIO_SMSC_SIO1036 0
+#define CONFIG_HAVE_ACPI_RESUME 0
+#define CONFIG_MP_SERVICES_PPI_V1 0
+#define CONFIG_BOARD_GOOGLE_KIP 0
+#define CONFIG_SMM_MODULE_HEAP_SIZE 0
+#define CONFIG_UDK_2015_BINDING 0
+#define CONFIG_CPU_MICROCODE_CBFS_EXTERNAL_HEADER 0
+#define CONFIG_BOARD_PROTECTLI_FW2B 0
+#define CONFIG_SOUTHBRIDGE_INTEL_IBEXPEAK 0
+#define CONFIG_QC_SDI_ENABLE 0
+#define CONFIG_STATIC_OPTION_TABLE 0
+#define CONFIG_CBFS_PREFIX_FALLBACK 0
+#define CONFIG_NO_FADT_8042 0
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL_8 0
+#define CONFIG_SOC_QUALCOMM_QCS405 0
+#define CONFIG_BOARD_GOOGLE_RAMBI 0
+#define CONFIG_BOARD_INTEL_MINNOW3 0
+#define CONFIG_EARLY_PCI_MMIO_BASE 0
+#define CONFIG_LINUXBOOT_KERNEL_STABLE 0
+#define CONFIG_SMM_TSEG_SIZE 0
+#define CONFIG_KBC1126_FIRMWARE 0
+#define CONFIG_SDHCI_ADMA_IN_VERSTAGE 0
+#define CONFIG_ARCH_ROMSTAGE_X86_64 0
+#define CONFIG_BOARD_AOPEN_DXPLPLUSU 0
+#define CONFIG_STM_CBMEM_CONSOLE 0
+#define CONFIG_BOARD_ROMSIZE_KB_2048 0
+#define CONFIG_BOOT_DEVICE_SUPPORTS_WRITES 0
+#define CONFIG_BOARD_AMD_INAGUA 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_114 0
+#define CONFIG_LINEAR_FRAMEBUFFER 0
+#define CONFIG_CUSTOM_SPD_TWR 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_OCTOPUS 0
+#define CONFIG_CPU_QEMU_X86_PARALLEL_MP 0
+#define CONFIG_INTEL_TXT_DPR_SIZE 0
+#define CONFIG_SOUTHBRIDGE_INTEL_I82801DX 0
+#define CONFIG_SPD_CACHE_IN_FMAP 0
+#define CONFIG_ARCH_ARM64 0
+#define CONFIG_SAMPLING_PROFILER_PERIOD_US 0
+#define CONFIG_DRIVERS_UART_8250IO 1
+#define CONFIG_ARCH_BOOTBLOCK_ARMV8_64 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_PMC_DISCOVERABLE 0
+#define CONFIG_DRIVER_ANALOGIX_ANX7625 0
+#define CONFIG_BOARD_INTEL_ELKHARTLAKE_CRB 0
+#define CONFIG_TPM_STARTUP_IGNORE_POSTINIT 0
+#define CONFIG_VARIANT_HAS_FPMCU 0
+#define CONFIG_EFS_SPI_MICRON_FLAG 0
+#define CONFIG_BOARD_GOOGLE_WADDLEDOO 0
+#define CONFIG_SMSC_SIO1036_BASE_4E 0
+#define CONFIG_FRU_DEVICE_ID 0
+#define CONFIG_ARM64_USE_ARCH_TIMER 0
+#define CONFIG_BOARD_ASUS_P3B_F 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_BELTINO 0
+#define CONFIG_SOC_AMD_SMU_FANLESS 0
+#define CONFIG_CMOS_RECOVERY_BYTE 0
+#define CONFIG_BOARD_GOOGLE_MANCOMB 0
+#define CONFIG_MP_MEMTEST_FULL 0
+#define CONFIG_SUPERIO_ITE_ENV_CTRL_PWM_FREQ2 0
+#define CONFIG_SOC_ROCKCHIP_RK3288 0
+#define CONFIG_BOARD_GOOGLE_ZAKO 0
+#define CONFIG_VENDOR_UP 0
+#define CONFIG_LINUXBOOT_KERNEL_CUSTOM_CONFIG 0
+#define CONFIG_CPU_INTEL_MODEL_6EX 0
+#define CONFIG_BOARD_ASROCK_H110M_DVS 0
+#define CONFIG_BOARD_ASUS_P5Q_PRO 0
+#define CONFIG_CONSOLE_SERIAL_TEGRA210_UARTE 0
+#define CONFIG_HUDSON_PSP 0
+#define CONFIG_BOARD_GOOGLE_NOIBAT 0
+#define CONFIG_SEABIOS_DEBUG_LEVEL -1
+#define CONFIG_YABEL_DIRECTHW 0
+#define CONFIG_FSP_STATUS_GLOBAL_RESET_REQUIRED_8 0
+#define CONFIG_BOARD_ASUS_F2A85_M_DDR3_VOLT_165 0
+#define CONFIG_DRIVERS_SIL_3114 0
+#define CONFIG_FSP_CAR 0
+#define CONFIG_BOARD_GOOGLE_DRAWCIA_LEGACY 0
+#define CONFIG_DRIVERS_UART_ACPI 0
+#define CONFIG_BMP_LOGO 0
+#define CONFIG_BOARD_HP_2760P 0
+#define CONFIG_BOARD_LENOVO_W520 0
+#define CONFIG_HAVE_FSP_LOGO_SUPPORT 0
+#define CONFIG_VENDOR_GOOGLE 0
+#define CONFIG_SOC_AMD_CEZANNE 0
+#define CONFIG_BOARD_IBASE_MB899 0
+#define CONFIG_DRIVERS_I2C_HID 0
+#define CONFIG_PAYLOAD_IS_FLAT_BINARY 0
+#define CONFIG_SB800_FWM_AT_FF820000 0
+#define CONFIG_BOARD_INTEL_EMERALDLAKE2 0
+#define CONFIG_VARIANT_SPECIFIC_OPTIONS_NAMI 0
+#define CONFIG_NORTHBRIDGE_INTEL_PINEVIEW 0
+#define CONFIG_SOC_INTEL_WHISKEYLAKE 0
+#define CONFIG_RAID_MISC_ROM_POSITION 0
+#define CONFIG_PXE_ROM 0
+#define CONFIG_INTEL_GMA_BCLM_WIDTH 16
+#define CONFIG_HAVE_UART_SPECIAL 0
+#define CONFIG_BOARD_LENOVO_X131E 0
+#define CONFIG_BOARD_CLEVO_KBLU_COMMON 0
+#define CONFIG_BOARD_GOOGLE_KINDRED 0
+#define CONFIG_CPU_INTEL_SOCKET_LGA775 0
+#define CONFIG_SUPERIO_ITE_ENV_CTRL_FAN16_CONFIG 0
+#define CONFIG_CPU_QEMU_X86_ASEG_SMM 0
+#define CONFIG_BOARD_INTEL_JASPERLAKE_RVP_EXT_EC 0
+#define CONFIG_CPU_HAS_L2_ENABLE_MSR 0
+#define CONFIG_BOARD_SUPERMICRO_X10SLM_PLUS_F 0
+#define CONFIG_BOARD_ASUS_P2B 0
+#define CONFIG_HAVE_USBDEBUG 0
+#define CONFIG_DRIVERS_I2C_RTD2132 0
+#define CONFIG_CPU_INTEL_COMMON_TIMEBASE 0
+#define CONFIG_BOARD_GOOGLE_VEYRON_MIGHTY 0
+#define CONFIG_POST_DEVICE 1
+#define CONFIG_BOARD_EMULATION_QEMU_POWER8 0
+#define CONFIG_SUPERIO_WINBOND_W83667HG_A 0
+#define CONFIG_SOC_INTEL_UART_DEV_MAX 0
+#define CONFIG_ROMSTAGE_SPD_SMBUS 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_102 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_ITSS 0
+#define CONFIG_TPM2 0
+#define CONFIG_CHROMEOS_WIFI_SAR 0
+#define CONFIG_EC_BASE_ACPI_COMMAND 0
+#define CONFIG_USE_DENVERTON_NS_CAR_NEM_ENHANCED 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_MEMINIT 0
+#define CONFIG_EC_GOOGLE_CHROMEEC_SWITCHES 0
+#define CONFIG_BOARD_EMULATION_QEMU_RISCV_RV32 0
+#define CONFIG_CPU_INTEL_MODEL_F3X 0
+#define CONFIG_SUPERIO_ITE_IT8613E 0
+#define CONFIG_SB800_FWM_POSITION 0
+#define CONFIG_BOARD_INTEL_APOLLOLAKE_RVP2 0
+#define CONFIG_HEAP_FREE_LIST 0
+#define CONFIG_GRUB2_INCLUDE_RUNTIME_CONFIG_FILE 0
+#define CONFIG_VENDORCODE_ELTAN_OEM_MANIFEST_LOC 0
+#define CONFIG_BOARD_JETWAY_NF81_T56N_LF 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_10D 0
+#define CONFIG_VARIANT_SPECIFIC_OPTIONS_NAUTILUS 0
+#define CONFIG_SOC_SIFIVE_FU540 0
+#define CONFIG_VBOOT_MUST_REQUEST_DISPLAY 0
+#define CONFIG_LEGACY_UART_MODE 0
+#define CONFIG_DRIVERS_INTEL_MIPI_CAMERA 0
+#define CONFIG_SB800_IMC_FWM 0
+#define CONFIG_BOARD_SIEMENS_MC_APL5 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_SLIPPY 0
+#define CONFIG_HAVE_IFD_BIN 0
+#define CONFIG_HW_MEM_HOLE_SIZEK 0
+#define CONFIG_CBFS_HASH_ALGO 0
+#define CONFIG_SOC_INTEL_ICELAKE_DEBUG_CONSENT 0
+#define CONFIG_BOARD_GOOGLE_BUTTERFLY 0
+#define CONFIG_YABITS_REVISION 0
+#define CONFIG_CACHE_MRC_SETTINGS 0
+#define CONFIG_HAVE_SPD_IN_CBFS 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_XHCI 0
+#define CONFIG_DIGITIZER_AUTODETECT 0
+#define CONFIG_DRIVERS_INTEL_USB4_RETIMER 0
+#define CONFIG_HAVE_PIRQ_TABLE 1
+#define CONFIG_BOARD_FOXCONN_G41S_K 0
+#define CONFIG_SQUELCH_EARLY_SMP 1
+#define CONFIG_SOC_INTEL_COMMON_BLOCK_SATA 0
+#define CONFIG_GRU_HAS_WLAN_RESET 0
+#define CONFIG_SOC_INTEL_TIGERLAKE 0
+#define CONFIG_POWER_BUTTON_DEFAULT_ENABLE 0
+#define CONFIG_SOUTH_BRIDGE_OPTIONS 0
+#define CONFIG_PAYLOAD_GRUB2 0
+#define CONFIG_PSP_LOAD_S0I3_FW 0
+#define CONFIG_NYAN_BIG_BCT_CFG_EMMC 0
+#define CONFIG_SOC_QUALCOMM_SC7180 0
+#define CONFIG_CUSTOM_SPD_UPPER_TRAS 0
+#define CONFIG_BOARD_ASROCK_B85M_PRO4 0
+#define CONFIG_COMPRESS_RAMSTAGE_ZSTD 0
+#define CONFIG_SMMSTORE_V2 0
+#define CONFIG_DISPLAY_MTRRS 0
+#define CONFIG_MAINBOARD_DO_DSI_INIT 0
+#define CONFIG_SOUTHBRIDGE_INTEL_I82801IX 0
+#define CONFIG_BOARD_GOOGLE_DIRINBOZ 0
+#define CONFIG_SERIRQ_CONTINUOUS_MODE 0
+#define CONFIG_TEGRA124_MODEL_TD580D 0
+#define CONFIG_CAR_HAS_SF_MASKS 0
+#define CONFIG_BOARD_INTEL_KBLRVP8 0
+#define CONFIG_IED_REGION_SIZE 0
+#define CONFIG_PAYLOAD_ELF 0
+#define CONFIG_APU1_PINMUX_GPIO1 0
+#define CONFIG_BROADWELL_VBOOT_IN_BOOTBLOCK 0
+#define CONFIG_MAINBOARD_HAS_LIBGFXINIT 0
+#define CONFIG_SOC_QUALCOMM_COMMON 0
+#define CONFIG_ARCH_ROMSTAGE_ARMV8_64 0
+#define CONFIG_BOOT_DEVICE_SPI_FLASH_RW_NOMMAP 0
+#define CONFIG_SOC_INTEL_COMMON_BLOCK 0
+#define CONFIG_I945_LVDS 0
+#define CONFIG_USE_CANNONLAKE_FSP_CAR 0
+#define CONFIG_CPU_SAMSUNG_EXYNOS5250 0
+#define CONFIG_SOUTHBRIDGE_INTEL_COMMON_PMCLIB 0
+#define CONFIG_EARLY_PCI_BRIDGE_FUNCTION 0
+#define CONFIG_CPU_SUPPORTS_PM_TIMER_EMULATION 0
+#define CONFIG_BOARD_ASUS_F2A85_M_DDR3_VOLT_135 0
+#define CONFIG_BOARD_INTEL_TGLRVP_UP3 0
+#define CONFIG_SANDYBRIDGE_VBOOT_IN_BOOTBLOCK 0
+#define CONFIG_CHROMEOS_RAMOOPS_RAM_SIZE 0
+#define CONFIG_SOC_INTEL_ALDERLAKE 0
+#define CONFIG_GFX_GMA_ANALOG_I2C_HDMI_D 0
+#define CONFIG_MRC_BIN_ADDRESS 0
+#define CONFIG_BOARD_GOOGLE_ENDEAVOUR 0
+#define CONFIG_HAVE_RAMPAYLOAD 0
+#define CONFIG_BOARD_GOOGLE_ELDRID 0
+#define CONFIG_BOARD_ELMEX_PCM205400 0
+#define CONFIG_MAINBOARD_DO_NATIVE_VGA_INIT 1
+#define CONFIG_SUPERIO_WINBOND_W83627THG 0
+#define CONFIG_UBSAN 0
+#define CONFIG_VENDOR_ELMEX 0
+#define CONFIG_IRQ_SLOT_COUNT 6
+#define CONFIG_CUSTOM_SPD_TRRD 0
+#define CONFIG_BOARD_GOOGLE_TODOR 0
+#define CONFIG_CMOS_POST 0
+#define CONFIG_TGL_CHROME_EC 0
+#define CONFIG_CHECK_SLFRCS_ON_RESUME 0
+#define CONFIG_ARCH_RISCV_M 0
+#define CONFIG_BOARD_GOOGLE_BASEBOARD_MANCOMB 0
+#define CONFIG_SUPERIO_ADDR_BASE 0
+#define CONFIG_CBFS_VERIFICATION 0
+#define CONFIG_DEVICE_TIMING_ENTRIES 0
+#define CONFIG_DRIVERS_TI_SN65DSI86BRIDGE 0
+#define CONFIG_BOARD_PCENGINES_APU1 0
+#define CONFIG_BOARD_APPLE_MACBOOK21 0
+#define CONFIG_CUSTOM_SPD_TFAW 0
+#define CONFIG_EC_RODA_IT8518 0
+#define CONFIG_PARALLEL_CPU_INIT 0
+#define CONFIG_ENABLE_DEBUG_LED_SOC_INIT_ENTRY 0
+#define CONFIG_CPU_AMD_AGESA_BINARY_PI 0
+#define CONFIG_BOARD_GOOGLE_ORCO 0
+#define CONFIG_FRAMEBUFFER_VESA_MODE_108 0
+#define CONFIG_BOARD_GOOGLE_LARS 0
+#define CONFIG_EC_SYSTEM76_EC_COLOR_KEYBOARD 0
+#define CONFIG_VENDOR_SAMSUNG 0
+#define CONFIG_BOARD_ASROCK_G41C_GS_R2_0 0
+#define CONFIG_ACPI_HAVE_PCAT_8259 1
+#define CONFIG_DSAR_SET_NUM 0
+#define CONFIG_EARLY_PCI_BRIDGE 0
+#define CONFIG_IOAPIC_INTERRUPTS_ON_APIC_SERIAL_BUS 0
+#define CONFIG_BOARD_GOOGLE_DUFFY_LEGACY 0
+#define CONFIG_NATIVE_RAMINIT_IGNORE_XMP_REQUESTED_VOLTAGE 0
+#define CONFIG_BOARD_GOOGLE_DEDEDE 0
+#define CONFIG_CPU_XTAL_HZ 0
+#define CONFIG_SMMSTORE_IN_CBFS 0
+#define CONFIG_DEFAULT_CONSOLE_LOGLEVEL_5 0
+#define CONFIG_NYAN_BCT_CFG_SPI 0
+#define CONFIG_GENERIC_UDELAY 0
+#define CONFIG_TIANOCORE_TARGET_IA32 0
+#define CONFIG_PICASSO_FW_B_POSITION 0
+#define CONFIG_DRIVERS_I2C_LM96000 0
+#define CONFIG_BOARD_GOOGLE_BOTEN_LEGACY 0
+#define CONFIG_DRIVERS_I2C_SX9324 0
+#define CONFIG_INTEL_PCH_UART_CONSOLE 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_SMI 0
+#define CONFIG_BOARD_MSI_MS7721 0
+#define CONFIG_UDK_2017_VERSION 0
+#define CONFIG_SOC_ROCKCHIP_RK3399 0
+#define CONFIG_BOARD_ASUS_P5Q 0
+#define CONFIG_DRIVERS_GENERIC_ADAU7002 0
+#define CONFIG_BOARD_GOOGLE_BURNET 0
+#define CONFIG_NHLT_MAX98373 0
+#define CONFIG_DRIVERS_I2C_GENERIC 0
+#define CONFIG_BOARD_GOOGLE_RAINIER 0
+#define CONFIG_SOC_AMD_COMMON_BLOCK_GRAPHICS_ATIF 0
+#define CONFIG_NHLT_MAX98357 0
+#define CONFIG_DISPLAY_HOBS 0
+#define CONFIG_COREBOOT_ROMSIZE_KB_512 0
+#define CONFIG_VBOOT_EARLY_EC_SYNC 0
+#define CONFIG_RAMINIT_ENABLE_ECC 0
+#define CONFIG_POST_DEVICE_NONE 1
+#define CONFIG_APU2_PINMUX_GPIO1 0
+#define CONFIG_USE_AMD_BLOBS 0
+#define CONFIG_INTEL_TXT_SINIT_SIZE 0
+#define CONFIG_BOARD_APPLE_IMAC52 0
+#define CONFIG_SUPERIO_NUVOTON_NCT6791D 0
+#define CONFIG_BOARD_SAMSUNG_STUMPY 0
+#define CONFIG_EC_GOOGLE_CHROMEEC 0
+#define CONFIG_CPU_QEMU_X86_64 0
+#define CONFIG_VBOOT 0
+#define CONFIG_OVERRIDE_DEVICETREE ""
+#define CONFIG_SPI_FLASH_WINBOND 0
+#define CONFIG_CONSOLE_CBMEM_BUFFER_SIZE 0x20000
+#define CONFIG_BMC_KCS_BASE 0
+#define CONFIG_BOARD_OPENCELLULAR_ELGON 0
+#define CONFIG_BOARD_GOOGLE_JACUZZI_COMMON 0
+#define CONFIG_BOARD_INTEL_KUNIMITSU 0
+#define CONFIG_BOARD_FOXCONN_G41M 0
+#define CONFIG_POWER_STATE_PREVIOUS_AFTER_FAILURE 0
+#define CONFIG_PCIX_PLUGIN_SUPPORT 1
+#define CONFIG_SUPERIO_WINBOND_W83627EHG 0
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/cmocka.dir/src/cmocka.c.o"
+  "CMakeFiles/cmocka.dir/src/cmocka.c.o.d"
+  "src/libcmocka.pdb"
+  "src/libcmocka.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/cmocka.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -58,6 +58,9 @@
 #define CBFS_COMPRESS_NONE  0
 #define CBFS_COMPRESS_LZMA  1
 #define CBFS_COMPRESS_LZ4   2
+#define CBFS_COMPRESS_ZSTD  5
+#define CBFS_COMPRESS_LZMA_BCJ_X86   6
+#define CBFS_COMPRESS_LZMA_BCJ_ARM64 7
 
 /** These are standard component types for well known
     components (i.e - those that coreboot needs to consume.
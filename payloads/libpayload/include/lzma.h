@@ -29,6 +29,8 @@
 #ifndef _LZMA_H
 #define _LZMA_H
 
+#include <stddef.h>
+
 /* Decompresses the data stream at src to dst. The sizes of the source and
  * destination buffers are in srcn and dstn.
  *
@@ -44,4 +46,10 @@ unsigned long ulzman(const unsigned char *src, unsigned long srcn,
  */
 unsigned long ulzma(const unsigned char *src, unsigned char *dst);
 
+/* Undoes (encode == 0) or applies the x86 or ARM64 branch converter that
+ * CBFS_COMPRESS_LZMA_BCJ_* data runs through before LZMA compression.
+ */
+void bcj_x86(void *buf, size_t size, int encode);
+void bcj_arm64(void *buf, size_t size, int encode);
+
 #endif
@@ -0,0 +1,14 @@
+/* SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only */
+
+#ifndef __ZSTD_H_
+#define __ZSTD_H_
+
+#include <stddef.h>
+
+/*
+ * Decompresses a Zstandard stream of srcn bytes at src into dst, which holds
+ * up to dstn bytes. Returns the decompressed size or 0 on error.
+ */
+size_t uzstdn(const void *src, size_t srcn, void *dst, size_t dstn);
+
+#endif /* __ZSTD_H_ */
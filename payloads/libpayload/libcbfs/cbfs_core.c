@@ -36,6 +36,9 @@
  * CBFS_CORE_WITH_LZ4 (must be #define)
  *      if defined, ulz4f() must exist for decompression of data streams
  *
+ * CBFS_CORE_WITH_ZSTD (must be #define)
+ *      if defined, uzstdn() must exist for decompression of data streams
+ *
  * ERROR(x...)
  *      print an error message x (in printf format)
  *
@@ -349,10 +352,22 @@ size_t cbfs_decompress(int algo, const void *src, size_t srcn, void *dst,
 #ifdef CBFS_CORE_WITH_LZMA
 		case CBFS_COMPRESS_LZMA:
 			return ulzman(src, srcn, dst, dstn);
+		case CBFS_COMPRESS_LZMA_BCJ_X86:
+			len = ulzman(src, srcn, dst, dstn);
+			bcj_x86(dst, len, 0);
+			return len;
+		case CBFS_COMPRESS_LZMA_BCJ_ARM64:
+			len = ulzman(src, srcn, dst, dstn);
+			bcj_arm64(dst, len, 0);
+			return len;
 #endif
 #ifdef CBFS_CORE_WITH_LZ4
 		case CBFS_COMPRESS_LZ4:
 			return ulz4fn(src, srcn, dst, dstn);
+#endif
+#ifdef CBFS_CORE_WITH_ZSTD
+		case CBFS_COMPRESS_ZSTD:
+			return uzstdn(src, srcn, dst, dstn);
 #endif
 		default:
 			ERROR("tried to decompress %zu bytes with algorithm "
@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only */
+
+/*
+ * Branch converters (BCJ filters) for executable code. Relative branch targets
+ * differ at every call site even when they point to the same function, which
+ * hides the repetition from LZMA. Turning them into absolute targets before
+ * compression and back after decompression makes code compress noticeably
+ * better. The conversions follow the x86 and ARM64 filters of xz (public
+ * domain), with the stream starting at position 0.
+ */
+
+#include <lzma.h>
+#include <stdint.h>
+
+#define X86_MS_BYTE_OK(b) ((b) == 0 || (b) == 0xff)
+
+void bcj_x86(void *buf, size_t size, int encode)
+{
+	static const uint8_t mask_allowed[8] = { 1, 1, 1, 0, 1, 0, 0, 0 };
+	static const uint8_t mask_bit[8] = { 0, 1, 2, 2, 3, 3, 3, 3 };
+	uint8_t *p = buf;
+	uint32_t prev_mask = 0;
+	uint32_t prev_pos = (uint32_t)-5;
+	size_t i = 0;
+
+	if (size < 5)
+		return;
+
+	while (i <= size - 5) {
+		uint32_t offset, src, dest;
+		uint8_t b = p[i];
+
+		/* CALL rel32 and JMP rel32 */
+		if (b != 0xe8 && b != 0xe9) {
+			i++;
+			continue;
+		}
+
+		offset = (uint32_t)i - prev_pos;
+		prev_pos = i;
+		if (offset > 5) {
+			prev_mask = 0;
+		} else {
+			while (offset--) {
+				prev_mask &= 0x77;
+				prev_mask <<= 1;
+			}
+		}
+
+		b = p[i + 4];
+		if (!X86_MS_BYTE_OK(b) || !mask_allowed[(prev_mask >> 1) & 0x7] ||
+		    (prev_mask >> 1) >= 0x10) {
+			i++;
+			prev_mask |= 1;
+			if (X86_MS_BYTE_OK(b))
+				prev_mask |= 0x10;
+			continue;
+		}
+
+		src = (uint32_t)b << 24 | p[i + 3] << 16 | p[i + 2] << 8 | p[i + 1];
+		while (1) {
+			uint32_t shift;
+
+			if (encode)
+				dest = src + ((uint32_t)i + 5);
+			else
+				dest = src - ((uint32_t)i + 5);
+			if (prev_mask == 0)
+				break;
+			shift = mask_bit[prev_mask >> 1] * 8;
+			b = dest >> (24 - shift);
+			if (!X86_MS_BYTE_OK(b))
+				break;
+			src = dest ^ ((1U << (32 - shift)) - 1);
+		}
+
+		/* Only 25 bits are kept, byte 4 is the sign extension of bit 24. */
+		p[i + 4] = ~(((dest >> 24) & 1) - 1);
+		p[i + 3] = dest >> 16;
+		p[i + 2] = dest >> 8;
+		p[i + 1] = dest;
+		i += 5;
+		prev_mask = 0;
+	}
+}
+
+void bcj_arm64(void *buf, size_t size, int encode)
+{
+	uint8_t *p = buf;
+	size_t i;
+
+	for (i = 0; i + 4 <= size; i += 4) {
+		uint32_t insn = p[i] | p[i + 1] << 8 | p[i + 2] << 16 |
+				(uint32_t)p[i + 3] << 24;
+		uint32_t pc = i;
+
+		if ((insn >> 26) == 0x25) {
+			/* BL: 26 bit word offset */
+			pc >>= 2;
+			if (!encode)
+				pc = -pc;
+			insn = 0x94000000 | ((insn + pc) & 0x03ffffff);
+		} else if ((insn & 0x9f000000) == 0x90000000) {
+			/* ADRP: 21 bit page offset, only convert +-512 MiB
+			   (18 bits) so unrelated bit patterns stay untouched. */
+			uint32_t src = ((insn >> 29) & 3) | ((insn >> 3) & 0x001ffffc);
+			uint32_t dest;
+
+			if ((src + 0x00020000) & 0x001c0000)
+				continue;
+
+			pc >>= 12;
+			if (!encode)
+				pc = -pc;
+			dest = src + pc;
+			insn &= 0x9000001f;
+			insn |= (dest & 3) << 29;
+			insn |= (dest & 0x0003fffc) << 3;
+			insn |= (-(dest & 0x00020000)) & 0x00e00000;
+		} else {
+			continue;
+		}
+
+		p[i] = insn;
+		p[i + 1] = insn >> 8;
+		p[i + 2] = insn >> 16;
+		p[i + 3] = insn >> 24;
+	}
+}
@@ -0,0 +1,886 @@
+/* SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only */
+
+/*
+ * Small Zstandard (RFC 8878) decoder for firmware use. It supports everything
+ * the reference compressor emits without a dictionary: raw, RLE and compressed
+ * blocks, Huffman coded literals with one or four streams, FSE coded sequences
+ * in all four table modes, repeat offsets, skippable frames and concatenated
+ * frames. Content checksums are skipped, not verified.
+ *
+ * The whole output has to fit into the destination buffer, which is also used
+ * as the history window, so no extra window memory is needed. Literals of a
+ * compressed block are decoded to the end of the destination buffer and moved
+ * into place as the sequences are executed, so no block sized buffer is needed
+ * either. The remaining decoder state (entropy tables) is about 10 KiB and kept
+ * in a static buffer, so this is not reentrant.
+ */
+
+#include <endian.h>
+#include <libpayload.h>
+#include <zstd.h>
+
+#define ZSTD_MAGIC		0xfd2fb528
+#define ZSTD_SKIPPABLE_MAGIC	0x184d2a50	/* Low 4 bits are ignored */
+
+#define ZSTD_BLOCK_RAW		0
+#define ZSTD_BLOCK_RLE		1
+#define ZSTD_BLOCK_COMPRESSED	2
+
+#define ZSTD_LIT_RAW		0
+#define ZSTD_LIT_RLE		1
+#define ZSTD_LIT_COMPRESSED	2
+#define ZSTD_LIT_TREELESS	3
+
+#define ZSTD_MODE_PREDEFINED	0
+#define ZSTD_MODE_RLE		1
+#define ZSTD_MODE_FSE		2
+#define ZSTD_MODE_REPEAT	3
+
+#define HUF_MAX_BITS		11
+#define HUF_MAX_SYMBOLS		256
+
+#define LL_MAX_SYMBOL		35
+#define ML_MAX_SYMBOL		52
+#define OF_MAX_SYMBOL		31
+#define LL_MAX_LOG		9
+#define ML_MAX_LOG		9
+#define OF_MAX_LOG		8
+#define HUF_WEIGHT_MAX_LOG	6
+#define FSE_MAX_SYMBOLS		256
+
+struct fse_entry {
+	uint8_t symbol;
+	uint8_t nbits;
+	uint16_t base;		/* Next state before adding the read bits */
+};
+
+struct huf_entry {
+	uint8_t symbol;
+	uint8_t nbits;
+};
+
+struct fse_table {
+	int log;
+	struct fse_entry *entries;
+};
+
+/* Entropy state that is carried over from block to block within a frame. */
+static struct zstd_state {
+	struct huf_entry huf[1 << HUF_MAX_BITS];
+	int huf_bits;			/* 0 if there is no table yet */
+	struct fse_entry ll_entries[1 << LL_MAX_LOG];
+	struct fse_entry ml_entries[1 << ML_MAX_LOG];
+	struct fse_entry of_entries[1 << OF_MAX_LOG];
+	struct fse_table ll, ml, of;	/* log < 0 if there is no table yet */
+	uint32_t rep[3];
+} zstd;
+
+static const int16_t ll_default[LL_MAX_SYMBOL + 1] = {
+	4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1,
+	2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1,
+	-1, -1, -1, -1,
+};
+
+static const int16_t ml_default[ML_MAX_SYMBOL + 1] = {
+	1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1,
+	-1, -1, -1, -1, -1,
+};
+
+static const int16_t of_default[28 + 1] = {
+	1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1,
+	1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1,
+};
+
+static const uint32_t ll_base[LL_MAX_SYMBOL + 1] = {
+	0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+	16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096,
+	8192, 16384, 32768, 65536,
+};
+
+static const uint8_t ll_bits[LL_MAX_SYMBOL + 1] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12,
+	13, 14, 15, 16,
+};
+
+static const uint32_t ml_base[ML_MAX_SYMBOL + 1] = {
+	3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18,
+	19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+	35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051,
+	4099, 8195, 16387, 32771, 65539,
+};
+
+static const uint8_t ml_bits[ML_MAX_SYMBOL + 1] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11,
+	12, 13, 14, 15, 16,
+};
+
+static inline int highbit(uint32_t v)
+{
+	return 31 - __builtin_clz(v);
+}
+
+static inline uint32_t read_le16p(const uint8_t *p)
+{
+	return p[0] | p[1] << 8;
+}
+
+static inline uint32_t read_le24p(const uint8_t *p)
+{
+	return p[0] | p[1] << 8 | p[2] << 16;
+}
+
+static inline uint32_t read_le32p(const uint8_t *p)
+{
+	return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+/*
+ * Bit streams. Entropy coded data is read backwards: |pos| counts the bits that
+ * are left, the next bits to read are the ones right below it. Reading past
+ * the start of the stream yields zeroes and makes |pos| negative, which the
+ * callers check for where the format requires an exactly consumed stream.
+ */
+struct bits {
+	const uint8_t *start;
+	size_t size;
+	intptr_t pos;
+};
+
+static inline uint64_t bits_load(const struct bits *b, size_t byte)
+{
+	uint64_t v = 0;
+	size_t i;
+
+	if (byte + 8 <= b->size) {
+		memcpy(&v, b->start + byte, sizeof(v));
+		return le64toh(v);
+	}
+
+	for (i = 0; byte + i < b->size; i++)
+		v |= (uint64_t)b->start[byte + i] << (8 * i);
+	return v;
+}
+
+/* Returns the |n| (<= 32) bits below the current position. */
+static inline uint32_t bits_peek(const struct bits *b, int n)
+{
+	intptr_t lo = b->pos - n;
+
+	if (n == 0)
+		return 0;
+	if (lo >= 0)
+		return (bits_load(b, lo >> 3) >> (lo & 7)) & ((1ULL << n) - 1);
+	if (b->pos <= 0)
+		return 0;
+	return (bits_load(b, 0) & ((1ULL << b->pos) - 1)) << -lo;
+}
+
+static inline uint32_t bits_read(struct bits *b, int n)
+{
+	uint32_t v = bits_peek(b, n);
+	b->pos -= n;
+	return v;
+}
+
+/* Sets up a backward stream, skipping the padding down to the end marker. */
+static int bits_init(struct bits *b, const uint8_t *src, size_t size)
+{
+	if (size == 0 || src[size - 1] == 0)
+		return -1;
+	b->start = src;
+	b->size = size;
+	b->pos = (intptr_t)(size - 1) * 8 + highbit(src[size - 1]);
+	return 0;
+}
+
+/* Forward stream used for FSE table descriptions, |pos| counts read bits. */
+static inline uint32_t fwd_read(const struct bits *b, intptr_t pos, int n)
+{
+	return (bits_load(b, pos >> 3) >> (pos & 7)) & ((1ULL << n) - 1);
+}
+
+/*
+ * Reads an FSE table description from |src| into |probs|. Returns the number
+ * of bytes used, or 0 on error.
+ */
+static size_t fse_read_probs(const uint8_t *src, size_t srcn, int16_t *probs,
+			     int *max_symbol, int *log, int max_log)
+{
+	struct bits b = { .start = src, .size = srcn };
+	intptr_t pos = 4;
+	int remaining, threshold, nbits;
+	int symbol = 0;
+	int previous0 = 0;
+
+	if (srcn == 0)
+		return 0;
+
+	*log = fwd_read(&b, 0, 4) + 5;
+	if (*log > max_log)
+		return 0;
+
+	remaining = (1 << *log) + 1;
+	threshold = 1 << *log;
+	nbits = *log + 1;
+
+	while (remaining > 1 && symbol <= *max_symbol) {
+		if (previous0) {
+			int repeat;
+			do {
+				repeat = fwd_read(&b, pos, 2);
+				pos += 2;
+				for (int i = 0; i < repeat; i++) {
+					if (symbol > *max_symbol)
+						return 0;
+					probs[symbol++] = 0;
+				}
+			} while (repeat == 3);
+			if (symbol > *max_symbol)
+				return 0;
+		}
+
+		int max = (2 * threshold - 1) - remaining;
+		int count = fwd_read(&b, pos, nbits);
+
+		if ((count & (threshold - 1)) < max) {
+			count &= threshold - 1;
+			pos += nbits - 1;
+		} else {
+			if (count >= threshold)
+				count -= max;
+			pos += nbits;
+		}
+
+		count--;	/* -1 means "less than 1" */
+		remaining -= count < 0 ? -count : count;
+		probs[symbol++] = count;
+		previous0 = count == 0;
+
+		while (remaining < threshold) {
+			nbits--;
+			threshold >>= 1;
+		}
+	}
+
+	if (remaining != 1 || (size_t)(pos + 7) / 8 > srcn)
+		return 0;
+
+	*max_symbol = symbol - 1;
+	return (pos + 7) / 8;
+}
+
+static int fse_build(struct fse_table *t, struct fse_entry *entries,
+		     const int16_t *probs, int max_symbol, int log)
+{
+	uint16_t next[FSE_MAX_SYMBOLS];
+	const int size = 1 << log;
+	const int step = (size >> 1) + (size >> 3) + 3;
+	int high = size - 1;
+	int position = 0;
+	int s, i;
+
+	for (s = 0; s <= max_symbol; s++) {
+		if (probs[s] == -1) {
+			entries[high--].symbol = s;
+			next[s] = 1;
+		} else {
+			next[s] = probs[s];
+		}
+	}
+
+	for (s = 0; s <= max_symbol; s++) {
+		for (i = 0; i < probs[s]; i++) {
+			entries[position].symbol = s;
+			do {
+				position = (position + step) & (size - 1);
+			} while (position > high);
+		}
+	}
+	if (position != 0)
+		return -1;
+
+	for (i = 0; i < size; i++) {
+		uint16_t state = next[entries[i].symbol]++;
+		entries[i].nbits = log - highbit(state);
+		entries[i].base = (state << entries[i].nbits) - size;
+	}
+
+	t->log = log;
+	t->entries = entries;
+	return 0;
+}
+
+static void fse_build_rle(struct fse_table *t, struct fse_entry *entries,
+			  uint8_t symbol)
+{
+	entries[0].symbol = symbol;
+	entries[0].nbits = 0;
+	entries[0].base = 0;
+	t->log = 0;
+	t->entries = entries;
+}
+
+static inline uint8_t fse_symbol(const struct fse_table *t, uint32_t state)
+{
+	return t->entries[state].symbol;
+}
+
+static inline uint32_t fse_update(const struct fse_table *t, uint32_t state,
+				  struct bits *b)
+{
+	const struct fse_entry *e = &t->entries[state];
+	return e->base + bits_read(b, e->nbits);
+}
+
+/*
+ * Reads a Huffman tree description and builds the decoding table. Returns the
+ * number of bytes used, or 0 on error.
+ */
+static size_t huf_read_table(const uint8_t *src, size_t srcn)
+{
+	uint8_t weights[HUF_MAX_SYMBOLS];
+	uint32_t rank_start[HUF_MAX_BITS + 2];
+	size_t num, used;
+	uint32_t total = 0;
+	int max_bits, w;
+	size_t i;
+
+	if (srcn == 0)
+		return 0;
+
+	if (src[0] >= 128) {
+		num = src[0] - 127;
+		used = 1 + (num + 1) / 2;
+		if (used > srcn)
+			return 0;
+		for (i = 0; i < num; i++) {
+			uint8_t byte = src[1 + i / 2];
+			weights[i] = i % 2 ? byte & 0xf : byte >> 4;
+		}
+	} else {
+		struct fse_entry entries[1 << HUF_WEIGHT_MAX_LOG];
+		int16_t probs[16];
+		int max_symbol = 15;
+		int log;
+		struct fse_table t;
+		struct bits b;
+		size_t hdr;
+
+		used = 1 + src[0];
+		if (used > srcn)
+			return 0;
+		hdr = fse_read_probs(src + 1, src[0], probs, &max_symbol, &log,
+				     HUF_WEIGHT_MAX_LOG);
+		if (!hdr || fse_build(&t, entries, probs, max_symbol, log))
+			return 0;
+		if (bits_init(&b, src + 1 + hdr, src[0] - hdr))
+			return 0;
+
+		uint32_t s1 = bits_read(&b, log);
+		uint32_t s2 = bits_read(&b, log);
+		num = 0;
+		while (num < HUF_MAX_SYMBOLS - 2) {
+			weights[num++] = fse_symbol(&t, s1);
+			s1 = fse_update(&t, s1, &b);
+			if (b.pos < 0) {
+				weights[num++] = fse_symbol(&t, s2);
+				break;
+			}
+			weights[num++] = fse_symbol(&t, s2);
+			s2 = fse_update(&t, s2, &b);
+			if (b.pos < 0) {
+				weights[num++] = fse_symbol(&t, s1);
+				break;
+			}
+		}
+		if (b.pos >= 0)
+			return 0;
+	}
+
+	if (num >= HUF_MAX_SYMBOLS)
+		return 0;
+
+	for (i = 0; i < num; i++) {
+		if (weights[i] > HUF_MAX_BITS)
+			return 0;
+		if (weights[i])
+			total += 1 << (weights[i] - 1);
+	}
+	if (total == 0)
+		return 0;
+
+	/* The last weight is implied by filling up to a power of two. */
+	max_bits = highbit(total) + 1;
+	uint32_t left = (1 << max_bits) - total;
+	if (max_bits > HUF_MAX_BITS || (left & (left - 1)))
+		return 0;
+	weights[num++] = highbit(left) + 1;
+
+	/* Codes are handed out from the lowest weight (longest code) up. */
+	rank_start[1] = 0;
+	for (w = 1; w <= max_bits; w++) {
+		uint32_t count = 0;
+		for (i = 0; i < num; i++)
+			if (weights[i] == w)
+				count++;
+		rank_start[w + 1] = rank_start[w] + (count << (w - 1));
+	}
+
+	for (i = 0; i < num; i++) {
+		w = weights[i];
+		if (!w)
+			continue;
+		uint32_t start = rank_start[w];
+		uint32_t len = 1 << (w - 1);
+		for (uint32_t j = start; j < start + len; j++) {
+			zstd.huf[j].symbol = i;
+			zstd.huf[j].nbits = max_bits + 1 - w;
+		}
+		rank_start[w] += len;
+	}
+
+	zstd.huf_bits = max_bits;
+	return used;
+}
+
+static int huf_decode_stream(const uint8_t *src, size_t srcn, uint8_t *dst,
+			     size_t dstn)
+{
+	const int max_bits = zstd.huf_bits;
+	struct bits b;
+	size_t i;
+
+	if (bits_init(&b, src, srcn))
+		return -1;
+
+	for (i = 0; i < dstn; i++) {
+		const struct huf_entry *e = &zstd.huf[bits_peek(&b, max_bits)];
+		dst[i] = e->symbol;
+		b.pos -= e->nbits;
+	}
+
+	return b.pos == 0 ? 0 : -1;
+}
+
+/*
+ * Decodes the literals section at |src| to |*lit|, which either points into
+ * |src| for raw literals or to the end of the output buffer. Returns the number
+ * of bytes used, or 0 on error.
+ */
+static size_t decode_literals(const uint8_t *src, size_t srcn, uint8_t *out_end,
+			      size_t out_space, const uint8_t **lit,
+			      size_t *lit_size)
+{
+	const int type = src[0] & 3;
+	const int format = (src[0] >> 2) & 3;
+	size_t hdr, regen, comp;
+	int streams = 1;
+	uint8_t *buf;
+
+	if (type == ZSTD_LIT_RAW || type == ZSTD_LIT_RLE) {
+		if (format == 0 || format == 2) {
+			hdr = 1;
+			regen = src[0] >> 3;
+		} else if (format == 1) {
+			hdr = 2;
+			if (srcn < hdr)
+				return 0;
+			regen = read_le16p(src) >> 4;
+		} else {
+			hdr = 3;
+			if (srcn < hdr)
+				return 0;
+			regen = read_le24p(src) >> 4;
+		}
+
+		if (type == ZSTD_LIT_RAW) {
+			if (srcn - hdr < regen)
+				return 0;
+			*lit = src + hdr;
+			*lit_size = regen;
+			return hdr + regen;
+		}
+
+		if (srcn < hdr + 1 || regen > out_space)
+			return 0;
+		buf = out_end - regen;
+		memset(buf, src[hdr], regen);
+		*lit = buf;
+		*lit_size = regen;
+		return hdr + 1;
+	}
+
+	if (format == 0 || format == 1) {
+		hdr = 3;
+		if (srcn < hdr)
+			return 0;
+		uint32_t v = read_le24p(src);
+		regen = (v >> 4) & 0x3ff;
+		comp = v >> 14;
+		streams = format == 0 ? 1 : 4;
+	} else if (format == 2) {
+		hdr = 4;
+		if (srcn < hdr)
+			return 0;
+		uint32_t v = read_le32p(src);
+		regen = (v >> 4) & 0x3fff;
+		comp = v >> 18;
+		streams = 4;
+	} else {
+		hdr = 5;
+		if (srcn < hdr)
+			return 0;
+		uint64_t v = read_le32p(src) | (uint64_t)src[4] << 32;
+		regen = (v >> 4) & 0x3ffff;
+		comp = v >> 22;
+		streams = 4;
+	}
+
+	if (srcn - hdr < comp || regen > out_space)
+		return 0;
+	const size_t used_total = hdr + comp;
+	src += hdr;
+
+	if (type == ZSTD_LIT_COMPRESSED) {
+		size_t used = huf_read_table(src, comp);
+		if (!used)
+			return 0;
+		src += used;
+		comp -= used;
+	} else if (!zstd.huf_bits) {
+		return 0;
+	}
+
+	buf = out_end - regen;
+	if (streams == 1) {
+		if (huf_decode_stream(src, comp, buf, regen))
+			return 0;
+	} else {
+		size_t sizes[4];
+		size_t part = (regen + 3) / 4;
+		int i;
+
+		if (comp < 6 || regen < 3 * part)
+			return 0;
+		sizes[0] = read_le16p(src);
+		sizes[1] = read_le16p(src + 2);
+		sizes[2] = read_le16p(src + 4);
+		if (sizes[0] + sizes[1] + sizes[2] > comp - 6)
+			return 0;
+		sizes[3] = comp - 6 - sizes[0] - sizes[1] - sizes[2];
+
+		const uint8_t *in = src + 6;
+		for (i = 0; i < 4; i++) {
+			size_t n = i < 3 ? part : regen - 3 * part;
+			if (huf_decode_stream(in, sizes[i], buf + i * part, n))
+				return 0;
+			in += sizes[i];
+		}
+	}
+
+	*lit = buf;
+	*lit_size = regen;
+	return used_total;
+}
+
+static size_t read_seq_table(const uint8_t *src, size_t srcn, int mode,
+			     struct fse_table *t, struct fse_entry *entries,
+			     const int16_t *def, int def_max, int def_log,
+			     int max_symbol, int max_log, int *err)
+{
+	int16_t probs[FSE_MAX_SYMBOLS];
+	int log;
+	size_t used;
+
+	switch (mode) {
+	case ZSTD_MODE_PREDEFINED:
+		if (fse_build(t, entries, def, def_max, def_log))
+			*err = 1;
+		return 0;
+	case ZSTD_MODE_RLE:
+		if (srcn < 1 || src[0] > max_symbol) {
+			*err = 1;
+			return 0;
+		}
+		fse_build_rle(t, entries, src[0]);
+		return 1;
+	case ZSTD_MODE_FSE:
+		used = fse_read_probs(src, srcn, probs, &max_symbol, &log,
+				      max_log);
+		if (!used || fse_build(t, entries, probs, max_symbol, log))
+			*err = 1;
+		return used;
+	default:
+		if (t->log < 0)
+			*err = 1;
+		return 0;
+	}
+}
+
+static int decode_sequences(const uint8_t *src, size_t srcn, uint8_t *dst,
+			    size_t *op, size_t frame_start, size_t dstn,
+			    const uint8_t *lit, size_t lit_size)
+{
+	size_t nseq, pos = 0;
+	int err = 0;
+
+	if (srcn < 1)
+		return -1;
+	if (src[0] < 128) {
+		nseq = src[0];
+		pos = 1;
+	} else if (src[0] < 255) {
+		if (srcn < 2)
+			return -1;
+		nseq = ((src[0] - 128) << 8) + src[1];
+		pos = 2;
+	} else {
+		if (srcn < 3)
+			return -1;
+		nseq = src[1] + (src[2] << 8) + 0x7f00;
+		pos = 3;
+	}
+
+	if (nseq > 0) {
+		if (srcn < pos + 1 || (src[pos] & 3))
+			return -1;
+		const uint8_t modes = src[pos++];
+
+		pos += read_seq_table(src + pos, srcn - pos, modes >> 6,
+				      &zstd.ll, zstd.ll_entries, ll_default,
+				      LL_MAX_SYMBOL, 6, LL_MAX_SYMBOL,
+				      LL_MAX_LOG, &err);
+		pos += read_seq_table(src + pos, srcn - pos, (modes >> 4) & 3,
+				      &zstd.of, zstd.of_entries, of_default,
+				      ARRAY_SIZE(of_default) - 1, 5,
+				      OF_MAX_SYMBOL, OF_MAX_LOG, &err);
+		pos += read_seq_table(src + pos, srcn - pos, (modes >> 2) & 3,
+				      &zstd.ml, zstd.ml_entries, ml_default,
+				      ML_MAX_SYMBOL, 6, ML_MAX_SYMBOL,
+				      ML_MAX_LOG, &err);
+		if (err || pos > srcn)
+			return -1;
+	}
+
+	size_t o = *op;
+	size_t lit_pos = 0;
+
+	if (nseq > 0) {
+		struct bits b;
+
+		if (bits_init(&b, src + pos, srcn - pos))
+			return -1;
+
+		uint32_t ll_state = bits_read(&b, zstd.ll.log);
+		uint32_t of_state = bits_read(&b, zstd.of.log);
+		uint32_t ml_state = bits_read(&b, zstd.ml.log);
+
+		while (nseq--) {
+			const uint8_t of_code = fse_symbol(&zstd.of, of_state);
+			const uint8_t ml_code = fse_symbol(&zstd.ml, ml_state);
+			const uint8_t ll_code = fse_symbol(&zstd.ll, ll_state);
+			uint32_t offset, ml, ll;
+
+			if (of_code > OF_MAX_SYMBOL || ml_code > ML_MAX_SYMBOL ||
+			    ll_code > LL_MAX_SYMBOL)
+				return -1;
+
+			offset = (1U << of_code) + bits_read(&b, of_code);
+			ml = ml_base[ml_code] + bits_read(&b, ml_bits[ml_code]);
+			ll = ll_base[ll_code] + bits_read(&b, ll_bits[ll_code]);
+
+			if (offset > 3) {
+				offset -= 3;
+				zstd.rep[2] = zstd.rep[1];
+				zstd.rep[1] = zstd.rep[0];
+				zstd.rep[0] = offset;
+			} else {
+				uint32_t idx = offset - 1 + (ll == 0);
+				if (idx == 0) {
+					offset = zstd.rep[0];
+				} else {
+					offset = idx < 3 ? zstd.rep[idx] :
+						 zstd.rep[0] - 1;
+					if (idx != 1)
+						zstd.rep[2] = zstd.rep[1];
+					zstd.rep[1] = zstd.rep[0];
+					zstd.rep[0] = offset;
+				}
+			}
+
+			if (nseq) {
+				ll_state = fse_update(&zstd.ll, ll_state, &b);
+				ml_state = fse_update(&zstd.ml, ml_state, &b);
+				of_state = fse_update(&zstd.of, of_state, &b);
+			}
+
+			if (ll > lit_size - lit_pos || ll > dstn - o ||
+			    ml > dstn - o - ll ||
+			    offset == 0 || offset > o + ll - frame_start)
+				return -1;
+
+			/* Literals may overlap with their destination. */
+			memmove(dst + o, lit + lit_pos, ll);
+			o += ll;
+			lit_pos += ll;
+
+			const uint8_t *match = dst + o - offset;
+			if (offset >= ml) {
+				memcpy(dst + o, match, ml);
+			} else {
+				for (uint32_t i = 0; i < ml; i++)
+					dst[o + i] = match[i];
+			}
+			o += ml;
+		}
+
+		if (b.pos != 0)
+			return -1;
+	}
+
+	if (lit_size - lit_pos > dstn - o)
+		return -1;
+	memmove(dst + o, lit + lit_pos, lit_size - lit_pos);
+	o += lit_size - lit_pos;
+
+	*op = o;
+	return 0;
+}
+
+static int decode_block(const uint8_t *src, size_t srcn, uint8_t *dst,
+			size_t *op, size_t frame_start, size_t dstn)
+{
+	const uint8_t *lit;
+	size_t lit_size, used;
+
+	if (srcn == 0)
+		return -1;
+
+	used = decode_literals(src, srcn, dst + dstn, dstn - *op, &lit,
+			       &lit_size);
+	if (!used)
+		return -1;
+
+	return decode_sequences(src + used, srcn - used, dst, op, frame_start,
+				dstn, lit, lit_size);
+}
+
+/* Decodes one frame, returns the number of input bytes used or 0 on error. */
+static size_t decode_frame(const uint8_t *src, size_t srcn, uint8_t *dst,
+			   size_t *op, size_t dstn)
+{
+	static const uint8_t did_size[4] = { 0, 1, 2, 4 };
+	static const uint8_t fcs_size[4] = { 0, 2, 4, 8 };
+	const size_t frame_start = *op;
+	size_t pos = 4;
+	int last = 0;
+
+	if (srcn < 5)
+		return 0;
+
+	const uint8_t fhd = src[pos++];
+	const int single_segment = (fhd >> 5) & 1;
+	const int checksum = (fhd >> 2) & 1;
+	size_t fcs_bytes = fcs_size[fhd >> 6];
+
+	if (fhd & 0x08)		/* Reserved bit */
+		return 0;
+	if (!single_segment)
+		pos++;		/* Window descriptor, we use the whole output */
+	if (fcs_bytes == 0 && single_segment)
+		fcs_bytes = 1;
+
+	if (pos + did_size[fhd & 3] + fcs_bytes > srcn)
+		return 0;
+	for (int i = 0; i < did_size[fhd & 3]; i++)
+		if (src[pos + i])	/* Dictionaries are not supported */
+			return 0;
+	pos += did_size[fhd & 3] + fcs_bytes;
+
+	zstd.huf_bits = 0;
+	zstd.ll.log = zstd.ml.log = zstd.of.log = -1;
+	zstd.rep[0] = 1;
+	zstd.rep[1] = 4;
+	zstd.rep[2] = 8;
+
+	while (!last) {
+		if (srcn - pos < 3)
+			return 0;
+		const uint32_t bh = read_le24p(src + pos);
+		const size_t size = bh >> 3;
+		pos += 3;
+		last = bh & 1;
+
+		switch ((bh >> 1) & 3) {
+		case ZSTD_BLOCK_RAW:
+			if (srcn - pos < size || dstn - *op < size)
+				return 0;
+			memcpy(dst + *op, src + pos, size);
+			*op += size;
+			pos += size;
+			break;
+		case ZSTD_BLOCK_RLE:
+			if (srcn - pos < 1 || dstn - *op < size)
+				return 0;
+			memset(dst + *op, src[pos], size);
+			*op += size;
+			pos += 1;
+			break;
+		case ZSTD_BLOCK_COMPRESSED:
+			if (srcn - pos < size ||
+			    decode_block(src + pos, size, dst, op, frame_start,
+					 dstn))
+				return 0;
+			pos += size;
+			break;
+		default:
+			return 0;
+		}
+	}
+
+	if (checksum) {
+		if (srcn - pos < 4)
+			return 0;
+		pos += 4;
+	}
+
+	return pos;
+}
+
+size_t uzstdn(const void *src, size_t srcn, void *dst, size_t dstn)
+{
+	const uint8_t *in = src;
+	size_t pos = 0;
+	size_t out = 0;
+
+	while (srcn - pos >= 4) {
+		const uint32_t magic = read_le32p(in + pos);
+		size_t used;
+
+		if ((magic & ~0xfU) == ZSTD_SKIPPABLE_MAGIC) {
+			if (srcn - pos < 8)
+				return 0;
+			used = 8 + (size_t)read_le32p(in + pos + 4);
+			if (used > srcn - pos)
+				return 0;
+		} else if (magic == ZSTD_MAGIC) {
+			used = decode_frame(in + pos, srcn - pos, dst, &out,
+					    dstn);
+			if (!used)
+				return 0;
+		} else {
+			return 0;
+		}
+		pos += used;
+	}
+
+	if (pos != srcn)
+		return 0;
+
+	return out;
+}
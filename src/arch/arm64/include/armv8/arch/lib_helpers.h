@@ -162,6 +162,7 @@ MAKE_REGISTER_ACCESSORS(hacr_el2)
 MAKE_REGISTER_ACCESSORS(hcr_el2)
 MAKE_REGISTER_ACCESSORS(hpfar_el2)
 MAKE_REGISTER_ACCESSORS(hstr_el2)
+MAKE_REGISTER_ACCESSORS(id_aa64isar0_el1)
 MAKE_REGISTER_ACCESSORS(isr_el1)
 MAKE_REGISTER_ACCESSORS_EL123(mair)
 MAKE_REGISTER_ACCESSORS_EL123(mdcr)
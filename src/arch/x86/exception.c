@@ -377,6 +377,11 @@ void x86_exception(struct eregs *info);
 
 void x86_exception(struct eregs *info)
 {
+	if (CONFIG(SAMPLING_PROFILER) && ENV_RAMSTAGE && info->vector == PROFILER_VECTOR) {
+		lapic_profiler_interrupt(info);
+		return;
+	}
+
 #if CONFIG(GDB_STUB)
 	int signo;
 	memcpy(gdb_stub_registers, info, 8*sizeof(uint32_t));
@@ -590,7 +595,14 @@ static const uintptr_t intr_entries[] = {
 	(uintptr_t)vec16, (uintptr_t)vec17, (uintptr_t)vec18, (uintptr_t)vec19,
 };
 
-static struct intr_gate idt[ARRAY_SIZE(intr_entries)] __aligned(8);
+#if CONFIG(SAMPLING_PROFILER) && ENV_RAMSTAGE
+extern u8 vec_profiler[];
+#define IDT_ENTRIES (PROFILER_VECTOR + 1)
+#else
+#define IDT_ENTRIES ARRAY_SIZE(intr_entries)
+#endif
+
+static struct intr_gate idt[IDT_ENTRIES] __aligned(8);
 
 static inline uint16_t get_cs(void)
 {
@@ -637,6 +649,17 @@ static void load_idt(void *table, size_t sz)
 		memcpy(&idtarg, &lidtarg, sizeof(idtarg));
 }
 
+static void set_gate(struct intr_gate *gate, uintptr_t entry, uint16_t segment)
+{
+	gate->offset_0 = entry;
+	gate->segsel = segment;
+	gate->flags = IGATE_FLAGS;
+	gate->offset_1 = entry >> 16;
+#if ENV_X86_64
+	gate->offset_2 = entry >> 32;
+#endif
+}
+
 asmlinkage void exception_init(void)
 {
 	int i;
@@ -645,15 +668,13 @@ asmlinkage void exception_init(void)
 	segment = get_cs();
 
 	/* Initialize IDT. */
-	for (i = 0; i < ARRAY_SIZE(idt); i++) {
-		idt[i].offset_0 = intr_entries[i];
-		idt[i].segsel = segment;
-		idt[i].flags = IGATE_FLAGS;
-		idt[i].offset_1 = intr_entries[i] >> 16;
-#if ENV_X86_64
-		idt[i].offset_2 = intr_entries[i] >> 32;
+	for (i = 0; i < ARRAY_SIZE(intr_entries); i++)
+		set_gate(&idt[i], intr_entries[i], segment);
+
+#if CONFIG(SAMPLING_PROFILER) && ENV_RAMSTAGE
+	/* The gates in between stay not present. */
+	set_gate(&idt[PROFILER_VECTOR], (uintptr_t)vec_profiler, segment);
 #endif
-	}
 
 	load_idt(idt, sizeof(idt));
 }
@@ -3,7 +3,12 @@
 #ifndef _ARCH_EXCEPTION_H
 #define _ARCH_EXCEPTION_H
 
+/* Vector of the sampling profiler's timer interrupt, above the i8259's 0x20-0x2f. */
+#define PROFILER_VECTOR		0x30
+
+#if !defined(__ASSEMBLER__)
 #include <arch/cpu.h>
+#include <arch/registers.h>
 
 #if CONFIG(IDT_IN_EVERY_STAGE) || ENV_RAMSTAGE
 asmlinkage void exception_init(void);
@@ -11,4 +16,8 @@ asmlinkage void exception_init(void);
 static inline void exception_init(void) { /* not implemented */ }
 #endif
 
+/* Handles PROFILER_VECTOR, see src/cpu/x86/lapic/lapic_profiler.c. */
+void lapic_profiler_interrupt(struct eregs *info);
+#endif
+
 #endif
@@ -2,6 +2,7 @@
 
 #include <assert.h>
 #include <commonlib/bsd/cbfs_private.h>
+#include <string.h>
 
 /*
  * A CBFS metadata cache is an in memory data structure storing CBFS file headers (= metadata).
@@ -20,11 +21,22 @@
  * metadata (entry->file.h.offset). The next mcache_entry begins at the next
  * CBFS_MCACHE_ALIGNMENT boundary after that. The cache is terminated by a special 4-byte
  * mcache_entry that consists only of a magic number (MCACHE_MAGIC_END or MCACHE_MAGIC_FULL).
+ *
+ * The last 8 bytes of the (aligned) cache area always hold a struct mcache_index trailer,
+ * which is directly preceded by an array of |num_slots| struct mcache_index_slot. This is an
+ * open-addressed (linear probing) hash table with a power-of-two number of slots that maps a
+ * 32-bit hash of each file name to the offset of its mcache_entry relative to the start of the
+ * cache, so that lookups can find a file in constant time instead of comparing every entry.
+ * If the table didn't fit between the terminating magic and the trailer (or the cache itself
+ * overflowed), |num_slots| is 0 and lookups fall back to walking the entries linearly.
  */
 
 #define MCACHE_MAGIC_FILE	0x454c4946	/* 'FILE' */
 #define MCACHE_MAGIC_FULL	0x4c4c5546	/* 'FULL' */
 #define MCACHE_MAGIC_END	0x444e4524	/* '$END' */
+#define MCACHE_MAGIC_INDEX	0x58444e49	/* 'INDX' */
+
+#define MCACHE_INDEX_EMPTY	0xffffffff
 
 union mcache_entry {
 	union cbfs_mdata file;
@@ -34,6 +46,107 @@ union mcache_entry {
 	};
 };
 
+struct mcache_index_slot {
+	uint32_t hash;
+	uint32_t offset;	/* Offset of the mcache_entry from the start of the mcache */
+};
+
+struct mcache_index {
+	uint32_t num_slots;	/* 0 or a power of two */
+	uint32_t magic;
+};
+
+/* 32-bit FNV-1a hash of a file name, up to |max_len| bytes or the terminating '\0'. */
+static uint32_t mcache_name_hash(const char *name, size_t max_len)
+{
+	uint32_t hash = 0x811c9dc5;
+
+	while (max_len-- && *name) {
+		hash ^= (uint8_t)*name++;
+		hash *= 0x01000193;
+	}
+
+	return hash;
+}
+
+static struct mcache_index *mcache_index_trailer(const void *mcache, size_t mcache_size)
+{
+	return (void *)mcache + ALIGN_DOWN(mcache_size, CBFS_MCACHE_ALIGNMENT) -
+	       sizeof(struct mcache_index);
+}
+
+static size_t mcache_index_size(const struct mcache_index *index)
+{
+	return index->num_slots * sizeof(struct mcache_index_slot) + sizeof(*index);
+}
+
+/* Returns the trailer of the index in |mcache|, or NULL if it does not have a valid one. */
+static const struct mcache_index *mcache_find_index(const void *mcache, size_t mcache_size)
+{
+	const struct mcache_index *index;
+
+	if (ALIGN_DOWN(mcache_size, CBFS_MCACHE_ALIGNMENT) < sizeof(*index))
+		return NULL;
+
+	index = mcache_index_trailer(mcache, mcache_size);
+	if (index->magic != MCACHE_MAGIC_INDEX ||
+	    (index->num_slots & (index->num_slots - 1)) != 0 ||
+	    (const void *)index - mcache < index->num_slots * sizeof(struct mcache_index_slot))
+		return NULL;
+
+	return index;
+}
+
+static const struct mcache_index_slot *mcache_index_slots(const struct mcache_index *index)
+{
+	return (const struct mcache_index_slot *)index - index->num_slots;
+}
+
+/*
+ * Fill in the hash table for the |count| entries in |mcache| which are terminated by the
+ * MCACHE_MAGIC_END entry at |term|, if it fits in front of the |index| trailer.
+ */
+static void mcache_build_index(void *mcache, union mcache_entry *term, int count,
+			       struct mcache_index *index)
+{
+	const void *free_space = (void *)term + sizeof(term->magic);
+	struct mcache_index_slot *slots;
+	const union mcache_entry *entry;
+	uint32_t num_slots = 1;
+	uint32_t i;
+
+	/* Keep the load factor at or below 50% to keep probe sequences short. */
+	while (num_slots < 2 * count)
+		num_slots <<= 1;
+
+	if ((void *)index - free_space < num_slots * sizeof(*slots)) {
+		LOG("No space for %u slot mcache index, lookups will be slower\n", num_slots);
+		return;
+	}
+
+	slots = (struct mcache_index_slot *)index - num_slots;
+	for (i = 0; i < num_slots; i++)
+		slots[i].offset = MCACHE_INDEX_EMPTY;
+
+	for (entry = mcache; entry != term;
+	     entry = (const void *)entry + ALIGN_UP(be32toh(entry->file.h.offset),
+						    CBFS_MCACHE_ALIGNMENT)) {
+		const size_t name_max = be32toh(entry->file.h.offset) -
+					offsetof(union cbfs_mdata, h.filename);
+		const uint32_t hash = mcache_name_hash(entry->file.h.filename, name_max);
+
+		/* Insert in CBFS order so that the first of several files with the same
+		   name is found first, just like with a linear walk. */
+		for (i = hash & (num_slots - 1); slots[i].offset != MCACHE_INDEX_EMPTY;
+		     i = (i + 1) & (num_slots - 1))
+			;
+		slots[i].hash = hash;
+		slots[i].offset = (const void *)entry - mcache;
+	}
+
+	index->num_slots = num_slots;
+}
+
 struct cbfs_mcache_build_args {
 	void *mcache;
 	void *end;
@@ -68,33 +181,84 @@ cb_err_t cbfs_mcache_build(cbfs_dev_t dev, void *mcache, size_t size,
 	struct cbfs_mcache_build_args args = {
 		.mcache = mcache,
 		.end = mcache + ALIGN_DOWN(size, CBFS_MCACHE_ALIGNMENT)
-		       - sizeof(uint32_t), /* leave space for terminating magic */
+		       - sizeof(uint32_t)	/* leave space for terminating magic */
+		       - sizeof(struct mcache_index),	/* and for the index trailer */
 		.count = 0,
 	};
+	struct mcache_index *index = mcache_index_trailer(mcache, size);
+
+	assert(size > sizeof(uint32_t) + sizeof(*index) &&
+	       IS_ALIGNED((uintptr_t)mcache, CBFS_MCACHE_ALIGNMENT));
+	index->magic = MCACHE_MAGIC_INDEX;
+	index->num_slots = 0;
 
-	assert(size > sizeof(uint32_t) && IS_ALIGNED((uintptr_t)mcache, CBFS_MCACHE_ALIGNMENT));
 	cb_err_t ret = cbfs_walk(dev, build_walker, &args, metadata_hash, 0);
 	union mcache_entry *entry = args.mcache;
 	if (ret == CB_CBFS_NOT_FOUND) {
 		ret = CB_SUCCESS;
 		entry->magic = MCACHE_MAGIC_END;
+		mcache_build_index(mcache, entry, args.count, index);
 	} else if (ret == CB_CBFS_CACHE_FULL) {
 		ERROR("mcache overflow, should increase CBFS_MCACHE size!\n");
 		entry->magic = MCACHE_MAGIC_FULL;
 	}
 
 	LOG("mcache @%p built for %d files, used %#zx of %#zx bytes\n", mcache,
-	    args.count, args.mcache + sizeof(entry->magic) - mcache, size);
+	    args.count, cbfs_mcache_real_size(mcache, size), size);
 	return ret;
 }
 
+/* If |entry| is the file |name|, copy out its metadata and data offset and return true. */
+static bool mcache_entry_match(const union mcache_entry *entry, const char *name,
+			       size_t namesize, union cbfs_mdata *mdata_out,
+			       size_t *data_offset_out)
+{
+	assert(entry->magic == MCACHE_MAGIC_FILE);
+	const uint32_t data_offset = be32toh(entry->file.h.offset);
+	const uint32_t data_length = be32toh(entry->file.h.len);
+	if (namesize > data_offset - offsetof(union cbfs_mdata, h.filename) ||
+	    memcmp(name, entry->file.h.filename, namesize) != 0)
+		return false;
+
+	LOG("Found '%s' @%#x size %#x in mcache @%p\n",
+	    name, entry->offset, data_length, entry);
+	*data_offset_out = entry->offset + data_offset;
+	memcpy(mdata_out, &entry->file, data_offset);
+	return true;
+}
+
+static cb_err_t mcache_lookup_index(const void *mcache, const struct mcache_index *index,
+				    const char *name, size_t namesize,
+				    union cbfs_mdata *mdata_out, size_t *data_offset_out)
+{
+	const struct mcache_index_slot *slots = mcache_index_slots(index);
+	const uint32_t mask = index->num_slots - 1;
+	const uint32_t hash = mcache_name_hash(name, namesize);
+	uint32_t i;
+
+	for (i = hash & mask; slots[i].offset != MCACHE_INDEX_EMPTY; i = (i + 1) & mask) {
+		if (slots[i].hash != hash)
+			continue;
+		if (mcache_entry_match(mcache + slots[i].offset, name, namesize,
+				       mdata_out, data_offset_out))
+			return CB_SUCCESS;
+	}
+
+	return CB_CBFS_NOT_FOUND;
+}
+
 cb_err_t cbfs_mcache_lookup(const void *mcache, size_t mcache_size, const char *name,
 			    union cbfs_mdata *mdata_out, size_t *data_offset_out)
 {
 	const size_t namesize = strlen(name) + 1; /* Count trailing \0 so we can memcmp() it. */
+	const struct mcache_index *index = mcache_find_index(mcache, mcache_size);
 	const void *end = mcache + mcache_size;
 	const void *current = mcache;
 
+	if (index && index->num_slots)
+		return mcache_lookup_index(mcache, index, name, namesize, mdata_out,
+					   data_offset_out);
+
 	while (current + sizeof(uint32_t) <= end) {
 		const union mcache_entry *entry = current;
 
@@ -103,26 +267,17 @@ cb_err_t cbfs_mcache_lookup(const void *mcache, size_t mcache_size, const char *
 		if (entry->magic == MCACHE_MAGIC_FULL)
 			return CB_CBFS_CACHE_FULL;
 
-		assert(entry->magic == MCACHE_MAGIC_FILE);
-		const uint32_t data_offset = be32toh(entry->file.h.offset);
-		const uint32_t data_length = be32toh(entry->file.h.len);
-		if (namesize <= data_offset - offsetof(union cbfs_mdata, h.filename) &&
-		    memcmp(name, entry->file.h.filename, namesize) == 0) {
-			LOG("Found '%s' @%#x size %#x in mcache @%p\n",
-			    name, entry->offset, data_length, current);
-			*data_offset_out = entry->offset + data_offset;
-			memcpy(mdata_out, &entry->file, data_offset);
+		if (mcache_entry_match(entry, name, namesize, mdata_out, data_offset_out))
 			return CB_SUCCESS;
-		}
 
-		current += ALIGN_UP(data_offset, CBFS_MCACHE_ALIGNMENT);
+		current += ALIGN_UP(be32toh(entry->file.h.offset), CBFS_MCACHE_ALIGNMENT);
 	}
 
 	ERROR("CBFS mcache overflow!\n");
 	return CB_ERR;
 }
 
-size_t cbfs_mcache_real_size(const void *mcache, size_t mcache_size)
+static size_t mcache_entries_size(const void *mcache, size_t mcache_size)
 {
 	const void *end = mcache + mcache_size;
 	const void *current = mcache;
@@ -141,3 +296,26 @@ size_t cbfs_mcache_real_size(const void *mcache, size_t mcache_size)
 
 	return current - mcache;
 }
+
+size_t cbfs_mcache_real_size(const void *mcache, size_t mcache_size)
+{
+	const struct mcache_index *index = mcache_find_index(mcache, mcache_size);
+	size_t size = mcache_entries_size(mcache, mcache_size);
+
+	if (index)
+		size += mcache_index_size(index);
+
+	return size;
+}
+
+void cbfs_mcache_copy(void *dst, const void *src, size_t src_size)
+{
+	const struct mcache_index *index = mcache_find_index(src, src_size);
+	size_t entries_size = mcache_entries_size(src, src_size);
+
+	memcpy(dst, src, entries_size);
+	if (index) {
+		const size_t index_size = mcache_index_size(index);
+		memcpy(dst + entries_size, mcache_index_slots(index), index_size);
+	}
+}
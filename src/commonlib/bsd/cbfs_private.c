@@ -2,14 +2,66 @@
 
 #include <commonlib/bsd/cbfs_private.h>
 #include <assert.h>
+#include <string.h>
 
-static cb_err_t read_next_header(cbfs_dev_t dev, size_t *offset, struct cbfs_file *buffer)
+/*
+ * cbfs_walk() reads every file header and its metadata separately, which costs a full
+ * command/address cycle per read on boot devices that aren't memory mapped. With
+ * CBFS_READAHEAD_SIZE set, these reads are served from a window of up to that size instead.
+ * A read outside of the window refills it with just enough for one file's metadata. Only
+ * while misses land right behind the window, i.e. while files are small and their metadata
+ * close together, each refill doubles in size. The window is only valid for the duration of
+ * a single cbfs_walk().
+ */
+struct cbfs_readahead {
+	size_t offset;	/* Device offset of the window */
+	size_t size;	/* Valid bytes in the window, 0 if empty */
+};
+
+#if CBFS_READAHEAD_SIZE
+static uint8_t readahead_buf[CBFS_READAHEAD_SIZE];
+#endif
+
+static ssize_t walk_read(cbfs_dev_t dev, struct cbfs_readahead *ra, void *buffer,
+			 size_t offset, size_t size)
+{
+#if CBFS_READAHEAD_SIZE
+	const size_t devsize = cbfs_dev_size(dev);
+	const size_t end = ra->offset + ra->size;
+
+	if (size > CBFS_READAHEAD_SIZE || offset >= devsize || size > devsize - offset)
+		return cbfs_dev_read(dev, buffer, offset, size);
+
+	if (offset < ra->offset || offset + size > end) {
+		size_t len = sizeof(union cbfs_mdata);
+
+		/* Skipping less than the last refill means the files are small. */
+		if (ra->size && offset >= end && offset - end < ra->size)
+			len = 2 * ra->size;
+		len = MIN(MAX(len, size), MIN(CBFS_READAHEAD_SIZE, devsize - offset));
+
+		ra->size = 0;
+		if (cbfs_dev_read(dev, readahead_buf, offset, len) != len)
+			return -1;
+		ra->offset = offset;
+		ra->size = len;
+	}
+
+	memcpy(buffer, readahead_buf + (offset - ra->offset), size);
+	return size;
+#else
+	return cbfs_dev_read(dev, buffer, offset, size);
+#endif
+}
+
+static cb_err_t read_next_header(cbfs_dev_t dev, struct cbfs_readahead *ra, size_t *offset,
+				 struct cbfs_file *buffer)
 {
 	const size_t devsize = cbfs_dev_size(dev);
 	DEBUG("Looking for next file @%#zx...\n", *offset);
 	*offset = ALIGN_UP(*offset, CBFS_ALIGNMENT);
 	while (*offset + sizeof(*buffer) < devsize) {
-		if (cbfs_dev_read(dev, buffer, *offset, sizeof(*buffer)) != sizeof(*buffer))
+		if (walk_read(dev, ra, buffer, *offset, sizeof(*buffer)) != sizeof(*buffer))
 			return CB_CBFS_IO;
 
 		if (memcmp(buffer->magic, CBFS_FILE_MAGIC, sizeof(buffer->magic)) == 0)
@@ -41,7 +93,8 @@ cb_err_t cbfs_walk(cbfs_dev_t dev, cb_err_t (*walker)(cbfs_dev_t dev, size_t off
 	cb_err_t ret_header;
 	cb_err_t ret_walker = CB_CBFS_NOT_FOUND;
 	union cbfs_mdata mdata;
-	while ((ret_header = read_next_header(dev, &offset, &mdata.h)) == CB_SUCCESS) {
+	struct cbfs_readahead ra = { 0 };
+	while ((ret_header = read_next_header(dev, &ra, &offset, &mdata.h)) == CB_SUCCESS) {
 		const uint32_t attr_offset = be32toh(mdata.h.attributes_offset);
 		const uint32_t data_offset = be32toh(mdata.h.offset);
 		const uint32_t data_length = be32toh(mdata.h.len);
@@ -72,8 +125,8 @@ cb_err_t cbfs_walk(cbfs_dev_t dev, cb_err_t (*walker)(cbfs_dev_t dev, size_t off
 
 		/* Read the rest of the metadata (filename, and possibly attributes). */
 		assert(todo > 0 && todo <= sizeof(mdata) - sizeof(mdata.h));
-		if (cbfs_dev_read(dev, mdata.raw + sizeof(mdata.h),
-				  offset + sizeof(mdata.h), todo) != todo)
+		if (walk_read(dev, &ra, mdata.raw + sizeof(mdata.h),
+			      offset + sizeof(mdata.h), todo) != todo)
 			return CB_CBFS_IO;
 		DEBUG("File name: '%s'\n", mdata.h.filename);
 
@@ -190,3 +243,27 @@ const void *cbfs_find_attr(const union cbfs_mdata *mdata, uint32_t attr_tag, siz
 
 	return NULL;
 }
+
+const struct vb2_hash *cbfs_file_hash(const union cbfs_mdata *mdata)
+{
+	/* Hashes are variable-length attributes, so check the length by hand. */
+	const struct cbfs_file_attr_hash *attr =
+		cbfs_find_attr(mdata, CBFS_FILE_ATTR_TAG_HASH, 0);
+	if (!attr)
+		return NULL;
+
+	const size_t asize = be32toh(attr->len);
+	const size_t hsize = vb2_digest_size(attr->hash.algo);
+	if (!hsize) {
+		ERROR("Hash algo %u for '%s' unsupported\n", attr->hash.algo,
+		      mdata->h.filename);
+		return NULL;
+	}
+	if (asize != offsetof(struct cbfs_file_attr_hash, hash.raw) + hsize) {
+		ERROR("Hash attribute size for '%s' (%zu) incorrect for algo %u\n",
+		      mdata->h.filename, asize, attr->hash.algo);
+		return NULL;
+	}
+
+	return &attr->hash;
+}
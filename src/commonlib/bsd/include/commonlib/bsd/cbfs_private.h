@@ -38,9 +38,19 @@
  *
  * size_t cbfs_dev_size(cbfs_dev_t dev);
  *			Return the total size in bytes of the CBFS storage (actual CBFS area).
+ *
+ * It may optionally define:
+ *
+ * CBFS_READAHEAD_SIZE	Size of a static buffer through which cbfs_walk() reads file
+ *			metadata in bulk. 0 (the default) reads every header directly. The
+ *			buffer is shared, so cbfs_walk() must not run concurrently when set.
  */
 #include <cbfs_glue.h>
 
+#ifndef CBFS_READAHEAD_SIZE
+#define CBFS_READAHEAD_SIZE 0
+#endif
+
 /*
  * Helper structure to allocate space for a blob of metadata on the stack.
  * NOTE: The fields in any union cbfs_mdata or any of its substructures from cbfs_serialized.h
@@ -130,9 +140,17 @@ cb_err_t cbfs_mcache_lookup(const void *mcache, size_t mcache_size, const char *
 /* Returns the amount of bytes actually used by the CBFS metadata cache in |mcache|. */
 size_t cbfs_mcache_real_size(const void *mcache, size_t mcache_size);
 
+/* Copy the CBFS metadata cache in |src| to |dst| in its most compact form, so that it remains
+   usable with an mcache_size of cbfs_mcache_real_size(src, src_size) (the size of |dst|). */
+void cbfs_mcache_copy(void *dst, const void *src, size_t src_size);
+
 /* Finds a CBFS attribute in a metadata block. Attribute returned as-is (still big-endian).
    If |size| is not 0, will check that it matches the length of the attribute (if found)...
    else caller is responsible for checking the |len| field to avoid reading out-of-bounds. */
 const void *cbfs_find_attr(const union cbfs_mdata *mdata, uint32_t attr_tag, size_t size_check);
 
+/* Returns the file hash from the hash attribute of |mdata|, or NULL if there is none or its
+   algorithm is unsupported or doesn't match the attribute size. */
+const struct vb2_hash *cbfs_file_hash(const union cbfs_mdata *mdata);
+
 #endif	/* _COMMONLIB_BSD_CBFS_PRIVATE_H_ */
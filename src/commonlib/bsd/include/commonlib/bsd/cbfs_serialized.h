@@ -10,6 +10,11 @@ enum cbfs_compression {
 	CBFS_COMPRESS_NONE	= 0,
 	CBFS_COMPRESS_LZMA	= 1,
 	CBFS_COMPRESS_LZ4	= 2,
+	CBFS_COMPRESS_LZMA_CHUNKED = 3,
+	CBFS_COMPRESS_LZ4_CHUNKED = 4,
+	CBFS_COMPRESS_ZSTD	= 5,
+	CBFS_COMPRESS_LZMA_BCJ_X86 = 6,
+	CBFS_COMPRESS_LZMA_BCJ_ARM64 = 7,
 };
 
 enum cbfs_type {
@@ -138,6 +143,24 @@ struct cbfs_file_attr_compression {
 	uint32_t decompressed_size;
 } __packed;
 
+/* Chunked compression formats (CBFS_COMPRESS_*_CHUNKED) split the data into
+   chunk_size blocks (the last one may be shorter) that are compressed
+   independently, so that they can be decompressed in parallel. The compressed
+   data starts with this header, followed by a block table of num_chunks
+   compressed block sizes and then the compressed blocks back to back. Unlike
+   a file attribute, this also works for stages and payload segments.
+   All fields are big-endian. */
+#define CBFS_CHUNKED_MAGIC		0x43484e4b /* BE: 'CHNK' */
+#define CBFS_CHUNKED_MAX_CHUNKS		256
+
+struct cbfs_chunked_header {
+	uint32_t magic;
+	uint32_t chunk_size;
+	uint32_t num_chunks;
+	uint32_t decompressed_size;
+	uint32_t compressed_size[0];
+} __packed;
+
 /* Actual size in CBFS may be larger/smaller than struct size! */
 struct cbfs_file_attr_hash {
 	uint32_t tag;
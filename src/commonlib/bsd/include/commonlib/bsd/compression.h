@@ -15,7 +15,37 @@
  */
 size_t ulz4fn(const void *src, size_t srcn, void *dst, size_t dstn);
 
+/* Same as ulz4fn(), but passes the input to |consume| in order, each block
+ * right before it is decompressed (e.g. to hash it while it is in the cache).
+ * On success, all |srcn| bytes have been passed on. */
+size_t ulz4fn_consume(const void *src, size_t srcn, void *dst, size_t dstn,
+		      void (*consume)(void *arg, const void *buf, size_t size),
+		      void *consume_arg);
+
 /* Same as ulz4fn() but does not perform any bounds checks. */
 size_t ulz4f(const void *src, void *dst);
 
+/* Decompresses one or more Zstandard frames from src to dst, ensuring that it
+ * doesn't read more than srcn bytes and doesn't write more than dstn. The whole
+ * output must fit into dst, which doubles as the history window. Parts of dst
+ * beyond the returned size may be clobbered. Dictionaries are not supported and
+ * content checksums are not verified. Not reentrant.
+ * Returns amount of decompressed bytes, or 0 on error.
+ */
+size_t uzstdn(const void *src, size_t srcn, void *dst, size_t dstn);
+
+/* Same as uzstdn(), but passes the input to |consume| in order, each block
+ * right before it is decompressed. On success, all |srcn| bytes have been
+ * passed on. */
+size_t uzstdn_consume(const void *src, size_t srcn, void *dst, size_t dstn,
+		      void (*consume)(void *arg, const void *buf, size_t size),
+		      void *consume_arg);
+
+/* Branch converters for x86 and ARM64 code, applied in place before (encode
+ * != 0) and after (encode == 0) compression. They turn relative CALL/JMP
+ * (x86) or BL/ADRP (ARM64) targets into absolute ones, which compress better.
+ */
+void bcj_x86(void *buf, size_t size, int encode);
+void bcj_arm64(void *buf, size_t size, int encode);
+
 #endif	/* _COMMONLIB_COMPRESSION_H_ */
@@ -100,9 +100,12 @@ struct lz4_block_header {
 	/* + uint32_t block_checksum iff has_block_checksum is set */
 } __packed;
 
-size_t ulz4fn(const void *src, size_t srcn, void *dst, size_t dstn)
+size_t ulz4fn_consume(const void *src, size_t srcn, void *dst, size_t dstn,
+		      void (*consume)(void *arg, const void *buf, size_t size),
+		      void *consume_arg)
 {
 	const void *in = src;
+	const void *consumed = src;
 	void *out = dst;
 	size_t out_size = 0;
 	int has_block_checksum;
@@ -142,9 +145,18 @@ size_t ulz4fn(const void *src, size_t srcn, void *dst, size_t dstn)
 
 		if (!b.size) {
 			out_size = out - dst;
+			if (consume)
+				consume(consume_arg, consumed,
+					src + srcn - consumed);
 			break;			/* decompression successful */
 		}
 
+		/* Block checksums are passed on with the next block. */
+		if (consume) {
+			consume(consume_arg, consumed, in + b.size - consumed);
+			consumed = in + b.size;
+		}
+
 		if (b.not_compressed) {
 			size_t size = MIN((uintptr_t)b.size, (uintptr_t)dst
 				+ dstn - (uintptr_t)out);
@@ -170,6 +182,11 @@ size_t ulz4fn(const void *src, size_t srcn, void *dst, size_t dstn)
 	return out_size;
 }
 
+size_t ulz4fn(const void *src, size_t srcn, void *dst, size_t dstn)
+{
+	return ulz4fn_consume(src, srcn, dst, dstn, NULL, NULL);
+}
+
 size_t ulz4f(const void *src, void *dst)
 {
 	/* LZ4 uses signed size parameters, so can't just use ((u32)-1) here. */
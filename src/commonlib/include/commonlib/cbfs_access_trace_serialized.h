@@ -0,0 +1,19 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef __CBFS_ACCESS_TRACE_SERIALIZED_H__
+#define __CBFS_ACCESS_TRACE_SERIALIZED_H__
+
+#include <stdint.h>
+
+/*
+ * Names of the CBFS files looked up during boot, NUL terminated and back to
+ * back in the order of their first lookup. Every name is listed only once.
+ */
+struct cbfs_access_trace {
+	uint32_t	size;		/* Bytes available in names[] */
+	uint32_t	used;		/* Bytes of names[] filled in */
+	uint32_t	dropped;	/* Names that didn't fit */
+	char		names[0];
+} __packed;
+
+#endif
@@ -11,24 +11,30 @@
 #define CBMEM_ID_AGESA_RUNTIME	0x41474553
 #define CBMEM_ID_AMDMCT_MEMINFO 0x494D454E
 #define CBMEM_ID_CAR_GLOBALS	0xcac4e6a3
+#define CBMEM_ID_CBFS_ACCESS	0x43424143
 #define CBMEM_ID_CBTABLE	0x43425442
 #define CBMEM_ID_CBTABLE_FWD	0x43425443
 #define CBMEM_ID_CB_EARLY_DRAM	0x4544524D
 #define CBMEM_ID_CONSOLE	0x434f4e53
+#define CBMEM_ID_CONSOLE_DEFERRED 0x434f4e44
 #define CBMEM_ID_CPU_CRASHLOG	0x4350555f
 #define CBMEM_ID_COVERAGE	0x47434f56
+#define CBMEM_ID_DEV_TIMING	0x44544d47
 #define CBMEM_ID_EHCI_DEBUG	0xe4c1deb9
 #define CBMEM_ID_ELOG		0x454c4f47
 #define CBMEM_ID_FREESPACE	0x46524545
 #define CBMEM_ID_FSP_RESERVED_MEMORY 0x46535052
 #define CBMEM_ID_FSP_RUNTIME	0x52505346
+#define CBMEM_ID_FUNCTION_TRACE	0x46545243
 #define CBMEM_ID_GDT		0x4c474454
+#define CBMEM_ID_HEAP_STATS	0x48454150
 #define CBMEM_ID_HOB_POINTER	0x484f4221
 #define CBMEM_ID_IGD_OPREGION	0x4f444749
 #define CBMEM_ID_IMD_ROOT	0xff4017ff
 #define CBMEM_ID_IMD_SMALL	0x53a11439
 #define CBMEM_ID_MDATA_HASH	0x6873484D
 #define CBMEM_ID_MEMINFO	0x494D454D
+#define CBMEM_ID_MEMTEST	0x4d544553
 #define CBMEM_ID_MMA_DATA	0x4D4D4144
 #define CBMEM_ID_MMC_STATUS	0x4d4d4353
 #define CBMEM_ID_MPTABLE	0x534d5054
@@ -39,6 +45,7 @@
 #define CBMEM_ID_NONE		0x00000000
 #define CBMEM_ID_PIRQ		0x49525154
 #define CBMEM_ID_POWER_STATE	0x50535454
+#define CBMEM_ID_PROFILE	0x50524f46
 #define CBMEM_ID_RAM_OOPS	0x05430095
 #define CBMEM_ID_RAMSTAGE	0x9a357a9e
 #define CBMEM_ID_RAMSTAGE_CACHE	0x9a3ca54e
@@ -86,22 +93,28 @@
 	{ CBMEM_ID_AFTER_CAR,		"AFTER CAR  " }, \
 	{ CBMEM_ID_AMDMCT_MEMINFO,	"AMDMEM INFO" }, \
 	{ CBMEM_ID_CAR_GLOBALS,		"CAR GLOBALS" }, \
+	{ CBMEM_ID_CBFS_ACCESS,		"CBFS ACCESS" }, \
 	{ CBMEM_ID_CBTABLE,		"COREBOOT   " }, \
 	{ CBMEM_ID_CBTABLE_FWD,		"COREBOOTFWD" }, \
 	{ CBMEM_ID_CB_EARLY_DRAM,	"EARLY DRAM USAGE" }, \
 	{ CBMEM_ID_CONSOLE,		"CONSOLE    " }, \
+	{ CBMEM_ID_CONSOLE_DEFERRED,	"CONSOLE BIN" }, \
 	{ CBMEM_ID_COVERAGE,		"COVERAGE   " }, \
 	{ CBMEM_ID_CPU_CRASHLOG,	"CPU CRASHLOG"}, \
+	{ CBMEM_ID_DEV_TIMING,		"DEV TIMING " }, \
 	{ CBMEM_ID_EHCI_DEBUG,		"USBDEBUG   " }, \
 	{ CBMEM_ID_ELOG,		"ELOG       " }, \
 	{ CBMEM_ID_FREESPACE,		"FREE SPACE " }, \
 	{ CBMEM_ID_FSP_RESERVED_MEMORY, "FSP MEMORY " }, \
 	{ CBMEM_ID_FSP_RUNTIME,		"FSP RUNTIME" }, \
+	{ CBMEM_ID_FUNCTION_TRACE,	"FUNC TRACE " }, \
 	{ CBMEM_ID_GDT,			"GDT        " }, \
+	{ CBMEM_ID_HEAP_STATS,		"HEAP STATS " }, \
 	{ CBMEM_ID_HOB_POINTER,		"HOB        " }, \
 	{ CBMEM_ID_IMD_ROOT,		"IMD ROOT   " }, \
 	{ CBMEM_ID_IMD_SMALL,		"IMD SMALL  " }, \
 	{ CBMEM_ID_MEMINFO,		"MEM INFO   " }, \
+	{ CBMEM_ID_MEMTEST,		"MEM TEST   " }, \
 	{ CBMEM_ID_MMA_DATA,		"MMA DATA   " }, \
 	{ CBMEM_ID_MMC_STATUS,		"MMC STATUS " }, \
 	{ CBMEM_ID_MPTABLE,		"SMP TABLE  " }, \
@@ -111,6 +124,7 @@
 	{ CBMEM_ID_MTC,			"MTC        " }, \
 	{ CBMEM_ID_PIRQ,		"IRQ TABLE  " }, \
 	{ CBMEM_ID_POWER_STATE,		"POWER STATE" }, \
+	{ CBMEM_ID_PROFILE,		"PROFILE    " }, \
 	{ CBMEM_ID_RAM_OOPS,		"RAMOOPS    " }, \
 	{ CBMEM_ID_RAMSTAGE_CACHE,	"RAMSTAGE $ " }, \
 	{ CBMEM_ID_RAMSTAGE,		"RAMSTAGE   " }, \
@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef __CONSOLE_DEFERRED_SERIALIZED_H__
+#define __CONSOLE_DEFERRED_SERIALIZED_H__
+
+#include <stdint.h>
+
+/*
+ * With CONSOLE_CBMEM_DEFERRED_FORMAT, messages that only go to the CBMEM
+ * console are not formatted into text. Instead a record referring to the
+ * format string in the stage's ELF file is appended to the
+ * CBMEM_ID_CONSOLE_DEFERRED area, and util/cbmem turns it back into text on
+ * output. The text console itself only ever holds text.
+ *
+ * The area is filled once and never wraps. When a record doesn't fit anymore,
+ * the message is formatted into the text console as usual.
+ *
+ * Each record remembers where the text console was at the time, so that the
+ * decoded message can be put back in between the text that surrounds it:
+ * the position in the text ring is wraps * text console size + cursor.
+ */
+struct cbmemc_deferred_record {
+	uint32_t	wraps;		/* Text console wraps at log time */
+	uint32_t	cursor;		/* Text console cursor at log time */
+	uint32_t	fmt_offset;	/* Format string offset from _program */
+	uint16_t	args_size;	/* Bytes of argument data in args[] */
+	uint8_t		stage;		/* enum cbmemc_deferred_stage */
+	uint8_t		reserved;
+	uint8_t		args[0];
+} __packed;
+
+/*
+ * The arguments are stored in the order in which the format string consumes
+ * them:
+ *
+ *   d, i, '*' width and precision	zigzag encoded LEB128
+ *   o, u, x, X, p			LEB128
+ *   c					one byte
+ *   s					the characters vtxprintf() would
+ *					print (all of them, or as many as
+ *					the precision allows), NUL terminated
+ *
+ * Messages with %n are always formatted into text.
+ */
+struct cbmemc_deferred_area {
+	uint32_t	size;		/* Bytes available in body[] */
+	uint32_t	used;		/* Bytes of records in body[] */
+	uint32_t	wraps;		/* Times the text console wrapped */
+	uint8_t		body[0];
+} __packed;
+
+enum cbmemc_deferred_stage {
+	CBMEMC_DEFERRED_BOOTBLOCK = 1,
+	CBMEMC_DEFERRED_VERSTAGE = 2,
+	CBMEMC_DEFERRED_ROMSTAGE = 3,
+	CBMEMC_DEFERRED_POSTCAR = 4,
+	CBMEMC_DEFERRED_RAMSTAGE = 5,
+	CBMEMC_DEFERRED_STAGE_MAX,
+};
+
+#endif
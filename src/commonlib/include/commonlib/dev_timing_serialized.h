@@ -0,0 +1,40 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef __DEV_TIMING_SERIALIZED_H__
+#define __DEV_TIMING_SERIALIZED_H__
+
+#include <stdint.h>
+
+#define DEV_TIMING_NAME_LEN	32
+
+enum dev_timing_op {
+	DEV_TIMING_READ_RESOURCES = 1,
+	DEV_TIMING_SET_RESOURCES = 2,
+	DEV_TIMING_ENABLE_RESOURCES = 3,
+	DEV_TIMING_INIT = 4,
+	DEV_TIMING_FINAL = 5,
+	/* Phases of a boot state, the name is that of the state. */
+	DEV_TIMING_BS_ENTRY = 16,
+	DEV_TIMING_BS_RUN = 17,
+	DEV_TIMING_BS_EXIT = 18,
+};
+
+/*
+ * One device operation or boot state phase. Times are in microseconds of
+ * the ramstage's monotonic timer.
+ */
+struct dev_timing_entry {
+	char		name[DEV_TIMING_NAME_LEN];	/* dev_path() or state */
+	uint32_t	op;
+	uint32_t	start_usecs;
+	uint32_t	duration_usecs;
+} __packed;
+
+struct dev_timing_table {
+	uint32_t	max_entries;
+	uint32_t	num_entries;
+	uint32_t	dropped;	/* Records that didn't fit */
+	struct dev_timing_entry entries[0]; /* Variable number of entries */
+} __packed;
+
+#endif
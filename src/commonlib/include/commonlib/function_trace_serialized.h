@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef __FUNCTION_TRACE_SERIALIZED_H__
+#define __FUNCTION_TRACE_SERIALIZED_H__
+
+#include <stdint.h>
+
+/*
+ * Function entry and exit events recorded with FUNCTION_TRACE. `func` is the
+ * offset of the function from the ramstage's _program symbol, with
+ * FUNCTION_TRACE_EXIT set for the exit event. `stamp` is in timestamp ticks.
+ *
+ * The events form a ring: once it is full, the oldest events are overwritten.
+ * `total` counts every event, so the valid ones are the last
+ * MIN(total, max_entries), starting at index total % max_entries if the ring
+ * wrapped.
+ */
+
+#define FUNCTION_TRACE_EXIT	(1U << 31)
+
+struct function_trace_entry {
+	uint32_t	func;
+	uint64_t	stamp;
+} __packed;
+
+struct function_trace_buffer {
+	uint32_t	max_entries;
+	uint32_t	total;
+	uint32_t	tick_freq_mhz;
+	struct function_trace_entry entries[0];
+} __packed;
+
+#endif
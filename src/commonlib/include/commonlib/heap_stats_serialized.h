@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef __HEAP_STATS_SERIALIZED_H__
+#define __HEAP_STATS_SERIALIZED_H__
+
+#include <stdint.h>
+
+/*
+ * Heap usage statistics of the free-list allocator, stored in CBMEM under
+ * CBMEM_ID_HEAP_STATS. All sizes are in bytes and include block headers.
+ */
+struct heap_stats {
+	uint32_t	heap_size;
+	uint32_t	in_use;		/* Currently allocated */
+	uint32_t	high_water;	/* Maximum of in_use seen so far */
+	uint32_t	free_bytes;
+	uint32_t	largest_free;	/* Largest single free block */
+	uint32_t	free_blocks;	/* Number of free blocks */
+	uint32_t	allocations;	/* Number of successful allocations */
+	uint32_t	frees;		/* Number of blocks returned */
+} __packed;
+
+#endif
@@ -0,0 +1,29 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef __MEMTEST_SERIALIZED_H__
+#define __MEMTEST_SERIALIZED_H__
+
+#include <stdint.h>
+
+/* A 64-bit word that didn't read back what was written to it. */
+struct memtest_error {
+	uint64_t	addr;
+	uint64_t	expected;
+	uint64_t	actual;
+} __packed;
+
+/*
+ * Result of the ramstage DRAM test. Only the first failing words are listed
+ * in entries[], errors counts all of them.
+ */
+struct memtest_result {
+	uint64_t	tested;		/* Bytes tested */
+	uint64_t	skipped;	/* RAM ramstage couldn't address */
+	uint32_t	duration_us;
+	uint32_t	passes;		/* Reads and writes of every word */
+	uint32_t	errors;		/* Failing words found */
+	uint32_t	num_entries;	/* Entries filled in */
+	struct memtest_error entries[0];
+} __packed;
+
+#endif
@@ -0,0 +1,30 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef __PROFILE_SERIALIZED_H__
+#define __PROFILE_SERIALIZED_H__
+
+#include <stdint.h>
+
+/*
+ * Samples of the sampling profiler, see SAMPLING_PROFILER. Each sample holds
+ * `depth` program counters as offsets from the ramstage's _program symbol,
+ * the interrupted one first, followed by the return addresses found by
+ * walking the frame pointers. Unused slots are PROFILE_PC_NONE.
+ *
+ * The samples form a ring: once it is full, the oldest samples are
+ * overwritten. `total` counts every sample taken, so the valid samples are
+ * the last MIN(total, max_samples) ones.
+ */
+
+#define PROFILE_PC_NONE		0xffffffff
+#define PROFILE_PC_EXTERNAL	0xfffffffe	/* Outside the stage, e.g. FSP */
+
+struct profile_buffer {
+	uint32_t	period_us;
+	uint32_t	depth;
+	uint32_t	max_samples;
+	uint32_t	total;
+	uint32_t	samples[0];	/* max_samples * depth entries */
+};
+
+#endif
@@ -36,6 +36,39 @@ int rdev_munmap(const struct region_device *rd, void *mapping);
 ssize_t rdev_readat(const struct region_device *rd, void *b, size_t offset,
 			size_t size);
 
+/*
+ * State of an asynchronous read. Only to be filled in by the rdev_readat_async
+ * functions and the region device implementations.
+ */
+struct rdev_async_read {
+	const struct region_device *rdev;	/* Root device handling the read */
+	void *buffer;
+	size_t offset;
+	size_t size;
+	ssize_t result;		/* Valid once done */
+	bool done;
+};
+
+/*
+ * Start reading |size| bytes at |offset| into |b| without waiting for the
+ * data to arrive. The read is tracked in |req| and |b| must not be touched
+ * until it has completed. Region devices without asynchronous read support
+ * complete the read before this returns. Returns < 0 if the read could not
+ * be started, 0 otherwise.
+ */
+int rdev_readat_async_start(const struct region_device *rd,
+			    struct rdev_async_read *req, void *b,
+			    size_t offset, size_t size);
+
+/* Returns true once the read tracked by |req| has completed. */
+bool rdev_readat_async_poll(struct rdev_async_read *req);
+
+/*
+ * Wait for the read tracked by |req| to complete. Same return value as
+ * rdev_readat() for the original request.
+ */
+ssize_t rdev_readat_async_wait(struct rdev_async_read *req);
+
 /*
  * Returns < 0 on error otherwise returns size of data wrote at provided
  * offset from the buffer passed.
@@ -71,6 +104,20 @@ struct region_device_ops {
 	ssize_t (*writeat)(const struct region_device *, const void *, size_t,
 		size_t);
 	ssize_t (*eraseat)(const struct region_device *, size_t, size_t);
+	/*
+	 * Optional asynchronous read support (e.g. through a DMA engine). The
+	 * request is already normalized to the root device. readat_async_start
+	 * returns < 0 on error. readat_async_poll returns true and sets
+	 * req->result once the read completed. Implementations that forward to
+	 * another device may start the read there instead, which then takes
+	 * over req->rdev. Only the translated region devices do so for now; no
+	 * boot media or SPI/DMA driver implements these yet, so all reads take
+	 * the synchronous fallback.
+	 */
+	int (*readat_async_start)(const struct region_device *,
+				  struct rdev_async_read *req);
+	bool (*readat_async_poll)(const struct region_device *,
+				  struct rdev_async_read *req);
 };
 
 struct region {
@@ -18,6 +18,15 @@ struct timestamp_table {
 	struct timestamp_entry entries[0]; /* Variable number of entries */
 } __packed;
 
+/*
+ * Timestamps recorded on an application processor carry the index of that CPU
+ * in the upper bits of entry_id. Entries from the boot CPU (index 0) are plain
+ * timestamp IDs.
+ */
+#define TIMESTAMP_CPU_SHIFT	20
+#define TIMESTAMP_ID_MASK	((1U << TIMESTAMP_CPU_SHIFT) - 1)
+#define TIMESTAMP_CPU_MAX	((1U << (32 - TIMESTAMP_CPU_SHIFT)) - 1)
+
 enum timestamp_id {
 	TS_START_ROMSTAGE = 1,
 	TS_BEFORE_INITRAM = 2,
@@ -36,6 +45,8 @@ enum timestamp_id {
 	TS_END_ULZMA = 16,
 	TS_START_ULZ4F = 17,
 	TS_END_ULZ4F = 18,
+	TS_START_UZSTD = 19,
+	TS_END_UZSTD = 20,
 	TS_DEVICE_ENUMERATE = 30,
 	TS_DEVICE_CONFIGURE = 40,
 	TS_DEVICE_ENABLE = 50,
@@ -54,6 +65,10 @@ enum timestamp_id {
 	TS_END_POSTCAR = 101,
 	TS_DELAY_START = 110,
 	TS_DELAY_END = 111,
+	TS_MEMORY_CLEAR_START = 112,
+	TS_MEMORY_CLEAR_END = 113,
+	TS_MEMTEST_START = 114,
+	TS_MEMTEST_END = 115,
 
 	/* 500+ reserved for vendorcode extensions (500-600: google/chromeos) */
 	TS_START_COPYVER = 501,
@@ -165,6 +180,8 @@ static const struct timestamp_id_to_name {
 	{ TS_END_ULZMA,		"finished LZMA decompress (ignore for x86)" },
 	{ TS_START_ULZ4F,	"starting LZ4 decompress (ignore for x86)" },
 	{ TS_END_ULZ4F,		"finished LZ4 decompress (ignore for x86)" },
+	{ TS_START_UZSTD,	"starting Zstandard decompress" },
+	{ TS_END_UZSTD,		"finished Zstandard decompress" },
 	{ TS_DEVICE_ENUMERATE,	"device enumeration" },
 	{ TS_DEVICE_CONFIGURE,	"device configuration" },
 	{ TS_DEVICE_ENABLE,	"device enable" },
@@ -181,6 +198,10 @@ static const struct timestamp_id_to_name {
 	{ TS_SELFBOOT_JUMP,	"selfboot jump" },
 	{ TS_DELAY_START,	"Forced delay start" },
 	{ TS_DELAY_END,		"Forced delay end" },
+	{ TS_MEMORY_CLEAR_START, "starting to clear DRAM" },
+	{ TS_MEMORY_CLEAR_END,	"finished clearing DRAM" },
+	{ TS_MEMTEST_START,	"starting DRAM test" },
+	{ TS_MEMTEST_END,	"finished DRAM test" },
 
 	{ TS_START_COPYVER,	"starting to load verstage" },
 	{ TS_END_COPYVER,	"finished loading verstage" },
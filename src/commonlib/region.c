@@ -91,6 +91,53 @@ ssize_t rdev_readat(const struct region_device *rd, void *b, size_t offset,
 	return rdev->ops->readat(rdev, b, req.offset, req.size);
 }
 
+int rdev_readat_async_start(const struct region_device *rd,
+			    struct rdev_async_read *req, void *b,
+			    size_t offset, size_t size)
+{
+	const struct region_device *rdev;
+	struct region r = {
+		.offset = offset,
+		.size = size,
+	};
+
+	if (!normalize_and_ok(&rd->region, &r))
+		return -1;
+
+	rdev = rdev_root(rd);
+
+	req->rdev = rdev;
+	req->buffer = b;
+	req->offset = r.offset;
+	req->size = r.size;
+	req->done = false;
+
+	if (rdev->ops->readat_async_start == NULL) {
+		/* Fall back to a synchronous read. */
+		req->result = rdev->ops->readat(rdev, b, r.offset, r.size);
+		req->done = true;
+		return req->result < 0 ? -1 : 0;
+	}
+
+	return rdev->ops->readat_async_start(rdev, req);
+}
+
+bool rdev_readat_async_poll(struct rdev_async_read *req)
+{
+	if (!req->done)
+		req->done = req->rdev->ops->readat_async_poll(req->rdev, req);
+
+	return req->done;
+}
+
+ssize_t rdev_readat_async_wait(struct rdev_async_read *req)
+{
+	while (!rdev_readat_async_poll(req))
+		;
+
+	return req->result;
+}
+
 ssize_t rdev_writeat(const struct region_device *rd, const void *b,
 			size_t offset, size_t size)
 {
@@ -394,6 +441,28 @@ static ssize_t xlate_readat(const struct region_device *rd, void *b,
 	return rdev_readat(xlwindow->access_dev, b, offset, size);
 }
 
+static int xlate_readat_async_start(const struct region_device *rd,
+				    struct rdev_async_read *req)
+{
+	struct region r = {
+		.offset = req->offset,
+		.size = req->size,
+	};
+	const struct xlate_window *xlwindow;
+	const struct xlate_region_device *xldev;
+
+	xldev = container_of(rd, __typeof__(*xldev), rdev);
+
+	xlwindow = xlate_find_window(xldev, &r);
+	if (!xlwindow)
+		return -1;
+
+	/* Hand the request over to the access device. */
+	return rdev_readat_async_start(xlwindow->access_dev, req, req->buffer,
+				       req->offset - region_offset(&xlwindow->sub_region),
+				       req->size);
+}
+
 static ssize_t xlate_writeat(const struct region_device *rd, const void *b,
 				size_t offset, size_t size)
 {
@@ -440,12 +509,14 @@ const struct region_device_ops xlate_rdev_ro_ops = {
 	.mmap = xlate_mmap,
 	.munmap = xlate_munmap,
 	.readat = xlate_readat,
+	.readat_async_start = xlate_readat_async_start,
 };
 
 const struct region_device_ops xlate_rdev_rw_ops = {
 	.mmap = xlate_mmap,
 	.munmap = xlate_munmap,
 	.readat = xlate_readat,
+	.readat_async_start = xlate_readat_async_start,
 	.writeat = xlate_writeat,
 	.eraseat = xlate_eraseat,
 };
@@ -1,6 +1,8 @@
 /* SPDX-License-Identifier: GPL-2.0-only */
 
+#include <commonlib/helpers.h>
 #include <console/cbmem_console.h>
+#include <console/console.h>
 #include <console/ne2k.h>
 #include <console/qemu_debugcon.h>
 #include <console/spkmodem.h>
@@ -10,6 +12,130 @@
 #include <console/spi.h>
 #include <console/flash.h>
 #include <console/system76_ec.h>
+#include <stdio.h>
+
+#define UART_NONBLOCKING (CONFIG(CONSOLE_SERIAL_NONBLOCKING) && \
+	__CONSOLE_SERIAL_ENABLE__ && !ENV_SMM)
+
+#if UART_NONBLOCKING
+/*
+ * Serial output is queued here and handed to the UART whenever it can take
+ * it without waiting. A line that doesn't fit any more is dropped from the
+ * serial output, the other consoles still get it.
+ */
+static u8 uart_backlog[CONFIG_CONSOLE_SERIAL_BACKLOG];
+static size_t uart_head;	/* Next free slot, free-running */
+static size_t uart_tail;	/* Next byte to send, free-running */
+static size_t uart_line;	/* Start of the line being queued */
+static bool uart_dropping;
+static unsigned int uart_dropped_lines;
+
+static size_t uart_backlog_room(void)
+{
+	return ARRAY_SIZE(uart_backlog) - (uart_head - uart_tail);
+}
+
+static void uart_backlog_drain(bool wait)
+{
+	const unsigned int idx = get_uart_for_console();
+
+	while (uart_tail != uart_head) {
+		if (!wait && !uart_can_tx_byte(idx))
+			return;
+		uart_tx_byte(idx, uart_backlog[uart_tail++ % ARRAY_SIZE(uart_backlog)]);
+	}
+}
+
+static void uart_backlog_push(const char *buf, size_t len)
+{
+	while (len--)
+		uart_backlog[uart_head++ % ARRAY_SIZE(uart_backlog)] = *buf++;
+}
+
+/* Tell the reader about dropped lines, once there is room for it. */
+static void uart_queue_dropped_marker(void)
+{
+	char marker[48];
+	int len;
+
+	len = snprintf(marker, sizeof(marker),
+		       "*** %u lines dropped from serial log ***\r\n",
+		       uart_dropped_lines);
+	if (uart_backlog_room() < (size_t)len)
+		uart_backlog_drain(false);
+	if (uart_backlog_room() >= (size_t)len) {
+		uart_backlog_push(marker, len);
+		uart_line = uart_head;
+		uart_dropped_lines = 0;
+	}
+}
+
+static void uart_queue_byte(u8 byte)
+{
+	if (uart_dropping) {
+		if (byte == '\n') {
+			uart_dropping = false;
+			uart_line = uart_head;
+		}
+		return;
+	}
+
+	if (uart_head == uart_line && uart_dropped_lines)
+		uart_queue_dropped_marker();
+
+	if (!uart_backlog_room())
+		uart_backlog_drain(false);
+
+	if (!uart_backlog_room()) {
+		/* Take back what is still queued of this line and skip the rest. */
+		uart_head = MAX(uart_line, uart_tail);
+		uart_dropped_lines++;
+		uart_dropping = byte != '\n';
+		uart_line = uart_head;
+		return;
+	}
+
+	uart_backlog_push((const char *)&byte, 1);
+	if (byte == '\n')
+		uart_line = uart_head;
+}
+
+static void uart_console_tx_byte(u8 byte)
+{
+	uart_queue_byte(byte);
+}
+
+static void uart_console_tx_flush(void)
+{
+	uart_backlog_drain(false);
+}
+
+void console_drain(void)
+{
+	uart_backlog_drain(true);
+	if (uart_dropped_lines && !uart_dropping) {
+		uart_queue_dropped_marker();
+		uart_backlog_drain(true);
+	}
+	__uart_tx_flush();
+}
+#else
+static void uart_console_tx_byte(u8 byte)
+{
+	__uart_tx_byte(byte);
+}
+
+static void uart_console_tx_flush(void)
+{
+	__uart_tx_flush();
+}
+
+#if CONFIG(CONSOLE_SERIAL_NONBLOCKING)
+void console_drain(void)
+{
+}
+#endif
+#endif
 
 void console_hw_init(void)
 {
@@ -35,11 +161,11 @@ void console_tx_byte(unsigned char byte)
 	 * to keep terminals happy.
 	 */
 	if (byte == '\n') {
-		__uart_tx_byte('\r');
+		uart_console_tx_byte('\r');
 		__usb_tx_byte('\r');
 	}
 
-	__uart_tx_byte(byte);
+	uart_console_tx_byte(byte);
 	__ne2k_tx_byte(byte);
 	__usb_tx_byte(byte);
 	__spiconsole_tx_byte(byte);
@@ -49,7 +175,7 @@ void console_tx_byte(unsigned char byte)
 
 void console_tx_flush(void)
 {
-	__uart_tx_flush();
+	uart_console_tx_flush();
 	__ne2k_tx_flush();
 	__usb_tx_flush();
 	__flashconsole_tx_flush();
@@ -22,6 +22,7 @@ void __noreturn die(const char *fmt, ...)
 	vprintk(BIOS_EMERG, fmt, args);
 	va_end(args);
 
+	console_drain();
 	die_notify();
 	halt();
 }
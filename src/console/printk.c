@@ -85,7 +85,11 @@ int do_vprintk(int msg_level, const char *fmt, va_list args)
 	console_time_run();
 
 	if (log_this == CONSOLE_LOG_FAST) {
-		i = vtxprintf(wrap_putchar_cbmemc, fmt, args, NULL);
+		i = -1;
+		if (CONFIG(CONSOLE_CBMEM_DEFERRED_FORMAT))
+			i = __cbmemc_log_deferred(fmt, args);
+		if (i < 0)
+			i = vtxprintf(wrap_putchar_cbmemc, fmt, args, NULL);
 	} else {
 		i = vtxprintf(wrap_putchar, fmt, args, NULL);
 		console_tx_flush();
@@ -9,11 +9,16 @@
 #include <cpu/x86/cache.h>
 #include <cpu/x86/name.h>
 #include <cpu/intel/smm_reloc.h>
+#include <smp/node.h>
 
 #include "chip.h"
 
 static void init_timer(void)
 {
+	/* The sampling profiler already runs the boot CPU's APIC timer. */
+	if (CONFIG(SAMPLING_PROFILER) && boot_cpu())
+		return;
+
 	/* Set the APIC timer to no interrupts and periodic mode */
 	lapic_write(LAPIC_LVTT, (1 << 17) | (1 << 16) | (0 << 12) | (0 << 0));
 
@@ -0,0 +1,94 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <arch/exception.h>
+#include <arch/io.h>
+#include <console/console.h>
+#include <cpu/x86/lapic.h>
+#include <delay.h>
+#include <profiler.h>
+#include <stdint.h>
+
+/* Interrupt mask registers of the master and slave i8259 */
+#define PIC_MASTER_IMR	0x21
+#define PIC_SLAVE_IMR	0xa1
+
+static uint8_t saved_pic_mask[2];
+
+static inline void enable_interrupts(void)
+{
+	asm volatile ("sti" ::: "memory");
+}
+
+static inline void disable_interrupts(void)
+{
+	asm volatile ("cli" ::: "memory");
+}
+
+void lapic_profiler_interrupt(struct eregs *info)
+{
+#if ENV_X86_64
+	profiler_record(info->rip, info->rbp, (uintptr_t)info);
+#else
+	profiler_record(info->eip, info->ebp, (uintptr_t)info);
+#endif
+	lapic_write(LAPIC_EOI, 0);
+}
+
+/* Count LAPIC timer ticks for a millisecond of udelay(). */
+static uint32_t lapic_timer_ticks_per_ms(void)
+{
+	uint32_t start;
+
+	lapic_write(LAPIC_LVTT, LAPIC_LVT_MASKED);
+	lapic_write(LAPIC_TDCR, LAPIC_TDR_DIV_1);
+	lapic_write(LAPIC_TMICT, 0xffffffff);
+
+	start = lapic_read(LAPIC_TMCCT);
+	udelay(1000);
+
+	return start - lapic_read(LAPIC_TMCCT);
+}
+
+int arch_profiler_start(unsigned int period_us)
+{
+	uint32_t ticks;
+
+	/* This may run before the LAPIC is set up along with the other CPUs. */
+	enable_lapic();
+	lapic_write(LAPIC_SPIV, lapic_read(LAPIC_SPIV) | LAPIC_SPIV_ENABLE);
+
+	ticks = lapic_timer_ticks_per_ms();
+
+	if (!ticks) {
+		printk(BIOS_ERR, "Profiler: LAPIC timer is not running\n");
+		return -1;
+	}
+
+	/*
+	 * Nothing but the timer may interrupt us, so keep a legacy PIC from
+	 * delivering anything through LINT0 while interrupts are enabled.
+	 */
+	saved_pic_mask[0] = inb(PIC_MASTER_IMR);
+	saved_pic_mask[1] = inb(PIC_SLAVE_IMR);
+	outb(0xff, PIC_MASTER_IMR);
+	outb(0xff, PIC_SLAVE_IMR);
+
+	lapic_write(LAPIC_LVTT, LAPIC_LVT_TIMER_PERIODIC | PROFILER_VECTOR);
+	lapic_write(LAPIC_TMICT, (uint64_t)ticks * period_us / 1000);
+	enable_interrupts();
+
+	printk(BIOS_DEBUG, "Profiler: sampling every %u us, %u LAPIC ticks/ms\n",
+	       period_us, ticks);
+
+	return 0;
+}
+
+void arch_profiler_stop(void)
+{
+	disable_interrupts();
+	lapic_write(LAPIC_LVTT, LAPIC_LVT_MASKED);
+	lapic_write(LAPIC_TMICT, 0);
+
+	outb(saved_pic_mask[0], PIC_MASTER_IMR);
+	outb(saved_pic_mask[1], PIC_SLAVE_IMR);
+}
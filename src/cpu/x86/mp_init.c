@@ -874,6 +874,7 @@ static void trigger_smm_relocation(void)
 }
 
 static struct mp_callback *ap_callbacks[CONFIG_MAX_CPUS];
+static bool aps_waiting_for_work;
 
 static struct mp_callback *read_callback(struct mp_callback **slot)
 {
@@ -1001,12 +1002,103 @@ int mp_run_on_all_cpus(void (*func)(void *), void *arg)
 	return mp_run_on_aps(func, arg, MP_RUN_ON_ALL_CPUS, 1000 * USECS_PER_MSEC);
 }
 
+/*
+ * Work handed to all CPUs by mp_run_on_all_cpus_synchronously(). APs get the
+ * generation of the call they accepted as argument. An AP that only gets to
+ * it after the call was closed, or a later one was started, doesn't join.
+ */
+static struct {
+	void (*func)(void *);
+	void *arg;
+	uintptr_t generation;
+	bool open;
+	atomic_t joined;
+	atomic_t active;
+} sync_work;
+
+DECLARE_SPIN_LOCK(sync_work_lock);
+
+static void run_sync_work(void *generation)
+{
+	bool join;
+
+	spin_lock(&sync_work_lock);
+	join = sync_work.open && sync_work.generation == (uintptr_t)generation;
+	if (join) {
+		atomic_inc(&sync_work.joined);
+		atomic_inc(&sync_work.active);
+	}
+	spin_unlock(&sync_work_lock);
+
+	if (!join)
+		return;
+
+	sync_work.func(sync_work.arg);
+	mfence();
+
+	/* Last access to sync_work, the next call may start right after. */
+	atomic_dec(&sync_work.active);
+}
+
+static void close_sync_work(void)
+{
+	spin_lock(&sync_work_lock);
+	sync_work.open = false;
+	spin_unlock(&sync_work_lock);
+}
+
+int mp_run_on_all_cpus_synchronously(void (*func)(void *), void *arg)
+{
+	void *generation;
+	int ret = -1;
+
+	spin_lock(&sync_work_lock);
+	sync_work.func = func;
+	sync_work.arg = arg;
+	sync_work.generation++;
+	sync_work.open = true;
+	atomic_set(&sync_work.joined, 0);
+	atomic_set(&sync_work.active, 0);
+	generation = (void *)sync_work.generation;
+	spin_unlock(&sync_work_lock);
+
+	/* Start the APs first, so that they work alongside the BSP. */
+	if (mp_aps_waiting_for_work())
+		ret = mp_run_on_aps(run_sync_work, generation, MP_RUN_ON_ALL_CPUS,
+				    1000 * USECS_PER_MSEC);
+
+	run_sync_work(generation);
+
+	/*
+	 * If all APs accepted the call, all of them join it. Otherwise keep
+	 * latecomers out and only wait for the ones that already joined.
+	 */
+	if (!ret) {
+		while (atomic_read(&sync_work.joined) < global_num_aps + 1)
+			cpu_relax();
+	} else {
+		close_sync_work();
+	}
+	while (atomic_read(&sync_work.active))
+		cpu_relax();
+	close_sync_work();
+
+	return ret;
+}
+
+bool mp_aps_waiting_for_work(void)
+{
+	return aps_waiting_for_work;
+}
+
 int mp_park_aps(void)
 {
 	struct stopwatch sw;
 	int ret;
 	long duration_msecs;
 
+	aps_waiting_for_work = false;
+
 	stopwatch_init(&sw);
 
 	ret = mp_run_on_aps(park_this_cpu, NULL, MP_RUN_ON_ALL_CPUS,
@@ -1108,6 +1200,9 @@ int mp_init_with_smm(struct bus *cpu_bus, const struct mp_ops *mp_ops)
 
 	restore_default_smm_area(default_smm_area);
 
+	if (ret == 0 && CONFIG(PARALLEL_MP_AP_WORK))
+		aps_waiting_for_work = true;
+
 	/* Signal callback on success if it's provided. */
 	if (ret == 0 && mp_state.ops.post_mp_init != NULL)
 		mp_state.ops.post_mp_init();
@@ -130,13 +130,20 @@ void paging_disable_pae(void)
 int memset_pae(uint64_t dest, unsigned char pat, uint64_t length, void *pgtbl,
 	       void *vmem_addr)
 {
-	struct pg_table *pgtbl_buf = (struct pg_table *)pgtbl;
-	ssize_t offset;
-
 	printk(BIOS_DEBUG, "%s: Using virtual address %p as scratchpad\n",
 	       __func__, vmem_addr);
 	printk(BIOS_DEBUG, "%s: Using address %p for page tables\n",
-	       __func__, pgtbl_buf);
+	       __func__, pgtbl);
+
+	return memset_pae_with(dest, pat, length, pgtbl, vmem_addr, memset);
+}
+
+int memset_pae_with(uint64_t dest, unsigned char pat, uint64_t length,
+		    void *pgtbl, void *vmem_addr,
+		    void *(*fill)(void *dst, int c, size_t len))
+{
+	struct pg_table *pgtbl_buf = (struct pg_table *)pgtbl;
+	ssize_t offset;
 
 	/* Cover some basic error conditions */
 	if (!IS_ALIGNED((uintptr_t)pgtbl_buf, s4KiB) ||
@@ -201,7 +208,7 @@ int memset_pae(uint64_t dest, unsigned char pat, uint64_t length, void *pgtbl,
 		printk(BIOS_SPEW, "%s: Clearing %llx[%lx] - %zx\n", __func__,
 		       dest + offset, (uintptr_t)vmem_addr + offset, len);
 
-		memset(vmem_addr + offset, pat, len);
+		fill(vmem_addr + offset, pat, len);
 
 		dest += s2MiB;
 		length -= len;
@@ -6,12 +6,14 @@
 
 #include <console/console.h>
 #include <device/device.h>
+#include <device/device_timing.h>
 #include <device/pci_def.h>
 #include <device/pci_ids.h>
 #include <post.h>
 #include <stdlib.h>
 #include <string.h>
 #include <smp/spinlock.h>
+#include <thread.h>
 #if ENV_X86
 #include <arch/ebda.h>
 #endif
@@ -160,6 +162,7 @@ static void read_resources(struct bus *bus)
 	/* Walk through all devices and find which resources they need. */
 	for (curdev = bus->children; curdev; curdev = curdev->sibling) {
 		struct bus *link;
+		struct stopwatch sw;
 
 		if (!curdev->enabled)
 			continue;
@@ -171,7 +174,9 @@ static void read_resources(struct bus *bus)
 			continue;
 		}
 		post_log_path(curdev);
+		stopwatch_init(&sw);
 		curdev->ops->read_resources(curdev);
+		dev_timing_record_dev(curdev, DEV_TIMING_READ_RESOURCES, &sw);
 
 		/* Read in the resources behind the current device's links. */
 		for (link = curdev->link_list; link; link = link->next)
@@ -272,6 +277,8 @@ void assign_resources(struct bus *bus)
 	       dev_path(bus->dev), __func__, bus->secondary, bus->link_num);
 
 	for (curdev = bus->children; curdev; curdev = curdev->sibling) {
+		struct stopwatch sw;
+
 		if (!curdev->enabled || !curdev->resource_list)
 			continue;
 
@@ -281,7 +288,9 @@ void assign_resources(struct bus *bus)
 			continue;
 		}
 		post_log_path(curdev);
+		stopwatch_init(&sw);
 		curdev->ops->set_resources(curdev);
+		dev_timing_record_dev(curdev, DEV_TIMING_SET_RESOURCES, &sw);
 	}
 	post_log_clear();
 	printk(BIOS_SPEW, "%s %s, bus %d link: %d done\n",
@@ -307,8 +316,12 @@ static void enable_resources(struct bus *link)
 
 	for (dev = link->children; dev; dev = dev->sibling) {
 		if (dev->enabled && dev->ops && dev->ops->enable_resources) {
+			struct stopwatch sw;
+
 			post_log_path(dev);
+			stopwatch_init(&sw);
 			dev->ops->enable_resources(dev);
+			dev_timing_record_dev(dev, DEV_TIMING_ENABLE_RESOURCES, &sw);
 		}
 	}
 
@@ -529,6 +542,7 @@ static void init_dev(struct device *dev)
 		stopwatch_init(&sw);
 		dev->initialized = 1;
 		dev->ops->init(dev);
+		dev_timing_record_dev(dev, DEV_TIMING_INIT, &sw);
 
 		init_time = stopwatch_duration_msecs(&sw);
 		printk(BIOS_DEBUG, "%s init finished in %ld msecs\n", dev_path(dev),
@@ -536,6 +550,58 @@ static void init_dev(struct device *dev)
 	}
 }
 
+static void init_link(struct bus *link);
+
+/* Number of device subtrees still being initialized on other threads. */
+static int async_inits_pending;
+
+/* How long dev_initialize() waits for them before it warns. */
+#define ASYNC_INIT_TIMEOUT_MS 10000
+
+static void init_subtree(void *arg)
+{
+	struct device *dev = arg;
+	struct bus *link;
+
+	post_log_path(dev);
+	init_dev(dev);
+
+	for (link = dev->link_list; link; link = link->next)
+		init_link(link);
+
+	if (dev->init_in_thread)
+		async_inits_pending--;
+}
+
+/*
+ * Hand a device that opted in via async_init off to a cooperative thread,
+ * which initializes it and everything below it. The thread runs whenever
+ * the current one waits in udelay(), so slow init() methods of independent
+ * subtrees overlap. Returns 1 if the subtree was handed off.
+ */
+static int init_dev_async(struct device *dev)
+{
+	if (!CONFIG(PARALLEL_DEV_INIT) || !dev->enabled || !dev->ops ||
+	    !dev->ops->async_init)
+		return 0;
+
+	/* Running out of threads is expected, just initialize in place. */
+	if (!thread_available())
+		return 0;
+
+	printk(BIOS_DEBUG, "%s init on thread\n", dev_path(dev));
+
+	dev->init_in_thread = 1;
+	async_inits_pending++;
+	if (thread_run(init_subtree, dev) < 0) {
+		dev->init_in_thread = 0;
+		async_inits_pending--;
+		return 0;
+	}
+
+	return 1;
+}
+
 static void init_link(struct bus *link)
 {
 	struct device *dev;
@@ -543,11 +609,16 @@ static void init_link(struct bus *link)
 
 	for (dev = link->children; dev; dev = dev->sibling) {
 		post_code(POST_BS_DEV_INIT);
+		if (init_dev_async(dev))
+			continue;
 		post_log_path(dev);
 		init_dev(dev);
 	}
 
 	for (dev = link->children; dev; dev = dev->sibling) {
+		/* The thread takes care of the device's children. */
+		if (dev->init_in_thread)
+			continue;
 		for (c_link = dev->link_list; c_link; c_link = c_link->next)
 			init_link(c_link);
 	}
@@ -562,6 +633,7 @@ static void init_link(struct bus *link)
 void dev_initialize(void)
 {
 	struct bus *link;
+	struct stopwatch sw;
 
 	printk(BIOS_INFO, "Initializing devices...\n");
 
@@ -576,6 +648,20 @@ void dev_initialize(void)
 	/* Now initialize everything. */
 	for (link = dev_root.link_list; link; link = link->next)
 		init_link(link);
+
+	/*
+	 * Let the threads started above run to completion. Every device has to
+	 * be initialized before BS_DEV_INIT is left, so never stop waiting.
+	 */
+	stopwatch_init_msecs_expire(&sw, ASYNC_INIT_TIMEOUT_MS);
+	while (async_inits_pending && !stopwatch_expired(&sw))
+		thread_yield_microseconds(100);
+	if (async_inits_pending) {
+		printk(BIOS_WARNING, "%d device subtrees still initializing after %d ms\n",
+		       async_inits_pending, ASYNC_INIT_TIMEOUT_MS);
+		while (async_inits_pending)
+			thread_yield_microseconds(100);
+	}
 	post_log_clear();
 
 	printk(BIOS_INFO, "Devices initialized\n");
@@ -597,8 +683,12 @@ static void final_dev(struct device *dev)
 		return;
 
 	if (dev->ops && dev->ops->final) {
+		struct stopwatch sw;
+
 		printk(BIOS_DEBUG, "%s final\n", dev_path(dev));
+		stopwatch_init(&sw);
 		dev->ops->final(dev);
+		dev_timing_record_dev(dev, DEV_TIMING_FINAL, &sw);
 	}
 }
 
@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <cbmem.h>
+#include <console/console.h>
+#include <device/device.h>
+#include <device/device_timing.h>
+#include <string.h>
+
+static struct dev_timing_table *timing_table;
+
+static struct dev_timing_table *dev_timing_table(void)
+{
+	size_t size;
+
+	if (timing_table)
+		return timing_table;
+
+	size = sizeof(*timing_table) +
+		CONFIG_DEVICE_TIMING_ENTRIES * sizeof(timing_table->entries[0]);
+	timing_table = cbmem_add(CBMEM_ID_DEV_TIMING, size);
+	if (!timing_table) {
+		printk(BIOS_ERR, "Unable to allocate device timing table\n");
+		return NULL;
+	}
+
+	/* On S3 resume this is the previous boot's table, start over. */
+	timing_table->max_entries = CONFIG_DEVICE_TIMING_ENTRIES;
+	timing_table->num_entries = 0;
+	timing_table->dropped = 0;
+
+	return timing_table;
+}
+
+void dev_timing_record(const char *name, enum dev_timing_op op,
+		       const struct mono_time *start, const struct mono_time *end)
+{
+	struct dev_timing_table *table = dev_timing_table();
+	struct dev_timing_entry *entry;
+
+	if (!table)
+		return;
+
+	if (table->num_entries >= table->max_entries) {
+		table->dropped++;
+		return;
+	}
+
+	entry = &table->entries[table->num_entries++];
+	strncpy(entry->name, name, sizeof(entry->name) - 1);
+	entry->name[sizeof(entry->name) - 1] = '\0';
+	entry->op = op;
+	entry->start_usecs = start->microseconds;
+	entry->duration_usecs = mono_time_diff_microseconds(start, end);
+}
+
+void dev_timing_record_dev(const struct device *dev, enum dev_timing_op op,
+			   struct stopwatch *sw)
+{
+	stopwatch_tick(sw);
+	dev_timing_record(dev_path(dev), op, &sw->start, &sw->current);
+}
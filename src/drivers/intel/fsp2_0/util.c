@@ -155,7 +155,8 @@ static void *fsp_get_dest_and_load(struct fsp_load_descriptor *fspld, size_t siz
 		return dest;
 
 	if (cbfs_load_and_decompress(source_rdev, 0, region_device_sz(source_rdev),
-			dest, size, compression_algo) != size) {
+			dest, size, compression_algo,
+			prog_cbfs_hash(&fspld->fsp_prog)) != size) {
 		printk(BIOS_ERR, "Failed to load FSP component.\n");
 		return NULL;
 	}
@@ -193,6 +194,7 @@ enum cb_err fsp_load_component(struct fsp_load_descriptor *fspld, struct fsp_hea
 		return CB_ERR;
 
 	cbfs_file_data(&source_rdev, &file_desc);
+	prog_set_cbfs_hash(fsp_prog, &file_desc.mdata);
 
 	dest = fsp_get_dest_and_load(fspld, output_size, &source_rdev, compression_algo);
 
@@ -16,16 +16,42 @@
 #define SINGLE_CHAR_TIMEOUT	(50 * 1000)
 #define FIFO_TIMEOUT		(16 * SINGLE_CHAR_TIMEOUT)
 
-static int uart8250_can_tx_byte(unsigned int base_port)
+/*
+ * Transmit FIFO state per UART. extra is how many bytes the FIFO takes beyond
+ * the one every 8250 has, room how many can still be written before LSR has
+ * to be checked again. All zero means byte by byte, which keeps this in .bss
+ * for the pre-RAM stages. Unknown UARTs share a slot that stays that way.
+ */
+struct tx_fifo {
+	unsigned int extra;
+	unsigned int room;
+};
+
+static const unsigned int bases[] = { 0x3f8, 0x2f8, 0x3e8, 0x2e8 };
+
+static struct tx_fifo tx_fifos[ARRAY_SIZE(bases) + 1];
+
+static struct tx_fifo *uart8250_tx_fifo(unsigned int idx)
+{
+	return &tx_fifos[MIN(idx, ARRAY_SIZE(bases))];
+}
+
+static int uart8250_can_tx_byte(unsigned int base_port, struct tx_fifo *fifo)
 {
-	return inb(base_port + UART8250_LSR) & UART8250_LSR_THRE;
+	/* THRE means the whole transmit FIFO is empty. */
+	if (!fifo->room && (inb(base_port + UART8250_LSR) & UART8250_LSR_THRE))
+		fifo->room = 1 + fifo->extra;
+	return fifo->room;
 }
 
-static void uart8250_tx_byte(unsigned int base_port, unsigned char data)
+static void uart8250_tx_byte(unsigned int base_port, struct tx_fifo *fifo,
+			     unsigned char data)
 {
 	unsigned long int i = SINGLE_CHAR_TIMEOUT;
-	while (i-- && !uart8250_can_tx_byte(base_port));
+	while (i-- && !uart8250_can_tx_byte(base_port, fifo));
 	outb(data, base_port + UART8250_TBR);
+	if (fifo->room)
+		fifo->room--;
 }
 
 static void uart8250_tx_flush(unsigned int base_port)
@@ -51,12 +77,19 @@ static unsigned char uart8250_rx_byte(unsigned int base_port)
 		return 0x0;
 }
 
-static void uart8250_init(unsigned int base_port, unsigned int divisor)
+static void uart8250_init(unsigned int base_port, struct tx_fifo *fifo,
+			  unsigned int divisor)
 {
 	/* Disable interrupts */
 	outb(0x0, base_port + UART8250_IER);
 	/* Enable FIFOs */
 	outb(UART8250_FCR_FIFO_EN, base_port + UART8250_FCR);
+	fifo->room = 0;
+	if (fifo != uart8250_tx_fifo(ARRAY_SIZE(bases)) &&
+	    (inb(base_port + UART8250_IIR) & UART8250_IIR_FIFO) == UART8250_IIR_FIFO)
+		fifo->extra = CONFIG_DRIVERS_UART_8250_TX_FIFO_SIZE - 1;
+	else
+		fifo->extra = 0;
 
 	/* assert DTR and RTS so the other end is happy */
 	outb(UART8250_MCR_DTR | UART8250_MCR_RTS, base_port + UART8250_MCR);
@@ -72,8 +105,6 @@ static void uart8250_init(unsigned int base_port, unsigned int divisor)
 	outb(CONFIG_TTYS0_LCS, base_port + UART8250_LCR);
 }
 
-static const unsigned int bases[] = { 0x3f8, 0x2f8, 0x3e8, 0x2e8 };
-
 uintptr_t uart_platform_base(unsigned int idx)
 {
 	if (idx < ARRAY_SIZE(bases))
@@ -87,13 +118,20 @@ void uart_init(unsigned int idx)
 		unsigned int div;
 		div = uart_baudrate_divisor(get_uart_baudrate(),
 			uart_platform_refclk(), uart_input_clock_divider());
-		uart8250_init(uart_platform_base(idx), div);
+		uart8250_init(uart_platform_base(idx), uart8250_tx_fifo(idx),
+			      div);
 	}
 }
 
 void uart_tx_byte(unsigned int idx, unsigned char data)
 {
-	uart8250_tx_byte(uart_platform_base(idx), data);
+	uart8250_tx_byte(uart_platform_base(idx), uart8250_tx_fifo(idx), data);
+}
+
+int uart_can_tx_byte(unsigned int idx)
+{
+	return uart8250_can_tx_byte(uart_platform_base(idx),
+				    uart8250_tx_fifo(idx));
 }
 
 unsigned char uart_rx_byte(unsigned int idx)
@@ -39,17 +39,43 @@ static void uart8250_write(void *base, uint8_t reg, uint8_t data)
 }
 #endif
 
-static int uart8250_mem_can_tx_byte(void *base)
+/*
+ * Transmit FIFO state per UART. extra is how many bytes the FIFO takes beyond
+ * the one every 8250 has, room how many can still be written before LSR has
+ * to be checked again. All zero means byte by byte, which keeps this in .bss
+ * for the pre-RAM stages. Unknown UARTs share a slot that stays that way.
+ */
+#define TX_FIFO_UARTS	8
+
+struct tx_fifo {
+	unsigned int extra;
+	unsigned int room;
+};
+
+static struct tx_fifo tx_fifos[TX_FIFO_UARTS + 1];
+
+static struct tx_fifo *uart8250_tx_fifo(unsigned int idx)
+{
+	return &tx_fifos[MIN(idx, TX_FIFO_UARTS)];
+}
+
+static int uart8250_mem_can_tx_byte(void *base, struct tx_fifo *fifo)
 {
-	return uart8250_read(base, UART8250_LSR) & UART8250_LSR_THRE;
+	/* THRE means the whole transmit FIFO is empty. */
+	if (!fifo->room && (uart8250_read(base, UART8250_LSR) & UART8250_LSR_THRE))
+		fifo->room = 1 + fifo->extra;
+	return fifo->room;
 }
 
-static void uart8250_mem_tx_byte(void *base, unsigned char data)
+static void uart8250_mem_tx_byte(void *base, struct tx_fifo *fifo,
+				 unsigned char data)
 {
 	unsigned long int i = SINGLE_CHAR_TIMEOUT;
-	while (i-- && !uart8250_mem_can_tx_byte(base))
+	while (i-- && !uart8250_mem_can_tx_byte(base, fifo))
 		udelay(1);
 	uart8250_write(base, UART8250_TBR, data);
+	if (fifo->room)
+		fifo->room--;
 }
 
 static void uart8250_mem_tx_flush(void *base)
@@ -77,12 +103,19 @@ static unsigned char uart8250_mem_rx_byte(void *base)
 		return 0x0;
 }
 
-static void uart8250_mem_init(void *base, unsigned int divisor)
+static void uart8250_mem_init(void *base, struct tx_fifo *fifo,
+			      unsigned int divisor)
 {
 	/* Disable interrupts */
 	uart8250_write(base, UART8250_IER, 0x0);
 	/* Enable FIFOs */
 	uart8250_write(base, UART8250_FCR, UART8250_FCR_FIFO_EN);
+	fifo->room = 0;
+	if (fifo != uart8250_tx_fifo(TX_FIFO_UARTS) &&
+	    (uart8250_read(base, UART8250_IIR) & UART8250_IIR_FIFO) == UART8250_IIR_FIFO)
+		fifo->extra = CONFIG_DRIVERS_UART_8250_TX_FIFO_SIZE - 1;
+	else
+		fifo->extra = 0;
 
 	/* Assert DTR and RTS so the other end is happy */
 	uart8250_write(base, UART8250_MCR, UART8250_MCR_DTR | UART8250_MCR_RTS);
@@ -106,7 +139,7 @@ void uart_init(unsigned int idx)
 	unsigned int div;
 	div = uart_baudrate_divisor(get_uart_baudrate(),
 		uart_platform_refclk(), uart_input_clock_divider());
-	uart8250_mem_init(base, div);
+	uart8250_mem_init(base, uart8250_tx_fifo(idx), div);
 }
 
 void uart_tx_byte(unsigned int idx, unsigned char data)
@@ -114,7 +147,15 @@ void uart_tx_byte(unsigned int idx, unsigned char data)
 	void *base = uart_platform_baseptr(idx);
 	if (!base)
 		return;
-	uart8250_mem_tx_byte(base, data);
+	uart8250_mem_tx_byte(base, uart8250_tx_fifo(idx), data);
+}
+
+int uart_can_tx_byte(unsigned int idx)
+{
+	void *base = uart_platform_baseptr(idx);
+	if (!base)
+		return 1;
+	return uart8250_mem_can_tx_byte(base, uart8250_tx_fifo(idx));
 }
 
 unsigned char uart_rx_byte(unsigned int idx)
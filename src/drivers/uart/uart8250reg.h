@@ -17,6 +17,7 @@
 #define UART8250_IIR 0x02
 #define   UART8250_IIR_NO_INT	0x01 /* No interrupts pending */
 #define   UART8250_IIR_ID	0x06 /* Mask for the interrupt ID */
+#define   UART8250_IIR_FIFO	0xC0 /* FIFOs enabled and working (16550A) */
 
 #define   UART8250_IIR_MSI	0x00 /* Modem status interrupt */
 #define   UART8250_IIR_THRI	0x02 /* Transmitter holding register empty */
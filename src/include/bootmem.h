@@ -93,4 +93,12 @@ int bootmem_region_targets_type(uint64_t start, uint64_t size,
 /* Allocate a temporary buffer from the unused RAM areas. */
 void *bootmem_allocate_buffer(size_t size);
 
+/*
+ * Initialize mem with all fixed, cacheable DRAM as BM_MEM_RAM, except for
+ * CBMEM, which also holds the ramstage program, stack and heap. This is the
+ * DRAM ramstage can overwrite at the end of device init. The caller has to
+ * tear mem down again.
+ */
+void bootmem_init_unused_dram(struct memranges *mem);
+
 #endif /* BOOTMEM_H */
@@ -45,11 +45,34 @@ size_t cbfs_ro_load(const char *name, void *buf, size_t buf_size);
  * large |buffer|, decompressing it according to |compression| in the process.
  * Returns the decompressed file size, or 0 on error.
  * LZMA files will be mapped for decompression. LZ4 files will be decompressed
- * in-place with the buffer size requirements outlined in compression.h. */
+ * in-place with the buffer size requirements outlined in compression.h.
+ * If |file_hash| is not NULL and CONFIG(CBFS_FILE_HASH_CHECK) is enabled, all
+ * of |rdev| (the whole CBFS file) is checked against it while it is read, and
+ * a mismatch is an error. */
 size_t cbfs_load_and_decompress(const struct region_device *rdev, size_t offset,
-	size_t in_size, void *buffer, size_t buffer_size, uint32_t compression);
+	size_t in_size, void *buffer, size_t buffer_size, uint32_t compression,
+	const struct vb2_hash *file_hash);
+/* Decompress the |srcn| bytes of chunked (CBFS_COMPRESS_*_CHUNKED) data at
+ * |src| into the |dstn| bytes large |dst|. In ramstage, the chunks are spread
+ * across all CPUs when CONFIG(CBFS_CHUNKED_PARALLEL) is enabled and the APs
+ * are waiting for work; otherwise they are decompressed one after another.
+ * Returns the decompressed size, or 0 on error. */
+size_t cbfs_decompress_chunked(const void *src, size_t srcn, void *dst,
+			       size_t dstn, uint32_t compression);
+/* Undo the branch conversion of the |size| bytes at |buf| that were just
+ * decompressed from a CBFS_COMPRESS_LZMA_BCJ_* file. Does nothing for any
+ * other |compression|. Returns |size|. */
+size_t cbfs_bcj_decode(void *buf, size_t size, uint32_t compression);
 
-/* Load stage into memory filling in prog. Return 0 on success. < 0 on error. */
+/* Append |name| to the CBFS access trace in CBMEM (CONFIG_CBFS_ACCESS_TRACE). */
+void cbfs_access_trace_record(const char *name);
+
+/* Remember the hash attribute of the CBFS file described by |mdata| (if any and
+   if CONFIG(CBFS_FILE_HASH_CHECK) is enabled) as prog_cbfs_hash() of |prog|. */
+void prog_set_cbfs_hash(struct prog *prog, const union cbfs_mdata *mdata);
+
+/* Load stage into memory filling in prog. Return 0 on success. < 0 on error.
+   The file is checked against prog_cbfs_hash() while it is loaded. */
 int cbfs_prog_stage_load(struct prog *prog);
 
 /*
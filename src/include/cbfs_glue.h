@@ -19,6 +19,12 @@
 #define CBFS_ENABLE_HASHING (CONFIG(CBFS_VERIFICATION) && \
 			     (CONFIG(TOCTOU_SAFETY) || ENV_INITIAL_STAGE))
 
+/*
+ * Other CPUs may walk the CBFS at the same time in ramstage and SMM, and the read-ahead
+ * buffer is shared. Those stages mostly find their files in the mcache anyway.
+ */
+#define CBFS_READAHEAD_SIZE ((ENV_RAMSTAGE || ENV_SMM) ? 0 : CONFIG_CBFS_READAHEAD_SIZE)
+
 #define ERROR(...) printk(BIOS_ERR, "CBFS ERROR: " __VA_ARGS__)
 #define LOG(...) printk(BIOS_ERR, "CBFS: " __VA_ARGS__)
 #define DEBUG(...) do { \
@@ -2,10 +2,17 @@
 #ifndef _CONSOLE_CBMEM_CONSOLE_H_
 #define _CONSOLE_CBMEM_CONSOLE_H_
 
+#include <stdarg.h>
 #include <stdint.h>
 
 void cbmemc_init(void);
 void cbmemc_tx_byte(unsigned char data);
+/*
+ * Store a message as a binary record instead of text, see
+ * commonlib/console_deferred_serialized.h. Returns the size of the record or
+ * -1 if the message has to be formatted by the caller.
+ */
+int cbmemc_log_deferred(const char *fmt, va_list args);
 
 #define __CBMEM_CONSOLE_ENABLE__	(CONFIG(CONSOLE_CBMEM) && \
 	(ENV_RAMSTAGE || ENV_SEPARATE_VERSTAGE || ENV_POSTCAR  || \
@@ -14,9 +21,17 @@ void cbmemc_tx_byte(unsigned char data);
 #if __CBMEM_CONSOLE_ENABLE__
 static inline void __cbmemc_init(void)	{ cbmemc_init(); }
 static inline void __cbmemc_tx_byte(u8 data)	{ cbmemc_tx_byte(data); }
+static inline int __cbmemc_log_deferred(const char *fmt, va_list args)
+{
+	return cbmemc_log_deferred(fmt, args);
+}
 #else
 static inline void __cbmemc_init(void)	{}
 static inline void __cbmemc_tx_byte(u8 data)	{}
+static inline int __cbmemc_log_deferred(const char *fmt, va_list args)
+{
+	return -1;
+}
 #endif
 
 void cbmem_dump_console(void);
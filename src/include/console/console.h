@@ -56,6 +56,12 @@ void do_putchar(unsigned char byte);
    get_and_reset() call. */
 long console_time_get_and_reset(void);
 void console_time_report(void);
+#if CONFIG(CONSOLE_SERIAL_NONBLOCKING)
+/* Wait until output queued for slow consoles has been sent. */
+void console_drain(void);
+#else
+static inline void console_drain(void) {}
+#endif
 
 #define printk(LEVEL, fmt, args...) do_printk(LEVEL, fmt, ##args)
 #define vprintk(LEVEL, fmt, args) do_vprintk(LEVEL, fmt, args)
@@ -69,6 +75,7 @@ static inline void vprintk(int LEVEL, const char *fmt, va_list args) {}
 static inline void do_putchar(unsigned char byte) {}
 static inline long console_time_get_and_reset(void) { return 0; }
 static inline void console_time_report(void) {}
+static inline void console_drain(void) {}
 #endif
 
 int do_printk(int msg_level, const char *fmt, ...)
@@ -50,6 +50,8 @@ void uart_bitbang_tx_byte(unsigned char data, void (*set_tx)(int line_state));
 void uart_init(unsigned int idx);
 void uart_tx_byte(unsigned int idx, unsigned char data);
 void uart_tx_flush(unsigned int idx);
+/* Only 8250: return non-zero if uart_tx_byte() would not have to wait. */
+int uart_can_tx_byte(unsigned int idx);
 unsigned char uart_rx_byte(unsigned int idx);
 
 uintptr_t uart_platform_base(unsigned int idx);
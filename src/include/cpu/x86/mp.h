@@ -5,6 +5,7 @@
 
 #include <arch/smp/atomic.h>
 #include <cpu/x86/smm.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -128,6 +129,19 @@ int mp_run_on_aps(void (*func)(void *), void *arg, int logical_cpu_num,
 /* Like mp_run_on_aps() but also runs func on BSP. */
 int mp_run_on_all_cpus(void (*func)(void *), void *arg);
 
+/*
+ * Runs func on all APs and the BSP at the same time and only returns once
+ * all of them are done. func has to cope with any number of CPUs taking part,
+ * e.g. by taking work items off a shared queue: if the APs can't take work,
+ * it only runs on the BSP and < 0 is returned. Either way no CPU runs func
+ * anymore once it returns, also not an AP that accepts the call too late.
+ */
+int mp_run_on_all_cpus_synchronously(void (*func)(void *), void *arg);
+
+/* Returns true once mp_init_with_smm() brought up the APs with
+   PARALLEL_MP_AP_WORK and until they get parked. */
+bool mp_aps_waiting_for_work(void);
+
 /*
  * Park all APs to prepare for OS boot. This is handled automatically
  * by the coreboot infrastructure.
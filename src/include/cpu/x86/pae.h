@@ -51,5 +51,10 @@ void *map_2M_page(unsigned long page);
 
 int memset_pae(uint64_t dest, unsigned char pat, uint64_t length, void *pgtbl,
 	       void *vmem_addr);
+/* Like memset_pae(), but fills each mapped window with the given function.
+   Each CPU calling it concurrently needs its own page tables. */
+int memset_pae_with(uint64_t dest, unsigned char pat, uint64_t length,
+		    void *pgtbl, void *vmem_addr,
+		    void *(*fill)(void *dst, int c, size_t len));
 
 #endif /* CPU_X86_PAE_H  */
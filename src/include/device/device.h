@@ -45,6 +45,12 @@ struct device_operations {
 	void (*enable)(struct device *dev);
 	void (*vga_disable)(struct device *dev);
 	void (*reset_bus)(struct bus *bus);
+	/*
+	 * With PARALLEL_DEV_INIT, run init() and the initialization of all
+	 * devices below this one on a separate thread. Only set this if
+	 * init() doesn't depend on devices outside of its own subtree.
+	 */
+	bool async_init;
 #if CONFIG(GENERATE_SMBIOS_TABLES)
 	int (*get_smbios_data)(struct device *dev, int *handle,
 		unsigned long *current);
@@ -127,6 +133,8 @@ struct device {
 	unsigned int    hidden : 1;
 	/* set if this device is used even in minimum PCI cases */
 	unsigned int    mandatory : 1;
+	/* set if this device and its subtree are initialized on a thread */
+	unsigned int    init_in_thread : 1;
 	u8 command;
 	uint16_t hotplug_buses; /* Number of hotplug buses to allocate */
 
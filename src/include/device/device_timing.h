@@ -0,0 +1,25 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef DEVICE_TIMING_H
+#define DEVICE_TIMING_H
+
+#include <commonlib/dev_timing_serialized.h>
+#include <timer.h>
+
+struct device;
+
+#if CONFIG(DEVICE_TIMING) && ENV_RAMSTAGE
+/* Record that `name` spent the time from start to end in operation op. */
+void dev_timing_record(const char *name, enum dev_timing_op op,
+		       const struct mono_time *start, const struct mono_time *end);
+/* Record a device operation timed by a stopwatch started right before it. */
+void dev_timing_record_dev(const struct device *dev, enum dev_timing_op op,
+			   struct stopwatch *sw);
+#else
+static inline void dev_timing_record(const char *name, enum dev_timing_op op,
+		const struct mono_time *start, const struct mono_time *end) {}
+static inline void dev_timing_record_dev(const struct device *dev,
+		enum dev_timing_op op, struct stopwatch *sw) {}
+#endif
+
+#endif /* DEVICE_TIMING_H */
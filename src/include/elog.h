@@ -206,6 +206,15 @@ struct elog_event_mem_cache_update {
 #define ELOG_TYPE_MI_HRPC                 0xb4
 #define ELOG_TYPE_MI_HR                   0xb5
 
+/* DRAM test failure, one event per failing address */
+#define ELOG_TYPE_MEM_TEST_FAIL           0xb6
+struct elog_event_mem_test_fail {
+	u32 errors;	/* Failing 64-bit words found in total */
+	u64 address;
+	u64 expected;
+	u64 actual;
+} __packed;
+
 struct elog_event_extended_event {
 	u8 event_type;
 	u32 event_complement;
@@ -3,6 +3,7 @@
 #ifndef _IMD_H_
 #define _IMD_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
@@ -95,14 +96,14 @@ int imd_lockdown(struct imd *imd);
 int imd_region_used(struct imd *imd, void **base, size_t *size);
 
 /* Add an entry to the imd. If id already exists NULL is returned. */
-const struct imd_entry *imd_entry_add(const struct imd *imd, uint32_t id,
+const struct imd_entry *imd_entry_add(struct imd *imd, uint32_t id,
 					size_t size);
 
 /* Locate an entry within the imd. NULL is returned when not found. */
-const struct imd_entry *imd_entry_find(const struct imd *imd, uint32_t id);
+const struct imd_entry *imd_entry_find(struct imd *imd, uint32_t id);
 
 /* Find an existing entry or add a new one. */
-const struct imd_entry *imd_entry_find_or_add(const struct imd *imd,
+const struct imd_entry *imd_entry_find_or_add(struct imd *imd,
 						uint32_t id, size_t size);
 
 /* Returns size of entry. */
@@ -115,7 +116,7 @@ void *imd_entry_at(const struct imd *imd, const struct imd_entry *entry);
 uint32_t imd_entry_id(const struct imd_entry *entry);
 
 /* Attempt to remove entry from imd. */
-int imd_entry_remove(const struct imd *imd, const struct imd_entry *entry);
+int imd_entry_remove(struct imd *imd, const struct imd_entry *entry);
 
 /* Print the entry information provided by lookup with the specified size. */
 struct imd_lookup {
@@ -140,9 +141,17 @@ const struct imd_entry *imd_cursor_next(struct imd_cursor *cursor);
  * NOTE: Do not directly touch any fields within this structure. An imd pointer
  * is meant to be opaque, but the fields are exposed for stack allocation.
  */
+#define IMD_INDEX_SLOTS 128
+
 struct imdr {
 	uintptr_t limit;
 	void *r;
+	/* Hash of entry ids to entry numbers, valid while root and number of
+	   entries match the ones it was built for. */
+	const void *index_root;
+	uint32_t index_entries;
+	bool index_overflow;
+	uint8_t index[IMD_INDEX_SLOTS];
 };
 struct imd {
 	struct imdr lg;
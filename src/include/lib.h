@@ -10,6 +10,32 @@
 /* Defined in src/lib/lzma.c. Returns decompressed size or 0 on error. */
 size_t ulzman(const void *src, size_t srcn, void *dst, size_t dstn);
 
+/* Defined in src/lib/lzma.c. Same as ulzman(), but keeps the decoder state in
+   the caller's |scratchpad| of ULZMA_SCRATCHPAD_SIZE bytes instead of a static
+   buffer, so that several CPUs can decompress at the same time. */
+#define ULZMA_SCRATCHPAD_SIZE 15980
+size_t ulzman_scratch(const void *src, size_t srcn, void *dst, size_t dstn,
+		      void *scratchpad);
+
+/* Defined in src/lib/lzma.c. Same as ulzman(), but reads the |srcn| bytes of
+   compressed input at |offset| in |rdev| through a small window buffer while
+   decoding, instead of requiring the whole input to be mapped. If |consume| is
+   not NULL, it is passed every piece of input in order as soon as it was read,
+   e.g. to hash it. */
+struct region_device;
+size_t ulzman_rdev(const struct region_device *rdev, size_t offset,
+		   size_t srcn, void *dst, size_t dstn,
+		   void (*consume)(void *arg, const void *buf, size_t size),
+		   void *consume_arg);
+
+/* Defined in src/lib/lzma.c. Same as ulzman(), but hands the input to the
+   decoder in small pieces and passes each one to |consume| right before it is
+   decoded, e.g. to hash it while it is in the cache. All |srcn| bytes are
+   passed on. */
+size_t ulzman_consume(const void *src, size_t srcn, void *dst, size_t dstn,
+		      void (*consume)(void *arg, const void *buf, size_t size),
+		      void *consume_arg);
+
 /* Defined in src/lib/ramtest.c */
 /* Assumption is 32-bit addressable UC memory. */
 void ram_check(uintptr_t start);
@@ -0,0 +1,22 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <stdint.h>
+
+/*
+ * Record a sample from the profiler's timer interrupt. `pc` is the
+ * interrupted program counter, `fp` its frame pointer and `sp` a stack
+ * address below the interrupted frame.
+ */
+void profiler_record(uintptr_t pc, uintptr_t fp, uintptr_t sp);
+
+/*
+ * Implemented by the architecture: start calling profiler_record() every
+ * `period_us` microseconds on the boot CPU, and stop again.
+ */
+int arch_profiler_start(unsigned int period_us);
+void arch_profiler_stop(void);
+
+#endif /* __PROFILER_H__ */
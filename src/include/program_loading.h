@@ -6,6 +6,7 @@
 #include <commonlib/region.h>
 #include <stdint.h>
 #include <stddef.h>
+#include <vb2_sha.h>
 
 enum {
 	/* Last segment of program. Can be used to take different actions for
@@ -48,6 +49,8 @@ struct prog {
 	uint32_t cbfs_type;
 	const char *name;
 	struct region_device rdev;
+	/* Hash of the CBFS file, algo is VB2_HASH_INVALID if it has none. */
+	struct vb2_hash cbfs_hash;
 	/* Entry to program with optional argument. It's up to the architecture
 	 * to decide if argument is passed. */
 	void (*entry)(void *);
@@ -80,6 +83,12 @@ static inline struct region_device *prog_rdev(struct prog *prog)
 	return &prog->rdev;
 }
 
+/* Expected hash of the CBFS file prog_rdev() points to, or NULL. */
+static inline const struct vb2_hash *prog_cbfs_hash(const struct prog *prog)
+{
+	return prog->cbfs_hash.algo != VB2_HASH_INVALID ? &prog->cbfs_hash : NULL;
+}
+
 /* Only valid for loaded programs. */
 static inline size_t prog_size(const struct prog *prog)
 {
@@ -33,6 +33,8 @@ int thread_run(void (*func)(void *), void *arg);
  * machine. */
 int thread_run_until(void (*func)(void *), void *arg,
 		     boot_state_t state, boot_state_sequence_t seq);
+/* Return 1 if thread_run() would find a free thread to start, 0 otherwise. */
+int thread_available(void);
 /* Return 0 on successful yield for the given amount of time, < 0 when thread
  * did not yield. */
 int thread_yield_microseconds(unsigned int microsecs);
@@ -59,6 +61,7 @@ void arch_prepare_thread(struct thread *t,
 #else
 static inline void threads_initialize(void) {}
 static inline int thread_run(void (*func)(void *), void *arg) { return -1; }
+static inline int thread_available(void) { return 0; }
 static inline int thread_yield_microseconds(unsigned int microsecs)
 {
 	return -1;
@@ -85,6 +85,21 @@ static void bootmem_init(void)
 	bootmem_platform_add_ranges();
 }
 
+void bootmem_init_unused_dram(struct memranges *mem)
+{
+	const unsigned long dram = IORESOURCE_MEM | IORESOURCE_FIXED |
+				   IORESOURCE_STORED | IORESOURCE_ASSIGNED |
+				   IORESOURCE_CACHEABLE;
+	void *baseptr = NULL;
+	size_t size = 0;
+
+	/* FSP1.0 is marked as MMIO and won't appear here */
+	memranges_init(mem, dram, dram, BM_MEM_RAM);
+
+	cbmem_get_region(&baseptr, &size);
+	memranges_insert(mem, (uintptr_t)baseptr, size, BM_MEM_TABLE);
+}
+
 void bootmem_add_range(uint64_t start, uint64_t size,
 		       const enum bootmem_type tag)
 {
@@ -13,11 +13,16 @@
 #include <metadata_hash.h>
 #include <security/tpm/tspi/crtm.h>
 #include <security/vboot/vboot_common.h>
+#include <smp/spinlock.h>
 #include <stdlib.h>
 #include <string.h>
 #include <symbols.h>
 #include <timestamp.h>
 
+#if ENV_RAMSTAGE && CONFIG(CBFS_CHUNKED_PARALLEL)
+#include <cpu/x86/mp.h>
+#endif
+
 cb_err_t cbfs_boot_lookup(const char *name, bool force_ro,
 			  union cbfs_mdata *mdata, struct region_device *rdev)
 {
@@ -72,6 +77,10 @@ cb_err_t cbfs_boot_lookup(const char *name, bool force_ro,
 	if (tspi_measure_cbfs_hook(rdev, name, be32toh(mdata->h.type)))
 		return CB_ERR;
 
+	if (CONFIG(CBFS_ACCESS_TRACE) &&
+	    (ENV_ROMSTAGE || ENV_POSTCAR || ENV_RAMSTAGE))
+		cbfs_access_trace_record(name);
+
 	return CB_SUCCESS;
 }
 
@@ -194,18 +203,442 @@ static inline bool cbfs_lzma_enabled(void)
 	return true;
 }
 
-size_t cbfs_load_and_decompress(const struct region_device *rdev, size_t offset,
-	size_t in_size, void *buffer, size_t buffer_size, uint32_t compression)
+static inline bool cbfs_zstd_enabled(void)
+{
+	/* Only ramstage (and the payloads it loads) may use Zstandard, unless
+	   it was chosen for ramstage itself. */
+	if (ENV_RAMSTAGE)
+		return true;
+	if ((ENV_ROMSTAGE || ENV_POSTCAR) && CONFIG(COMPRESS_RAMSTAGE_ZSTD))
+		return true;
+	return false;
+}
+
+static inline uint32_t chunked_base_compression(uint32_t compression)
+{
+	if (compression == CBFS_COMPRESS_LZMA_CHUNKED)
+		return CBFS_COMPRESS_LZMA;
+	if (compression == CBFS_COMPRESS_LZ4_CHUNKED)
+		return CBFS_COMPRESS_LZ4;
+	return CBFS_COMPRESS_NONE;
+}
+
+static inline bool cbfs_chunked_enabled(uint32_t compression)
+{
+	switch (chunked_base_compression(compression)) {
+	case CBFS_COMPRESS_LZMA:
+		return cbfs_lzma_enabled();
+	case CBFS_COMPRESS_LZ4:
+		return cbfs_lz4_enabled();
+	default:
+		return false;
+	}
+}
+
+/* Checks a chunked header and returns the size of header plus block table,
+   or 0 if it is invalid. */
+static size_t chunked_header_check(const struct cbfs_chunked_header *hdr,
+				   size_t in_size, size_t buffer_size)
+{
+	uint32_t num_chunks = read_be32(&hdr->num_chunks);
+	uint32_t chunk_size = read_be32(&hdr->chunk_size);
+	uint32_t size = read_be32(&hdr->decompressed_size);
+	size_t table_size = sizeof(*hdr) + num_chunks * sizeof(uint32_t);
+
+	if (read_be32(&hdr->magic) != CBFS_CHUNKED_MAGIC) {
+		printk(BIOS_WARNING, "CBFS: Bad chunked header magic.\n");
+		return 0;
+	}
+	if (num_chunks == 0 || num_chunks > CBFS_CHUNKED_MAX_CHUNKS ||
+	    chunk_size == 0 || DIV_ROUND_UP(size, chunk_size) != num_chunks ||
+	    table_size > in_size) {
+		printk(BIOS_WARNING, "CBFS: Bad chunked header.\n");
+		return 0;
+	}
+	if (size > buffer_size)
+		return 0;
+
+	return table_size;
+}
+
+/*
+ * State shared by all CPUs working on one chunked image. Chunks are handed out
+ * in order under chunked_lock until none are left. The compressed data of a
+ * chunk is passed to |consume| (if any) as it is handed out, which keeps it in
+ * file order and in the cache of the CPU that decompresses it next.
+ */
+static struct chunked_job {
+	const uint8_t *table;		/* Block table, followed by the data */
+	const uint8_t *data;
+	uint8_t *dst;
+	uint32_t compression;		/* Algorithm of the individual chunks */
+	size_t chunk_size;
+	size_t decompressed_size;
+	size_t num_chunks;
+	size_t next;			/* Next chunk to hand out */
+	size_t next_offset;		/* Its offset in data */
+	void (*consume)(void *arg, const void *buf, size_t size);
+	void *consume_arg;
+	int workers;			/* Number of CPUs that joined */
+	bool failed;
+} chunked_job;
+
+DECLARE_SPIN_LOCK(chunked_lock)
+
+#if ENV_RAMSTAGE && CONFIG(CBFS_CHUNKED_PARALLEL)
+#define CHUNKED_WORKERS CONFIG_CBFS_CHUNKED_PARALLEL_WORKERS
+/* One LZMA decoder state per worker, ulzman() only has a single one. */
+static uint8_t chunked_scratchpad[CHUNKED_WORKERS][ULZMA_SCRATCHPAD_SIZE];
+#else
+#define CHUNKED_WORKERS 1
+#endif
+
+static bool chunked_decompress_one(const struct chunked_job *job, size_t i,
+				   size_t offset, int worker)
+{
+	size_t start = i * job->chunk_size;
+	size_t dstn = MIN(job->chunk_size, job->decompressed_size - start);
+	size_t out_size;
+
+	const uint8_t *src = job->data + offset;
+	size_t srcn = read_be32(job->table + i * sizeof(uint32_t));
+
+	if (job->compression == CBFS_COMPRESS_LZ4)
+		out_size = ulz4fn(src, srcn, job->dst + start, dstn);
+#if ENV_RAMSTAGE && CONFIG(CBFS_CHUNKED_PARALLEL)
+	else
+		out_size = ulzman_scratch(src, srcn, job->dst + start, dstn,
+					  chunked_scratchpad[worker]);
+#else
+	else
+		out_size = ulzman(src, srcn, job->dst + start, dstn);
+#endif
+
+	return out_size == dstn;
+}
+
+static void chunked_worker(void *unused)
+{
+	struct chunked_job *job = &chunked_job;
+	int worker;
+	size_t i, offset, srcn;
+
+	spin_lock(&chunked_lock);
+	worker = job->workers++;
+	/* LZMA workers are limited by the number of decoder states. */
+	if (job->compression == CBFS_COMPRESS_LZMA && worker >= CHUNKED_WORKERS) {
+		spin_unlock(&chunked_lock);
+		return;
+	}
+
+	while (job->next < job->num_chunks) {
+		i = job->next++;
+		offset = job->next_offset;
+		srcn = read_be32(job->table + i * sizeof(uint32_t));
+		job->next_offset += srcn;
+		if (job->consume)
+			job->consume(job->consume_arg, job->data + offset, srcn);
+		spin_unlock(&chunked_lock);
+
+		bool ok = chunked_decompress_one(job, i, offset, worker);
+
+		spin_lock(&chunked_lock);
+		if (!ok) {
+			job->failed = true;
+			job->next = job->num_chunks;
+		}
+	}
+
+	spin_unlock(&chunked_lock);
+}
+
+static void chunked_run(void)
+{
+#if ENV_RAMSTAGE && CONFIG(CBFS_CHUNKED_PARALLEL)
+	if (chunked_job.num_chunks > 1 && mp_aps_waiting_for_work()) {
+		if (mp_run_on_all_cpus_synchronously(chunked_worker, NULL) < 0)
+			printk(BIOS_WARNING,
+			       "CBFS: Not all APs are decompressing chunks.\n");
+		return;
+	}
+#endif
+	chunked_worker(NULL);
+}
+
+static size_t decompress_chunked(const void *src, size_t srcn, void *dst,
+		size_t dstn, uint32_t compression,
+		void (*consume)(void *arg, const void *buf, size_t size),
+		void *consume_arg)
+{
+	const struct cbfs_chunked_header *hdr = src;
+	struct chunked_job *job = &chunked_job;
+	size_t table_size;
+	uint64_t data_size = 0;
+	size_t i;
+	bool failed;
+
+	if (!cbfs_chunked_enabled(compression) || srcn < sizeof(*hdr))
+		return 0;
+
+	table_size = chunked_header_check(hdr, srcn, dstn);
+	if (!table_size)
+		return 0;
+
+	for (i = 0; i < read_be32(&hdr->num_chunks); i++)
+		data_size += read_be32(&hdr->compressed_size[i]);
+	if (data_size > srcn - table_size)
+		return 0;
+
+	spin_lock(&chunked_lock);
+	job->table = (const uint8_t *)hdr->compressed_size;
+	job->data = (const uint8_t *)src + table_size;
+	job->dst = dst;
+	job->compression = chunked_base_compression(compression);
+	job->chunk_size = read_be32(&hdr->chunk_size);
+	job->decompressed_size = read_be32(&hdr->decompressed_size);
+	job->num_chunks = read_be32(&hdr->num_chunks);
+	job->workers = 0;
+	job->failed = false;
+	job->next = 0;
+	job->next_offset = 0;
+	job->consume = consume;
+	job->consume_arg = consume_arg;
+	spin_unlock(&chunked_lock);
+
+	if (consume)
+		consume(consume_arg, src, table_size);
+
+	if (job->compression == CBFS_COMPRESS_LZ4)
+		timestamp_add_now(TS_START_ULZ4F);
+	else
+		timestamp_add_now(TS_START_ULZMA);
+
+	chunked_run();
+
+	if (job->compression == CBFS_COMPRESS_LZ4)
+		timestamp_add_now(TS_END_ULZ4F);
+	else
+		timestamp_add_now(TS_END_ULZMA);
+
+	spin_lock(&chunked_lock);
+	failed = job->failed;
+	spin_unlock(&chunked_lock);
+
+	if (failed) {
+		printk(BIOS_WARNING, "CBFS: Chunk decompression failed.\n");
+		return 0;
+	}
+
+	if (consume)
+		consume(consume_arg, job->data + data_size,
+			srcn - table_size - data_size);
+
+	return job->decompressed_size;
+}
+
+size_t cbfs_decompress_chunked(const void *src, size_t srcn, void *dst,
+			       size_t dstn, uint32_t compression)
+{
+	return decompress_chunked(src, srcn, dst, dstn, compression, NULL,
+				  NULL);
+}
+
+/*
+ * With CBFS_FILE_HASH_CHECK, files that carry a hash attribute are hashed while
+ * they are loaded. The decompressors pass every piece of their input to
+ * hasher_consume() right before they decode it, in file order, so the data is
+ * only read from the boot medium once and is still in the cache when it gets
+ * decoded. Offsets are relative to the file's region device.
+ */
+struct file_hasher {
+	struct vb2_digest_context dc;
+	const struct vb2_hash *hash;
+	const struct region_device *rdev;
+	size_t pos;	/* Bytes hashed so far */
+	bool error;
+};
+
+static inline bool cbfs_file_hash_enabled(void)
+{
+	/* SMM doesn't link vboot's hashing code. */
+	return CONFIG(CBFS_FILE_HASH_CHECK) && !ENV_SMM;
+}
+
+static struct file_hasher *hasher_start(struct file_hasher *h,
+		const struct region_device *rdev, const struct vb2_hash *hash)
+{
+	if (!cbfs_file_hash_enabled() || !hash)
+		return NULL;
+
+	h->hash = hash;
+	h->rdev = rdev;
+	h->pos = 0;
+	h->error = false;
+
+	if (hash->algo != CONFIG_CBFS_HASH_ALGO) {
+		printk(BIOS_ERR, "CBFS ERROR: file hash algo %d, expected %d\n",
+		       hash->algo, CONFIG_CBFS_HASH_ALGO);
+		h->error = true;
+	} else if (vb2_digest_init(&h->dc, hash->algo) != VB2_SUCCESS) {
+		h->error = true;
+	}
+	return h;
+}
+
+/* Hash the |size| bytes at |buf|, which hold the file data at |offset|. Data
+   that doesn't directly follow what was hashed before is ignored. */
+static void hasher_extend(struct file_hasher *h, size_t offset, const void *buf,
+			  size_t size)
+{
+	if (!cbfs_file_hash_enabled() || !h || h->error || offset != h->pos)
+		return;
+
+	if (vb2_digest_extend(&h->dc, buf, size) != VB2_SUCCESS)
+		h->error = true;
+	h->pos += size;
+}
+
+/* The decompressors hand out their input in order, starting at the current
+   position. */
+static void hasher_consume(void *arg, const void *buf, size_t size)
+{
+	struct file_hasher *h = arg;
+
+	hasher_extend(h, h->pos, buf, size);
+}
+
+/* Hash the file up to |offset| in one go, for the little data no decompressor
+   reads, like the stage header rmodule_stage_load() parsed on its own. */
+static void hasher_skip_to(struct file_hasher *h, size_t offset)
+{
+	void *map;
+
+	if (!cbfs_file_hash_enabled() || !h || h->error || h->pos >= offset)
+		return;
+
+	map = rdev_mmap(h->rdev, h->pos, offset - h->pos);
+	if (map == NULL) {
+		h->error = true;
+		return;
+	}
+	hasher_extend(h, h->pos, map, offset - h->pos);
+	rdev_munmap(h->rdev, map);
+}
+
+/* Hash the rest of the file and compare. Returns false on a mismatch. */
+static bool hasher_finish(struct file_hasher *h)
+{
+	uint8_t digest[VB2_MAX_DIGEST_SIZE];
+	size_t size;
+
+	if (!cbfs_file_hash_enabled() || !h)
+		return true;
+
+	hasher_skip_to(h, region_device_sz(h->rdev));
+
+	size = vb2_digest_size(h->hash->algo);
+	if (h->error || vb2_digest_finalize(&h->dc, digest, size) != VB2_SUCCESS ||
+	    memcmp(digest, h->hash->raw, size)) {
+		printk(BIOS_ERR, "CBFS ERROR: file hash mismatch!\n");
+		return false;
+	}
+
+	return true;
+}
+
+void prog_set_cbfs_hash(struct prog *prog, const union cbfs_mdata *mdata)
+{
+	const struct vb2_hash *hash = NULL;
+
+	prog->cbfs_hash.algo = VB2_HASH_INVALID;
+
+	if (cbfs_file_hash_enabled())
+		hash = cbfs_file_hash(mdata);
+	if (hash)
+		memcpy(&prog->cbfs_hash, hash, offsetof(struct vb2_hash, raw) +
+		       vb2_digest_size(hash->algo));
+}
+
+static size_t load_and_decompress(const struct region_device *rdev,
+		size_t offset, size_t in_size, void *buffer, size_t buffer_size,
+		uint32_t compression, struct file_hasher *h);
+
+/* Serial fallback for boot devices that are not memory mapped, where mapping a
+   whole large file at once would need just as large a bounce buffer. Only the
+   header and block table are mapped. */
+static size_t cbfs_load_chunked_serial(const struct region_device *rdev,
+		size_t offset, size_t in_size, void *buffer, size_t buffer_size,
+		uint32_t compression, struct file_hasher *h)
+{
+	struct cbfs_chunked_header hdr;
+	const struct cbfs_chunked_header *table;
+	size_t table_size, num_chunks, chunk_size, size;
+	size_t data_offset, start, i;
+
+	if (in_size < sizeof(hdr) ||
+	    rdev_readat(rdev, &hdr, offset, sizeof(hdr)) != sizeof(hdr))
+		return 0;
+
+	table_size = chunked_header_check(&hdr, in_size, buffer_size);
+	if (!table_size)
+		return 0;
+
+	table = rdev_mmap(rdev, offset, table_size);
+	if (table == NULL)
+		return 0;
+	hasher_extend(h, offset, table, table_size);
+
+	num_chunks = be32toh(hdr.num_chunks);
+	chunk_size = be32toh(hdr.chunk_size);
+	size = be32toh(hdr.decompressed_size);
+	data_offset = table_size;
+
+	for (i = 0; i < num_chunks; i++) {
+		size_t srcn = read_be32(&table->compressed_size[i]);
+		start = i * chunk_size;
+		size_t dstn = MIN(chunk_size, size - start);
+
+		if (srcn > in_size - data_offset ||
+		    load_and_decompress(rdev, offset + data_offset, srcn,
+				buffer + start, dstn,
+				chunked_base_compression(compression), h) != dstn) {
+			size = 0;
+			break;
+		}
+		data_offset += srcn;
+	}
+
+	rdev_munmap(rdev, (void *)table);
+
+	return size;
+}
+
+size_t cbfs_bcj_decode(void *buf, size_t size, uint32_t compression)
+{
+	if (compression == CBFS_COMPRESS_LZMA_BCJ_X86)
+		bcj_x86(buf, size, 0);
+	else if (compression == CBFS_COMPRESS_LZMA_BCJ_ARM64)
+		bcj_arm64(buf, size, 0);
+
+	return size;
+}
+
+static size_t load_and_decompress(const struct region_device *rdev,
+		size_t offset, size_t in_size, void *buffer, size_t buffer_size,
+		uint32_t compression, struct file_hasher *h)
 {
 	size_t out_size;
 	void *map;
 
+	hasher_skip_to(h, offset);
+
 	switch (compression) {
 	case CBFS_COMPRESS_NONE:
 		if (buffer_size < in_size)
 			return 0;
 		if (rdev_readat(rdev, buffer, offset, in_size) != in_size)
 			return 0;
+		hasher_extend(h, offset, buffer, in_size);
 		return in_size;
 
 	case CBFS_COMPRESS_LZ4:
@@ -219,7 +652,8 @@ size_t cbfs_load_and_decompress(const struct region_device *rdev, size_t offset,
 			return 0;
 
 		timestamp_add_now(TS_START_ULZ4F);
-		out_size = ulz4fn(map, in_size, buffer, buffer_size);
+		out_size = ulz4fn_consume(map, in_size, buffer, buffer_size,
+					  h ? hasher_consume : NULL, h);
 		timestamp_add_now(TS_END_ULZ4F);
 
 		rdev_munmap(rdev, map);
@@ -227,19 +661,72 @@ size_t cbfs_load_and_decompress(const struct region_device *rdev, size_t offset,
 		return out_size;
 
 	case CBFS_COMPRESS_LZMA:
+	case CBFS_COMPRESS_LZMA_BCJ_X86:
+	case CBFS_COMPRESS_LZMA_BCJ_ARM64:
 		if (!cbfs_lzma_enabled())
 			return 0;
+
+		/* Without a memory-mapped boot device, mapping the input would
+		   mean a full bounce read before decoding can even start. */
+		if (!CONFIG(BOOT_DEVICE_MEMORY_MAPPED)) {
+			timestamp_add_now(TS_START_ULZMA);
+			out_size = ulzman_rdev(rdev, offset, in_size, buffer,
+					       buffer_size, h ? hasher_consume : NULL,
+					       h);
+			timestamp_add_now(TS_END_ULZMA);
+			return cbfs_bcj_decode(buffer, out_size, compression);
+		}
+
 		map = rdev_mmap(rdev, offset, in_size);
 		if (map == NULL)
 			return 0;
 
 		/* Note: timestamp not useful for memory-mapped media (x86) */
 		timestamp_add_now(TS_START_ULZMA);
-		out_size = ulzman(map, in_size, buffer, buffer_size);
+		out_size = ulzman_consume(map, in_size, buffer, buffer_size,
+					  h ? hasher_consume : NULL, h);
 		timestamp_add_now(TS_END_ULZMA);
 
 		rdev_munmap(rdev, map);
 
+		return cbfs_bcj_decode(buffer, out_size, compression);
+
+	case CBFS_COMPRESS_ZSTD:
+		if (!cbfs_zstd_enabled())
+			return 0;
+
+		map = rdev_mmap(rdev, offset, in_size);
+		if (map == NULL)
+			return 0;
+
+		timestamp_add_now(TS_START_UZSTD);
+		out_size = uzstdn_consume(map, in_size, buffer, buffer_size,
+					  h ? hasher_consume : NULL, h);
+		timestamp_add_now(TS_END_UZSTD);
+
+		rdev_munmap(rdev, map);
+
+		return out_size;
+
+	case CBFS_COMPRESS_LZMA_CHUNKED:
+	case CBFS_COMPRESS_LZ4_CHUNKED:
+		if (!cbfs_chunked_enabled(compression))
+			return 0;
+
+		if (!CONFIG(BOOT_DEVICE_MEMORY_MAPPED))
+			return cbfs_load_chunked_serial(rdev, offset, in_size,
+					buffer, buffer_size, compression, h);
+
+		map = rdev_mmap(rdev, offset, in_size);
+		if (map == NULL)
+			return 0;
+
+		out_size = decompress_chunked(map, in_size, buffer, buffer_size,
+					      compression,
+					      h ? hasher_consume : NULL, h);
+
+		rdev_munmap(rdev, map);
+
 		return out_size;
 
 	default:
@@ -247,9 +734,25 @@ size_t cbfs_load_and_decompress(const struct region_device *rdev, size_t offset,
 	}
 }
 
+size_t cbfs_load_and_decompress(const struct region_device *rdev, size_t offset,
+	size_t in_size, void *buffer, size_t buffer_size, uint32_t compression,
+	const struct vb2_hash *file_hash)
+{
+	struct file_hasher hasher;
+	struct file_hasher *h = hasher_start(&hasher, rdev, file_hash);
+	size_t out_size;
+
+	out_size = load_and_decompress(rdev, offset, in_size, buffer,
+				       buffer_size, compression, h);
+	if (!out_size || !hasher_finish(h))
+		return 0;
+
+	return out_size;
+}
+
 static size_t cbfs_stage_load_and_decompress(const struct region_device *rdev,
 		size_t offset, size_t in_size, void *buffer, size_t buffer_size,
-		uint32_t compression)
+		uint32_t compression, struct file_hasher *h)
 {
 	struct region_device rdev_src;
 
@@ -261,19 +764,21 @@ static size_t cbfs_stage_load_and_decompress(const struct region_device *rdev,
 		 * the caller to ensure that buffer_size is large enough
 		 * (see compression.h, guaranteed by cbfstool for stages). */
 		void *compr_start = buffer + buffer_size - in_size;
+		hasher_skip_to(h, offset);
 		if (rdev_readat(rdev, compr_start, offset, in_size) != in_size)
 			return 0;
+		hasher_extend(h, offset, compr_start, in_size);
 		/* Create a region device backed by memory. */
 		rdev_chain(&rdev_src, &addrspace_32bit.rdev,
 				(uintptr_t)compr_start, in_size);
 
-		return cbfs_load_and_decompress(&rdev_src, 0, in_size, buffer,
-					buffer_size, compression);
+		return load_and_decompress(&rdev_src, 0, in_size, buffer,
+					   buffer_size, compression, NULL);
 	}
 
 	/* All other algorithms can use the generic implementation. */
-	return cbfs_load_and_decompress(rdev, offset, in_size, buffer,
-					buffer_size, compression);
+	return load_and_decompress(rdev, offset, in_size, buffer, buffer_size,
+				   compression, h);
 }
 
 static inline int tohex4(unsigned int c)
@@ -334,8 +839,12 @@ static size_t _cbfs_load(const char *name, void *buf, size_t buf_size,
 			return 0;
 	}
 
+	const struct vb2_hash *file_hash = NULL;
+	if (cbfs_file_hash_enabled())
+		file_hash = cbfs_file_hash(&mdata);
+
 	return cbfs_load_and_decompress(&rdev, 0, region_device_sz(&rdev),
-					buf, buf_size, compression);
+					buf, buf_size, compression, file_hash);
 }
 
 size_t cbfs_load(const char *name, void *buf, size_t buf_size)
@@ -350,6 +859,7 @@ size_t cbfs_ro_load(const char *name, void *buf, size_t buf_size)
 
 int cbfs_prog_stage_load(struct prog *pstage)
 {
+	struct file_hasher hasher, *h;
 	struct cbfs_stage stage;
 	uint8_t *load;
 	void *entry;
@@ -360,6 +870,9 @@ int cbfs_prog_stage_load(struct prog *pstage)
 	if (rdev_readat(fh, &stage, 0, sizeof(stage)) != sizeof(stage))
 		return -1;
 
+	h = hasher_start(&hasher, fh, prog_cbfs_hash(pstage));
+	hasher_extend(h, 0, &stage, sizeof(stage));
+
 	fsize = region_device_sz(fh);
 	fsize -= sizeof(stage);
 	foffset = 0;
@@ -389,8 +902,8 @@ int cbfs_prog_stage_load(struct prog *pstage)
 	}
 
 	fsize = cbfs_stage_load_and_decompress(fh, foffset, fsize, load,
-					 stage.memlen, stage.compression);
-	if (!fsize)
+					 stage.memlen, stage.compression, h);
+	if (!fsize || !hasher_finish(h))
 		return -1;
 
 	/* Clear area not covered by file. */
@@ -507,7 +1020,7 @@ static void mcache_to_cbmem(const struct cbfs_boot_device *cbd, u32 cbmem_id)
 		       cbmem_id, real_size);
 		return;
 	}
-	memcpy(cbmem_mcache, cbd->mcache, real_size);
+	cbfs_mcache_copy(cbmem_mcache, cbd->mcache, cbd->mcache_size);
 }
 
 static void cbfs_mcache_migrate(int unused)
@@ -0,0 +1,90 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <cbfs.h>
+#include <cbmem.h>
+#include <commonlib/cbfs_access_trace_serialized.h>
+#include <console/console.h>
+#include <string.h>
+
+#define EARLY_TRACE_SIZE 512
+
+static struct cbfs_access_trace *trace;
+
+/*
+ * Romstage lookups before CBMEM is up, moved to CBMEM by the init hook. This
+ * has to stay in .bss for CAR, the size is filled in with the first name.
+ */
+static struct {
+	struct cbfs_access_trace hdr;
+	char names[EARLY_TRACE_SIZE];
+} early_trace;
+
+static bool trace_contains(const struct cbfs_access_trace *t, const char *name)
+{
+	uint32_t i = 0;
+
+	while (i < t->used) {
+		if (!strcmp(&t->names[i], name))
+			return true;
+		i += strlen(&t->names[i]) + 1;
+	}
+	return false;
+}
+
+static void trace_append(struct cbfs_access_trace *t, const char *name)
+{
+	size_t len = strlen(name) + 1;
+
+	if (trace_contains(t, name))
+		return;
+
+	if (len > t->size - t->used) {
+		t->dropped++;
+		return;
+	}
+
+	memcpy(&t->names[t->used], name, len);
+	t->used += len;
+}
+
+void cbfs_access_trace_record(const char *name)
+{
+	if (trace)
+		trace_append(trace, name);
+	else if (ENV_ROMSTAGE) {
+		early_trace.hdr.size = EARLY_TRACE_SIZE;
+		trace_append(&early_trace.hdr, name);
+	}
+}
+
+static void cbfs_access_trace_start(int is_recovery)
+{
+	struct cbfs_access_trace *t;
+	uint32_t i = 0;
+
+	t = cbmem_add(CBMEM_ID_CBFS_ACCESS,
+		      sizeof(*t) + CONFIG_CBFS_ACCESS_TRACE_SIZE);
+	if (!t) {
+		printk(BIOS_ERR, "CBFS access trace: Could not allocate buffer\n");
+		return;
+	}
+
+	/* On S3 resume this is the previous boot's trace, start over. */
+	t->size = CONFIG_CBFS_ACCESS_TRACE_SIZE;
+	t->used = 0;
+	t->dropped = early_trace.hdr.dropped;
+
+	while (i < early_trace.hdr.used) {
+		trace_append(t, &early_trace.names[i]);
+		i += strlen(&early_trace.names[i]) + 1;
+	}
+	trace = t;
+}
+ROMSTAGE_CBMEM_INIT_HOOK(cbfs_access_trace_start)
+
+static void cbfs_access_trace_find(int is_recovery)
+{
+	trace = cbmem_find(CBMEM_ID_CBFS_ACCESS);
+}
+POSTCAR_CBMEM_INIT_HOOK(cbfs_access_trace_find)
+RAMSTAGE_CBMEM_INIT_HOOK(cbfs_access_trace_find)
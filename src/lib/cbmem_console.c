@@ -1,8 +1,11 @@
 /* SPDX-License-Identifier: GPL-2.0-only */
 
+#include <commonlib/console_deferred_serialized.h>
 #include <console/cbmem_console.h>
 #include <console/uart.h>
 #include <cbmem.h>
+#include <ctype.h>
+#include <string.h>
 #include <symbols.h>
 
 /*
@@ -37,6 +40,9 @@ _Static_assert(CONFIG_CONSOLE_CBMEM_BUFFER_SIZE <= MAX_SIZE,
 
 static struct cbmem_console *current_console;
 
+/* Binary records of CONSOLE_CBMEM_DEFERRED_FORMAT, kept outside the text. */
+static struct cbmemc_deferred_area *current_deferred;
+
 /*
  * While running from ROM, before DRAM is initialized, some area in cache as
  * RAM space is used for the console buffer storage. The size and location of
@@ -98,11 +104,238 @@ void cbmemc_tx_byte(unsigned char data)
 	if (cursor >= current_console->size) {
 		cursor = 0;
 		flags |= OVERFLOW;
+		if (CONFIG(CONSOLE_CBMEM_DEFERRED_FORMAT) && current_deferred)
+			current_deferred->wraps++;
 	}
 
 	current_console->cursor = flags | cursor;
 }
 
+#if CONFIG(CONSOLE_CBMEM_DEFERRED_FORMAT)
+static const u8 deferred_stage =
+	ENV_BOOTBLOCK ? CBMEMC_DEFERRED_BOOTBLOCK :
+	ENV_SEPARATE_VERSTAGE ? CBMEMC_DEFERRED_VERSTAGE :
+	ENV_ROMSTAGE ? CBMEMC_DEFERRED_ROMSTAGE :
+	ENV_POSTCAR ? CBMEMC_DEFERRED_POSTCAR : CBMEMC_DEFERRED_RAMSTAGE;
+
+/*
+ * The argument data is walked twice: once with a NULL buffer to size it and
+ * to check that it can be stored at all, once to store it.
+ */
+struct deferred_out {
+	u8 *buf;
+	size_t len;
+};
+
+static void deferred_byte(struct deferred_out *out, u8 byte)
+{
+	if (out->buf)
+		out->buf[out->len] = byte;
+	out->len++;
+}
+
+static void deferred_uleb(struct deferred_out *out, u64 val)
+{
+	do {
+		u8 byte = val & 0x7f;
+
+		val >>= 7;
+		deferred_byte(out, val ? byte | 0x80 : byte);
+	} while (val);
+}
+
+static void deferred_sleb(struct deferred_out *out, s64 val)
+{
+	deferred_uleb(out, ((u64)val << 1) ^ (u64)(val >> 63));
+}
+
+/*
+ * Pull the arguments off the list the same way vtxprintf() does, so that
+ * the decoded text matches what it would have printed. Returns -1 if the
+ * message can't be stored in binary form.
+ */
+static int deferred_args(struct deferred_out *out, const char *fmt,
+			 va_list args)
+{
+	unsigned long long num;
+	int precision, qualifier;
+	bool is_signed;
+	const char *s;
+	size_t len;
+
+	for (; *fmt; ++fmt) {
+		if (*fmt != '%')
+			continue;
+
+		do
+			++fmt;
+		while (*fmt == '-' || *fmt == '+' || *fmt == ' ' ||
+		       *fmt == '#' || *fmt == '0');
+
+		if (*fmt == '*') {
+			deferred_sleb(out, va_arg(args, int));
+			++fmt;
+		} else {
+			while (isdigit(*fmt))
+				++fmt;
+		}
+
+		precision = -1;
+		if (*fmt == '.') {
+			++fmt;
+			if (*fmt == '*') {
+				precision = va_arg(args, int);
+				deferred_sleb(out, precision);
+				++fmt;
+			} else {
+				for (precision = 0; isdigit(*fmt); ++fmt)
+					precision = precision * 10 + *fmt - '0';
+			}
+			if (precision < 0)
+				precision = 0;
+		}
+
+		qualifier = -1;
+		if (*fmt == 'h' || *fmt == 'l' || *fmt == 'L' || *fmt == 'z' || *fmt == 'j') {
+			qualifier = *fmt;
+			++fmt;
+			if (*fmt == 'l') {
+				qualifier = 'L';
+				++fmt;
+			}
+			if (*fmt == 'h') {
+				qualifier = 'H';
+				++fmt;
+			}
+		}
+
+		is_signed = false;
+		switch (*fmt) {
+		case 'c':
+			deferred_byte(out, (unsigned char)va_arg(args, int));
+			continue;
+		case 's':
+			s = va_arg(args, char *);
+			if (!s)
+				s = "<NULL>";
+			len = strnlen(s, (size_t)precision);
+			while (len--)
+				deferred_byte(out, *s++);
+			deferred_byte(out, '\0');
+			continue;
+		case 'p':
+			deferred_uleb(out, (unsigned long)va_arg(args, void *));
+			continue;
+		case 'n':
+			/* The count is only known once the text is formatted. */
+			return -1;
+		case 'd':
+		case 'i':
+			is_signed = true;
+			break;
+		case 'o':
+		case 'u':
+		case 'x':
+		case 'X':
+			break;
+		case '\0':
+			--fmt;
+			continue;
+		default:
+			continue;
+		}
+
+		if (qualifier == 'L') {
+			num = va_arg(args, unsigned long long);
+		} else if (qualifier == 'l') {
+			num = va_arg(args, unsigned long);
+		} else if (qualifier == 'z') {
+			num = va_arg(args, size_t);
+		} else if (qualifier == 'j') {
+			num = va_arg(args, uintmax_t);
+		} else if (qualifier == 'h') {
+			num = (unsigned short)va_arg(args, int);
+			if (is_signed)
+				num = (short)num;
+		} else if (qualifier == 'H') {
+			num = (unsigned char)va_arg(args, int);
+			if (is_signed)
+				num = (signed char)num;
+		} else if (is_signed) {
+			num = va_arg(args, int);
+		} else {
+			num = va_arg(args, unsigned int);
+		}
+
+		if (is_signed)
+			deferred_sleb(out, (long long)num);
+		else
+			deferred_uleb(out, num);
+	}
+
+	return 0;
+}
+
+static void init_deferred_ptr(void *storage, u32 total_space)
+{
+	struct cbmemc_deferred_area *area = storage;
+
+	if (!area || total_space <= sizeof(*area)) {
+		current_deferred = NULL;
+		return;
+	}
+
+	if (area->size != total_space - sizeof(*area) || area->used > area->size) {
+		area->size = total_space - sizeof(*area);
+		area->used = 0;
+		area->wraps = 0;
+	}
+
+	current_deferred = area;
+}
+
+int cbmemc_log_deferred(const char *fmt, va_list args)
+{
+	struct cbmemc_deferred_record *rec;
+	struct deferred_out out = { .buf = NULL };
+	va_list size_args;
+	size_t size;
+	int ret;
+
+	/* Records are only kept once the console has moved to CBMEM. */
+	if (!current_deferred || !current_console)
+		return -1;
+
+	/* util/cbmem can only find format strings that are part of the stage. */
+	if ((u8 *)fmt < _program || (u8 *)fmt >= _eprogram)
+		return -1;
+
+	va_copy(size_args, args);
+	ret = deferred_args(&out, fmt, size_args);
+	va_end(size_args);
+
+	size = sizeof(*rec) + out.len;
+	if (ret < 0 || out.len > UINT16_MAX ||
+	    size > current_deferred->size - current_deferred->used)
+		return -1;
+
+	rec = (void *)&current_deferred->body[current_deferred->used];
+	rec->wraps = current_deferred->wraps;
+	rec->cursor = current_console->cursor & CURSOR_MASK;
+	rec->fmt_offset = (uintptr_t)fmt - (uintptr_t)_program;
+	rec->args_size = out.len;
+	rec->stage = deferred_stage;
+	rec->reserved = 0;
+
+	out.buf = rec->args;
+	out.len = 0;
+	deferred_args(&out, fmt, args);
+	current_deferred->used += size;
+
+	return size;
+}
+#endif
+
 /*
  * Copy the current console buffer (either from the cache as RAM area or from
  * the static buffer, pointed at by src_cons_p) into the newly initialized CBMEM
@@ -142,6 +375,11 @@ static void cbmemc_reinit(int is_recovery)
 	struct cbmem_console *cbmem_cons_p = cbmem_add(CBMEM_ID_CONSOLE, size);
 	struct cbmem_console *previous_cons_p = current_console;
 
+#if CONFIG(CONSOLE_CBMEM_DEFERRED_FORMAT)
+	const size_t deferred_size = CONFIG_CONSOLE_CBMEM_DEFERRED_BUFFER_SIZE;
+	init_deferred_ptr(cbmem_add(CBMEM_ID_CONSOLE_DEFERRED, deferred_size),
+			  deferred_size);
+#endif
 	init_console_ptr(cbmem_cons_p, size);
 	copy_console_buffer(previous_cons_p);
 }
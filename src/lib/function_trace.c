@@ -0,0 +1,85 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <bootstate.h>
+#include <cbmem.h>
+#include <commonlib/function_trace_serialized.h>
+#include <console/console.h>
+#include <stdbool.h>
+#include <symbols.h>
+#include <timestamp.h>
+
+#if ENV_X86
+#include <arch/cpu.h>
+#endif
+
+/*
+ * Entry and exit hooks for code built with -finstrument-functions, see
+ * FUNCTION_TRACE_DIRS. None of this may be instrumented itself.
+ */
+#define __no_trace __attribute__((no_instrument_function))
+
+void __cyg_profile_func_enter(void *func, void *call_site) __no_trace;
+void __cyg_profile_func_exit(void *func, void *call_site) __no_trace;
+
+static struct function_trace_buffer *trace;
+static bool in_trace;
+
+static __no_trace void function_trace_record(void *func, uint32_t flags)
+{
+	struct function_trace_entry *e;
+
+	if (!trace || in_trace)
+		return;
+
+	/* Events of other CPUs would interleave with the BSP's call stack. */
+	if (ENV_X86 && cpu_info()->index != 0)
+		return;
+
+	/* timestamp_get() may live in an instrumented directory. */
+	in_trace = true;
+	e = &trace->entries[trace->total % trace->max_entries];
+	e->func = ((uintptr_t)func - (uintptr_t)_program) | flags;
+	e->stamp = timestamp_get();
+	trace->total++;
+	in_trace = false;
+}
+
+void __cyg_profile_func_enter(void *func, void *call_site)
+{
+	function_trace_record(func, 0);
+}
+
+void __cyg_profile_func_exit(void *func, void *call_site)
+{
+	function_trace_record(func, FUNCTION_TRACE_EXIT);
+}
+
+static __no_trace void function_trace_start(int is_recovery)
+{
+	struct function_trace_buffer *buf;
+
+	buf = cbmem_add(CBMEM_ID_FUNCTION_TRACE, sizeof(*buf) +
+			CONFIG_FUNCTION_TRACE_ENTRIES * sizeof(buf->entries[0]));
+	if (!buf) {
+		printk(BIOS_ERR, "Function trace: Could not allocate buffer\n");
+		return;
+	}
+
+	buf->max_entries = CONFIG_FUNCTION_TRACE_ENTRIES;
+	buf->total = 0;
+	buf->tick_freq_mhz = timestamp_tick_freq_mhz();
+	trace = buf;
+}
+
+static __no_trace void function_trace_stop(void *unused)
+{
+	if (!trace)
+		return;
+
+	printk(BIOS_DEBUG, "Function trace: %u events recorded\n", trace->total);
+	trace = NULL;
+}
+
+RAMSTAGE_CBMEM_INIT_HOOK(function_trace_start)
+BOOT_STATE_INIT_ENTRY(BS_OS_RESUME, BS_ON_ENTRY, function_trace_stop, NULL);
+BOOT_STATE_INIT_ENTRY(BS_PAYLOAD_BOOT, BS_ON_ENTRY, function_trace_stop, NULL);
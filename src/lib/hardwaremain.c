@@ -16,6 +16,7 @@
 #include <cbmem.h>
 #include <version.h>
 #include <device/device.h>
+#include <device/device_timing.h>
 #include <device/pci.h>
 #include <delay.h>
 #include <stdlib.h>
@@ -233,6 +234,9 @@ static void bs_sample_time(struct boot_state *state)
 	if ((i >= 0) && (i < ARRAY_SIZE(sample_id))) {
 		long execution = mono_time_diff_microseconds(&previous_sample, &this_sample);
 
+		dev_timing_record(state->name, DEV_TIMING_BS_ENTRY + i,
+				  &previous_sample, &this_sample);
+
 		/* Report with millisecond precision to reduce log diffs. */
 		execution = DIV_ROUND_CLOSEST(execution, USECS_PER_MSEC);
 		console = DIV_ROUND_CLOSEST(console, USECS_PER_MSEC);
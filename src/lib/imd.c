@@ -90,12 +90,81 @@ static void imd_entry_assign(struct imd_entry *e, uint32_t id,
 	e->id = id;
 }
 
+/*
+ * Lookups go through an open addressing hash table in the handle that maps
+ * entry ids to entry numbers. It is built from the root on recovery or first
+ * use and kept up to date by adding and removing entries. Entry numbers that
+ * don't fit into a slot or a full table make lookups that miss fall back to
+ * scanning the root.
+ */
+static size_t imdr_index_slot(uint32_t id)
+{
+	return (uint32_t)(id * 0x9e3779b1) >> (32 - __builtin_ctz(IMD_INDEX_SLOTS));
+}
+
+static size_t imdr_index_next(size_t slot)
+{
+	return (slot + 1) % IMD_INDEX_SLOTS;
+}
+
+static void imdr_index_insert(struct imdr *imdr, const struct imd_root *r,
+				size_t n)
+{
+	uint32_t id = r->entries[n].id;
+	size_t slot = imdr_index_slot(id);
+	size_t i;
+
+	if (n > UINT8_MAX) {
+		imdr->index_overflow = true;
+		return;
+	}
+
+	for (i = 0; i < IMD_INDEX_SLOTS; i++, slot = imdr_index_next(slot)) {
+		if (imdr->index[slot] == 0) {
+			imdr->index[slot] = n;
+			return;
+		}
+		/* Like the scan, lookups return the first entry with an id. */
+		if (r->entries[imdr->index[slot]].id == id)
+			return;
+	}
+
+	imdr->index_overflow = true;
+}
+
+static void imdr_index_build(struct imdr *imdr)
+{
+	const struct imd_root *r = imdr->r;
+	size_t i;
+
+	memset(imdr->index, 0, sizeof(imdr->index));
+	imdr->index_overflow = false;
+	imdr->index_root = r;
+	imdr->index_entries = r ? r->num_entries : 0;
+
+	if (r == NULL)
+		return;
+
+	/* Skip first entry covering the root. */
+	for (i = 1; i < r->num_entries; i++)
+		imdr_index_insert(imdr, r, i);
+}
+
+static bool imdr_index_valid(const struct imdr *imdr)
+{
+	const struct imd_root *r = imdr->r;
+
+	return r != NULL && imdr->index_root == r &&
+		imdr->index_entries == r->num_entries;
+}
+
 static void imdr_init(struct imdr *ir, void *upper_limit)
 {
 	uintptr_t limit = (uintptr_t)upper_limit;
 	/* Upper limit is aligned down to 4KiB */
 	ir->limit = ALIGN_DOWN(limit, LIMIT_ALIGN);
 	ir->r = NULL;
+	ir->index_root = NULL;
 }
 
 static int imdr_create_empty(struct imdr *imdr, size_t root_size,
@@ -149,6 +218,7 @@ static int imdr_create_empty(struct imdr *imdr, size_t root_size,
 	r->num_entries = 1;
 	e = &r->entries[0];
 	imd_entry_assign(e, CBMEM_ID_IMD_ROOT, 0, root_size);
+	imdr_index_build(imdr);
 
 	printk(BIOS_DEBUG, "IMD: root @ %p %u entries.\n", r, r->max_entries);
 
@@ -206,22 +276,36 @@ static int imdr_recover(struct imdr *imdr)
 
 	/* Set root pointer. */
 	imdr->r = r;
+	imdr_index_build(imdr);
 
 	return 0;
 }
 
-static const struct imd_entry *imdr_entry_find(const struct imdr *imdr,
-						uint32_t id)
+static const struct imd_entry *imdr_entry_find(struct imdr *imdr, uint32_t id)
 {
 	struct imd_root *r;
 	struct imd_entry *e;
-	size_t i;
+	size_t i, slot;
 
 	r = imdr_root(imdr);
 
 	if (r == NULL)
 		return NULL;
 
+	if (!imdr_index_valid(imdr))
+		imdr_index_build(imdr);
+
+	slot = imdr_index_slot(id);
+	for (i = 0; i < IMD_INDEX_SLOTS && imdr->index[slot];
+	     i++, slot = imdr_index_next(slot)) {
+		e = &r->entries[imdr->index[slot]];
+		if (e->id == id)
+			return e;
+	}
+
+	if (!imdr->index_overflow)
+		return NULL;
+
 	e = NULL;
 	/* Skip first entry covering the root. */
 	for (i = 1; i < r->num_entries; i++) {
@@ -304,10 +388,12 @@ static struct imd_entry *imd_entry_add_to_root(struct imd_root *r, uint32_t id,
 	return entry;
 }
 
-static const struct imd_entry *imdr_entry_add(const struct imdr *imdr,
+static const struct imd_entry *imdr_entry_add(struct imdr *imdr,
 						uint32_t id, size_t size)
 {
 	struct imd_root *r;
+	struct imd_entry *e;
+	bool index_valid;
 
 	r = imdr_root(imdr);
 
@@ -317,7 +403,16 @@ static const struct imd_entry *imdr_entry_add(const struct imdr *imdr,
 	if (root_is_locked(r))
 		return NULL;
 
-	return imd_entry_add_to_root(r, id, size);
+	index_valid = imdr_index_valid(imdr);
+	e = imd_entry_add_to_root(r, id, size);
+
+	/* An out of date index gets rebuilt on the next lookup instead. */
+	if (e != NULL && index_valid) {
+		imdr_index_insert(imdr, r, r->num_entries - 1);
+		imdr->index_entries = r->num_entries;
+	}
+
+	return e;
 }
 
 static bool imdr_has_entry(const struct imdr *imdr, const struct imd_entry *e)
@@ -507,11 +602,11 @@ int imd_region_used(struct imd *imd, void **base, size_t *size)
 	return 0;
 }
 
-const struct imd_entry *imd_entry_add(const struct imd *imd, uint32_t id,
+const struct imd_entry *imd_entry_add(struct imd *imd, uint32_t id,
 					size_t size)
 {
 	struct imd_root *r;
-	const struct imdr *imdr;
+	struct imdr *imdr;
 	const struct imd_entry *e = NULL;
 
 	/*
@@ -534,7 +629,7 @@ const struct imd_entry *imd_entry_add(const struct imd *imd, uint32_t id,
 	return e;
 }
 
-const struct imd_entry *imd_entry_find(const struct imd *imd, uint32_t id)
+const struct imd_entry *imd_entry_find(struct imd *imd, uint32_t id)
 {
 	const struct imd_entry *e;
 
@@ -548,7 +643,7 @@ const struct imd_entry *imd_entry_find(const struct imd *imd, uint32_t id)
 	return e;
 }
 
-const struct imd_entry *imd_entry_find_or_add(const struct imd *imd,
+const struct imd_entry *imd_entry_find_or_add(struct imd *imd,
 						uint32_t id, size_t size)
 {
 	const struct imd_entry *e;
@@ -583,14 +678,16 @@ uint32_t imd_entry_id(const struct imd_entry *entry)
 	return entry->id;
 }
 
-int imd_entry_remove(const struct imd *imd, const struct imd_entry *entry)
+int imd_entry_remove(struct imd *imd, const struct imd_entry *entry)
 {
 	struct imd_root *r;
-	const struct imdr *imdr;
-
-	imdr = imd_entry_to_imdr(imd, entry);
+	struct imdr *imdr;
 
-	if (imdr == NULL)
+	if (imdr_has_entry(&imd->lg, entry))
+		imdr = &imd->lg;
+	else if (imdr_has_entry(&imd->sm, entry))
+		imdr = &imd->sm;
+	else
 		return -1;
 
 	r = imdr_root(imdr);
@@ -606,6 +703,7 @@ int imd_entry_remove(const struct imd *imd, const struct imd_entry *entry)
 		return -1;
 
 	r->num_entries--;
+	imdr_index_build(imdr);
 
 	return 0;
 }
@@ -10,55 +10,244 @@
  *
  */
 
+#include <commonlib/region.h>
 #include <console/console.h>
 #include <string.h>
 #include <lib.h>
 
 #include "lzmadecode.h"
 
-size_t ulzman(const void *src, size_t srcn, void *dst, size_t dstn)
+#define LZMA_HEADER_SIZE (LZMA_PROPERTIES_SIZE + 8)
+
+static unsigned char ulzma_scratchpad[ULZMA_SCRATCHPAD_SIZE];
+
+/* Decode the |header| (properties and size) and the stream following it,
+ * which is either at |src| or provided through state->Refill. */
+static size_t ulzma_decode(CLzmaDecoderState *state, const unsigned char *header,
+			   const void *src, size_t srcn, void *dst, size_t dstn,
+			   void *scratchpad)
 {
-	unsigned char properties[LZMA_PROPERTIES_SIZE];
-	const int data_offset = LZMA_PROPERTIES_SIZE + 8;
 	UInt32 outSize;
 	SizeT inProcessed;
 	SizeT outProcessed;
 	int res;
-	CLzmaDecoderState state;
 	SizeT mallocneeds;
-	static unsigned char scratchpad[15980];
 	const unsigned char *cp;
 
-	if (srcn < data_offset) {
-		printk(BIOS_WARNING, "lzma: Input too small.\n");
-		return 0;
-	}
-
-	memcpy(properties, src, LZMA_PROPERTIES_SIZE);
 	/* The outSize in LZMA stream is a 64bit integer stored in little-endian
 	 * (ref: lzma.cc@LZMACompress: put_64). To prevent accessing by
 	 * unaligned memory address and to load in correct endianness, read each
 	 * byte and re-construct. */
-	cp = src + LZMA_PROPERTIES_SIZE;
+	cp = header + LZMA_PROPERTIES_SIZE;
 	outSize = cp[3] << 24 | cp[2] << 16 | cp[1] << 8 | cp[0];
 	if (outSize > dstn)
 		outSize = dstn;
-	if (LzmaDecodeProperties(&state.Properties, properties,
+	if (LzmaDecodeProperties(&state->Properties, header,
 				 LZMA_PROPERTIES_SIZE) != LZMA_RESULT_OK) {
 		printk(BIOS_WARNING, "lzma: Incorrect stream properties.\n");
 		return 0;
 	}
-	mallocneeds = (LzmaGetNumProbs(&state.Properties) * sizeof(CProb));
-	if (mallocneeds > 15980) {
+	mallocneeds = (LzmaGetNumProbs(&state->Properties) * sizeof(CProb));
+	if (mallocneeds > ULZMA_SCRATCHPAD_SIZE) {
 		printk(BIOS_WARNING, "lzma: Decoder scratchpad too small!\n");
 		return 0;
 	}
-	state.Probs = (CProb *)scratchpad;
-	res = LzmaDecode(&state, src + data_offset, srcn - data_offset,
-			 &inProcessed, dst, outSize, &outProcessed);
+	state->Probs = (CProb *)scratchpad;
+	res = LzmaDecode(state, src, srcn, &inProcessed, dst, outSize,
+			 &outProcessed);
 	if (res != 0) {
 		printk(BIOS_WARNING, "lzma: Decoding error = %d\n", res);
 		return 0;
 	}
 	return outProcessed;
 }
+
+size_t ulzman_scratch(const void *src, size_t srcn, void *dst, size_t dstn,
+		      void *scratchpad)
+{
+	unsigned char header[LZMA_HEADER_SIZE];
+	CLzmaDecoderState state = { .Refill = NULL };
+
+	if (srcn < LZMA_HEADER_SIZE) {
+		printk(BIOS_WARNING, "lzma: Input too small.\n");
+		return 0;
+	}
+
+	memcpy(header, src, LZMA_HEADER_SIZE);
+	return ulzma_decode(&state, header, src + LZMA_HEADER_SIZE,
+			    srcn - LZMA_HEADER_SIZE, dst, dstn, scratchpad);
+}
+
+size_t ulzman(const void *src, size_t srcn, void *dst, size_t dstn)
+{
+	return ulzman_scratch(src, srcn, dst, dstn, ulzma_scratchpad);
+}
+
+/*
+ * The stream window is split into two halves: while the decoder consumes one
+ * of them, the next chunk of input is read into the other one. This would
+ * overlap flash access and decoding on a boot device with asynchronous read
+ * support. None implements it yet, so each read still completes before
+ * rdev_readat_async_start() returns.
+ */
+#define ULZMA_CHUNK_SIZE (CONFIG_LZMA_STREAM_WINDOW_SIZE / 2)
+
+struct ulzma_stream {
+	const struct region_device *rdev;
+	size_t offset;
+	size_t remaining;
+	struct rdev_async_read req;
+	bool pending;
+	int next;	/* Window half the pending read goes to */
+	void (*consume)(void *arg, const void *buf, size_t size);
+	void *consume_arg;
+};
+
+static uint32_t ulzma_window[2][ULZMA_CHUNK_SIZE / sizeof(uint32_t)];
+
+static void ulzma_stream_fetch(struct ulzma_stream *stream)
+{
+	size_t size = MIN(stream->remaining, ULZMA_CHUNK_SIZE);
+
+	if (size == 0)
+		return;
+
+	if (rdev_readat_async_start(stream->rdev, &stream->req,
+				    ulzma_window[stream->next], stream->offset, size))
+		return;
+
+	stream->offset += size;
+	stream->remaining -= size;
+	stream->pending = true;
+}
+
+static SizeT ulzma_stream_refill(void *arg, const unsigned char **buffer)
+{
+	struct ulzma_stream *stream = arg;
+	const int current = stream->next;
+	ssize_t size;
+
+	if (!stream->pending)
+		ulzma_stream_fetch(stream);
+	if (!stream->pending)
+		return 0;
+
+	size = rdev_readat_async_wait(&stream->req);
+	stream->pending = false;
+	if (size != stream->req.size) {
+		printk(BIOS_WARNING, "lzma: Failed to read input @%#zx.\n",
+		       stream->req.offset);
+		return 0;
+	}
+
+	if (stream->consume)
+		stream->consume(stream->consume_arg, ulzma_window[current], size);
+
+	/* Get the next chunk on its way before handing this one out. */
+	stream->next = !current;
+	ulzma_stream_fetch(stream);
+
+	*buffer = (const unsigned char *)ulzma_window[current];
+	return size;
+}
+
+size_t ulzman_rdev(const struct region_device *rdev, size_t offset,
+		   size_t srcn, void *dst, size_t dstn,
+		   void (*consume)(void *arg, const void *buf, size_t size),
+		   void *consume_arg)
+{
+	unsigned char header[LZMA_HEADER_SIZE];
+	struct ulzma_stream stream = {
+		.rdev = rdev,
+		.offset = offset + LZMA_HEADER_SIZE,
+		.remaining = srcn - LZMA_HEADER_SIZE,
+		.consume = consume,
+		.consume_arg = consume_arg,
+	};
+	CLzmaDecoderState state = {
+		.Refill = ulzma_stream_refill,
+		.RefillArg = &stream,
+	};
+
+	if (srcn < LZMA_HEADER_SIZE) {
+		printk(BIOS_WARNING, "lzma: Input too small.\n");
+		return 0;
+	}
+
+	if (rdev_readat(rdev, header, offset, sizeof(header)) != sizeof(header))
+		return 0;
+	if (consume)
+		consume(consume_arg, header, sizeof(header));
+
+	/* Start with an empty buffer, the decoder pulls in the first chunk. */
+	size_t out_size = ulzma_decode(&state, header, header, 0, dst, dstn,
+				       ulzma_scratchpad);
+
+	/* The decoder may be done before the last read-ahead completed. */
+	if (stream.pending &&
+	    rdev_readat_async_wait(&stream.req) == stream.req.size && consume)
+		consume(consume_arg, ulzma_window[stream.next], stream.req.size);
+
+	return out_size;
+}
+
+/* Mapped input handed to the decoder in window sized pieces, so that each one
+ * can be consumed right before it is decoded. */
+struct ulzma_mapped {
+	const unsigned char *src;
+	size_t remaining;
+	void (*consume)(void *arg, const void *buf, size_t size);
+	void *consume_arg;
+};
+
+static SizeT ulzma_mapped_refill(void *arg, const unsigned char **buffer)
+{
+	struct ulzma_mapped *mapped = arg;
+	size_t size = MIN(mapped->remaining, ULZMA_CHUNK_SIZE);
+
+	if (size == 0)
+		return 0;
+
+	mapped->consume(mapped->consume_arg, mapped->src, size);
+
+	*buffer = mapped->src;
+	mapped->src += size;
+	mapped->remaining -= size;
+	return size;
+}
+
+size_t ulzman_consume(const void *src, size_t srcn, void *dst, size_t dstn,
+		      void (*consume)(void *arg, const void *buf, size_t size),
+		      void *consume_arg)
+{
+	struct ulzma_mapped mapped = {
+		.src = (const unsigned char *)src + LZMA_HEADER_SIZE,
+		.remaining = srcn - LZMA_HEADER_SIZE,
+		.consume = consume,
+		.consume_arg = consume_arg,
+	};
+	CLzmaDecoderState state = {
+		.Refill = ulzma_mapped_refill,
+		.RefillArg = &mapped,
+	};
+
+	if (!consume)
+		return ulzman(src, srcn, dst, dstn);
+
+	if (srcn < LZMA_HEADER_SIZE) {
+		printk(BIOS_WARNING, "lzma: Input too small.\n");
+		return 0;
+	}
+
+	consume(consume_arg, src, LZMA_HEADER_SIZE);
+
+	/* Start with an empty buffer, the decoder pulls in the first piece. */
+	size_t out_size = ulzma_decode(&state, src, src, 0, dst, dstn,
+				       ulzma_scratchpad);
+
+	/* Pass on the rest the decoder didn't need. */
+	if (mapped.remaining)
+		consume(consume_arg, mapped.src, mapped.remaining);
+
+	return out_size;
+}
@@ -51,7 +51,29 @@
 }
 
 
-#define RC_TEST { if (Buffer == BufferLim) return LZMA_RESULT_DATA_ERROR; }
+#define RC_TEST { if (Buffer == BufferLim && !RC_REFILL) return LZMA_RESULT_DATA_ERROR; }
+
+/* Fetch the next chunk of input through the state's Refill callback (if any).
+ * Only called once Buffer has reached BufferLim, at which point the look-ahead
+ * word has always been consumed completely. */
+#define RC_REFILL (vs->Refill && rc_refill(vs, &Buffer, &BufferLim,	\
+					    &BufferStart, &inProcessedChunks))
+
+static int rc_refill(CLzmaDecoderState *vs, const Byte **buffer,
+		     const Byte **bufferLim, const Byte **bufferStart,
+		     SizeT *inProcessedChunks)
+{
+	const Byte *next;
+	SizeT size = vs->Refill(vs->RefillArg, &next);
+
+	if (size == 0)
+		return 0;
+
+	*inProcessedChunks += (SizeT)(*bufferLim - *bufferStart);
+	*bufferStart = *buffer = next;
+	*bufferLim = next + size;
+	return 1;
+}
 
 #define RC_INIT(buffer, bufferSize) Buffer = buffer; \
 	BufferLim = buffer + bufferSize; RC_INIT2
@@ -207,6 +229,9 @@ int LzmaDecode(CLzmaDecoderState *vs,
 	} look_ahead;
 	UInt32 Range;
 	UInt32 Code;
+	/* Input consumed in chunks before BufferStart (streaming only). */
+	const Byte *BufferStart = inStream;
+	SizeT inProcessedChunks = 0;
 
 	*inSizeProcessed = 0;
 	*outSizeProcessed = 0;
@@ -428,7 +453,7 @@ int LzmaDecode(CLzmaDecoderState *vs,
 	 (void)len;
 
 
-	*inSizeProcessed = (SizeT)(Buffer - inStream);
+	*inSizeProcessed = (SizeT)(Buffer - BufferStart) + inProcessedChunks;
 	*outSizeProcessed = nowPos;
 	return LZMA_RESULT_OK;
 }
@@ -55,6 +55,12 @@ int LzmaDecodeProperties(CLzmaProperties *propsRes,
 typedef struct _CLzmaDecoderState {
 	CLzmaProperties Properties;
 	CProb *Probs;
+	/* Optional input callback for streaming decompression. Called whenever
+	 * the current input buffer is exhausted, it must point *buffer at the
+	 * next chunk of compressed data and return its size, or return 0 if
+	 * there is no more input. inSizeProcessed then counts all chunks. */
+	SizeT (*Refill)(void *arg, const unsigned char **buffer);
+	void *RefillArg;
 } CLzmaDecoderState;
 
 
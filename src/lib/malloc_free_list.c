@@ -0,0 +1,329 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+/*
+ * Segregated free-list heap allocator.
+ *
+ * Every block starts with a header holding its own size and the size of the
+ * block physically preceding it, so neighbours can be found in both
+ * directions and merged on free(). Free blocks are kept on doubly linked
+ * lists, one per power-of-two size class. Allocation takes the first block
+ * that fits from the smallest non-empty class and splits off the remainder.
+ */
+
+#include <bootstate.h>
+#include <cbmem.h>
+#include <commonlib/heap_stats_serialized.h>
+#include <console/console.h>
+#include <lib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if CONFIG(DEBUG_MALLOC)
+#define MALLOCDBG(x...) printk(BIOS_SPEW, x)
+#else
+#define MALLOCDBG(x...)
+#endif
+
+struct heap_block {
+	size_t prev_size;	/* Size of the block below, 0 for the first */
+	size_t size;		/* Size including this header, | BLOCK_IN_USE */
+};
+
+/* Only free blocks carry the list links, directly behind the header. */
+struct free_block {
+	struct heap_block hdr;
+	struct free_block *next;
+	struct free_block *prev;
+};
+
+#define BLOCK_IN_USE	((size_t)1)
+#define HEAP_ALIGN	sizeof(u64)
+#define HEADER_SIZE	ALIGN_UP(sizeof(struct heap_block), HEAP_ALIGN)
+#define MIN_BLOCK_SIZE	ALIGN_UP(sizeof(struct free_block), HEAP_ALIGN)
+#define NUM_CLASSES	32
+
+extern unsigned char _heap, _eheap;
+static unsigned char *heap_start;
+static unsigned char *heap_end;
+static struct free_block *free_lists[NUM_CLASSES];
+static struct heap_stats stats;
+
+static inline size_t block_size(const struct heap_block *b)
+{
+	return b->size & ~BLOCK_IN_USE;
+}
+
+static inline bool block_in_use(const struct heap_block *b)
+{
+	return b->size & BLOCK_IN_USE;
+}
+
+static inline struct heap_block *next_block(struct heap_block *b)
+{
+	unsigned char *next = (unsigned char *)b + block_size(b);
+
+	return next < heap_end ? (struct heap_block *)next : NULL;
+}
+
+static inline struct heap_block *prev_block(struct heap_block *b)
+{
+	if (!b->prev_size)
+		return NULL;
+	return (struct heap_block *)((unsigned char *)b - b->prev_size);
+}
+
+static int size_class(size_t size)
+{
+	return MIN(log2(size), NUM_CLASSES - 1);
+}
+
+static void free_list_insert(struct heap_block *b)
+{
+	struct free_block *f = (struct free_block *)b;
+	struct free_block **head = &free_lists[size_class(block_size(b))];
+
+	f->prev = NULL;
+	f->next = *head;
+	if (f->next)
+		f->next->prev = f;
+	*head = f;
+}
+
+static void free_list_remove(struct heap_block *b)
+{
+	struct free_block *f = (struct free_block *)b;
+
+	if (f->prev)
+		f->prev->next = f->next;
+	else
+		free_lists[size_class(block_size(b))] = f->next;
+	if (f->next)
+		f->next->prev = f->prev;
+}
+
+/* Set the size of a block and keep its upper neighbour's back link in sync. */
+static void set_block_size(struct heap_block *b, size_t size, size_t flags)
+{
+	struct heap_block *next;
+
+	b->size = size | flags;
+	next = next_block(b);
+	if (next)
+		next->prev_size = size;
+}
+
+static void heap_init(void)
+{
+	struct heap_block *b;
+
+	heap_start = (unsigned char *)ALIGN_UP((uintptr_t)&_heap, HEAP_ALIGN);
+	heap_end = (unsigned char *)ALIGN_DOWN((uintptr_t)&_eheap, HEAP_ALIGN);
+	memset(free_lists, 0, sizeof(free_lists));
+	memset(&stats, 0, sizeof(stats));
+	stats.heap_size = heap_end - heap_start;
+
+	if (heap_end - heap_start < MIN_BLOCK_SIZE) {
+		heap_end = heap_start;
+		return;
+	}
+
+	b = (struct heap_block *)heap_start;
+	b->prev_size = 0;
+	b->size = heap_end - heap_start;
+	free_list_insert(b);
+}
+
+/*
+ * Split the block so that it is exactly `size` bytes long and return the
+ * remainder to the free lists, provided that it is large enough to form a
+ * block of its own.
+ */
+static void split_block(struct heap_block *b, size_t size)
+{
+	struct heap_block *rest;
+	size_t rest_size = block_size(b) - size;
+
+	if (rest_size < MIN_BLOCK_SIZE)
+		return;
+
+	rest = (struct heap_block *)((unsigned char *)b + size);
+	rest->prev_size = size;
+	b->size = size | (b->size & BLOCK_IN_USE);
+	set_block_size(rest, rest_size, 0);
+	free_list_insert(rest);
+}
+
+static struct heap_block *find_free_block(size_t size)
+{
+	struct free_block *f;
+
+	/* First fit within the request's own class... */
+	for (f = free_lists[size_class(size)]; f; f = f->next)
+		if (block_size(&f->hdr) >= size)
+			return &f->hdr;
+
+	/* ...otherwise every block of a larger class fits. */
+	for (int i = size_class(size) + 1; i < NUM_CLASSES; i++)
+		if (free_lists[i])
+			return &free_lists[i]->hdr;
+
+	return NULL;
+}
+
+/* We don't restrict the boundary. This is firmware,
+ * you are supposed to know what you are doing.
+ */
+void *memalign(size_t boundary, size_t size)
+{
+	struct heap_block *b;
+	uintptr_t payload, aligned;
+	size_t need, lead;
+
+	MALLOCDBG("%s Enter, boundary %zu, size %zu\n", __func__, boundary,
+		  size);
+
+	if (!heap_start)
+		heap_init();
+
+	if (boundary < HEAP_ALIGN)
+		boundary = HEAP_ALIGN;
+	else if (!IS_POWER_OF_2(boundary))
+		boundary = 1 << log2_ceil(boundary);
+
+	need = MAX(ALIGN_UP(size + HEADER_SIZE, HEAP_ALIGN), MIN_BLOCK_SIZE);
+	/* Leave room to split off a leading free block to reach alignment. */
+	if (boundary > HEAP_ALIGN)
+		need += boundary + MIN_BLOCK_SIZE;
+
+	b = find_free_block(need);
+	if (!b) {
+		printk(BIOS_ERR, "memalign(boundary=%zu, size=%zu): failed: ",
+				boundary, size);
+		printk(BIOS_ERR, "no free block of %zu bytes, %u of %u bytes in use\n",
+				need, stats.in_use, stats.heap_size);
+		die("Error! memalign: Out of memory");
+	}
+
+	free_list_remove(b);
+
+	payload = (uintptr_t)b + HEADER_SIZE;
+	aligned = ALIGN_UP(payload, boundary);
+	if (aligned != payload) {
+		struct heap_block *lead_block = b;
+
+		/* The leading gap has to form a block of its own. */
+		lead = aligned - payload;
+		if (lead < MIN_BLOCK_SIZE)
+			lead += ALIGN_UP(MIN_BLOCK_SIZE - lead, boundary);
+
+		b = (struct heap_block *)((unsigned char *)lead_block + lead);
+		b->prev_size = lead;
+		set_block_size(b, block_size(lead_block) - lead, 0);
+		lead_block->size = lead;
+		free_list_insert(lead_block);
+	}
+
+	need = MAX(ALIGN_UP(size + HEADER_SIZE, HEAP_ALIGN), MIN_BLOCK_SIZE);
+	b->size |= BLOCK_IN_USE;
+	split_block(b, need);
+
+	stats.in_use += block_size(b);
+	stats.high_water = MAX(stats.high_water, stats.in_use);
+	stats.allocations++;
+
+	MALLOCDBG("memalign %p\n", (unsigned char *)b + HEADER_SIZE);
+
+	return (unsigned char *)b + HEADER_SIZE;
+}
+
+void *malloc(size_t size)
+{
+	return memalign(sizeof(u64), size);
+}
+
+void free(void *ptr)
+{
+	struct heap_block *b, *neighbour;
+
+	if (ptr == NULL)
+		return;
+
+	if ((unsigned char *)ptr < heap_start + HEADER_SIZE ||
+	    (unsigned char *)ptr >= heap_end) {
+		printk(BIOS_WARNING, "Warning - Pointer passed to %s is not "
+					"pointing to the heap\n", __func__);
+		return;
+	}
+
+	b = (struct heap_block *)((unsigned char *)ptr - HEADER_SIZE);
+	if (!block_in_use(b)) {
+		printk(BIOS_WARNING, "Warning - %s: %p is not allocated\n",
+		       __func__, ptr);
+		return;
+	}
+
+	stats.in_use -= block_size(b);
+	stats.frees++;
+	b->size &= ~BLOCK_IN_USE;
+
+	neighbour = next_block(b);
+	if (neighbour && !block_in_use(neighbour)) {
+		free_list_remove(neighbour);
+		set_block_size(b, block_size(b) + block_size(neighbour), 0);
+	}
+
+	neighbour = prev_block(b);
+	if (neighbour && !block_in_use(neighbour)) {
+		free_list_remove(neighbour);
+		set_block_size(neighbour, block_size(neighbour) + block_size(b), 0);
+		b = neighbour;
+	}
+
+	free_list_insert(b);
+}
+
+static void heap_stats_update(struct heap_stats *out)
+{
+	struct heap_block *b;
+
+	memcpy(out, &stats, sizeof(*out));
+	out->free_bytes = 0;
+	out->largest_free = 0;
+	out->free_blocks = 0;
+
+	b = heap_start < heap_end ? (struct heap_block *)heap_start : NULL;
+	for (; b; b = next_block(b)) {
+		if (block_in_use(b))
+			continue;
+		out->free_bytes += block_size(b);
+		out->largest_free = MAX(out->largest_free, block_size(b));
+		out->free_blocks++;
+	}
+}
+
+#if ENV_RAMSTAGE
+static void heap_stats_to_cbmem(void *unused)
+{
+	struct heap_stats *cbmem_stats;
+
+	if (!heap_start)
+		heap_init();
+
+	cbmem_stats = cbmem_find(CBMEM_ID_HEAP_STATS);
+	if (!cbmem_stats)
+		cbmem_stats = cbmem_add(CBMEM_ID_HEAP_STATS, sizeof(*cbmem_stats));
+	if (!cbmem_stats)
+		return;
+
+	heap_stats_update(cbmem_stats);
+
+	printk(BIOS_DEBUG, "Heap: %u/%u bytes in use, %u peak, %u free in %u blocks "
+	       "(largest %u)\n", cbmem_stats->in_use, cbmem_stats->heap_size,
+	       cbmem_stats->high_water, cbmem_stats->free_bytes,
+	       cbmem_stats->free_blocks, cbmem_stats->largest_free);
+}
+
+/* Record the statistics once with the tables and refresh them before boot. */
+BOOT_STATE_INIT_ENTRY(BS_WRITE_TABLES, BS_ON_ENTRY, heap_stats_to_cbmem, NULL);
+BOOT_STATE_INIT_ENTRY(BS_PAYLOAD_BOOT, BS_ON_ENTRY, heap_stats_to_cbmem, NULL);
+#endif
@@ -1,12 +1,55 @@
+#include <stdint.h>
 #include <string.h>
+
+/*
+ * Generic memcpy() for architectures without an optimized version. If source
+ * and destination share the same alignment modulo the word size, the bulk of
+ * the copy is done one machine word at a time (unrolled by four), otherwise
+ * it falls back to byte copies so that no unaligned accesses are generated.
+ */
+typedef unsigned long __attribute__((__may_alias__)) word_t;
+
+#define WORD_SIZE	sizeof(word_t)
+#define WORD_MASK	(WORD_SIZE - 1)
+
 void *memcpy(void *vdest, const void *vsrc, size_t bytes)
 {
 	const char *src = vsrc;
 	char *dest = vdest;
-	int i;
 
-	for (i = 0; i < (int)bytes; i++)
-		dest[i] = src[i];
+	if ((((uintptr_t)dest ^ (uintptr_t)src) & WORD_MASK) == 0) {
+		const word_t *wsrc;
+		word_t *wdest;
+
+		while (bytes && ((uintptr_t)dest & WORD_MASK)) {
+			*dest++ = *src++;
+			bytes--;
+		}
+
+		wsrc = (const word_t *)src;
+		wdest = (word_t *)dest;
+
+		while (bytes >= 4 * WORD_SIZE) {
+			wdest[0] = wsrc[0];
+			wdest[1] = wsrc[1];
+			wdest[2] = wsrc[2];
+			wdest[3] = wsrc[3];
+			wdest += 4;
+			wsrc += 4;
+			bytes -= 4 * WORD_SIZE;
+		}
+
+		while (bytes >= WORD_SIZE) {
+			*wdest++ = *wsrc++;
+			bytes -= WORD_SIZE;
+		}
+
+		src = (const char *)wsrc;
+		dest = (char *)wdest;
+	}
+
+	while (bytes--)
+		*dest++ = *src++;
 
 	return vdest;
 }
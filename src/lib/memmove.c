@@ -1,17 +1,57 @@
+#include <stdint.h>
 #include <string.h>
+
+/*
+ * Generic memmove() for architectures without an optimized version. Copies
+ * forward or backward depending on the overlap and, if source and destination
+ * share the same word alignment, moves whole machine words in the middle.
+ */
+typedef unsigned long __attribute__((__may_alias__)) word_t;
+
+#define WORD_SIZE	sizeof(word_t)
+#define WORD_MASK	(WORD_SIZE - 1)
+
 void *memmove(void *vdest, const void *vsrc, size_t count)
 {
 	const char *src = vsrc;
 	char *dest = vdest;
+	const int word_copy = (((uintptr_t)dest ^ (uintptr_t)src) & WORD_MASK) == 0;
+
+	if (dest == src || count == 0)
+		return vdest;
 
-	if (dest <= src) {
+	if (dest < src) {
+		if (word_copy) {
+			while (count && ((uintptr_t)dest & WORD_MASK)) {
+				*dest++ = *src++;
+				count--;
+			}
+			while (count >= WORD_SIZE) {
+				*(word_t *)dest = *(const word_t *)src;
+				dest += WORD_SIZE;
+				src += WORD_SIZE;
+				count -= WORD_SIZE;
+			}
+		}
 		while (count--)
 			*dest++ = *src++;
 	} else {
-		src  += count - 1;
-		dest += count - 1;
+		src += count;
+		dest += count;
+		if (word_copy) {
+			while (count && ((uintptr_t)dest & WORD_MASK)) {
+				*--dest = *--src;
+				count--;
+			}
+			while (count >= WORD_SIZE) {
+				dest -= WORD_SIZE;
+				src -= WORD_SIZE;
+				*(word_t *)dest = *(const word_t *)src;
+				count -= WORD_SIZE;
+			}
+		}
 		while (count--)
-			*dest-- = *src--;
+			*--dest = *--src;
 	}
 	return vdest;
 }
@@ -1,12 +1,53 @@
+#include <stdint.h>
 #include <string.h>
 
+/*
+ * Generic memset() for architectures without an optimized version. Once the
+ * destination is word aligned the fill pattern is stored one machine word at
+ * a time (unrolled by four).
+ */
+typedef unsigned long __attribute__((__may_alias__)) word_t;
+
+#define WORD_SIZE	sizeof(word_t)
+#define WORD_MASK	(WORD_SIZE - 1)
+
 void *memset(void *s, int c, size_t n)
 {
-	int i;
 	char *ss = (char *) s;
+	word_t *ws;
+	word_t pattern;
+
+	while (n && ((uintptr_t)ss & WORD_MASK)) {
+		*ss++ = c;
+		n--;
+	}
+
+	/* Replicate the fill byte into every byte of a word. */
+	pattern = (unsigned char)c;
+	pattern |= pattern << 8;
+	pattern |= pattern << 16;
+	if (WORD_SIZE > 4)
+		pattern |= (pattern << 16) << 16;
+
+	ws = (word_t *)ss;
+
+	while (n >= 4 * WORD_SIZE) {
+		ws[0] = pattern;
+		ws[1] = pattern;
+		ws[2] = pattern;
+		ws[3] = pattern;
+		ws += 4;
+		n -= 4 * WORD_SIZE;
+	}
+
+	while (n >= WORD_SIZE) {
+		*ws++ = pattern;
+		n -= WORD_SIZE;
+	}
 
-	for (i = 0; i < (int)n; i++)
-		ss[i] = c;
+	ss = (char *)ws;
+	while (n--)
+		*ss++ = c;
 
 	return s;
 }
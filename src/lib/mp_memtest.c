@@ -0,0 +1,361 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <acpi/acpi.h>
+#include <bootmem.h>
+#include <bootstate.h>
+#include <cbmem.h>
+#include <commonlib/helpers.h>
+#include <commonlib/memtest_serialized.h>
+#include <console/console.h>
+#include <cpu/x86/mp.h>
+#include <elog.h>
+#include <memrange.h>
+#include <smp/spinlock.h>
+#include <string.h>
+#include <timer.h>
+#include <timestamp.h>
+
+/*
+ * DRAM test on the BSP and all APs, run at the end of device init on every
+ * boot that isn't an S3 resume. It covers the same memory clear_memory()
+ * wipes for security_clear_dram_request(): all bootmem RAM outside of CBMEM,
+ * which holds ramstage with its heap and stacks.
+ *
+ * RAM is handed out in 64 MiB chunks, aligned to their size. The test has
+ * three phases, each spread across all CPUs:
+ *  1. Write every 64-bit word with its own address.
+ *  2. Read all of it back. Doing this only after all memory was written
+ *     catches addresses aliasing each other across chunks.
+ *  3. Moving inversions within each chunk: fill with a pattern, check it
+ *     and write its inverse going up, check the inverse and write the
+ *     pattern going down. The last pattern is 0, so DRAM ends up cleared.
+ *
+ * Writes are 16 byte non-temporal SSE2 stores. They bypass the caches, so the
+ * reads that follow come from DRAM and not from a cache line that still holds
+ * the value written. Reads are compared a 64 byte block at a time with vector
+ * operations, only a mismatching block is looked at word by word.
+ */
+
+#define MEMTEST_CHUNK_SIZE	(64 * MiB)
+#define MEMTEST_BLOCK_SIZE	64
+#define MEMTEST_MAX_ERRORS	64
+#define MEMTEST_ELOG_ERRORS	4
+
+#define MEMTEST_SSE2 \
+	__attribute__((target("sse2"), force_align_arg_pointer))
+
+typedef uint64_t v2u64 __attribute__((vector_size(16)));
+
+union memtest_block {
+	v2u64 v[MEMTEST_BLOCK_SIZE / sizeof(v2u64)];
+	uint64_t w[MEMTEST_BLOCK_SIZE / sizeof(uint64_t)];
+};
+
+#define MOVNTDQ(p, x) \
+	__asm__ volatile("movntdq %1, %0" : "=m" (*(v2u64 *)(p)) : "x" (x))
+#define SFENCE() \
+	__asm__ volatile("sfence" ::: "memory")
+
+static const uint64_t memtest_patterns[] = {
+#if CONFIG(MP_MEMTEST_FULL)
+	0x5555555555555555ULL,
+	0x3333333333333333ULL,
+	0x0f0f0f0f0f0f0f0fULL,
+	0x00ff00ff00ff00ffULL,
+	0x0000ffff0000ffffULL,
+	0x00000000ffffffffULL,
+#endif
+	0,
+};
+
+enum memtest_phase {
+	MEMTEST_ADDR_WRITE,
+	MEMTEST_ADDR_CHECK,
+	MEMTEST_MOVING_INV,
+};
+
+static struct {
+	enum memtest_phase phase;
+	const struct range_entry *r;
+	resource_t next;
+	resource_t limit;		/* End of what pointers can reach */
+	uint64_t tested;
+	uint32_t errors;
+	uint32_t num_entries;
+	struct memtest_error entries[MEMTEST_MAX_ERRORS];
+} memtest_job;
+
+DECLARE_SPIN_LOCK(memtest_lock)
+
+static void memtest_report(uintptr_t addr, uint64_t expected, uint64_t actual)
+{
+	struct memtest_error *e;
+
+	spin_lock(&memtest_lock);
+	if (memtest_job.num_entries < MEMTEST_MAX_ERRORS) {
+		e = &memtest_job.entries[memtest_job.num_entries++];
+		e->addr = addr;
+		e->expected = expected;
+		e->actual = actual;
+	}
+	memtest_job.errors++;
+	spin_unlock(&memtest_lock);
+}
+
+/*
+ * Word by word check of a block the vector compare flagged. This looks at
+ * the values that were read, reading again could miss a transient error.
+ */
+static void memtest_check_block(uintptr_t p, const union memtest_block *b,
+				uint64_t expected, uint64_t step)
+{
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(b->w); i++, expected += step) {
+		if (b->w[i] != expected)
+			memtest_report(p + i * sizeof(b->w[0]), expected,
+				       b->w[i]);
+	}
+}
+
+MEMTEST_SSE2
+static void memtest_addr_write(uintptr_t p, uintptr_t end)
+{
+	const v2u64 step = { 16, 16 };
+	v2u64 v = { p, p + 8 };
+
+	for (; p < end; p += sizeof(v), v += step)
+		MOVNTDQ(p, v);
+	SFENCE();
+}
+
+MEMTEST_SSE2
+static void memtest_addr_check(uintptr_t p, uintptr_t end)
+{
+	const v2u64 step = { 16, 16 };
+	v2u64 v = { p, p + 8 };
+	union memtest_block b;
+	v2u64 diff;
+	size_t i;
+
+	for (; p < end; p += MEMTEST_BLOCK_SIZE) {
+		diff = (v2u64){ 0, 0 };
+		for (i = 0; i < ARRAY_SIZE(b.v); i++, v += step) {
+			b.v[i] = ((const volatile v2u64 *)p)[i];
+			diff |= b.v[i] ^ v;
+		}
+		if (diff[0] | diff[1])
+			memtest_check_block(p, &b, p, 8);
+	}
+}
+
+MEMTEST_SSE2
+static void memtest_fill(uintptr_t p, uintptr_t end, uint64_t pattern)
+{
+	const v2u64 v = { pattern, pattern };
+
+	for (; p < end; p += sizeof(v))
+		MOVNTDQ(p, v);
+	SFENCE();
+}
+
+/* Check every block for the pattern and replace it with its inverse. */
+MEMTEST_SSE2
+static void memtest_invert(uintptr_t start, uintptr_t end, uint64_t pattern,
+			   bool up)
+{
+	const size_t blocks = (end - start) / MEMTEST_BLOCK_SIZE;
+	const v2u64 v = { pattern, pattern };
+	union memtest_block b;
+	uintptr_t p;
+	v2u64 diff;
+	size_t n, i;
+
+	for (n = 0; n < blocks; n++) {
+		p = up ? start + n * MEMTEST_BLOCK_SIZE :
+			 end - (n + 1) * MEMTEST_BLOCK_SIZE;
+		diff = (v2u64){ 0, 0 };
+		for (i = 0; i < ARRAY_SIZE(b.v); i++) {
+			b.v[i] = ((const volatile v2u64 *)p)[i];
+			diff |= b.v[i] ^ v;
+			MOVNTDQ(p + i * sizeof(v), ~v);
+		}
+		if (diff[0] | diff[1])
+			memtest_check_block(p, &b, pattern, 0);
+	}
+	SFENCE();
+}
+
+/* Hands out the next chunk along with the phase it belongs to. */
+static bool memtest_next_chunk(enum memtest_phase *phase, uintptr_t *start,
+			       uintptr_t *end)
+{
+	const struct range_entry *r;
+	resource_t base, limit;
+	bool found = false;
+
+	spin_lock(&memtest_lock);
+	for (; memtest_job.r; memtest_job.r = r->next, memtest_job.next = 0) {
+		r = memtest_job.r;
+		if (range_entry_tag(r) != BM_MEM_RAM)
+			continue;
+
+		base = ALIGN_UP(MAX(memtest_job.next, range_entry_base(r)),
+				MEMTEST_BLOCK_SIZE);
+		limit = ALIGN_DOWN(MIN(range_entry_end(r), memtest_job.limit),
+				   MEMTEST_BLOCK_SIZE);
+		if (base >= limit)
+			continue;
+
+		memtest_job.next = MIN(ALIGN_DOWN(base, MEMTEST_CHUNK_SIZE) +
+				       MEMTEST_CHUNK_SIZE, limit);
+		if (memtest_job.phase == MEMTEST_ADDR_WRITE)
+			memtest_job.tested += memtest_job.next - base;
+
+		*phase = memtest_job.phase;
+		*start = base;
+		*end = memtest_job.next;
+		found = true;
+		break;
+	}
+	spin_unlock(&memtest_lock);
+
+	return found;
+}
+
+static void memtest_worker(void *unused)
+{
+	enum memtest_phase phase;
+	uintptr_t start, end;
+	size_t i;
+
+	while (memtest_next_chunk(&phase, &start, &end)) {
+		switch (phase) {
+		case MEMTEST_ADDR_WRITE:
+			memtest_addr_write(start, end);
+			break;
+		case MEMTEST_ADDR_CHECK:
+			memtest_addr_check(start, end);
+			break;
+		case MEMTEST_MOVING_INV:
+			for (i = 0; i < ARRAY_SIZE(memtest_patterns); i++) {
+				memtest_fill(start, end, memtest_patterns[i]);
+				memtest_invert(start, end, memtest_patterns[i],
+					       true);
+				memtest_invert(start, end, ~memtest_patterns[i],
+					       false);
+			}
+			break;
+		}
+	}
+}
+
+static void memtest_run_phase(struct memranges *mem, enum memtest_phase phase)
+{
+	spin_lock(&memtest_lock);
+	memtest_job.phase = phase;
+	memtest_job.r = mem->entries;
+	memtest_job.next = 0;
+	spin_unlock(&memtest_lock);
+
+	/*
+	 * No worker of this phase is left once this returns, also not one on
+	 * an AP that took the call too late. That keeps the phases apart.
+	 */
+	if (mp_run_on_all_cpus_synchronously(memtest_worker, NULL) < 0)
+		printk(BIOS_WARNING, "%s: Not all APs are testing DRAM\n",
+		       __func__);
+}
+
+static void memtest_record(long duration_us, uint64_t skipped)
+{
+	const uint32_t passes = 2 + 5 * ARRAY_SIZE(memtest_patterns);
+	struct elog_event_mem_test_fail event;
+	struct memtest_result *result;
+	const struct memtest_error *e;
+	uint32_t i;
+
+	printk(BIOS_INFO, "DRAM test: %llu MiB in %ld ms, %llu MiB/s, %u errors\n",
+	       (unsigned long long)(memtest_job.tested / MiB),
+	       duration_us / USECS_PER_MSEC,
+	       (unsigned long long)(memtest_job.tested * passes / MiB *
+				    USECS_PER_SEC / MAX(duration_us, 1)),
+	       memtest_job.errors);
+	if (skipped)
+		printk(BIOS_INFO, "DRAM test: %llu MiB above 4 GiB not tested\n",
+		       (unsigned long long)(skipped / MiB));
+
+	for (i = 0; i < memtest_job.num_entries; i++) {
+		e = &memtest_job.entries[i];
+		printk(BIOS_ERR, "DRAM test: %016llx: expected %016llx, "
+		       "got %016llx\n", (unsigned long long)e->addr,
+		       (unsigned long long)e->expected,
+		       (unsigned long long)e->actual);
+	}
+
+	result = cbmem_add(CBMEM_ID_MEMTEST, sizeof(*result) +
+			   memtest_job.num_entries * sizeof(*e));
+	if (result) {
+		result->tested = memtest_job.tested;
+		result->skipped = skipped;
+		result->duration_us = duration_us;
+		result->passes = passes;
+		result->errors = memtest_job.errors;
+		result->num_entries = memtest_job.num_entries;
+		memcpy(result->entries, memtest_job.entries,
+		       memtest_job.num_entries * sizeof(*e));
+	} else {
+		printk(BIOS_ERR, "%s: Can't add DRAM test result to CBMEM\n",
+		       __func__);
+	}
+
+	for (i = 0; i < MIN(memtest_job.num_entries, MEMTEST_ELOG_ERRORS); i++) {
+		e = &memtest_job.entries[i];
+		event.errors = memtest_job.errors;
+		event.address = e->addr;
+		event.expected = e->expected;
+		event.actual = e->actual;
+		elog_add_event_raw(ELOG_TYPE_MEM_TEST_FAIL, &event,
+				   sizeof(event));
+	}
+}
+
+static void mp_memtest(void *unused)
+{
+	const struct range_entry *r;
+	struct memranges mem;
+	struct stopwatch sw;
+	uint64_t skipped = 0;
+
+	if (acpi_is_wakeup_s3())
+		return;
+
+	bootmem_init_unused_dram(&mem);
+
+	memset(&memtest_job, 0, sizeof(memtest_job));
+	memtest_job.limit = sizeof(resource_t) == sizeof(void *) ?
+			    ~(resource_t)0 : 4ULL * GiB;
+
+	memranges_each_entry(r, &mem) {
+		if (range_entry_tag(r) == BM_MEM_RAM &&
+		    range_entry_end(r) > memtest_job.limit)
+			skipped += range_entry_end(r) -
+				   MAX(range_entry_base(r), memtest_job.limit);
+	}
+
+	printk(BIOS_DEBUG, "%s: Testing DRAM on all CPUs\n", __func__);
+	timestamp_add_now(TS_MEMTEST_START);
+	stopwatch_init(&sw);
+
+	memtest_run_phase(&mem, MEMTEST_ADDR_WRITE);
+	memtest_run_phase(&mem, MEMTEST_ADDR_CHECK);
+	memtest_run_phase(&mem, MEMTEST_MOVING_INV);
+
+	timestamp_add_now(TS_MEMTEST_END);
+	memtest_record(stopwatch_duration_usecs(&sw), skipped);
+
+	memranges_teardown(&mem);
+}
+
+/* After DEV_INIT, the APs are up and MTRRs are configured on x86. */
+BOOT_STATE_INIT_ENTRY(BS_DEV_INIT, BS_ON_EXIT, mp_memtest, NULL);
@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <bootstate.h>
+#include <cbmem.h>
+#include <commonlib/helpers.h>
+#include <commonlib/profile_serialized.h>
+#include <console/console.h>
+#include <profiler.h>
+#include <symbols.h>
+
+#if CONFIG(SAMPLING_PROFILER_CALL_STACKS)
+#define PROFILE_DEPTH	16
+#else
+#define PROFILE_DEPTH	1
+#endif
+
+/* Don't follow frame pointers further than this in one step. */
+#define MAX_FRAME_SIZE	(64 * KiB)
+
+static struct profile_buffer *profile;
+
+static uint32_t profile_pc(uintptr_t pc)
+{
+	if (pc < (uintptr_t)_program || pc >= (uintptr_t)_eprogram)
+		return PROFILE_PC_EXTERNAL;
+	return pc - (uintptr_t)_program;
+}
+
+void profiler_record(uintptr_t pc, uintptr_t fp, uintptr_t sp)
+{
+	uint32_t *sample;
+	size_t i;
+
+	if (!profile)
+		return;
+
+	sample = &profile->samples[(profile->total % profile->max_samples) * PROFILE_DEPTH];
+	sample[0] = profile_pc(pc);
+
+	for (i = 1; i < PROFILE_DEPTH; i++) {
+		const uintptr_t *frame = (const uintptr_t *)fp;
+
+		/* Frames have to be further up the stack than the last one. */
+		if (fp <= sp || fp - sp > MAX_FRAME_SIZE || !IS_ALIGNED(fp, sizeof(fp)))
+			break;
+
+		/* frame[0] is the caller's frame pointer, frame[1] the return address. */
+		sample[i] = profile_pc(frame[1]);
+		sp = fp;
+		fp = frame[0];
+	}
+
+	for (; i < PROFILE_DEPTH; i++)
+		sample[i] = PROFILE_PC_NONE;
+
+	profile->total++;
+}
+
+static void profiler_start(int is_recovery)
+{
+	struct profile_buffer *buf;
+
+	buf = cbmem_add(CBMEM_ID_PROFILE, sizeof(*buf) + CONFIG_SAMPLING_PROFILER_SAMPLES *
+			PROFILE_DEPTH * sizeof(buf->samples[0]));
+	if (!buf) {
+		printk(BIOS_ERR, "Profiler: Could not allocate sample buffer\n");
+		return;
+	}
+
+	buf->period_us = CONFIG_SAMPLING_PROFILER_PERIOD_US;
+	buf->depth = PROFILE_DEPTH;
+	buf->max_samples = CONFIG_SAMPLING_PROFILER_SAMPLES;
+	buf->total = 0;
+	profile = buf;
+
+	if (arch_profiler_start(buf->period_us))
+		profile = NULL;
+}
+
+static void profiler_stop(void *unused)
+{
+	if (!profile)
+		return;
+
+	arch_profiler_stop();
+	printk(BIOS_DEBUG, "Profiler: %u samples taken, %u kept\n", profile->total,
+	       MIN(profile->total, profile->max_samples));
+	profile = NULL;
+}
+
+RAMSTAGE_CBMEM_INIT_HOOK(profiler_start)
+BOOT_STATE_INIT_ENTRY(BS_OS_RESUME, BS_ON_ENTRY, profiler_stop, NULL);
+BOOT_STATE_INIT_ENTRY(BS_PAYLOAD_BOOT, BS_ON_ENTRY, profiler_stop, NULL);
@@ -34,6 +34,7 @@ int prog_locate(struct prog *prog)
 	cbfsf_file_type(&file, &prog->cbfs_type);
 
 	cbfs_file_data(prog_rdev(prog), &file);
+	prog_set_cbfs_hash(prog, &file.mdata);
 
 	return 0;
 }
@@ -1,5 +1,6 @@
 /* SPDX-License-Identifier: GPL-2.0-only */
 
+#include <console/console.h>
 #include <program_loading.h>
 
 /* For each segment of a program loaded this function is called*/
@@ -23,6 +24,8 @@ void __weak arch_segment_loaded(uintptr_t start, size_t size,
 
 void prog_run(struct prog *prog)
 {
+	/* Don't leave queued console output behind. */
+	console_drain();
 	platform_prog_run(prog);
 	arch_prog_run(prog);
 }
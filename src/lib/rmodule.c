@@ -269,7 +269,8 @@ int rmodule_stage_load(struct rmod_stage_load *rsl)
 	       prog_name(rsl->prog), rmod_loc, stage.memlen);
 
 	if (!cbfs_load_and_decompress(fh, sizeof(stage), stage.len, rmod_loc,
-				      stage.memlen, stage.compression))
+				      stage.memlen, stage.compression,
+				      prog_cbfs_hash(rsl->prog)))
 		return -1;
 
 	if (rmodule_parse(rmod_loc, &rmod_stage))
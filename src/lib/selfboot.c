@@ -71,6 +71,17 @@ static int load_one_segment(uint8_t *dest,
 			return 0;
 		break;
 	}
+	case CBFS_COMPRESS_LZMA_BCJ_X86:
+	case CBFS_COMPRESS_LZMA_BCJ_ARM64: {
+		printk(BIOS_DEBUG, "using LZMA with branch converter\n");
+		timestamp_add_now(TS_START_ULZMA);
+		len = ulzman(src, len, dest, memsz);
+		timestamp_add_now(TS_END_ULZMA);
+		if (!len) /* Decompression Error. */
+			return 0;
+		cbfs_bcj_decode(dest, len, compression);
+		break;
+	}
 	case CBFS_COMPRESS_LZ4: {
 		printk(BIOS_DEBUG, "using LZ4\n");
 		timestamp_add_now(TS_START_ULZ4F);
@@ -80,6 +91,24 @@ static int load_one_segment(uint8_t *dest,
 			return 0;
 		break;
 	}
+	case CBFS_COMPRESS_ZSTD: {
+		printk(BIOS_DEBUG, "using Zstandard\n");
+		timestamp_add_now(TS_START_UZSTD);
+		len = uzstdn(src, len, dest, memsz);
+		timestamp_add_now(TS_END_UZSTD);
+		if (!len) /* Decompression Error. */
+			return 0;
+		break;
+	}
+	case CBFS_COMPRESS_LZMA_CHUNKED:
+	case CBFS_COMPRESS_LZ4_CHUNKED: {
+		printk(BIOS_DEBUG, "using chunked %s\n",
+		       compression == CBFS_COMPRESS_LZ4_CHUNKED ? "LZ4" : "LZMA");
+		len = cbfs_decompress_chunked(src, len, dest, memsz, compression);
+		if (!len) /* Decompression Error. */
+			return 0;
+		break;
+	}
 	case CBFS_COMPRESS_NONE: {
 		printk(BIOS_DEBUG, "it's not compressed!\n");
 		memcpy(dest, src, len);
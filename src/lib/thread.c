@@ -294,6 +294,12 @@ int thread_run(void (*func)(void *), void *arg)
 	return 0;
 }
 
+int thread_available(void)
+{
+	return thread_can_yield(current_thread()) &&
+	       !thread_list_empty(&free_threads);
+}
+
 int thread_run_until(void (*func)(void *), void *arg,
 		     boot_state_t state, boot_state_sequence_t seq)
 {
@@ -1,6 +1,7 @@
 /* SPDX-License-Identifier: GPL-2.0-only */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <console/console.h>
 #include <cbmem.h>
@@ -9,6 +10,10 @@
 #include <timestamp.h>
 #include <smp/node.h>
 
+#if CONFIG(TIMESTAMPS_PER_CPU) && ENV_RAMSTAGE
+#include <arch/cpu.h>
+#endif
+
 #define MAX_TIMESTAMPS 192
 
 /* This points to the active timestamp_table and can change within a stage
@@ -117,6 +122,99 @@ static void timestamp_add_table_entry(struct timestamp_table *ts_table,
 		printk(BIOS_ERR, "ERROR: Timestamp table full\n");
 }
 
+#if CONFIG(TIMESTAMPS_PER_CPU) && ENV_RAMSTAGE
+#define TS_CPU_ENTRIES CONFIG_TIMESTAMPS_PER_CPU_ENTRIES
+
+_Static_assert(CONFIG_MAX_CPUS - 1 <= TIMESTAMP_CPU_MAX,
+	       "CPU index doesn't fit into timestamp entry_id");
+
+/*
+ * Application processors don't write to the shared table. Each one appends to
+ * a ring of its own, which the BSP drains into the table whenever it adds a
+ * timestamp itself. The head is only written by the owning CPU and the tail
+ * only by the BSP, so neither side has to take a lock.
+ */
+struct timestamp_cpu_ring {
+	uint32_t head;
+	uint32_t tail;
+	uint32_t dropped;
+	struct timestamp_entry entries[TS_CPU_ENTRIES];
+};
+
+static struct timestamp_cpu_ring cpu_rings[CONFIG_MAX_CPUS];
+static bool cpu_rings_used;
+
+/* Returns true if the timestamp was handled by an application processor. */
+static bool timestamp_cpu_add(enum timestamp_id id, uint64_t ts_time)
+{
+	unsigned int cpu = cpu_info()->index;
+	struct timestamp_cpu_ring *ring;
+	struct timestamp_entry *tse;
+	uint32_t head;
+
+	if (cpu == 0 || cpu >= ARRAY_SIZE(cpu_rings))
+		return false;
+
+	ring = &cpu_rings[cpu];
+	head = ring->head;
+	__atomic_store_n(&cpu_rings_used, true, __ATOMIC_RELAXED);
+
+	if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= TS_CPU_ENTRIES) {
+		__atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+		return true;
+	}
+
+	/* Stamps stay absolute until the BSP merges them into the table. */
+	tse = &ring->entries[head % TS_CPU_ENTRIES];
+	tse->entry_id = id | cpu << TIMESTAMP_CPU_SHIFT;
+	tse->entry_stamp = ts_time;
+
+	/* Publish the slot only once the entry has been written. */
+	__atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+static void timestamp_merge_cpu_rings(struct timestamp_table *ts_table)
+{
+	struct timestamp_cpu_ring *ring;
+	struct timestamp_entry *tse;
+	uint32_t head, tail, dropped;
+	unsigned int cpu;
+
+	if (!__atomic_load_n(&cpu_rings_used, __ATOMIC_RELAXED))
+		return;
+
+	for (cpu = 1; cpu < ARRAY_SIZE(cpu_rings); cpu++) {
+		ring = &cpu_rings[cpu];
+		head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+		for (tail = ring->tail; tail != head; tail++) {
+			tse = &ring->entries[tail % TS_CPU_ENTRIES];
+			timestamp_add_table_entry(ts_table, tse->entry_id,
+					tse->entry_stamp - ts_table->base_time);
+		}
+
+		/* Hand the slots back to the AP. */
+		__atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+
+		dropped = __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+		if (dropped)
+			printk(BIOS_WARNING, "WARNING: %u timestamps of CPU %u dropped\n",
+			       dropped, cpu);
+	}
+}
+#else
+static bool timestamp_cpu_add(enum timestamp_id id, uint64_t ts_time)
+{
+	return false;
+}
+
+static void timestamp_merge_cpu_rings(struct timestamp_table *ts_table)
+{
+}
+#endif
+
 void timestamp_add(enum timestamp_id id, uint64_t ts_time)
 {
 	struct timestamp_table *ts_table;
@@ -124,6 +222,9 @@ void timestamp_add(enum timestamp_id id, uint64_t ts_time)
 	if (!timestamp_should_run())
 		return;
 
+	if (timestamp_cpu_add(id, ts_time))
+		return;
+
 	ts_table = timestamp_table_get();
 
 	if (!ts_table) {
@@ -131,6 +232,9 @@ void timestamp_add(enum timestamp_id id, uint64_t ts_time)
 		return;
 	}
 
+	/* Keep AP entries ahead of whatever the BSP is about to record. */
+	timestamp_merge_cpu_rings(ts_table);
+
 	ts_time -= ts_table->base_time;
 	timestamp_add_table_entry(ts_table, id, ts_time);
 
@@ -257,6 +361,9 @@ void timestamp_rescale_table(uint16_t N, uint16_t M)
 		return;
 	}
 
+	/* Pending AP entries are still absolute and must be scaled as well. */
+	timestamp_merge_cpu_rings(ts_table);
+
 	ts_table->base_time /= M;
 	ts_table->base_time *= N;
 	for (i = 0; i < ts_table->num_entries; i++) {
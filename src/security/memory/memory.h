@@ -1,3 +1,12 @@
 /* SPDX-License-Identifier: GPL-2.0-only */
 
+#include <stdbool.h>
+#include <stdint.h>
+
 bool security_clear_dram_request(void);
+
+/*
+ * Returns the NUMA node of the DRAM at addr, or -1 if unknown. Parallel DRAM
+ * clearing uses it to clear memory from CPUs of the same node.
+ */
+int memory_clear_dram_node(uint64_t addr);
@@ -4,6 +4,7 @@
 #include <cpu/x86/pae.h>
 #else
 #define memset_pae(a, b, c, d, e) 0
+#define memset_pae_with(a, b, c, d, e, f) 0
 #define MEMSET_PAE_PGTL_ALIGN 0
 #define MEMSET_PAE_PGTL_SIZE 0
 #define MEMSET_PAE_PGTL_SIZE 0
@@ -18,8 +19,15 @@
 #include <arch/memory_clear.h>
 #include <string.h>
 #include <security/memory/memory.h>
-#include <cbmem.h>
 #include <acpi/acpi.h>
+#include <timestamp.h>
+
+#if CONFIG(SECURITY_CLEAR_DRAM_PARALLEL)
+#include <arch/cpu.h>
+#include <cpu/x86/mp.h>
+#include <device/device.h>
+#include <smp/spinlock.h>
+#endif
 
 /* Helper to find free space for memset_pae. */
 static uintptr_t get_free_memory_range(struct memranges *mem,
@@ -45,61 +53,35 @@ static uintptr_t get_free_memory_range(struct memranges *mem,
 }
 
 /*
- * Clears all memory regions marked as BM_MEM_RAM.
+ * Clears all memory regions marked as BM_MEM_RAM from the BSP.
  * Uses memset_pae if the memory region can't be accessed by memset and
  * architecture is x86.
- *
- * @return 0 on success, 1 on error
  */
-static void clear_memory(void *unused)
+static void clear_memory_serial(struct memranges *mem)
 {
 	const struct range_entry *r;
-	struct memranges mem;
 	uintptr_t pgtbl, vmem_addr;
 
-	if (acpi_is_wakeup_s3())
-		return;
-
-	if (!security_clear_dram_request())
-		return;
-
-	/* FSP1.0 is marked as MMIO and won't appear here */
-
-	memranges_init(&mem, IORESOURCE_MEM | IORESOURCE_FIXED |
-			IORESOURCE_STORED | IORESOURCE_ASSIGNED |
-			IORESOURCE_CACHEABLE,
-			IORESOURCE_MEM | IORESOURCE_FIXED |
-			IORESOURCE_STORED | IORESOURCE_ASSIGNED |
-			IORESOURCE_CACHEABLE,
-			BM_MEM_RAM);
-
-	/* Add reserved entries */
-	void *baseptr = NULL;
-	size_t size = 0;
-
-	/* Only skip CBMEM, stage program, stack and heap are included there. */
-
-	cbmem_get_region(&baseptr, &size);
-	memranges_insert(&mem, (uintptr_t)baseptr, size, BM_MEM_TABLE);
-
 	if (ENV_X86) {
 		/* Find space for PAE enabled memset */
-		pgtbl = get_free_memory_range(&mem, MEMSET_PAE_PGTL_ALIGN,
+		pgtbl = get_free_memory_range(mem, MEMSET_PAE_PGTL_ALIGN,
 					MEMSET_PAE_PGTL_SIZE);
 
 		/* Don't touch page tables while clearing */
-		memranges_insert(&mem, pgtbl, MEMSET_PAE_PGTL_SIZE,
+		memranges_insert(mem, pgtbl, MEMSET_PAE_PGTL_SIZE,
 					BM_MEM_TABLE);
 
-		vmem_addr = get_free_memory_range(&mem, MEMSET_PAE_VMEM_ALIGN,
+		vmem_addr = get_free_memory_range(mem, MEMSET_PAE_VMEM_ALIGN,
 						MEMSET_PAE_PGTL_SIZE);
 
 		printk(BIOS_SPEW, "%s: pgtbl at %p, virt memory at %p\n",
 		__func__, (void *)pgtbl, (void *)vmem_addr);
 	}
 
+	timestamp_add_now(TS_MEMORY_CLEAR_START);
+
 	/* Now clear all useable DRAM */
-	memranges_each_entry(r, &mem) {
+	memranges_each_entry(r, mem) {
 		if (range_entry_tag(r) != BM_MEM_RAM)
 			continue;
 		printk(BIOS_DEBUG, "%s: Clearing DRAM %016llx-%016llx\n",
@@ -133,6 +115,253 @@ static void clear_memory(void *unused)
 		memset((void *)pgtbl, 0, MEMSET_PAE_PGTL_SIZE);
 	}
 
+	timestamp_add_now(TS_MEMORY_CLEAR_END);
+}
+
+#if CONFIG(SECURITY_CLEAR_DRAM_PARALLEL)
+/*
+ * Chunks are aligned to their size so that they never straddle a NUMA node
+ * or the 4 GiB boundary. Each node has its own cursor walking the memranges
+ * and only handing out chunks of that node. CPUs take chunks of their own
+ * node first and help out on the other nodes once it is done.
+ */
+#define CLEAR_CHUNK_SIZE	(64 * MiB)
+#define CLEAR_MAX_NODES		8
+
+struct clear_cursor {
+	const struct range_entry *r;
+	resource_t next;
+};
+
+static struct {
+	struct clear_cursor cursor[CLEAR_MAX_NODES];
+	uintptr_t pgtbl;		/* One set of page tables per worker */
+	uintptr_t vmem_addr;
+	int max_workers;
+	int workers;			/* Worker slots handed out */
+	bool failed;
+	struct {
+		int cpu;
+		uint64_t cleared;
+	} stats[CONFIG_MAX_CPUS];
+} clear_job;
+
+DECLARE_SPIN_LOCK(clear_lock)
+
+__weak int memory_clear_dram_node(uint64_t addr)
+{
+	return -1;
+}
+
+static int clear_node(uint64_t addr)
+{
+	int node = memory_clear_dram_node(addr);
+
+	return node < 0 || node >= CLEAR_MAX_NODES ? 0 : node;
+}
+
+/* Called with clear_lock held. */
+static bool clear_cursor_next(struct clear_cursor *c, int node,
+			      resource_t *base, resource_t *size)
+{
+	for (; c->r; c->r = c->r->next, c->next = 0) {
+		resource_t start, end;
+
+		if (range_entry_tag(c->r) != BM_MEM_RAM)
+			continue;
+
+		start = MAX(c->next, range_entry_base(c->r));
+		while (start < range_entry_end(c->r)) {
+			end = MIN(ALIGN_DOWN(start, CLEAR_CHUNK_SIZE) +
+				  CLEAR_CHUNK_SIZE, range_entry_end(c->r));
+			c->next = end;
+			if (clear_node(start) == node) {
+				*base = start;
+				*size = end - start;
+				return true;
+			}
+			start = end;
+		}
+	}
+	return false;
+}
+
+/*
+ * Zero memory with non-temporal stores. They go to the write combining
+ * buffers instead of pulling every line into the cache first, which roughly
+ * doubles the usable write bandwidth and keeps the caches of the CPU intact.
+ */
+static void *memset_nt(void *dst, int c, size_t len)
+{
+	uintptr_t p = (uintptr_t)dst;
+	uintptr_t end = p + len;
+	unsigned long v = (unsigned char)c * (~0UL / 0xff);
+	size_t head = MIN(len, ALIGN_UP(p, CACHELINE_SIZE) - p);
+
+	if (!CONFIG(SSE2))
+		return memset(dst, c, len);
+
+	memset(dst, c, head);
+	for (p += head; p + CACHELINE_SIZE <= end; p += CACHELINE_SIZE) {
+		unsigned long *l = (unsigned long *)p;
+		size_t i;
+
+		for (i = 0; i < CACHELINE_SIZE / sizeof(*l); i++)
+			asm volatile("movnti %1, %0" : "=m" (l[i]) : "r" (v));
+	}
+	memset((void *)p, c, end - p);
+
+	/* Make the stores globally visible before anybody else looks. */
+	asm volatile("sfence" ::: "memory");
+	return dst;
+}
+
+static bool clear_chunk(resource_t base, resource_t size, int worker)
+{
+	/* Does regular memset work? */
+	if (sizeof(resource_t) == sizeof(void *) ||
+	    !((base + size) >> (sizeof(void *) * 8))) {
+		memset_nt((void *)(uintptr_t)base, 0, size);
+		return true;
+	}
+
+	/* Each worker has its own page tables, the window can be shared. */
+	return !memset_pae_with(base, 0, size, (void *)(clear_job.pgtbl +
+				worker * MEMSET_PAE_PGTL_SIZE),
+				(void *)clear_job.vmem_addr, memset_nt);
+}
+
+/*
+ * APs may only add timestamps to their own ring. Without TIMESTAMPS_PER_CPU
+ * they'd all update the shared table at once, so only the BSP records then.
+ */
+static void clear_timestamp(const struct cpu_info *info, enum timestamp_id id)
+{
+	if (CONFIG(TIMESTAMPS_PER_CPU) || info->index == 0)
+		timestamp_add_now(id);
+}
+
+static void clear_worker(void *unused)
+{
+	const struct cpu_info *info = cpu_info();
+	resource_t base, size;
+	int home = 0, node, worker, i;
+	bool found, ok;
+
+	if (info->cpu)
+		home = info->cpu->path.apic.node_id % CLEAR_MAX_NODES;
+
+	spin_lock(&clear_lock);
+	if (clear_job.workers >= clear_job.max_workers) {
+		spin_unlock(&clear_lock);
+		return;
+	}
+	worker = clear_job.workers++;
+	clear_job.stats[worker].cpu = info->index;
+	spin_unlock(&clear_lock);
+
+	clear_timestamp(info, TS_MEMORY_CLEAR_START);
+
+	do {
+		spin_lock(&clear_lock);
+		found = false;
+		for (i = 0; !found && i < CLEAR_MAX_NODES; i++) {
+			node = (home + i) % CLEAR_MAX_NODES;
+			found = clear_cursor_next(&clear_job.cursor[node], node,
+						  &base, &size);
+		}
+		spin_unlock(&clear_lock);
+
+		if (found) {
+			ok = clear_chunk(base, size, worker);
+			spin_lock(&clear_lock);
+			clear_job.stats[worker].cleared += size;
+			clear_job.failed |= !ok;
+			spin_unlock(&clear_lock);
+		}
+	} while (found);
+
+	clear_timestamp(info, TS_MEMORY_CLEAR_END);
+}
+
+/*
+ * Clears all memory regions marked as BM_MEM_RAM on the BSP and all APs.
+ * Returns false if the APs can't take work, the caller clears on the BSP
+ * then.
+ */
+static bool clear_memory_parallel(struct memranges *mem)
+{
+	const bool need_pae = sizeof(resource_t) != sizeof(void *);
+	int i;
+
+	if (!mp_aps_waiting_for_work())
+		return false;
+
+	memset(&clear_job, 0, sizeof(clear_job));
+	clear_job.max_workers = CONFIG_MAX_CPUS;
+
+	if (need_pae) {
+		const size_t pgtbl_size = clear_job.max_workers *
+					  MEMSET_PAE_PGTL_SIZE;
+
+		clear_job.pgtbl = get_free_memory_range(mem,
+				MEMSET_PAE_PGTL_ALIGN, pgtbl_size);
+		if (!clear_job.pgtbl)
+			return false;
+		memranges_insert(mem, clear_job.pgtbl, pgtbl_size,
+				 BM_MEM_TABLE);
+
+		clear_job.vmem_addr = get_free_memory_range(mem,
+				MEMSET_PAE_VMEM_ALIGN, MEMSET_PAE_VMEM_SIZE);
+	}
+
+	for (i = 0; i < CLEAR_MAX_NODES; i++)
+		clear_job.cursor[i].r = mem->entries;
+
+	printk(BIOS_DEBUG, "%s: Clearing DRAM on all CPUs\n", __func__);
+
+	if (mp_run_on_all_cpus_synchronously(clear_worker, NULL) < 0)
+		printk(BIOS_WARNING, "%s: Not all APs are clearing DRAM\n",
+		       __func__);
+
+	if (need_pae)
+		memset((void *)clear_job.pgtbl, 0,
+		       clear_job.max_workers * MEMSET_PAE_PGTL_SIZE);
+
+	for (i = 0; i < clear_job.workers; i++)
+		printk(BIOS_DEBUG, "%s: CPU %d cleared %llu MiB\n", __func__,
+		       clear_job.stats[i].cpu,
+		       (unsigned long long)(clear_job.stats[i].cleared / MiB));
+	if (clear_job.failed)
+		printk(BIOS_ERR, "%s: Failed to memset memory\n", __func__);
+
+	return true;
+}
+#else
+static bool clear_memory_parallel(struct memranges *mem)
+{
+	return false;
+}
+#endif
+
+/*
+ * Clears all memory regions marked as BM_MEM_RAM.
+ */
+static void clear_memory(void *unused)
+{
+	struct memranges mem;
+
+	if (acpi_is_wakeup_s3())
+		return;
+
+	if (!security_clear_dram_request())
+		return;
+
+	bootmem_init_unused_dram(&mem);
+
+	if (!clear_memory_parallel(&mem))
+		clear_memory_serial(&mem);
+
 	memranges_teardown(&mem);
 }
 
@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <commonlib/bsd/helpers.h>
+#include <console/console.h>
+#include <endian.h>
+#include <security/vboot/sha256_accel.h>
+#include <string.h>
+#include <vb2_api.h>
+
+/*
+ * vboot hands the RW firmware body to these hooks instead of its own portable
+ * SHA-256 when init() succeeds. Only the compression function runs on the
+ * CPU's SHA instructions, buffering and padding are done here. On CPUs
+ * without the instructions init() reports the hash as unsupported and vboot
+ * falls back to software.
+ */
+
+static const uint32_t sha256_iv[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static struct {
+	uint32_t state[8];
+	uint8_t block[SHA256_ACCEL_BLOCK_SIZE];
+	size_t used;
+	uint64_t total;
+} ctx;
+
+vb2_error_t vb2ex_hwcrypto_digest_init(enum vb2_hash_algorithm hash_alg,
+				       uint32_t data_size)
+{
+	if (hash_alg != VB2_HASH_SHA256 || !sha256_accel_supported())
+		return VB2_ERROR_EX_HWCRYPTO_UNSUPPORTED;
+
+	memcpy(ctx.state, sha256_iv, sizeof(ctx.state));
+	ctx.used = 0;
+	ctx.total = 0;
+
+	printk(BIOS_DEBUG, "Using CPU SHA-256 instructions for %u bytes\n",
+	       data_size);
+	return VB2_SUCCESS;
+}
+
+vb2_error_t vb2ex_hwcrypto_digest_extend(const uint8_t *buf, uint32_t size)
+{
+	size_t blocks;
+
+	ctx.total += size;
+
+	if (ctx.used) {
+		size_t fill = MIN(size, SHA256_ACCEL_BLOCK_SIZE - ctx.used);
+
+		memcpy(ctx.block + ctx.used, buf, fill);
+		ctx.used += fill;
+		buf += fill;
+		size -= fill;
+		if (ctx.used < SHA256_ACCEL_BLOCK_SIZE)
+			return VB2_SUCCESS;
+		sha256_accel_blocks(ctx.state, ctx.block, 1);
+		ctx.used = 0;
+	}
+
+	blocks = size / SHA256_ACCEL_BLOCK_SIZE;
+	if (blocks) {
+		sha256_accel_blocks(ctx.state, buf, blocks);
+		buf += blocks * SHA256_ACCEL_BLOCK_SIZE;
+		size -= blocks * SHA256_ACCEL_BLOCK_SIZE;
+	}
+
+	memcpy(ctx.block, buf, size);
+	ctx.used = size;
+	return VB2_SUCCESS;
+}
+
+vb2_error_t vb2ex_hwcrypto_digest_finalize(uint8_t *digest,
+					   uint32_t digest_size)
+{
+	const size_t len_offset = SHA256_ACCEL_BLOCK_SIZE - sizeof(uint64_t);
+	size_t i;
+
+	if (digest_size != SHA256_ACCEL_DIGEST_SIZE)
+		return VB2_ERROR_SHA_FINALIZE_DIGEST_SIZE;
+
+	/* Terminating 1 bit, zeroes and the message length in bits. */
+	ctx.block[ctx.used++] = 0x80;
+	if (ctx.used > len_offset) {
+		memset(ctx.block + ctx.used, 0,
+		       SHA256_ACCEL_BLOCK_SIZE - ctx.used);
+		sha256_accel_blocks(ctx.state, ctx.block, 1);
+		ctx.used = 0;
+	}
+	memset(ctx.block + ctx.used, 0, len_offset - ctx.used);
+	be64enc(ctx.block + len_offset, ctx.total * 8);
+	sha256_accel_blocks(ctx.state, ctx.block, 1);
+
+	for (i = 0; i < ARRAY_SIZE(ctx.state); i++)
+		be32enc(digest + i * sizeof(uint32_t), ctx.state[i]);
+
+	return VB2_SUCCESS;
+}
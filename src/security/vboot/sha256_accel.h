@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#ifndef __VBOOT_SHA256_ACCEL_H__
+#define __VBOOT_SHA256_ACCEL_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_ACCEL_BLOCK_SIZE		64
+#define SHA256_ACCEL_DIGEST_SIZE	32
+
+/*
+ * Architecture backend for the SHA-256 hwcrypto hooks. The support check runs
+ * once per digest and may prepare the CPU for the instructions used, blocks
+ * are only called after it returned true. The state is the eight working
+ * variables a..h in host byte order, the data is raw big-endian message.
+ */
+bool sha256_accel_supported(void);
+void sha256_accel_blocks(uint32_t state[8], const uint8_t *data,
+			 size_t blocks);
+
+#endif /* __VBOOT_SHA256_ACCEL_H__ */
@@ -0,0 +1,20 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <arch/barrier.h>
+#include <arch/lib_helpers.h>
+#include <security/vboot/sha256_accel.h>
+
+#define ID_AA64ISAR0_SHA2_SHIFT	12
+#define ID_AA64ISAR0_SHA2_MASK	0xf
+
+bool sha256_accel_supported(void)
+{
+	if (!((raw_read_id_aa64isar0_el1() >> ID_AA64ISAR0_SHA2_SHIFT) &
+	      ID_AA64ISAR0_SHA2_MASK))
+		return false;
+
+	/* The reset value of CPTR_EL3.TFP is unknown, SIMD must not trap. */
+	raw_write_cptr_el3(raw_read_cptr_el3() & ~CPTR_EL3_TFP_ENABLE);
+	isb();
+	return true;
+}
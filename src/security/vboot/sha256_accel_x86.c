@@ -0,0 +1,148 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <arch/cpu.h>
+#include <security/vboot/sha256_accel.h>
+
+/*
+ * SHA-256 compression with the SHA extensions (SHA-NI). The instructions keep
+ * the state as ABEF/CDGH register pairs and work on four message words at a
+ * time. coreboot is built without SSE code generation on x86_32, so the
+ * function enabling the instructions is self contained and only reaches the
+ * vector registers through generic vector types and inline assembly.
+ */
+
+#define CPUID_EXT_FEATURES_EBX_SHA	(1 << 29)
+#define CPUID_FEATURES_ECX_SSE41	(1 << 19)
+#define CPUID_FEATURES_ECX_SSSE3	(1 << 9)
+
+typedef uint32_t v4u32 __attribute__((vector_size(16)));
+typedef uint32_t v4u32_unaligned __attribute__((vector_size(16), aligned(1)));
+
+static const uint32_t sha256_k[64] __aligned(16) = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+	0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+	0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+	0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+	0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+	0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+/* pshufb mask turning big-endian message words into host order. */
+static const uint8_t bswap32_mask[16] __aligned(16) = {
+	3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+};
+
+#define PSHUFB(x, mask) \
+	__asm__("pshufb %1, %0" : "+x" (x) : "x" (mask))
+#define PSHUFD(dst, src, imm) \
+	__asm__("pshufd $" #imm ", %1, %0" : "=x" (dst) : "x" (src))
+#define PALIGNR(hi, lo, imm) \
+	__asm__("palignr $" #imm ", %1, %0" : "+x" (hi) : "x" (lo))
+#define PBLENDW(x, y, imm) \
+	__asm__("pblendw $" #imm ", %1, %0" : "+x" (x) : "x" (y))
+#define SHA256MSG1(x, y) \
+	__asm__("sha256msg1 %1, %0" : "+x" (x) : "x" (y))
+#define SHA256MSG2(x, y) \
+	__asm__("sha256msg2 %1, %0" : "+x" (x) : "x" (y))
+/* Two rounds, the message words plus constants are implicitly in xmm0. */
+#define SHA256RNDS2(cdgh, abef, wk) do {				\
+	register v4u32 __wk __asm__("xmm0") = (wk);			\
+	__asm__("sha256rnds2 %%xmm0, %1, %0"				\
+		: "+x" (cdgh) : "x" (abef), "x" (__wk));		\
+} while (0)
+
+/*
+ * Four rounds on the message words in cur, with the schedule for later
+ * rounds interleaved: next gets its final words once rounds 12-15 are under
+ * way, prev starts its sha256msg1 step once it is no longer needed.
+ */
+#define QUAD(g, cur, prev, next) do {					\
+	if ((g) < 4) {							\
+		cur = *(const v4u32_unaligned *)(data + (g) * 16);	\
+		PSHUFB(cur, mask);					\
+	}								\
+	wk = cur + *(const v4u32 *)&sha256_k[(g) * 4];			\
+	SHA256RNDS2(cdgh, abef, wk);					\
+	if ((g) >= 3 && (g) <= 14) {					\
+		tmp = cur;						\
+		PALIGNR(tmp, prev, 4);					\
+		next += tmp;						\
+		SHA256MSG2(next, cur);					\
+	}								\
+	PSHUFD(wk, wk, 0x0e);						\
+	SHA256RNDS2(abef, cdgh, wk);					\
+	if ((g) >= 1 && (g) <= 12)					\
+		SHA256MSG1(prev, cur);					\
+} while (0)
+
+__attribute__((target("sha,sse4.1"), force_align_arg_pointer))
+void sha256_accel_blocks(uint32_t state[8], const uint8_t *data,
+			 size_t blocks)
+{
+	const v4u32 mask = *(const v4u32 *)bswap32_mask;
+	v4u32 abef, cdgh, abef_save, cdgh_save, tmp, wk;
+	v4u32 m0, m1, m2, m3;
+
+	/* a..d and e..h into the ABEF/CDGH layout the instructions use. */
+	tmp = *(const v4u32_unaligned *)&state[0];
+	cdgh = *(const v4u32_unaligned *)&state[4];
+	PSHUFD(tmp, tmp, 0xb1);
+	PSHUFD(cdgh, cdgh, 0x1b);
+	abef = tmp;
+	PALIGNR(abef, cdgh, 8);
+	PBLENDW(cdgh, tmp, 0xf0);
+
+	for (; blocks; blocks--, data += SHA256_ACCEL_BLOCK_SIZE) {
+		abef_save = abef;
+		cdgh_save = cdgh;
+
+		QUAD(0, m0, m3, m1);
+		QUAD(1, m1, m0, m2);
+		QUAD(2, m2, m1, m3);
+		QUAD(3, m3, m2, m0);
+		QUAD(4, m0, m3, m1);
+		QUAD(5, m1, m0, m2);
+		QUAD(6, m2, m1, m3);
+		QUAD(7, m3, m2, m0);
+		QUAD(8, m0, m3, m1);
+		QUAD(9, m1, m0, m2);
+		QUAD(10, m2, m1, m3);
+		QUAD(11, m3, m2, m0);
+		QUAD(12, m0, m3, m1);
+		QUAD(13, m1, m0, m2);
+		QUAD(14, m2, m1, m3);
+		QUAD(15, m3, m2, m0);
+
+		abef += abef_save;
+		cdgh += cdgh_save;
+	}
+
+	PSHUFD(tmp, abef, 0x1b);
+	PSHUFD(cdgh, cdgh, 0xb1);
+	abef = tmp;
+	PBLENDW(abef, cdgh, 0xf0);
+	PALIGNR(cdgh, tmp, 8);
+	*(v4u32_unaligned *)&state[0] = abef;
+	*(v4u32_unaligned *)&state[4] = cdgh;
+}
+
+bool sha256_accel_supported(void)
+{
+	if (cpuid_get_max_func() < 7)
+		return false;
+	if ((cpuid_ecx(1) & (CPUID_FEATURES_ECX_SSE41 |
+			     CPUID_FEATURES_ECX_SSSE3)) !=
+	    (CPUID_FEATURES_ECX_SSE41 | CPUID_FEATURES_ECX_SSSE3))
+		return false;
+	return !!(cpuid_ext(7, 0).ebx & CPUID_EXT_FEATURES_EBX_SHA);
+}
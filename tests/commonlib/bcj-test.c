@@ -0,0 +1,89 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <commonlib/bsd/compression.h>
+#include <commonlib/bsd/helpers.h>
+#include <string.h>
+#include <tests/test.h>
+
+static void test_bcj_x86(void **state)
+{
+	/* Two calls to the same target from different sites, and one call whose
+	   displacement is too large to be a near branch. */
+	const uint8_t code[] = {
+		0x90, 0xe8, 0xfb, 0x0f, 0x00, 0x00,	/* 1: call 0x1001 */
+		0x90, 0x90, 0xe8, 0xf4, 0x0f, 0x00, 0x00, /* 8: call 0x1001 */
+		0xe8, 0x78, 0x56, 0x34, 0x12,		/* 13: call far away */
+		0x90, 0x90, 0xe8, 0x00,			/* truncated */
+	};
+	uint8_t buf[sizeof(code)];
+
+	memcpy(buf, code, sizeof(buf));
+	bcj_x86(buf, sizeof(buf), 1);
+
+	/* Both near calls now carry the same absolute target. */
+	assert_memory_equal(&buf[2], &buf[9], 4);
+	/* Non-branches, the far call and the truncated tail stay untouched. */
+	assert_memory_equal(&buf[13], &code[13], sizeof(code) - 13);
+
+	bcj_x86(buf, sizeof(buf), 0);
+	assert_memory_equal(buf, code, sizeof(buf));
+}
+
+static void test_bcj_arm64(void **state)
+{
+	const uint32_t code[] = {
+		0x94000010,	/* 0: bl +0x40 */
+		0xd503201f,	/* nop */
+		0x9400000e,	/* 8: bl +0x38 */
+		0x90000001,	/* adrp x1, +0 */
+		0xb0000001,	/* adrp x1, +0x1000 */
+	};
+	uint32_t buf[ARRAY_SIZE(code)];
+
+	memcpy(buf, code, sizeof(buf));
+	bcj_arm64(buf, sizeof(buf), 1);
+
+	/* Both BLs branch to 0x40. */
+	assert_int_equal(buf[0], buf[2]);
+	assert_int_equal(buf[1], code[1]);
+
+	bcj_arm64(buf, sizeof(buf), 0);
+	assert_memory_equal(buf, code, sizeof(buf));
+}
+
+static void test_bcj_random(void **state)
+{
+	static uint8_t data[64 * KiB], buf[64 * KiB];
+	uint32_t seed = 0x12345678;
+	size_t i;
+
+	for (i = 0; i < sizeof(data); i++) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = seed >> 16;
+		/* Sprinkle in plenty of branch opcodes. */
+		if (i % 7 == 0)
+			data[i] = 0xe8;
+	}
+
+	memcpy(buf, data, sizeof(buf));
+	bcj_x86(buf, sizeof(buf), 1);
+	bcj_x86(buf, sizeof(buf), 0);
+	assert_memory_equal(buf, data, sizeof(buf));
+
+	/* Unaligned tail is left alone. */
+	memcpy(buf, data, sizeof(buf));
+	bcj_arm64(buf, sizeof(buf) - 3, 1);
+	bcj_arm64(buf, sizeof(buf) - 3, 0);
+	assert_memory_equal(buf, data, sizeof(buf));
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_bcj_x86),
+		cmocka_unit_test(test_bcj_arm64),
+		cmocka_unit_test(test_bcj_random),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
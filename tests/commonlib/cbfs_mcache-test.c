@@ -0,0 +1,208 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include "../commonlib/bsd/cbfs_mcache.c"
+
+#include <commonlib/bsd/helpers.h>
+#include <stdio.h>
+#include <string.h>
+#include <tests/test.h>
+
+#define IMAGE_SIZE (16 * KiB)
+#define MCACHE_SIZE (4 * KiB)
+#define NAME_SIZE 32
+#define ENTRY_SIZE (sizeof(struct cbfs_file) + NAME_SIZE)
+#define DATA_SIZE 16
+
+static u8 image[IMAGE_SIZE];
+static size_t image_used;
+
+static u32 mcache_buf[MCACHE_SIZE / sizeof(u32)];
+static u32 copy_buf[MCACHE_SIZE / sizeof(u32)];
+
+static void add_file(const char *name)
+{
+	struct cbfs_file *h = (void *)&image[image_used];
+
+	memcpy(h->magic, CBFS_FILE_MAGIC, sizeof(h->magic));
+	h->len = htobe32(DATA_SIZE);
+	h->type = htobe32(CBFS_TYPE_RAW);
+	h->attributes_offset = 0;
+	h->offset = htobe32(ENTRY_SIZE);
+	assert_true(strlen(name) < NAME_SIZE);
+	strcpy((char *)&image[image_used + sizeof(*h)], name);
+
+	image_used = ALIGN_UP(image_used + ENTRY_SIZE + DATA_SIZE, CBFS_ALIGNMENT);
+	assert_true(image_used <= IMAGE_SIZE);
+}
+
+/* Create an image with |count| files named "file<n>", optionally preceded by |prefix|. */
+static void create_image(const char *prefix, int count)
+{
+	char name[NAME_SIZE];
+	int i;
+
+	memset(image, 0xff, sizeof(image));
+	image_used = 0;
+	for (i = 0; i < count; i++) {
+		snprintf(name, sizeof(name), "%sfile%d", prefix, i);
+		add_file(name);
+	}
+}
+
+static cb_err_t build(void *mcache, size_t size)
+{
+	struct mem_region_device mdev = MEM_REGION_DEV_RO_INIT(image, image_used);
+
+	return cbfs_mcache_build(&mdev.rdev, mcache, size, NULL);
+}
+
+/* Return the number of index slots, or -1 if there's no valid index trailer. */
+static int index_slots(const void *mcache, size_t size)
+{
+	const struct mcache_index *index = mcache_find_index(mcache, size);
+
+	return index ? index->num_slots : -1;
+}
+
+/* Check that |name| is found as the |nth| file of the image. */
+static void check_found(const void *mcache, size_t size, const char *name, int nth)
+{
+	union cbfs_mdata mdata;
+	size_t data_offset;
+
+	assert_int_equal(cbfs_mcache_lookup(mcache, size, name, &mdata, &data_offset),
+			 CB_SUCCESS);
+	assert_string_equal(mdata.h.filename, name);
+	assert_int_equal(data_offset,
+			 nth * ALIGN_UP(ENTRY_SIZE + DATA_SIZE, CBFS_ALIGNMENT) + ENTRY_SIZE);
+}
+
+static void check_not_found(const void *mcache, size_t size, const char *name, cb_err_t err)
+{
+	union cbfs_mdata mdata;
+	size_t data_offset;
+
+	assert_int_equal(cbfs_mcache_lookup(mcache, size, name, &mdata, &data_offset), err);
+}
+
+static void check_all_files(const void *mcache, size_t size, const char *prefix, int count)
+{
+	char name[NAME_SIZE];
+	int i;
+
+	for (i = 0; i < count; i++) {
+		snprintf(name, sizeof(name), "%sfile%d", prefix, i);
+		check_found(mcache, size, name, i);
+	}
+}
+
+static void test_mcache_index_lookup(void **state)
+{
+	create_image("", 40);
+	assert_int_equal(build(mcache_buf, sizeof(mcache_buf)), CB_SUCCESS);
+
+	/* Load factor at or below 50%. */
+	assert_int_equal(index_slots(mcache_buf, sizeof(mcache_buf)), 128);
+
+	check_all_files(mcache_buf, sizeof(mcache_buf), "", 40);
+	check_not_found(mcache_buf, sizeof(mcache_buf), "file40", CB_CBFS_NOT_FOUND);
+	check_not_found(mcache_buf, sizeof(mcache_buf), "file", CB_CBFS_NOT_FOUND);
+	check_not_found(mcache_buf, sizeof(mcache_buf), "file10x", CB_CBFS_NOT_FOUND);
+	check_not_found(mcache_buf, sizeof(mcache_buf), "", CB_CBFS_NOT_FOUND);
+}
+
+static void test_mcache_index_duplicate_names(void **state)
+{
+	create_image("", 4);
+	add_file("file2");
+	assert_int_equal(build(mcache_buf, sizeof(mcache_buf)), CB_SUCCESS);
+	assert_true(index_slots(mcache_buf, sizeof(mcache_buf)) > 0);
+
+	/* Like a walk over the CBFS, the first of several files with the same name wins. */
+	check_found(mcache_buf, sizeof(mcache_buf), "file2", 2);
+}
+
+static void test_mcache_no_room_for_index(void **state)
+{
+	/* Room for the entries, terminator and trailer, but not for the 16 slots. */
+	const size_t size = 8 * ENTRY_SIZE + sizeof(u32) + sizeof(struct mcache_index) + 64;
+
+	create_image("", 8);
+	assert_int_equal(build(mcache_buf, size), CB_SUCCESS);
+	assert_int_equal(index_slots(mcache_buf, size), 0);
+
+	/* Lookups walk the entries instead. */
+	check_all_files(mcache_buf, size, "", 8);
+	check_not_found(mcache_buf, size, "file8", CB_CBFS_NOT_FOUND);
+}
+
+static void test_mcache_full(void **state)
+{
+	const size_t size = 4 * ENTRY_SIZE + sizeof(u32) + sizeof(struct mcache_index);
+
+	create_image("", 8);
+	assert_int_equal(build(mcache_buf, size), CB_CBFS_CACHE_FULL);
+	assert_int_equal(index_slots(mcache_buf, size), 0);
+
+	/* Files that made it in are found, for all others the caller has to ask the CBFS. */
+	check_all_files(mcache_buf, size, "", 4);
+	check_not_found(mcache_buf, size, "file4", CB_CBFS_CACHE_FULL);
+}
+
+static void test_mcache_rebuild(void **state)
+{
+	const size_t small_size = 8 * ENTRY_SIZE + sizeof(u32) + sizeof(struct mcache_index);
+
+	create_image("", 40);
+	assert_int_equal(build(mcache_buf, sizeof(mcache_buf)), CB_SUCCESS);
+	assert_int_equal(index_slots(mcache_buf, sizeof(mcache_buf)), 128);
+
+	/* Rebuilding in the same area replaces the index of the old contents. */
+	create_image("new", 3);
+	assert_int_equal(build(mcache_buf, sizeof(mcache_buf)), CB_SUCCESS);
+	assert_int_equal(index_slots(mcache_buf, sizeof(mcache_buf)), 8);
+	check_all_files(mcache_buf, sizeof(mcache_buf), "new", 3);
+	check_not_found(mcache_buf, sizeof(mcache_buf), "file0", CB_CBFS_NOT_FOUND);
+	check_not_found(mcache_buf, sizeof(mcache_buf), "newfile3", CB_CBFS_NOT_FOUND);
+
+	/* Same if the index doesn't fit anymore. The old slots must not be used. */
+	create_image("", 8);
+	assert_int_equal(build(mcache_buf, small_size), CB_SUCCESS);
+	assert_int_equal(index_slots(mcache_buf, small_size), 0);
+	check_all_files(mcache_buf, small_size, "", 8);
+	check_not_found(mcache_buf, small_size, "newfile0", CB_CBFS_NOT_FOUND);
+}
+
+static void test_mcache_copy(void **state)
+{
+	size_t size;
+
+	create_image("", 40);
+	assert_int_equal(build(mcache_buf, sizeof(mcache_buf)), CB_SUCCESS);
+
+	/* A copy (e.g. the migration to CBMEM) is packed and keeps the index. */
+	size = cbfs_mcache_real_size(mcache_buf, sizeof(mcache_buf));
+	assert_int_equal(size, 40 * ENTRY_SIZE + sizeof(u32) +
+			 128 * sizeof(struct mcache_index_slot) + sizeof(struct mcache_index));
+	memset(copy_buf, 0, sizeof(copy_buf));
+	cbfs_mcache_copy(copy_buf, mcache_buf, sizeof(mcache_buf));
+	memset(mcache_buf, 0, sizeof(mcache_buf));
+
+	assert_int_equal(index_slots(copy_buf, size), 128);
+	check_all_files(copy_buf, size, "", 40);
+	check_not_found(copy_buf, size, "file40", CB_CBFS_NOT_FOUND);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_mcache_index_lookup),
+		cmocka_unit_test(test_mcache_index_duplicate_names),
+		cmocka_unit_test(test_mcache_no_room_for_index),
+		cmocka_unit_test(test_mcache_full),
+		cmocka_unit_test(test_mcache_rebuild),
+		cmocka_unit_test(test_mcache_copy),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
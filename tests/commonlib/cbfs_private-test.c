@@ -0,0 +1,164 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+/* Build the read-ahead window, the test config has a memory mapped boot device. */
+#undef CONFIG_CBFS_READAHEAD_SIZE
+#define CONFIG_CBFS_READAHEAD_SIZE 0x1000
+
+#include "../commonlib/bsd/cbfs_private.c"
+
+#include <commonlib/bsd/helpers.h>
+#include <stdio.h>
+#include <string.h>
+#include <tests/test.h>
+
+#define IMAGE_SIZE (128 * KiB)
+#define NAME_SIZE 32
+#define MAX_FILES 64
+#define MAX_READS 64
+
+static u8 image[IMAGE_SIZE];
+static size_t image_used;
+
+static size_t file_offsets[MAX_FILES];
+static size_t num_files;
+
+/* Device reads, in the order they were issued. */
+static struct region reads[MAX_READS];
+static size_t num_reads;
+
+static ssize_t image_readat(const struct region_device *rdev, void *buffer, size_t offset,
+			    size_t size)
+{
+	assert_true(num_reads < MAX_READS);
+	reads[num_reads].offset = offset;
+	reads[num_reads].size = size;
+	num_reads++;
+
+	memcpy(buffer, &image[offset], size);
+	return size;
+}
+
+static const struct region_device_ops image_ops = {
+	.readat = image_readat,
+};
+
+static void add_file(const char *name, size_t data_size)
+{
+	struct cbfs_file *h = (void *)&image[image_used];
+
+	assert_true(num_files < MAX_FILES);
+	file_offsets[num_files++] = image_used;
+
+	memcpy(h->magic, CBFS_FILE_MAGIC, sizeof(h->magic));
+	h->len = htobe32(data_size);
+	h->type = htobe32(CBFS_TYPE_RAW);
+	h->attributes_offset = 0;
+	h->offset = htobe32(sizeof(*h) + NAME_SIZE);
+	assert_true(strlen(name) < NAME_SIZE);
+	strcpy((char *)&image[image_used + sizeof(*h)], name);
+
+	image_used = ALIGN_UP(image_used + sizeof(*h) + NAME_SIZE + data_size, CBFS_ALIGNMENT);
+	assert_true(image_used <= IMAGE_SIZE);
+}
+
+static cb_err_t record_file(cbfs_dev_t dev, size_t offset, const union cbfs_mdata *mdata,
+			    size_t already_read, void *arg)
+{
+	size_t *found = arg;
+
+	assert_true(*found < num_files);
+	assert_int_equal(offset, file_offsets[*found]);
+	assert_int_equal(already_read, sizeof(mdata->h) + NAME_SIZE);
+	(*found)++;
+
+	return CB_CBFS_NOT_FOUND;
+}
+
+/* Walk the image up to |size| and check that every file was found. */
+static void walk_image(size_t size)
+{
+	struct region_device rdev = REGION_DEV_INIT(&image_ops, 0, size);
+	size_t found = 0;
+
+	num_reads = 0;
+	assert_int_equal(cbfs_walk(&rdev, record_file, &found, NULL, 0), CB_CBFS_NOT_FOUND);
+	assert_int_equal(found, num_files);
+}
+
+static int setup_image(void **state)
+{
+	memset(image, 0xff, sizeof(image));
+	image_used = 0;
+	num_files = 0;
+	return 0;
+}
+
+static void test_cbfs_walk_small_files(void **state)
+{
+	char name[NAME_SIZE];
+	size_t i, expected = sizeof(union cbfs_mdata);
+
+	for (i = 0; i < 40; i++) {
+		snprintf(name, sizeof(name), "file%zu", i);
+		add_file(name, 16);
+	}
+
+	walk_image(image_used);
+
+	/* The refill starts with one file's metadata and doubles while files are small. */
+	for (i = 0; i < num_reads; i++) {
+		if (i)
+			assert_int_equal(reads[i].offset,
+					 reads[i - 1].offset + reads[i - 1].size);
+		assert_int_equal(reads[i].size, MIN(expected, image_used - reads[i].offset));
+		expected = MIN(2 * expected, CONFIG_CBFS_READAHEAD_SIZE);
+	}
+	assert_int_equal(reads[num_reads - 1].offset + reads[num_reads - 1].size, image_used);
+
+	/* Far fewer than one header and one name read per file. */
+	assert_true(num_reads < num_files / 4);
+}
+
+static void test_cbfs_walk_large_file(void **state)
+{
+	size_t i;
+
+	add_file("small1", 16);
+	add_file("small2", 16);
+	add_file("large", 64 * KiB);
+	add_file("small3", 16);
+	add_file("small4", 16);
+	add_file("small5", 16);
+
+	walk_image(image_used);
+
+	/* Metadata of a file behind large data isn't fetched with a full window. */
+	for (i = 0; i < num_reads; i++)
+		if (reads[i].offset == file_offsets[3])
+			break;
+	assert_true(i < num_reads);
+	assert_int_equal(reads[i].size, sizeof(union cbfs_mdata));
+}
+
+static void test_cbfs_walk_device_end(void **state)
+{
+	add_file("first", 16);
+	add_file("last", 16);
+
+	/* Refills never run past the end of the device. */
+	walk_image(image_used);
+	assert_int_equal(num_reads, 1);
+	assert_int_equal(reads[0].offset, 0);
+	assert_int_equal(reads[0].size, image_used);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup(test_cbfs_walk_small_files, setup_image),
+		cmocka_unit_test_setup(test_cbfs_walk_large_file, setup_image),
+		cmocka_unit_test_setup(test_cbfs_walk_device_end, setup_image),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
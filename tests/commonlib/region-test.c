@@ -390,6 +390,127 @@ static void test_mem_rdev(void **state)
 	assert_memory_equal(backing, scratch, size);
 }
 
+/* Asynchronous device that completes a read after a fixed number of polls. */
+static u8 async_backing[256];
+static int async_polls_left;
+
+static ssize_t async_readat(const struct region_device *rdev, void *buffer, size_t offset,
+			    size_t size)
+{
+	fail_msg("Synchronous read on device with asynchronous read support");
+	return -1;
+}
+
+static int async_readat_start(const struct region_device *rdev, struct rdev_async_read *req)
+{
+	async_polls_left = 3;
+	return 0;
+}
+
+static bool async_readat_poll(const struct region_device *rdev, struct rdev_async_read *req)
+{
+	if (--async_polls_left > 0)
+		return false;
+
+	memcpy(req->buffer, &async_backing[req->offset], req->size);
+	req->result = req->size;
+	return true;
+}
+
+static const struct region_device_ops async_rdev_ops = {
+	.readat = async_readat,
+	.readat_async_start = async_readat_start,
+	.readat_async_poll = async_readat_poll,
+};
+
+static void test_rdev_async_read(void **state)
+{
+	const size_t size = 256;
+	const size_t offs = 0x30;
+	const size_t chunk = 0x40;
+	u8 backing[size];
+	u8 scratch[size];
+	int i;
+	struct mem_region_device mem = MEM_REGION_DEV_RO_INIT(backing, size);
+	struct region_device async_rdev = REGION_DEV_INIT(&async_rdev_ops, 0, size);
+	struct region_device child;
+	struct rdev_async_read req;
+
+	for (i = 0; i < size; i++) {
+		backing[i] = i;
+		async_backing[i] = ~i;
+	}
+
+	/* Devices without asynchronous support complete the read right away. */
+	assert_int_equal(rdev_chain(&child, &mem.rdev, offs, size - offs), 0);
+	memset(scratch, 0, size);
+	assert_int_equal(rdev_readat_async_start(&child, &req, scratch, offs, chunk), 0);
+	assert_true(rdev_readat_async_poll(&req));
+	assert_int_equal(rdev_readat_async_wait(&req), chunk);
+	assert_memory_equal(scratch, &backing[2 * offs], chunk);
+
+	/* Asynchronous reads are translated to the root device and only complete later. */
+	assert_int_equal(rdev_chain(&child, &async_rdev, offs, size - offs), 0);
+	memset(scratch, 0, size);
+	assert_int_equal(rdev_readat_async_start(&child, &req, scratch, offs, chunk), 0);
+	assert_ptr_equal(req.rdev, &async_rdev);
+	assert_int_equal(req.offset, 2 * offs);
+	assert_false(rdev_readat_async_poll(&req));
+	assert_int_equal(rdev_readat_async_wait(&req), chunk);
+	assert_true(rdev_readat_async_poll(&req));
+	assert_memory_equal(scratch, &async_backing[2 * offs], chunk);
+
+	/* Out of bounds requests are rejected up front. */
+	assert_int_equal(rdev_readat_async_start(&child, &req, scratch, size - offs, 1), -1);
+}
+
+static void test_xlate_rdev_async_read(void **state)
+{
+	const size_t size = 256;
+	const size_t win = 0x40;
+	u8 backing[size];
+	u8 scratch[size];
+	int i;
+	struct mem_region_device mem = MEM_REGION_DEV_RO_INIT(backing, size);
+	struct region_device async_rdev = REGION_DEV_INIT(&async_rdev_ops, 0, size);
+	struct xlate_window windows[2];
+	struct xlate_region_device xldev;
+	struct rdev_async_read req;
+
+	for (i = 0; i < size; i++) {
+		backing[i] = i;
+		async_backing[i] = ~i;
+	}
+
+	/* [0, win) comes from the start of mem, [2 * win, 3 * win) from async_rdev. */
+	xlate_window_init(&windows[0], &mem.rdev, 0, win);
+	xlate_window_init(&windows[1], &async_rdev, 2 * win, win);
+	xlate_region_device_ro_init(&xldev, ARRAY_SIZE(windows), windows, size);
+
+	/* Reads from a synchronous access device complete right away. */
+	memset(scratch, 0, size);
+	assert_int_equal(rdev_readat_async_start(&xldev.rdev, &req, scratch, 0x10, 0x20), 0);
+	assert_ptr_equal(req.rdev, &mem.rdev);
+	assert_true(rdev_readat_async_poll(&req));
+	assert_int_equal(rdev_readat_async_wait(&req), 0x20);
+	assert_memory_equal(scratch, &backing[0x10], 0x20);
+
+	/* Reads from an asynchronous access device are handed over to it. */
+	memset(scratch, 0, size);
+	assert_int_equal(rdev_readat_async_start(&xldev.rdev, &req, scratch, 2 * win + 0x8,
+						 0x10), 0);
+	assert_ptr_equal(req.rdev, &async_rdev);
+	assert_int_equal(req.offset, 0x8);
+	assert_false(rdev_readat_async_poll(&req));
+	assert_int_equal(rdev_readat_async_wait(&req), 0x10);
+	assert_memory_equal(scratch, &async_backing[0x8], 0x10);
+
+	/* Requests outside of a window or across windows are rejected. */
+	assert_int_equal(rdev_readat_async_start(&xldev.rdev, &req, scratch, win, 0x10), -1);
+	assert_int_equal(rdev_readat_async_start(&xldev.rdev, &req, scratch, win - 8, 0x10),
+			 -1);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -401,6 +522,8 @@ int main(void)
 		cmocka_unit_test(test_rdev_chain),
 		cmocka_unit_test(test_rdev_double_chain),
 		cmocka_unit_test(test_mem_rdev),
+		cmocka_unit_test(test_rdev_async_read),
+		cmocka_unit_test(test_xlate_rdev_async_read),
 	};
 
 	return cmocka_run_group_tests(tests, NULL, NULL);
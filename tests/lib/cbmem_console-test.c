@@ -1,5 +1,11 @@
 /* SPDX-License-Identifier: GPL-2.0-only */
 
+/* Build the binary record encoder as well. */
+#undef CONFIG_CONSOLE_CBMEM_DEFERRED_FORMAT
+#define CONFIG_CONSOLE_CBMEM_DEFERRED_FORMAT 1
+#undef CONFIG_CONSOLE_CBMEM_DEFERRED_BUFFER_SIZE
+#define CONFIG_CONSOLE_CBMEM_DEFERRED_BUFFER_SIZE 0x1000
+
 #include "../lib/cbmem_console.c"
 
 #include <inttypes.h>
@@ -17,6 +23,11 @@ __weak extern u8 _epreram_cbmem_console[];
 TEST_REGION(preram_cbmem_console, PRERAM_CBMEM_CONSOLE_SIZE);
 #endif
 
+/* Format strings of deferred messages have to be part of the program. */
+__weak extern u8 _program[];
+__weak extern u8 _eprogram[];
+TEST_REGION(program, 256);
+
 /* Disable init hooks. This test does not need them. */
 void cbmem_run_init_hooks(int is_recovery)
 {
@@ -116,6 +127,122 @@ void test_cbmemc_tx_byte_overflow(void **state)
 	free(check_buffer);
 }
 
+static int log_deferred(const char *fmt, ...)
+{
+	va_list args;
+	int i;
+
+	va_start(args, fmt);
+	i = cbmemc_log_deferred(fmt, args);
+	va_end(args);
+
+	return i;
+}
+
+static u8 deferred_storage[sizeof(struct cbmemc_deferred_area) + 96];
+
+static int setup_cbmemc_deferred(void **state)
+{
+	cbmemc_init();
+	memset(deferred_storage, 0, sizeof(deferred_storage));
+	init_deferred_ptr(deferred_storage, sizeof(deferred_storage));
+	return 0;
+}
+
+static int teardown_cbmemc_deferred(void **state)
+{
+	current_deferred = NULL;
+	return teardown_cbmemc(state);
+}
+
+void test_cbmemc_log_deferred(void **state)
+{
+	char *fmt = (char *)_program + 16;
+	const struct cbmemc_deferred_record *rec = (void *)current_deferred->body;
+	const u8 expected[] = {
+		5,			/* -3 */
+		'a', 'b', '\0',
+		0xb4, 0x24,		/* 0x1234 */
+		'c',
+		0x10,			/* '*' width of 8 */
+		0,
+	};
+
+	cbmemc_tx_byte('>');
+	strcpy(fmt, "%d %s %x %c%*u\n");
+	assert_int_equal(sizeof(*rec) + sizeof(expected),
+			 log_deferred(fmt, -3, "ab", 0x1234, 'c', 8, 0));
+
+	/* The record goes to its own area, the text console is untouched. */
+	assert_int_equal(1, current_console->cursor & CURSOR_MASK);
+	assert_int_equal(sizeof(*rec) + sizeof(expected), current_deferred->used);
+	assert_int_equal(0, rec->wraps);
+	assert_int_equal(1, rec->cursor);
+	assert_int_equal(16, rec->fmt_offset);
+	assert_int_equal(sizeof(expected), rec->args_size);
+	assert_int_equal(deferred_stage, rec->stage);
+	assert_memory_equal(expected, rec->args, sizeof(expected));
+}
+
+void test_cbmemc_log_deferred_strings(void **state)
+{
+	char *fmt = (char *)_program + 16;
+	const struct cbmemc_deferred_record *rec = (void *)current_deferred->body;
+	const char *s = "0123456789abcdef0123456789abcdef";
+	const u8 expected[] = {
+		'0', '1', '\0',	/* "%.2s" */
+		3,			/* '*' precision of -2 */
+		'\0',			/* which is treated as 0 */
+	};
+
+	strcpy(fmt, "%.2s%.*s\n");
+	assert_int_equal(sizeof(*rec) + sizeof(expected), log_deferred(fmt, s, -2, s));
+	assert_memory_equal(expected, rec->args, sizeof(expected));
+
+	/* Strings are stored in full, no matter how long. */
+	strcpy(fmt, "%s\n");
+	assert_int_equal(sizeof(*rec) + strlen(s) + 1, log_deferred(fmt, s));
+	rec = (void *)&current_deferred->body[sizeof(*rec) + sizeof(expected)];
+	assert_string_equal(s, (const char *)rec->args);
+}
+
+void test_cbmemc_log_deferred_fallback(void **state)
+{
+	char *fmt = (char *)_program + 16;
+	int n;
+
+	/* Strings outside the program can't be looked up and must be formatted. */
+	assert_int_equal(-1, log_deferred("%d\n", 1));
+
+	/* %n needs the length of the formatted text. */
+	strcpy(fmt, "%d%n\n");
+	assert_int_equal(-1, log_deferred(fmt, 1, &n));
+
+	/* Records never wrap, they have to fit in the remaining space. */
+	strcpy(fmt, "%s\n");
+	assert_int_equal(-1, log_deferred(fmt, "0123456789abcdef0123456789abcdef"
+					  "0123456789abcdef0123456789abcdef"
+					  "0123456789abcdef0123456789abcdef"));
+
+	assert_int_equal(0, current_deferred->used);
+	assert_int_equal(0, current_console->cursor & CURSOR_MASK);
+}
+
+void test_cbmemc_log_deferred_wraps(void **state)
+{
+	char *fmt = (char *)_program + 16;
+	const struct cbmemc_deferred_record *rec = (void *)current_deferred->body;
+	int i;
+
+	for (i = 0; i < current_console->size + 3; i++)
+		cbmemc_tx_byte('x');
+
+	strcpy(fmt, "\n");
+	assert_int_equal(sizeof(*rec), log_deferred(fmt));
+	assert_int_equal(1, rec->wraps);
+	assert_int_equal(3, rec->cursor);
+}
+
 int main(void)
 {
 #if ENV_ROMSTAGE_OR_BEFORE
@@ -130,6 +257,14 @@ int main(void)
 						setup_cbmemc, teardown_cbmemc),
 		cmocka_unit_test_setup_teardown(test_cbmemc_tx_byte_overflow,
 						setup_cbmemc, teardown_cbmemc),
+		cmocka_unit_test_setup_teardown(test_cbmemc_log_deferred,
+				setup_cbmemc_deferred, teardown_cbmemc_deferred),
+		cmocka_unit_test_setup_teardown(test_cbmemc_log_deferred_strings,
+				setup_cbmemc_deferred, teardown_cbmemc_deferred),
+		cmocka_unit_test_setup_teardown(test_cbmemc_log_deferred_fallback,
+				setup_cbmemc_deferred, teardown_cbmemc_deferred),
+		cmocka_unit_test_setup_teardown(test_cbmemc_log_deferred_wraps,
+				setup_cbmemc_deferred, teardown_cbmemc_deferred),
 	};
 
 	return cmocka_run_group_tests_name(test_name, tests, NULL, NULL);
@@ -670,6 +670,58 @@ static void test_imd_entry_remove(void **state)
 	free(base);
 }
 
+/* Longest run of occupied index slots, which bounds the probes of a lookup. */
+static size_t imdr_index_longest_run(const struct imdr *imdr)
+{
+	size_t i, run = 0, longest = 0;
+
+	/* Go around twice to catch runs wrapping past the last slot. */
+	for (i = 0; i < 2 * IMD_INDEX_SLOTS; i++) {
+		run = imdr->index[i % IMD_INDEX_SLOTS] ? run + 1 : 0;
+		longest = MAX(longest, run);
+	}
+
+	return longest;
+}
+
+static void test_imd_entry_find_index(void **state)
+{
+	void *base;
+	struct imd imd = {0};
+	uint32_t id;
+	size_t n, i, indexed = 0;
+
+	base = malloc(3 * LIMIT_ALIGN);
+	if (base == NULL)
+		fail_msg("Cannot allocate enough memory - fail test");
+
+	imd_handle_init(&imd, (void *)(3 * LIMIT_ALIGN + (uintptr_t)base));
+	assert_int_equal(0, imd_create_empty(&imd, LIMIT_ALIGN, LG_ENTRY_ALIGN));
+
+	for (n = 0; n < 100; n++)
+		assert_non_null(imd_entry_add(&imd, LG_ENTRY_ID + n, LG_ENTRY_SIZE));
+
+	for (id = LG_ENTRY_ID; id < LG_ENTRY_ID + n; id++)
+		assert_int_equal(id, imd_entry_id(imd_entry_find(&imd, id)));
+	assert_null(imd_entry_find(&imd, INVALID_REGION_ID));
+
+	/* Every entry is in the index, so no lookup falls back to a scan. */
+	assert_false(imd.lg.index_overflow);
+	for (i = 0; i < IMD_INDEX_SLOTS; i++)
+		indexed += !!imd.lg.index[i];
+	assert_int_equal(n, indexed);
+
+	/* A scan visits up to 100 entries, the index only a few slots. */
+	assert_in_range(imdr_index_longest_run(&imd.lg), 1, 8);
+
+	/* Removing an entry rebuilds the index without it. */
+	assert_int_equal(0, imd_entry_remove(&imd, imd_entry_find(&imd, LG_ENTRY_ID + n - 1)));
+	assert_null(imd_entry_find(&imd, LG_ENTRY_ID + n - 1));
+	assert_non_null(imd_entry_find(&imd, LG_ENTRY_ID));
+
+	free(base);
+}
+
 static void test_imd_cursor_init(void **state)
 {
 	struct imd imd = {0};
@@ -754,6 +806,7 @@ int main(void)
 		cmocka_unit_test(test_imd_entry_at),
 		cmocka_unit_test(test_imd_entry_id),
 		cmocka_unit_test(test_imd_entry_remove),
+		cmocka_unit_test(test_imd_entry_find_index),
 		cmocka_unit_test(test_imd_cursor_init),
 		cmocka_unit_test(test_imd_cursor_next),
 	};
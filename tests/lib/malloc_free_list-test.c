@@ -0,0 +1,241 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+/* Include malloc() and memalign() source code and alter its name to indicate the functions
+   source origin. */
+#define malloc cb_malloc
+#define free cb_free
+#define memalign cb_memalign
+#undef __noreturn
+#define __noreturn
+/* bootstate.h declares coreboot's void main(void), which clashes with the test's main() */
+#define _MAIN_DECL_H_
+
+#include "../lib/malloc_free_list.c"
+
+#undef malloc
+#undef free
+#undef memalign
+#undef __noreturn
+#define __noreturn __attribute__((noreturn))
+
+#include <setjmp.h>
+#include <stdlib.h>
+#include <tests/test.h>
+#include <commonlib/helpers.h>
+#include <types.h>
+#include <symbols.h>
+
+/* 1 MiB */
+#define TEST_HEAP_SZ 0x100000
+
+/* Heap region setup */
+__weak extern uint8_t _test_heap[];
+__weak extern uint8_t _etest_heap[];
+TEST_REGION(test_heap, TEST_HEAP_SZ);
+TEST_SYMBOL(_heap, _test_heap);
+TEST_SYMBOL(_eheap, _etest_heap);
+
+static jmp_buf die_jmp;
+
+void die(const char *msg, ...)
+{
+	function_called();
+	longjmp(die_jmp, 1);
+}
+
+static struct heap_stats cbmem_heap_stats;
+static bool cbmem_heap_stats_added;
+
+void *cbmem_find(u32 id)
+{
+	assert_int_equal(CBMEM_ID_HEAP_STATS, id);
+	return cbmem_heap_stats_added ? &cbmem_heap_stats : NULL;
+}
+
+void *cbmem_add(u32 id, u64 size)
+{
+	assert_int_equal(CBMEM_ID_HEAP_STATS, id);
+	assert_int_equal(sizeof(cbmem_heap_stats), size);
+	cbmem_heap_stats_added = true;
+	return &cbmem_heap_stats;
+}
+
+static int setup_test(void **state)
+{
+	heap_start = NULL;
+	heap_end = NULL;
+	cbmem_heap_stats_added = false;
+
+	return 0;
+}
+
+/* Expect the whole heap to be merged back into a single free block. */
+static void assert_heap_empty(void)
+{
+	struct heap_stats s;
+
+	heap_stats_update(&s);
+	assert_int_equal(0, s.in_use);
+	assert_int_equal(1, s.free_blocks);
+	assert_int_equal(s.heap_size, s.free_bytes);
+	assert_int_equal(s.heap_size, s.largest_free);
+}
+
+static void test_malloc_out_of_memory(void **state)
+{
+	/* Expect die() call if out of memory */
+	expect_function_call(die);
+	if (!setjmp(die_jmp))
+		cb_malloc(TEST_HEAP_SZ);
+}
+
+static void test_free_reuses_memory(void **state)
+{
+	void *ptr1 = cb_malloc(100);
+	void *ptr2 = cb_malloc(100);
+
+	cb_free(ptr1);
+	assert_ptr_equal(ptr1, cb_malloc(100));
+
+	/* Allocations of the whole heap only succeed if everything is returned. */
+	cb_free(ptr1);
+	cb_free(ptr2);
+	assert_heap_empty();
+	ptr1 = cb_malloc(TEST_HEAP_SZ / 2);
+	cb_free(ptr1);
+	ptr1 = cb_malloc(TEST_HEAP_SZ / 2);
+	assert_non_null(ptr1);
+}
+
+static void test_free_coalesces_neighbours(void **state)
+{
+	void *ptr[5];
+
+	for (int i = 0; i < ARRAY_SIZE(ptr); i++)
+		ptr[i] = cb_malloc(1000);
+
+	/* Free in an order that exercises merging with the block above, below and both. */
+	cb_free(ptr[1]);
+	cb_free(ptr[3]);
+	cb_free(ptr[2]);
+	cb_free(ptr[0]);
+	cb_free(ptr[4]);
+
+	assert_heap_empty();
+}
+
+static void test_free_invalid_pointers(void **state)
+{
+	uint8_t not_heap;
+	void *ptr = cb_malloc(16);
+
+	cb_free(ptr);
+	/* Freeing again must not corrupt the free lists. */
+	cb_free(ptr);
+	cb_free(&not_heap);
+	cb_free(NULL);
+
+	assert_heap_empty();
+	assert_int_equal(1, stats.frees);
+}
+
+static void test_memalign_different_alignments(void **state)
+{
+	size_t boundaries[] = { 1, 3, 4, 8, 11, 16, 64, 100, 4096 };
+	void *ptr[ARRAY_SIZE(boundaries)];
+
+	for (int i = 0; i < ARRAY_SIZE(boundaries); i++) {
+		ptr[i] = cb_memalign(boundaries[i], 30);
+		/* Non power of 2 boundaries are rounded up */
+		assert_true((uintptr_t)ptr[i] % (1 << log2_ceil(boundaries[i])) == 0);
+		assert_true((uintptr_t)ptr[i] % sizeof(u64) == 0);
+		memset(ptr[i], i, 30);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(boundaries); i++) {
+		for (int j = 0; j < 30; j++)
+			assert_int_equal(i, ((uint8_t *)ptr[i])[j]);
+		cb_free(ptr[i]);
+	}
+
+	assert_heap_empty();
+}
+
+static void test_random_alloc_free(void **state)
+{
+	struct {
+		uint8_t *ptr;
+		size_t size;
+	} slots[64] = { 0 };
+	unsigned int seed = 1;
+
+	for (int round = 0; round < 10000; round++) {
+		int i;
+
+		seed = seed * 1103515245 + 12345;
+		i = (seed >> 16) % ARRAY_SIZE(slots);
+
+		if (slots[i].ptr) {
+			for (size_t j = 0; j < slots[i].size; j++)
+				assert_int_equal((uint8_t)i, slots[i].ptr[j]);
+			cb_free(slots[i].ptr);
+			slots[i].ptr = NULL;
+			continue;
+		}
+
+		slots[i].size = (seed >> 8) % 4096;
+		if (seed & 1)
+			slots[i].ptr = cb_memalign(1 << ((seed >> 4) % 10), slots[i].size);
+		else
+			slots[i].ptr = cb_malloc(slots[i].size);
+		memset(slots[i].ptr, i, slots[i].size);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(slots); i++)
+		cb_free(slots[i].ptr);
+
+	assert_heap_empty();
+	assert_true(stats.high_water < TEST_HEAP_SZ / 2);
+}
+
+static void test_heap_stats_to_cbmem(void **state)
+{
+	void *ptr1 = cb_malloc(1000);
+	void *ptr2 = cb_malloc(2000);
+	void *ptr3 = cb_malloc(3000);
+
+	cb_free(ptr2);
+	heap_stats_to_cbmem(NULL);
+
+	assert_true(cbmem_heap_stats_added);
+	assert_int_equal(TEST_HEAP_SZ, cbmem_heap_stats.heap_size);
+	assert_int_equal(3, cbmem_heap_stats.allocations);
+	assert_int_equal(1, cbmem_heap_stats.frees);
+	assert_true(cbmem_heap_stats.in_use >= 4000);
+	assert_true(cbmem_heap_stats.high_water >= 6000);
+	assert_int_equal(TEST_HEAP_SZ, cbmem_heap_stats.in_use + cbmem_heap_stats.free_bytes);
+	/* The hole left by ptr2 and the rest of the heap */
+	assert_int_equal(2, cbmem_heap_stats.free_blocks);
+
+	/* A second call refreshes the existing entry. */
+	cb_free(ptr1);
+	cb_free(ptr3);
+	heap_stats_to_cbmem(NULL);
+	assert_int_equal(0, cbmem_heap_stats.in_use);
+	assert_int_equal(1, cbmem_heap_stats.free_blocks);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup(test_malloc_out_of_memory, setup_test),
+		cmocka_unit_test_setup(test_free_reuses_memory, setup_test),
+		cmocka_unit_test_setup(test_free_coalesces_neighbours, setup_test),
+		cmocka_unit_test_setup(test_free_invalid_pointers, setup_test),
+		cmocka_unit_test_setup(test_memalign_different_alignments, setup_test),
+		cmocka_unit_test_setup(test_random_alloc_free, setup_test),
+		cmocka_unit_test_setup(test_heap_stats_to_cbmem, setup_test),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
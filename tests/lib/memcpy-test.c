@@ -175,6 +175,38 @@ static void test_memcpy_copy_part_of_itself_to_itself(void **state)
 	assert_memory_equal(s->buffer_to + sz, s->helper_buffer + sz, offset);
 }
 
+static void test_memcpy_all_alignments(void **state)
+{
+	struct test_memcpy_data *s = *state;
+	const size_t max_offset = 2 * sizeof(unsigned long);
+	const size_t sizes[] = { 1, 7, 15, 16, 17, 63, 64, 65, 257, 1023 };
+	size_t dst_offset, src_offset, i;
+	void *res_cb;
+
+	fill_buffer_data_range(s->buffer_from, MEMCPY_BUFFER_SZ, 0, 255);
+
+	/* Exercise both word-wise and byte-wise copy paths with every combination
+	   of source and destination misalignment. */
+	for (i = 0; i < ARRAY_SIZE(sizes); i++) {
+		for (dst_offset = 0; dst_offset < max_offset; dst_offset++) {
+			for (src_offset = 0; src_offset < max_offset; src_offset++) {
+				const size_t sz = sizes[i];
+
+				memset(s->buffer_to, 0xBC, MEMCPY_BUFFER_SZ);
+				res_cb = cb_memcpy(s->buffer_to + dst_offset,
+						   s->buffer_from + src_offset, sz);
+				assert_ptr_equal(s->buffer_to + dst_offset, res_cb);
+				assert_memory_equal(s->buffer_to, s->helper_buffer, dst_offset);
+				assert_memory_equal(s->buffer_to + dst_offset,
+						    s->buffer_from + src_offset, sz);
+				assert_memory_equal(s->buffer_to + dst_offset + sz,
+						    s->helper_buffer + dst_offset + sz,
+						    MEMCPY_BUFFER_SZ - (dst_offset + sz));
+			}
+		}
+	}
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -190,6 +222,8 @@ int main(void)
 						setup_test, teardown_test),
 		cmocka_unit_test_setup_teardown(test_memcpy_copy_part_of_itself_to_itself,
 						setup_test, teardown_test),
+		cmocka_unit_test_setup_teardown(test_memcpy_all_alignments,
+						setup_test, teardown_test),
 	};
 
 	return cmocka_run_group_tests(tests, NULL, NULL);
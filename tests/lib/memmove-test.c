@@ -0,0 +1,125 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+/* Include memmove() source code and alter its name to compare results with libc memmove() */
+#define memmove cb_memmove
+#include "../lib/memmove.c"
+#undef memmove
+
+#include <stdlib.h>
+#include <tests/test.h>
+#include <commonlib/helpers.h>
+#include <types.h>
+
+#define MEMMOVE_BUFFER_SZ (4 * KiB)
+
+/* Prototype of memmove() from string.h was changed to cb_memmove().
+   It has to be defined again. */
+void *memmove(void *dest, const void *src, size_t n);
+
+struct test_memmove_data {
+	u8 *buffer;
+	u8 *helper_buffer;
+};
+
+static int setup_test(void **state)
+{
+	struct test_memmove_data *s = malloc(sizeof(struct test_memmove_data));
+
+	if (!s)
+		return -1;
+
+	s->buffer = malloc(MEMMOVE_BUFFER_SZ);
+	s->helper_buffer = malloc(MEMMOVE_BUFFER_SZ);
+	if (!s->buffer || !s->helper_buffer) {
+		free(s->buffer);
+		free(s->helper_buffer);
+		free(s);
+		return -1;
+	}
+
+	*state = s;
+
+	return 0;
+}
+
+static int teardown_test(void **state)
+{
+	struct test_memmove_data *s = *state;
+
+	if (s) {
+		free(s->buffer);
+		free(s->helper_buffer);
+	}
+
+	free(s);
+
+	return 0;
+}
+
+static void fill_buffer(u8 *buffer, size_t sz)
+{
+	for (size_t i = 0; i < sz; i++)
+		buffer[i] = i * 7 + (i >> 8);
+}
+
+/* Move within one buffer with cb_memmove() and check the result against libc memmove(). */
+static void check_move(struct test_memmove_data *s, size_t dst, size_t src, size_t sz)
+{
+	fill_buffer(s->buffer, MEMMOVE_BUFFER_SZ);
+	fill_buffer(s->helper_buffer, MEMMOVE_BUFFER_SZ);
+
+	assert_ptr_equal(cb_memmove(s->buffer + dst, s->buffer + src, sz), s->buffer + dst);
+	memmove(s->helper_buffer + dst, s->helper_buffer + src, sz);
+	assert_memory_equal(s->buffer, s->helper_buffer, MEMMOVE_BUFFER_SZ);
+}
+
+static void test_memmove_zero_size(void **state)
+{
+	check_move(*state, 16, 0, 0);
+}
+
+static void test_memmove_to_itself(void **state)
+{
+	check_move(*state, 3, 3, MEMMOVE_BUFFER_SZ / 2);
+}
+
+static void test_memmove_disjoint(void **state)
+{
+	check_move(*state, MEMMOVE_BUFFER_SZ / 2 + 5, 1, MEMMOVE_BUFFER_SZ / 4);
+	check_move(*state, 2, MEMMOVE_BUFFER_SZ / 2 + 11, MEMMOVE_BUFFER_SZ / 4);
+}
+
+static void test_memmove_overlap_all_alignments(void **state)
+{
+	const size_t max_offset = 2 * sizeof(unsigned long);
+	const size_t sizes[] = { 1, 7, 8, 9, 15, 16, 17, 63, 64, 65, 257, 1023 };
+	const size_t base = 64;
+	size_t dst, src, i;
+
+	/* Overlapping moves in both directions, with every combination of source and
+	   destination misalignment. This covers the word-wise middle part as well as the
+	   byte-wise heads and tails and the byte-wise fallback for mutual misalignment. */
+	for (i = 0; i < ARRAY_SIZE(sizes); i++)
+		for (dst = base; dst < base + max_offset; dst++)
+			for (src = base; src < base + max_offset; src++) {
+				check_move(*state, dst, src, sizes[i]);
+				check_move(*state, dst - base / 2, src, sizes[i]);
+				check_move(*state, dst, src - base / 2, sizes[i]);
+			}
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_memmove_zero_size,
+						setup_test, teardown_test),
+		cmocka_unit_test_setup_teardown(test_memmove_to_itself,
+						setup_test, teardown_test),
+		cmocka_unit_test_setup_teardown(test_memmove_disjoint,
+						setup_test, teardown_test),
+		cmocka_unit_test_setup_teardown(test_memmove_overlap_all_alignments,
+						setup_test, teardown_test),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
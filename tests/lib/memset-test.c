@@ -103,6 +103,31 @@ static void test_memset_one_byte(void **state)
 	assert_memory_equal(s->base_buffer, s->helper_buffer, MEMSET_BUFFER_SZ);
 }
 
+static void test_memset_all_alignments(void **state)
+{
+	struct memset_test_state *s = *state;
+	const size_t max_offset = 2 * sizeof(unsigned long);
+	const size_t max_size = 257;
+	size_t offset, sz, j;
+
+	/* Unaligned heads and tails around the word-wise middle part. Only the low byte of
+	   the fill value counts, even with the sign bit set. */
+	for (sz = 1; sz <= max_size; sz++) {
+		for (offset = 0; offset < max_offset; offset++) {
+			for (j = 0; j < MEMSET_BUFFER_SZ; j++) {
+				s->base_buffer[j] = 0x5A;
+				s->helper_buffer[j] = 0x5A;
+			}
+			for (j = offset; j < offset + sz; j++)
+				s->helper_buffer[j] = 0xA5;
+
+			assert_ptr_equal(memset(s->base_buffer + offset, 0x1A5, sz),
+					 s->base_buffer + offset);
+			assert_memory_equal(s->base_buffer, s->helper_buffer, MEMSET_BUFFER_SZ);
+		}
+	}
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -114,6 +139,8 @@ int main(void)
 				setup_test, teardown_test),
 		cmocka_unit_test_setup_teardown(test_memset_one_byte,
 				setup_test, teardown_test),
+		cmocka_unit_test_setup_teardown(test_memset_all_alignments,
+				setup_test, teardown_test),
 	};
 
 	return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,183 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <commonlib/bsd/helpers.h>
+#include <endian.h>
+#include <security/vboot/sha256_accel.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tests/test.h>
+#include <time.h>
+#include <vb2_api.h>
+
+/* Plain C compression function as reference and throughput baseline. */
+
+#define ROR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+static const uint32_t k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+	0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+	0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+	0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+	0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+	0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static void ref_blocks(uint32_t state[8], const uint8_t *data, size_t blocks)
+{
+	for (; blocks; blocks--, data += SHA256_ACCEL_BLOCK_SIZE) {
+		uint32_t w[64], v[8], t1, t2;
+		int i;
+
+		for (i = 0; i < 16; i++)
+			w[i] = be32dec(data + i * 4);
+		for (; i < 64; i++)
+			w[i] = w[i - 16] + w[i - 7] +
+			       (ROR(w[i - 15], 7) ^ ROR(w[i - 15], 18) ^
+				(w[i - 15] >> 3)) +
+			       (ROR(w[i - 2], 17) ^ ROR(w[i - 2], 19) ^
+				(w[i - 2] >> 10));
+
+		memcpy(v, state, sizeof(v));
+		for (i = 0; i < 64; i++) {
+			t1 = v[7] + (ROR(v[4], 6) ^ ROR(v[4], 11) ^
+				     ROR(v[4], 25)) +
+			     ((v[4] & v[5]) ^ (~v[4] & v[6])) + k[i] + w[i];
+			t2 = (ROR(v[0], 2) ^ ROR(v[0], 13) ^ ROR(v[0], 22)) +
+			     ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+			memmove(&v[1], &v[0], 7 * sizeof(v[0]));
+			v[4] += t1;
+			v[0] = t1 + t2;
+		}
+		for (i = 0; i < 8; i++)
+			state[i] += v[i];
+	}
+}
+
+static void hash(const void *buf, size_t size, size_t chunk, uint8_t *digest)
+{
+	const uint8_t *p = buf;
+
+	assert_int_equal(VB2_SUCCESS,
+			 vb2ex_hwcrypto_digest_init(VB2_HASH_SHA256, size));
+	while (size) {
+		size_t n = MIN(size, chunk);
+
+		assert_int_equal(VB2_SUCCESS,
+				 vb2ex_hwcrypto_digest_extend(p, n));
+		p += n;
+		size -= n;
+	}
+	assert_int_equal(VB2_SUCCESS, vb2ex_hwcrypto_digest_finalize(
+				digest, SHA256_ACCEL_DIGEST_SIZE));
+}
+
+static void test_sha256_accel_vectors(void **state)
+{
+	static const uint8_t abc[] = {
+		0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+		0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+		0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+		0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+	};
+	static const uint8_t empty[] = {
+		0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14,
+		0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+		0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c,
+		0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55,
+	};
+	/* One million times 'a', fed in odd sized pieces. */
+	static const uint8_t million_a[] = {
+		0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92,
+		0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+		0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e,
+		0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0,
+	};
+	uint8_t digest[SHA256_ACCEL_DIGEST_SIZE];
+	uint8_t *buf;
+
+	if (!sha256_accel_supported())
+		skip();
+
+	hash("abc", 3, 1, digest);
+	assert_memory_equal(digest, abc, sizeof(digest));
+
+	hash("", 0, 1, digest);
+	assert_memory_equal(digest, empty, sizeof(digest));
+
+	buf = malloc(1000000);
+	memset(buf, 'a', 1000000);
+	hash(buf, 1000000, 63, digest);
+	assert_memory_equal(digest, million_a, sizeof(digest));
+	free(buf);
+
+	assert_int_equal(VB2_ERROR_EX_HWCRYPTO_UNSUPPORTED,
+			 vb2ex_hwcrypto_digest_init(VB2_HASH_SHA512, 0));
+}
+
+static void test_sha256_accel_blocks(void **state)
+{
+	const size_t blocks = 257;
+	uint32_t ref[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	uint32_t accel[8];
+	uint8_t *buf;
+	size_t i;
+
+	if (!sha256_accel_supported())
+		skip();
+
+	buf = malloc(blocks * SHA256_ACCEL_BLOCK_SIZE);
+	for (i = 0; i < blocks * SHA256_ACCEL_BLOCK_SIZE; i++)
+		buf[i] = i * 2654435761u >> 24;
+	memcpy(accel, ref, sizeof(accel));
+
+	/* Unaligned input and a single call for many blocks. */
+	ref_blocks(ref, buf + 1, blocks - 1);
+	sha256_accel_blocks(accel, buf + 1, blocks - 1);
+	assert_memory_equal(ref, accel, sizeof(ref));
+
+	free(buf);
+}
+
+static double mbps(void (*fn)(uint32_t *, const uint8_t *, size_t),
+		   const uint8_t *buf, size_t blocks)
+{
+	uint32_t st[8] = { 0 };
+	clock_t start = clock();
+
+	fn(st, buf, blocks);
+	return blocks * SHA256_ACCEL_BLOCK_SIZE /
+		((double)(clock() - start) / CLOCKS_PER_SEC) / MiB;
+}
+
+/* Not a pass/fail criterion, just shows what the body hash gains. */
+static void test_sha256_accel_throughput(void **state)
+{
+	const size_t blocks = 4 * MiB / SHA256_ACCEL_BLOCK_SIZE;
+	uint8_t *buf;
+
+	if (!sha256_accel_supported())
+		skip();
+
+	buf = malloc(blocks * SHA256_ACCEL_BLOCK_SIZE);
+	memset(buf, 0x5a, blocks * SHA256_ACCEL_BLOCK_SIZE);
+	print_message("SHA-256 C: %.1f MiB/s, CPU instructions: %.1f MiB/s\n",
+		      mbps(ref_blocks, buf, blocks),
+		      mbps(sha256_accel_blocks, buf, blocks));
+	free(buf);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_sha256_accel_vectors),
+		cmocka_unit_test(test_sha256_accel_blocks),
+		cmocka_unit_test(test_sha256_accel_throughput),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -25,6 +25,11 @@ static const struct typedesc_t types_cbfs_compression[] = {
 	{CBFS_COMPRESS_NONE, "none"},
 	{CBFS_COMPRESS_LZMA, "LZMA"},
 	{CBFS_COMPRESS_LZ4, "LZ4"},
+	{CBFS_COMPRESS_LZMA_CHUNKED, "LZMA-chunked"},
+	{CBFS_COMPRESS_LZ4_CHUNKED, "LZ4-chunked"},
+	{CBFS_COMPRESS_ZSTD, "ZSTD"},
+	{CBFS_COMPRESS_LZMA_BCJ_X86, "LZMA-BCJ-x86"},
+	{CBFS_COMPRESS_LZMA_BCJ_ARM64, "LZMA-BCJ-arm64"},
 	{0, NULL},
 };
 
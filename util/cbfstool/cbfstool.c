@@ -8,6 +8,7 @@
 #include <ctype.h>
 #include <unistd.h>
 #include <getopt.h>
+#include <pthread.h>
 #include "common.h"
 #include "cbfs.h"
 #include "cbfs_image.h"
@@ -89,6 +90,10 @@ static struct param {
 	bool ibb;
 	enum cbfs_compression compression;
 	int precompression;
+	/* -c auto, picks the compression per file using the profile below */
+	bool compression_auto;
+	const char *compression_profile;
+	const char *compression_report;
 	enum vb2_hash_algorithm hash;
 	/* For linux payloads */
 	char *initrd;
@@ -106,6 +111,10 @@ static struct param {
 	 */
 	uint32_t ext_win_base;
 	uint32_t ext_win_size;
+	/* Number of worker threads used by add-batch, 0 means one per CPU. */
+	unsigned int jobs;
+	/* File names in boot access order, add-batch places them first. */
+	const char *access_order;
 } param = {
 	/* All variables not listed are initialized as zero. */
 	.arch = CBFS_ARCHITECTURE_UNKNOWN,
@@ -116,6 +125,9 @@ static struct param {
 	.u64val = -1,
 };
 
+/* Target profile of -c auto, set up once the options are parsed. */
+static struct compression_profile auto_profile;
+
 static bool region_is_flashmap(const char *region)
 {
 	return partitioned_file_region_check_magic(param.image_file, region,
@@ -640,67 +652,25 @@ static int add_topswap_bootblock(struct buffer *buffer, uint32_t *offset)
 	return convert_region_offset(buffer_size(buffer), offset);
 }
 
-static int cbfs_add_component(const char *filename,
-			      const char *name,
-			      uint32_t type,
-			      uint32_t offset,
-			      uint32_t headeroffset,
-			      convert_buffer_t convert)
+/*
+ * Add a file whose contents already went through its convert_buffer_t into
+ * the image. Takes ownership of both buffer and header.
+ */
+static int cbfs_add_converted_component(struct cbfs_image *image,
+					const char *filename,
+					const char *name,
+					uint32_t type,
+					uint32_t offset,
+					struct buffer *buffer,
+					struct cbfs_file *header)
 {
 	size_t len_align = 0;
 
-	if (!filename) {
-		ERROR("You need to specify -f/--filename.\n");
-		return 1;
-	}
-
-	if (!name) {
-		ERROR("You need to specify -n/--name.\n");
-		return 1;
-	}
-
-	if (type == 0) {
-		ERROR("You need to specify a valid -t/--type.\n");
-		return 1;
-	}
-
-	struct cbfs_image image;
-	if (cbfs_image_from_buffer(&image, param.image_region, headeroffset))
-		return 1;
-
-	if (cbfs_get_entry(&image, name)) {
-		ERROR("'%s' already in ROM image.\n", name);
-		return 1;
-	}
-
-	struct buffer buffer;
-	if (buffer_from_file(&buffer, filename) != 0) {
-		ERROR("Could not load file '%s'.\n", filename);
-		return 1;
-	}
-
-	/*
-	 * Check if Intel CPU topswap is specified this will require a
-	 * second bootblock to be added.
-	 */
-	if (type == CBFS_TYPE_BOOTBLOCK && param.topswap_size)
-		if (add_topswap_bootblock(&buffer, &offset))
-			return 1;
-
-	struct cbfs_file *header =
-		cbfs_create_file_header(type, buffer.size, name);
-
-	if (convert && convert(&buffer, &offset, header) != 0) {
-		ERROR("Failed to parse file '%s'.\n", filename);
-		buffer_delete(&buffer);
-		return 1;
-	}
-
 	if (param.hash != VB2_HASH_INVALID)
-		if (cbfs_add_file_hash(header, &buffer, param.hash) == -1) {
+		if (cbfs_add_file_hash(header, buffer, param.hash) == -1) {
 			ERROR("couldn't add hash for '%s'\n", name);
 			free(header);
-			buffer_delete(&buffer);
+			buffer_delete(buffer);
 			return 1;
 		}
 
@@ -765,28 +735,202 @@ static int cbfs_add_component(const char *filename,
 	if (IS_HOST_SPACE_ADDRESS(offset))
 		offset = convert_addr_space(param.image_region, offset);
 
-	if (cbfs_add_entry(&image, &buffer, offset, header, len_align) != 0) {
+	if (cbfs_add_entry(image, buffer, offset, header, len_align) != 0) {
 		ERROR("Failed to add '%s' into ROM image.\n", filename);
 		free(header);
-		buffer_delete(&buffer);
+		buffer_delete(buffer);
 		return 1;
 	}
 
 	free(header);
-	buffer_delete(&buffer);
+	buffer_delete(buffer);
 	return 0;
 }
 
-static int cbfstool_convert_raw(struct buffer *buffer,
-	unused uint32_t *offset, struct cbfs_file *header)
+/*
+ * One conversion of a file with the given compression, for -c auto. Returns 0
+ * on success like convert_buffer_t.
+ */
+typedef int (*auto_convert_t)(void *arg, enum cbfs_compression algo,
+			      struct buffer *buffer, uint32_t *offset,
+			      struct cbfs_file *header);
+
+/*
+ * -c auto: convert the file once with every candidate algorithm of the target
+ * profile and keep the result that is estimated to load fastest, reading it
+ * from the boot medium and decompressing it included. The size of the
+ * uncompressed conversion is what the file decompresses to.
+ */
+static int convert_auto(const char *name, uint32_t type, struct buffer *buffer,
+			uint32_t *offset, struct cbfs_file **header,
+			auto_convert_t convert, void *arg)
+{
+	struct buffer best = { 0 };
+	struct cbfs_file *best_header = NULL;
+	enum cbfs_compression best_algo = CBFS_COMPRESS_NONE;
+	uint32_t best_offset = *offset;
+	double best_us = 0, none_us = 0;
+	size_t loaded = 0;
+	int algo;
+
+	for (algo = 0; algo < COMPRESSION_PROFILE_ALGOS; algo++) {
+		struct buffer trial;
+		struct cbfs_file *trial_header;
+		uint32_t trial_offset = *offset;
+		double us;
+
+		if (!compression_profile_candidate(&auto_profile, algo))
+			continue;
+
+		if (buffer_create(&trial, buffer_size(buffer), "auto"))
+			goto fail;
+		memcpy(buffer_get(&trial), buffer_get(buffer),
+		       buffer_size(buffer));
+
+		trial_header = cbfs_create_file_header(type, trial.size, name);
+		if (!trial_header ||
+		    convert(arg, algo, &trial, &trial_offset, trial_header)) {
+			buffer_delete(&trial);
+			free(trial_header);
+			/* Without the uncompressed variant there is no baseline. */
+			if (algo == CBFS_COMPRESS_NONE)
+				goto fail;
+			DEBUG("'%s' can't use %s, skipped\n", name,
+			      compression_algo_name(algo));
+			continue;
+		}
+
+		if (algo == CBFS_COMPRESS_NONE)
+			loaded = buffer_size(&trial);
+		us = compression_estimate_us(&auto_profile, algo,
+					     buffer_size(&trial), loaded);
+		if (algo == CBFS_COMPRESS_NONE)
+			none_us = us;
+		DEBUG("'%s' with %s: %zu bytes, %.1f us\n", name,
+		      compression_algo_name(algo), buffer_size(&trial), us);
+
+		if (best_header && us >= best_us) {
+			buffer_delete(&trial);
+			free(trial_header);
+			continue;
+		}
+
+		buffer_delete(&best);
+		free(best_header);
+		best = trial;
+		best_header = trial_header;
+		best_offset = trial_offset;
+		best_algo = algo;
+		best_us = us;
+	}
+
+	buffer_delete(buffer);
+	*buffer = best;
+	free(*header);
+	*header = best_header;
+	*offset = best_offset;
+
+	INFO("'%s': %s, estimated %.1f us to load instead of %.1f us\n",
+	     name, compression_algo_name(best_algo), best_us, none_us);
+
+	if (param.compression_report &&
+	    compression_report_add(param.compression_report, name, best_algo,
+				   buffer_size(buffer), loaded, best_us, none_us))
+		return -1;
+	return 0;
+
+fail:
+	buffer_delete(&best);
+	free(best_header);
+	return -1;
+}
+
+static int convert_with_param(void *arg, enum cbfs_compression algo,
+			      struct buffer *buffer, uint32_t *offset,
+			      struct cbfs_file *header)
+{
+	convert_buffer_t convert = *(convert_buffer_t *)arg;
+
+	param.compression = algo;
+	return convert(buffer, offset, header);
+}
+
+static int cbfs_add_component(const char *filename,
+			      const char *name,
+			      uint32_t type,
+			      uint32_t offset,
+			      uint32_t headeroffset,
+			      convert_buffer_t convert)
+{
+	if (!filename) {
+		ERROR("You need to specify -f/--filename.\n");
+		return 1;
+	}
+
+	if (!name) {
+		ERROR("You need to specify -n/--name.\n");
+		return 1;
+	}
+
+	if (type == 0) {
+		ERROR("You need to specify a valid -t/--type.\n");
+		return 1;
+	}
+
+	struct cbfs_image image;
+	if (cbfs_image_from_buffer(&image, param.image_region, headeroffset))
+		return 1;
+
+	if (cbfs_get_entry(&image, name)) {
+		ERROR("'%s' already in ROM image.\n", name);
+		return 1;
+	}
+
+	struct buffer buffer;
+	if (buffer_from_file(&buffer, filename) != 0) {
+		ERROR("Could not load file '%s'.\n", filename);
+		return 1;
+	}
+
+	/*
+	 * Check if Intel CPU topswap is specified this will require a
+	 * second bootblock to be added.
+	 */
+	if (type == CBFS_TYPE_BOOTBLOCK && param.topswap_size)
+		if (add_topswap_bootblock(&buffer, &offset))
+			return 1;
+
+	struct cbfs_file *header =
+		cbfs_create_file_header(type, buffer.size, name);
+
+	/* XIP files can't be compressed, so there is nothing to pick. */
+	if (convert && param.compression_auto && !param.stage_xip) {
+		if (convert_auto(name, type, &buffer, &offset, &header,
+				 convert_with_param, &convert) != 0) {
+			ERROR("Failed to parse file '%s'.\n", filename);
+			buffer_delete(&buffer);
+			return 1;
+		}
+	} else if (convert && convert(&buffer, &offset, header) != 0) {
+		ERROR("Failed to parse file '%s'.\n", filename);
+		buffer_delete(&buffer);
+		return 1;
+	}
+
+	return cbfs_add_converted_component(&image, filename, name, type,
+					    offset, &buffer, header);
+}
+
+static int compress_raw(struct buffer *buffer, struct cbfs_file *header,
+			enum cbfs_compression algo, bool precompressed)
 {
 	char *compressed;
 	int decompressed_size, compressed_size;
 	comp_func_ptr compress;
 
 	decompressed_size = buffer->size;
-	if (param.precompression) {
-		param.compression = read_le32(buffer->data);
+	if (precompressed) {
+		algo = read_le32(buffer->data);
 		decompressed_size = read_le32(buffer->data + sizeof(uint32_t));
 		compressed_size = buffer->size - 8;
 		compressed = malloc(compressed_size);
@@ -794,10 +938,10 @@ static int cbfstool_convert_raw(struct buffer *buffer,
 			return -1;
 		memcpy(compressed, buffer->data + 8, compressed_size);
 	} else {
-		if (param.compression == CBFS_COMPRESS_NONE)
+		if (algo == CBFS_COMPRESS_NONE)
 			goto out;
 
-		compress = compression_function(param.compression);
+		compress = compression_function(algo);
 		if (!compress)
 			return -1;
 		compressed = calloc(buffer->size, 1);
@@ -821,7 +965,7 @@ static int cbfstool_convert_raw(struct buffer *buffer,
 		free(compressed);
 		return -1;
 	}
-	attrs->compression = htonl(param.compression);
+	attrs->compression = htonl(algo);
 	attrs->decompressed_size = htonl(decompressed_size);
 
 	free(buffer->data);
@@ -833,6 +977,13 @@ out:
 	return 0;
 }
 
+static int cbfstool_convert_raw(struct buffer *buffer,
+	unused uint32_t *offset, struct cbfs_file *header)
+{
+	return compress_raw(buffer, header, param.compression,
+			    param.precompression);
+}
+
 static int cbfstool_convert_fsp(struct buffer *buffer,
 				uint32_t *offset, struct cbfs_file *header)
 {
@@ -941,29 +1092,29 @@ static int cbfstool_convert_mkstage(struct buffer *buffer, uint32_t *offset,
 	return 0;
 }
 
-static int cbfstool_convert_mkpayload(struct buffer *buffer,
-	unused uint32_t *offset, struct cbfs_file *header)
+static int make_payload(struct buffer *buffer, struct cbfs_file *header,
+			enum cbfs_compression algo)
 {
 	struct buffer output;
 	int ret;
 	/* Per default, try and see if payload is an ELF binary */
-	ret = parse_elf_to_payload(buffer, &output, param.compression);
+	ret = parse_elf_to_payload(buffer, &output, algo);
 
 	/* If it's not an ELF, see if it's a FIT */
 	if (ret != 0) {
-		ret = parse_fit_to_payload(buffer, &output, param.compression);
+		ret = parse_fit_to_payload(buffer, &output, algo);
 		if (ret == 0)
 			header->type = htonl(CBFS_TYPE_FIT);
 	}
 
 	/* If it's not an FIT, see if it's a UEFI FV */
 	if (ret != 0)
-		ret = parse_fv_to_payload(buffer, &output, param.compression);
+		ret = parse_fv_to_payload(buffer, &output, algo);
 
 	/* If it's neither ELF nor UEFI Fv, try bzImage */
 	if (ret != 0)
 		ret = parse_bzImage_to_payload(buffer, &output,
-				param.initrd, param.cmdline, param.compression);
+				param.initrd, param.cmdline, algo);
 
 	/* Not a supported payload type */
 	if (ret != 0) {
@@ -979,6 +1130,12 @@ static int cbfstool_convert_mkpayload(struct buffer *buffer,
 	return 0;
 }
 
+static int cbfstool_convert_mkpayload(struct buffer *buffer,
+	unused uint32_t *offset, struct cbfs_file *header)
+{
+	return make_payload(buffer, header, param.compression);
+}
+
 static int cbfstool_convert_mkflatpayload(struct buffer *buffer,
 	unused uint32_t *offset, struct cbfs_file *header)
 {
@@ -1088,6 +1245,371 @@ static int cbfs_add_flat_binary(void)
 				  cbfstool_convert_mkflatpayload);
 }
 
+/*
+ * add-batch: add all files listed in a manifest to the image in one go. The
+ * expensive part of adding a file is converting and compressing it, which
+ * doesn't depend on the image, so that is done for all files in parallel.
+ * The converted files are then placed one by one in manifest order, which
+ * makes the result identical to a sequence of add / add-stage / add-payload
+ * invocations with the same arguments. Files that need a base address or an
+ * alignment can't be batched, add them with add / add-stage instead.
+ *
+ * With --access-order, the files listed in the access order file are placed
+ * first and in the order listed there, followed by the remaining files in
+ * manifest order. Since free space is filled first fit, this puts the files
+ * read during boot back to back in the order the firmware reads them.
+ */
+struct batch_entry {
+	char *name;
+	char *filename;
+	uint32_t type;
+	enum cbfs_compression compression;
+	bool compression_auto;
+	/* Stage section to drop, as with add-stage -S */
+	char *ignore_section;
+	/* Position in the access order file, SIZE_MAX if not listed */
+	size_t access_rank;
+	size_t manifest_index;
+	/* Filled in by batch_convert() */
+	struct buffer buffer;
+	struct cbfs_file *header;
+	int ret;
+};
+
+struct batch_queue {
+	struct batch_entry *entries;
+	size_t count;
+	size_t next;
+	pthread_mutex_t lock;
+};
+
+static int batch_convert_buffer(void *arg, enum cbfs_compression algo,
+				struct buffer *buffer, unused uint32_t *offset,
+				struct cbfs_file *header)
+{
+	struct batch_entry *entry = arg;
+	struct buffer output;
+
+	switch (entry->type) {
+	case CBFS_TYPE_STAGE:
+		if (parse_elf_to_stage(buffer, &output, algo,
+				       entry->ignore_section) != 0)
+			return 1;
+		buffer_delete(buffer);
+		// Direct assign, no dupe.
+		memcpy(buffer, &output, sizeof(output));
+		header->len = htonl(output.size);
+		return 0;
+	case CBFS_TYPE_SELF:
+		return make_payload(buffer, header, algo) != 0;
+	default:
+		return compress_raw(buffer, header, algo, false) != 0;
+	}
+}
+
+static int batch_convert(struct batch_entry *entry)
+{
+	uint32_t offset = 0;
+
+	if (buffer_from_file(&entry->buffer, entry->filename) != 0) {
+		ERROR("Could not load file '%s'.\n", entry->filename);
+		return 1;
+	}
+
+	entry->header = cbfs_create_file_header(entry->type,
+						entry->buffer.size, entry->name);
+	if (!entry->header)
+		return 1;
+
+	if (entry->compression_auto)
+		return convert_auto(entry->name, entry->type, &entry->buffer,
+				    &offset, &entry->header,
+				    batch_convert_buffer, entry) != 0;
+
+	return batch_convert_buffer(entry, entry->compression, &entry->buffer,
+				    &offset, entry->header);
+}
+
+static void *batch_worker(void *arg)
+{
+	struct batch_queue *queue = arg;
+	size_t i;
+
+	for (;;) {
+		pthread_mutex_lock(&queue->lock);
+		i = queue->next++;
+		pthread_mutex_unlock(&queue->lock);
+
+		if (i >= queue->count)
+			return NULL;
+
+		queue->entries[i].ret = batch_convert(&queue->entries[i]);
+	}
+}
+
+static void batch_free(struct batch_entry *entries, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		free(entries[i].name);
+		free(entries[i].filename);
+		free(entries[i].ignore_section);
+		free(entries[i].header);
+		buffer_delete(&entries[i].buffer);
+	}
+	free(entries);
+}
+
+/*
+ * Each non-empty manifest line has the form
+ *   TYPE NAME FILE [COMPRESSION] [-S SECTION]
+ * where TYPE is "stage", "payload" or any other type accepted by add -t,
+ * COMPRESSION is an algorithm name or "auto" as with -c and SECTION is the
+ * stage section to ignore as with add-stage -S. Without -S on the line, the
+ * -S passed to add-batch applies to all stages.
+ * Everything following a '#' is ignored.
+ */
+static int batch_parse_manifest(const char *path, struct batch_entry **entries,
+				size_t *count)
+{
+	FILE *f;
+	char *line = NULL, *save, *tok[7];
+	const char *compression, *ignore_section;
+	size_t line_size = 0, lineno = 0, n;
+	struct batch_entry *entry;
+	int ret = 1;
+
+	*entries = NULL;
+	*count = 0;
+
+	f = fopen(path, "r");
+	if (!f) {
+		ERROR("Could not open manifest '%s'.\n", path);
+		return 1;
+	}
+
+	while (getline(&line, &line_size, f) != -1) {
+		lineno++;
+		line[strcspn(line, "#")] = '\0';
+
+		n = 0;
+		for (char *p = strtok_r(line, " \t\r\n", &save);
+		     p && n < ARRAY_SIZE(tok);
+		     p = strtok_r(NULL, " \t\r\n", &save))
+			tok[n++] = p;
+
+		if (n == 0)
+			continue;
+		if (n < 3 || n == ARRAY_SIZE(tok)) {
+			ERROR("%s:%zu: expected TYPE NAME FILE [COMPRESSION] "
+			      "[-S SECTION].\n", path, lineno);
+			goto out;
+		}
+
+		compression = NULL;
+		ignore_section = param.ignore_section;
+		for (size_t i = 3; i < n; i++) {
+			if (strcmp(tok[i], "-S") == 0 && i + 1 < n) {
+				ignore_section = tok[++i];
+			} else if (tok[i][0] != '-' && !compression) {
+				compression = tok[i];
+			} else {
+				ERROR("%s:%zu: unexpected '%s', only compression "
+				      "and -S can be given in a batch.\n",
+				      path, lineno, tok[i]);
+				goto out;
+			}
+		}
+
+		entry = realloc(*entries, (*count + 1) * sizeof(*entry));
+		if (!entry)
+			goto out;
+		*entries = entry;
+		entry = &entry[(*count)++];
+		memset(entry, 0, sizeof(*entry));
+
+		if (strcmp(tok[0], "payload") == 0)
+			entry->type = CBFS_TYPE_SELF;
+		else if (intfiletype(tok[0]) != ((uint64_t) - 1))
+			entry->type = intfiletype(tok[0]);
+		else
+			entry->type = strtoul(tok[0], NULL, 0);
+
+		/* These need the image to be converted, so can't be batched. */
+		if (entry->type == 0 || entry->type == CBFS_TYPE_FSP ||
+		    entry->type == CBFS_TYPE_BOOTBLOCK) {
+			ERROR("%s:%zu: type '%s' not supported in a batch.\n",
+			      path, lineno, tok[0]);
+			goto out;
+		}
+
+		entry->compression = CBFS_COMPRESS_NONE;
+		if (compression && strcmp(compression, "auto") == 0) {
+			entry->compression_auto = true;
+		} else if (compression) {
+			int algo = cbfs_parse_comp_algo(compression);
+			if (algo < 0) {
+				ERROR("%s:%zu: unknown compression '%s'.\n",
+				      path, lineno, compression);
+				goto out;
+			}
+			entry->compression = algo;
+		}
+
+		entry->name = strdup(tok[1]);
+		entry->filename = strdup(tok[2]);
+		if (!entry->name || !entry->filename)
+			goto out;
+		if (entry->type == CBFS_TYPE_STAGE && ignore_section) {
+			entry->ignore_section = strdup(ignore_section);
+			if (!entry->ignore_section)
+				goto out;
+		}
+	}
+	ret = 0;
+
+out:
+	free(line);
+	fclose(f);
+	if (ret) {
+		batch_free(*entries, *count);
+		*entries = NULL;
+		*count = 0;
+	}
+	return ret;
+}
+
+static int compare_batch_entries(const void *a, const void *b)
+{
+	const struct batch_entry *ea = a, *eb = b;
+
+	if (ea->access_rank != eb->access_rank)
+		return ea->access_rank < eb->access_rank ? -1 : 1;
+	if (ea->manifest_index != eb->manifest_index)
+		return ea->manifest_index < eb->manifest_index ? -1 : 1;
+	return 0;
+}
+
+/*
+ * The access order file has one CBFS file name per line, as printed by
+ * `cbmem -a`. Blank lines are ignored.
+ */
+static int batch_sort_by_access(const char *path, struct batch_entry *entries,
+				size_t count)
+{
+	FILE *f;
+	char *line = NULL;
+	size_t line_size = 0, rank = 0, listed = 0;
+
+	for (size_t i = 0; i < count; i++) {
+		entries[i].access_rank = SIZE_MAX;
+		entries[i].manifest_index = i;
+	}
+
+	f = fopen(path, "r");
+	if (!f) {
+		ERROR("Could not open access order file '%s'.\n", path);
+		return 1;
+	}
+
+	while (getline(&line, &line_size, f) != -1) {
+		line[strcspn(line, "\r\n")] = '\0';
+		if (line[0] == '\0')
+			continue;
+
+		for (size_t i = 0; i < count; i++) {
+			if (entries[i].access_rank == SIZE_MAX &&
+			    strcmp(entries[i].name, line) == 0) {
+				entries[i].access_rank = rank;
+				listed++;
+			}
+		}
+		rank++;
+	}
+	free(line);
+	fclose(f);
+
+	qsort(entries, count, sizeof(*entries), compare_batch_entries);
+	DEBUG("%zu of %zu files placed in access order.\n", listed, count);
+	return 0;
+}
+
+static int cbfs_add_batch(void)
+{
+	struct batch_queue queue = { .lock = PTHREAD_MUTEX_INITIALIZER };
+	pthread_t *threads;
+	size_t jobs, started = 0;
+	int ret = 1;
+
+	if (!param.filename) {
+		ERROR("You need to specify -f/--filename.\n");
+		return 1;
+	}
+
+	if (batch_parse_manifest(param.filename, &queue.entries, &queue.count))
+		return 1;
+
+	if (param.access_order &&
+	    batch_sort_by_access(param.access_order, queue.entries, queue.count))
+		goto out;
+
+	jobs = param.jobs;
+	if (!jobs) {
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		jobs = cpus > 0 ? cpus : 1;
+	}
+	jobs = MIN(jobs, queue.count);
+
+	threads = calloc(jobs, sizeof(*threads));
+	if (jobs && !threads)
+		goto out;
+
+	for (; started < jobs; started++)
+		if (pthread_create(&threads[started], NULL, batch_worker,
+				   &queue))
+			break;
+	/* Lend a hand, this also copes with pthread_create() failing. */
+	batch_worker(&queue);
+	for (size_t i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+
+	for (size_t i = 0; i < queue.count; i++) {
+		if (queue.entries[i].ret) {
+			ERROR("Failed to parse file '%s'.\n",
+			      queue.entries[i].filename);
+			goto out;
+		}
+	}
+
+	struct cbfs_image image;
+	if (cbfs_image_from_buffer(&image, param.image_region,
+				   param.headeroffset))
+		goto out;
+
+	for (size_t i = 0; i < queue.count; i++) {
+		struct batch_entry *entry = &queue.entries[i];
+
+		if (cbfs_get_entry(&image, entry->name)) {
+			ERROR("'%s' already in ROM image.\n", entry->name);
+			goto out;
+		}
+
+		/* The entry's buffer and header are consumed here. */
+		struct cbfs_file *header = entry->header;
+		entry->header = NULL;
+		if (cbfs_add_converted_component(&image, entry->filename,
+				entry->name, ntohl(header->type), 0,
+				&entry->buffer, header))
+			goto out;
+		INFO("Added '%s' (%zu/%zu)\n", entry->name, i + 1, queue.count);
+	}
+	ret = 0;
+
+out:
+	batch_free(queue.entries, queue.count);
+	return ret;
+}
+
 static int cbfs_add_integer(void)
 {
 	if (!param.u64val_assigned) {
@@ -1476,6 +1998,7 @@ static const struct command commands[] = {
 				true, true},
 	{"add-stage", "a:H:r:f:n:t:c:b:P:QS:p:yvA:gh?", cbfs_add_stage,
 				true, true},
+	{"add-batch", "H:r:f:A:S:vh?", cbfs_add_batch, true, true},
 	{"add-int", "H:r:i:n:b:vgh?", cbfs_add_integer, true, true},
 	{"add-master-header", "H:r:vh?j:", cbfs_add_master_header, true, true},
 	{"compact", "r:h?", cbfs_compact, true, true},
@@ -1497,6 +2020,10 @@ enum {
 	LONGOPT_IBB = LONGOPT_START,
 	LONGOPT_EXT_WIN_BASE,
 	LONGOPT_EXT_WIN_SIZE,
+	LONGOPT_JOBS,
+	LONGOPT_COMPRESSION_PROFILE,
+	LONGOPT_COMPRESSION_REPORT,
+	LONGOPT_ACCESS_ORDER,
 	LONGOPT_END,
 };
 
@@ -1542,6 +2069,12 @@ static struct option long_options[] = {
 	{"ibb",           no_argument,       0, LONGOPT_IBB },
 	{"ext-win-base",  required_argument, 0, LONGOPT_EXT_WIN_BASE },
 	{"ext-win-size",  required_argument, 0, LONGOPT_EXT_WIN_SIZE },
+	{"jobs",          required_argument, 0, LONGOPT_JOBS },
+	{"compression-profile", required_argument, 0,
+					LONGOPT_COMPRESSION_PROFILE },
+	{"compression-report", required_argument, 0,
+					LONGOPT_COMPRESSION_REPORT },
+	{"access-order",  required_argument, 0, LONGOPT_ACCESS_ORDER },
 	{NULL,            0,                 0,  0  }
 };
 
@@ -1648,6 +2181,19 @@ static void usage(char *name)
 	     "                   space(x86 only)\n"
 	     "  --ext-win-size   Size of extended decode window in host address\n"
 	     "                   space(x86 only)\n"
+	     "  --jobs           Number of threads used by add-batch\n"
+	     "                   (default: one per CPU)\n"
+	     "  --compression-profile flash=MB/s,ALGO=MB/s,...\n"
+	     "                   Target profile for -c auto: boot medium read\n"
+	     "                   bandwidth and the decompression throughput of\n"
+	     "                   each candidate algorithm (default:\n"
+	     "                   flash=20,LZ4=400,LZMA=40)\n"
+	     "  --compression-report FILE\n"
+	     "                   Add the choices of -c auto to FILE\n"
+	     "  --access-order FILE\n"
+	     "                   Let add-batch place the files listed in FILE\n"
+	     "                   (one name per line, see `cbmem -a`) first and\n"
+	     "                   in that order\n"
 	     "COMMANDs:\n"
 	     " add [-r image,regions] -f FILE -n NAME -t TYPE [-A hash] \\\n"
 	     "        [-c compression] [-b base-address | -a alignment] \\\n"
@@ -1671,6 +2217,14 @@ static void usage(char *name)
 	     "        [-A hash] -l load-address -e entry-point \\\n"
 	     "        [-c compression] [-b base]                           "
 			"Add a 32bit flat mode binary\n"
+	     " add-batch [-r image,regions] -f MANIFEST [-A hash] \\\n"
+	     "        [-S section-to-ignore] \\\n"
+	     "        [--jobs threads] [--access-order FILE]               "
+			"Add all files listed in MANIFEST\n"
+	     "                                                         "
+	     "    MANIFEST lines: TYPE NAME FILE [compression] [-S section]\n"
+	     "                                                         "
+	     "    (no -b or -a, add such files with add or add-stage)\n"
 	     " add-int [-r image,regions] -i INTEGER -n NAME [-b base]     "
 			"Add a raw 64-bit integer value\n"
 	     " add-master-header [-r image,regions] \\                   \n"
@@ -1811,6 +2365,10 @@ int main(int argc, char **argv)
 					param.precompression = 1;
 					break;
 				}
+				if (strcmp(optarg, "auto") == 0) {
+					param.compression_auto = true;
+					break;
+				}
 				int algo = cbfs_parse_comp_algo(optarg);
 				if (algo >= 0)
 					param.compression = algo;
@@ -2008,6 +2566,22 @@ int main(int argc, char **argv)
 					return 1;
 				}
 				break;
+			case LONGOPT_JOBS:
+				param.jobs = strtoul(optarg, &suffix, 0);
+				if (!*optarg || (suffix && *suffix)) {
+					ERROR("Invalid number of jobs '%s'.\n", optarg);
+					return 1;
+				}
+				break;
+			case LONGOPT_COMPRESSION_PROFILE:
+				param.compression_profile = optarg;
+				break;
+			case LONGOPT_COMPRESSION_REPORT:
+				param.compression_report = optarg;
+				break;
+			case LONGOPT_ACCESS_ORDER:
+				param.access_order = optarg;
+				break;
 			case 'h':
 			case '?':
 				usage(argv[0]);
@@ -2017,6 +2591,14 @@ int main(int argc, char **argv)
 			}
 		}
 
+		if (param.compression_profile) {
+			if (compression_profile_parse(&auto_profile,
+						param.compression_profile))
+				return 1;
+		} else {
+			compression_profile_default(&auto_profile);
+		}
+
 		if (commands[i].function == cbfs_create) {
 			if (param.fmap) {
 				struct buffer flashmap;
@@ -155,6 +155,32 @@ typedef int (*decomp_func_ptr) (char *in, int in_len, char *out, int out_len,
 comp_func_ptr compression_function(enum cbfs_compression algo);
 decomp_func_ptr decompression_function(enum cbfs_compression algo);
 
+/* compress_auto.c */
+#define COMPRESSION_PROFILE_ALGOS 8
+
+/* Target profile for -c auto, all throughputs in MB/s. */
+struct compression_profile {
+	/* Read bandwidth of the boot medium. */
+	double flash_mbps;
+	/* Decompression throughput (of the output), 0 for non-candidates. */
+	double decomp_mbps[COMPRESSION_PROFILE_ALGOS];
+};
+
+void compression_profile_default(struct compression_profile *profile);
+int compression_profile_parse(struct compression_profile *profile,
+			      const char *spec);
+bool compression_profile_candidate(const struct compression_profile *profile,
+				   enum cbfs_compression algo);
+const char *compression_algo_name(enum cbfs_compression algo);
+/* Estimated time to read |stored| bytes and decompress them to |loaded|. */
+double compression_estimate_us(const struct compression_profile *profile,
+			       enum cbfs_compression algo, size_t stored,
+			       size_t loaded);
+/* Add a line for file |name| to the report at |path| and update its total. */
+int compression_report_add(const char *path, const char *name,
+			   enum cbfs_compression algo, size_t stored,
+			   size_t loaded, double est_us, double none_us);
+
 uint64_t intfiletype(const char *name);
 
 /* cbfs-mkpayload.c */
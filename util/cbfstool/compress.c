@@ -5,8 +5,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "common.h"
+#include <commonlib/endian.h>
 #include "lz4/lib/lz4frame.h"
 #include <commonlib/bsd/compression.h>
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
 
 static int lz4_compress(char *in, int in_len, char *out, int *out_len)
 {
@@ -50,6 +54,222 @@ static int lzma_decompress(char *in, int in_len, char *out, unused int out_len,
 {
 	return do_lzma_uncompress(out, out_len, in, in_len, actual_size);
 }
+
+typedef void (*bcj_func_ptr)(void *, size_t, int);
+
+/* Run the branch converter on a copy of the input before LZMA sees it. */
+static int lzma_bcj_compress(bcj_func_ptr bcj, char *in, int in_len,
+			     char *out, int *out_len)
+{
+	char *filtered = malloc(in_len);
+	int ret;
+
+	if (!filtered)
+		return -1;
+	memcpy(filtered, in, in_len);
+	bcj(filtered, in_len, 1);
+	ret = lzma_compress(filtered, in_len, out, out_len);
+	free(filtered);
+	return ret;
+}
+
+static int lzma_bcj_decompress(bcj_func_ptr bcj, char *in, int in_len,
+			       char *out, int out_len, size_t *actual_size)
+{
+	size_t size;
+
+	if (lzma_decompress(in, in_len, out, out_len, &size))
+		return -1;
+	bcj(out, size, 0);
+	if (actual_size != NULL)
+		*actual_size = size;
+	return 0;
+}
+
+static int lzma_bcj_x86_compress(char *in, int in_len, char *out, int *out_len)
+{
+	return lzma_bcj_compress(bcj_x86, in, in_len, out, out_len);
+}
+
+static int lzma_bcj_x86_decompress(char *in, int in_len, char *out,
+				   int out_len, size_t *actual_size)
+{
+	return lzma_bcj_decompress(bcj_x86, in, in_len, out, out_len,
+				   actual_size);
+}
+
+static int lzma_bcj_arm64_compress(char *in, int in_len, char *out,
+				   int *out_len)
+{
+	return lzma_bcj_compress(bcj_arm64, in, in_len, out, out_len);
+}
+
+static int lzma_bcj_arm64_decompress(char *in, int in_len, char *out,
+				     int out_len, size_t *actual_size)
+{
+	return lzma_bcj_decompress(bcj_arm64, in, in_len, out, out_len,
+				   actual_size);
+}
+#ifdef HAVE_LIBZSTD
+static int zstd_compress(char *in, int in_len, char *out, int *out_len)
+{
+	size_t worst_size = ZSTD_compressBound(in_len);
+	void *bounce = malloc(worst_size);
+	size_t len;
+
+	if (!bounce)
+		return -1;
+	len = ZSTD_compress(bounce, worst_size, in, in_len, ZSTD_maxCLevel());
+	if (ZSTD_isError(len) || len >= (size_t)in_len) {
+		free(bounce);
+		return -1;
+	}
+	memcpy(out, bounce, len);
+	*out_len = len;
+	free(bounce);
+	return 0;
+}
+#else
+static int zstd_compress(unused char *in, unused int in_len,
+			 unused char *out, unused int *out_len)
+{
+	ERROR("cbfstool was built without libzstd, cannot compress with it.\n");
+	return -1;
+}
+#endif
+
+static int zstd_decompress(char *in, int in_len, char *out, int out_len,
+			   size_t *actual_size)
+{
+	size_t result = uzstdn(in, in_len, out, out_len);
+	if (result == 0)
+		return -1;
+	if (actual_size != NULL)
+		*actual_size = result;
+	return 0;
+}
+
+/* Smallest chunk size for the chunked formats. It is doubled until the image
+   fits into CBFS_CHUNKED_MAX_CHUNKS chunks. Smaller chunks spread better over
+   many CPUs, larger ones compress better. */
+#define CHUNKED_MIN_CHUNK_SIZE (64 * KiB)
+
+static int chunked_compress(comp_func_ptr compress, char *in, int in_len,
+			    char *out, int *out_len)
+{
+	struct cbfs_chunked_header *hdr = (struct cbfs_chunked_header *)out;
+	size_t chunk_size = CHUNKED_MIN_CHUNK_SIZE;
+	size_t num_chunks, pos, i;
+	char *bounce;
+	int ret = -1;
+
+	if (in_len <= 0)
+		return -1;
+
+	while (DIV_ROUND_UP((size_t)in_len, chunk_size) > CBFS_CHUNKED_MAX_CHUNKS)
+		chunk_size *= 2;
+	num_chunks = DIV_ROUND_UP((size_t)in_len, chunk_size);
+
+	pos = sizeof(*hdr) + num_chunks * sizeof(uint32_t);
+	if (pos >= (size_t)in_len)
+		return -1;
+
+	bounce = malloc(chunk_size);
+	if (!bounce)
+		return -1;
+
+	for (i = 0; i < num_chunks; i++) {
+		int len = MIN(chunk_size, in_len - i * chunk_size);
+		int compressed_len;
+
+		if (compress(in + i * chunk_size, len, bounce, &compressed_len) ||
+		    compressed_len >= len ||
+		    pos + compressed_len >= (size_t)in_len)
+			goto out;
+
+		memcpy(out + pos, bounce, compressed_len);
+		write_be32(&hdr->compressed_size[i], compressed_len);
+		pos += compressed_len;
+	}
+
+	write_be32(&hdr->magic, CBFS_CHUNKED_MAGIC);
+	write_be32(&hdr->chunk_size, chunk_size);
+	write_be32(&hdr->num_chunks, num_chunks);
+	write_be32(&hdr->decompressed_size, in_len);
+	*out_len = pos;
+	ret = 0;
+out:
+	free(bounce);
+	return ret;
+}
+
+static int chunked_decompress(decomp_func_ptr decompress, char *in,
+			      int in_len, char *out, int out_len,
+			      size_t *actual_size)
+{
+	struct cbfs_chunked_header *hdr = (struct cbfs_chunked_header *)in;
+	size_t chunk_size, num_chunks, size, pos, i;
+
+	if ((size_t)in_len < sizeof(*hdr) ||
+	    read_be32(&hdr->magic) != CBFS_CHUNKED_MAGIC) {
+		ERROR("Chunked: Bad header.\n");
+		return -1;
+	}
+
+	chunk_size = read_be32(&hdr->chunk_size);
+	num_chunks = read_be32(&hdr->num_chunks);
+	size = read_be32(&hdr->decompressed_size);
+	pos = sizeof(*hdr) + num_chunks * sizeof(uint32_t);
+	if (chunk_size == 0 || num_chunks > CBFS_CHUNKED_MAX_CHUNKS ||
+	    DIV_ROUND_UP(size, chunk_size) != num_chunks ||
+	    pos > (size_t)in_len || size > (size_t)out_len) {
+		ERROR("Chunked: Bad header.\n");
+		return -1;
+	}
+
+	for (i = 0; i < num_chunks; i++) {
+		size_t compressed_len = read_be32(&hdr->compressed_size[i]);
+		size_t len = MIN(chunk_size, size - i * chunk_size);
+		size_t actual;
+
+		if (compressed_len > in_len - pos ||
+		    decompress(in + pos, compressed_len, out + i * chunk_size,
+			       len, &actual) || actual != len) {
+			ERROR("Chunked: Error in chunk %zu.\n", i);
+			return -1;
+		}
+		pos += compressed_len;
+	}
+
+	if (actual_size != NULL)
+		*actual_size = size;
+	return 0;
+}
+
+static int lzma_chunked_compress(char *in, int in_len, char *out, int *out_len)
+{
+	return chunked_compress(lzma_compress, in, in_len, out, out_len);
+}
+
+static int lzma_chunked_decompress(char *in, int in_len, char *out, int out_len,
+				   size_t *actual_size)
+{
+	return chunked_decompress(lzma_decompress, in, in_len, out, out_len,
+				  actual_size);
+}
+
+static int lz4_chunked_compress(char *in, int in_len, char *out, int *out_len)
+{
+	return chunked_compress(lz4_compress, in, in_len, out, out_len);
+}
+
+static int lz4_chunked_decompress(char *in, int in_len, char *out, int out_len,
+				  size_t *actual_size)
+{
+	return chunked_decompress(lz4_decompress, in, in_len, out, out_len,
+				  actual_size);
+}
+
 static int none_compress(char *in, int in_len, char *out, int *out_len)
 {
 	memcpy(out, in, in_len);
@@ -79,6 +299,21 @@ comp_func_ptr compression_function(enum cbfs_compression algo)
 	case CBFS_COMPRESS_LZ4:
 		compress = lz4_compress;
 		break;
+	case CBFS_COMPRESS_LZMA_CHUNKED:
+		compress = lzma_chunked_compress;
+		break;
+	case CBFS_COMPRESS_LZ4_CHUNKED:
+		compress = lz4_chunked_compress;
+		break;
+	case CBFS_COMPRESS_ZSTD:
+		compress = zstd_compress;
+		break;
+	case CBFS_COMPRESS_LZMA_BCJ_X86:
+		compress = lzma_bcj_x86_compress;
+		break;
+	case CBFS_COMPRESS_LZMA_BCJ_ARM64:
+		compress = lzma_bcj_arm64_compress;
+		break;
 	default:
 		ERROR("Unknown compression algorithm %d!\n", algo);
 		return NULL;
@@ -99,6 +334,21 @@ decomp_func_ptr decompression_function(enum cbfs_compression algo)
 	case CBFS_COMPRESS_LZ4:
 		decompress = lz4_decompress;
 		break;
+	case CBFS_COMPRESS_LZMA_CHUNKED:
+		decompress = lzma_chunked_decompress;
+		break;
+	case CBFS_COMPRESS_LZ4_CHUNKED:
+		decompress = lz4_chunked_decompress;
+		break;
+	case CBFS_COMPRESS_ZSTD:
+		decompress = zstd_decompress;
+		break;
+	case CBFS_COMPRESS_LZMA_BCJ_X86:
+		decompress = lzma_bcj_x86_decompress;
+		break;
+	case CBFS_COMPRESS_LZMA_BCJ_ARM64:
+		decompress = lzma_bcj_arm64_decompress;
+		break;
 	default:
 		ERROR("Unknown compression algorithm %d!\n", algo);
 		return NULL;
@@ -0,0 +1,194 @@
+/* boot time based compression selection for cbfstool */
+/* SPDX-License-Identifier: GPL-2.0-only */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "common.h"
+#include "cbfs.h"
+#include "cbfs_image.h"
+
+/*
+ * Defaults for a typical SPI flash behind a not memory mapped controller and
+ * a CPU in the low GHz range. Real boards should pass their own numbers.
+ */
+#define DEFAULT_FLASH_MBPS	20.0
+#define DEFAULT_LZ4_MBPS	400.0
+#define DEFAULT_LZMA_MBPS	40.0
+
+void compression_profile_default(struct compression_profile *profile)
+{
+	memset(profile, 0, sizeof(*profile));
+	profile->flash_mbps = DEFAULT_FLASH_MBPS;
+	profile->decomp_mbps[CBFS_COMPRESS_LZ4] = DEFAULT_LZ4_MBPS;
+	profile->decomp_mbps[CBFS_COMPRESS_LZMA] = DEFAULT_LZMA_MBPS;
+}
+
+/*
+ * The profile is a comma separated list of KEY=MB/s pairs. KEY is either
+ * "flash" for the read bandwidth of the boot medium or a compression
+ * algorithm name for its decompression throughput (measured on the output).
+ * Only the algorithms listed are candidates, "none" always is one.
+ */
+int compression_profile_parse(struct compression_profile *profile,
+			      const char *spec)
+{
+	char *copy, *save, *tok;
+	int ret = -1;
+
+	memset(profile, 0, sizeof(*profile));
+	profile->flash_mbps = DEFAULT_FLASH_MBPS;
+
+	copy = strdup(spec);
+	if (!copy)
+		return -1;
+
+	for (tok = strtok_r(copy, ",", &save); tok;
+	     tok = strtok_r(NULL, ",", &save)) {
+		char *value = strchr(tok, '=');
+		char *end;
+		double mbps;
+		int algo;
+
+		if (!value) {
+			ERROR("Profile entry '%s' is not KEY=MB/s.\n", tok);
+			goto out;
+		}
+		*value++ = '\0';
+
+		mbps = strtod(value, &end);
+		if (*end != '\0' || !(mbps > 0)) {
+			ERROR("Invalid throughput '%s' for '%s'.\n", value, tok);
+			goto out;
+		}
+
+		if (strcasecmp(tok, "flash") == 0) {
+			profile->flash_mbps = mbps;
+			continue;
+		}
+
+		algo = cbfs_parse_comp_algo(tok);
+		if (algo < 0 || algo >= COMPRESSION_PROFILE_ALGOS) {
+			ERROR("Unknown compression '%s' in profile.\n", tok);
+			goto out;
+		}
+		profile->decomp_mbps[algo] = mbps;
+	}
+	ret = 0;
+out:
+	free(copy);
+	return ret;
+}
+
+bool compression_profile_candidate(const struct compression_profile *profile,
+				   enum cbfs_compression algo)
+{
+	if (algo == CBFS_COMPRESS_NONE)
+		return true;
+	return algo < COMPRESSION_PROFILE_ALGOS &&
+		profile->decomp_mbps[algo] > 0;
+}
+
+double compression_estimate_us(const struct compression_profile *profile,
+			       enum cbfs_compression algo, size_t stored,
+			       size_t loaded)
+{
+	/* 1 MB/s moves one byte per microsecond. */
+	double us = stored / profile->flash_mbps;
+
+	if (algo != CBFS_COMPRESS_NONE)
+		us += loaded / profile->decomp_mbps[algo];
+	return us;
+}
+
+const char *compression_algo_name(enum cbfs_compression algo)
+{
+	const struct typedesc_t *desc;
+
+	for (desc = types_cbfs_compression; desc->name; desc++)
+		if (desc->type == algo)
+			return desc->name;
+	return "(unknown)";
+}
+
+#define REPORT_TOTAL "total"
+
+/*
+ * The report has one line per file and a running total at the end, so that a
+ * sequence of cbfstool invocations sharing a report file describes the whole
+ * image. The total line is recomputed every time a file is added.
+ */
+int compression_report_add(const char *path, const char *name,
+			   enum cbfs_compression algo, size_t stored,
+			   size_t loaded, double est_us, double none_us)
+{
+	static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+	char *line = NULL, *lines = NULL;
+	size_t line_size = 0, lines_len = 0;
+	unsigned long long total_stored = stored, total_loaded = loaded;
+	double total_est = est_us, total_none = none_us;
+	FILE *f;
+	int ret = -1;
+
+	pthread_mutex_lock(&lock);
+
+	/* Keep all per-file lines, drop the old header and total. */
+	f = fopen(path, "r");
+	if (f) {
+		while (getline(&line, &line_size, f) != -1) {
+			char entry[256], algo_name[32];
+			unsigned long long s, l;
+			double e, n;
+			size_t len = strlen(line);
+			char *tmp;
+
+			if (line[0] == '#' ||
+			    sscanf(line, "%255s %31s %llu %llu %lf %lf", entry,
+				   algo_name, &s, &l, &e, &n) != 6 ||
+			    strcmp(entry, REPORT_TOTAL) == 0)
+				continue;
+
+			total_stored += s;
+			total_loaded += l;
+			total_est += e;
+			total_none += n;
+
+			tmp = realloc(lines, lines_len + len + 1);
+			if (!tmp) {
+				fclose(f);
+				goto out;
+			}
+			lines = tmp;
+			memcpy(lines + lines_len, line, len + 1);
+			lines_len += len;
+		}
+		fclose(f);
+	}
+
+	f = fopen(path, "w");
+	if (!f) {
+		ERROR("Could not write compression report '%s'.\n", path);
+		goto out;
+	}
+	fprintf(f, "# %-30s %-14s %10s %10s %12s %12s\n", "name",
+		"compression", "stored", "loaded", "est_us", "none_us");
+	if (lines)
+		fputs(lines, f);
+	fprintf(f, "%-32s %-14s %10zu %10zu %12.1f %12.1f\n", name,
+		compression_algo_name(algo), stored, loaded, est_us, none_us);
+	fprintf(f, "%-32s %-14s %10llu %10llu %12.1f %12.1f\n", REPORT_TOTAL,
+		"-", total_stored, total_loaded, total_est, total_none);
+	fprintf(f, "# estimated savings: %.1f us (%.1f%%), %lld bytes of flash\n",
+		total_none - total_est,
+		total_none > 0 ? 100 * (total_none - total_est) / total_none : 0,
+		(long long)(total_loaded - total_stored));
+	ret = fclose(f) ? -1 : 0;
+out:
+	pthread_mutex_unlock(&lock);
+	free(line);
+	free(lines);
+	return ret;
+}
@@ -17,9 +17,16 @@
 #include <libgen.h>
 #include <assert.h>
 #include <regex.h>
+#include <elf.h>
 #include <commonlib/cbmem_id.h>
+#include <commonlib/console_deferred_serialized.h>
 #include <commonlib/timestamp_serialized.h>
 #include <commonlib/tcpa_log_serialized.h>
+#include <commonlib/cbfs_access_trace_serialized.h>
+#include <commonlib/memtest_serialized.h>
+#include <commonlib/dev_timing_serialized.h>
+#include <commonlib/function_trace_serialized.h>
+#include <commonlib/profile_serialized.h>
 #include <commonlib/coreboot_tables.h>
 
 #ifdef __OpenBSD__
@@ -529,11 +536,24 @@ static void print_norm(u64 v)
 
 static const char *timestamp_name(uint32_t id)
 {
+	static char name[80];
+	const char *base = "<unknown>";
+	uint32_t cpu = id >> TIMESTAMP_CPU_SHIFT;
+
+	id &= TIMESTAMP_ID_MASK;
 	for (size_t i = 0; i < ARRAY_SIZE(timestamp_ids); i++) {
-		if (timestamp_ids[i].id == id)
-			return timestamp_ids[i].name;
+		if (timestamp_ids[i].id == id) {
+			base = timestamp_ids[i].name;
+			break;
+		}
 	}
-	return "<unknown>";
+
+	if (!cpu)
+		return base;
+
+	/* Entries recorded on an application processor. */
+	snprintf(name, sizeof(name), "%s (CPU %u)", base, cpu);
+	return name;
 }
 
 static uint64_t timestamp_print_parseable_entry(uint32_t id, uint64_t stamp,
@@ -547,7 +567,7 @@ static uint64_t timestamp_print_parseable_entry(uint32_t id, uint64_t stamp,
 	step_time = arch_convert_raw_ts_entry(stamp - prev_stamp);
 
 	/* ID<tab>absolute time<tab>relative time<tab>description */
-	printf("%d\t", id);
+	printf("%d\t", id & TIMESTAMP_ID_MASK);
 	printf("%llu\t", (long long)arch_convert_raw_ts_entry(stamp));
 	printf("%llu\t", (long long)step_time);
 	printf("%s\n", name);
@@ -562,7 +582,7 @@ static uint64_t timestamp_print_entry(uint32_t id, uint64_t stamp, uint64_t prev
 
 	name = timestamp_name(id);
 
-	printf("%4d:", id);
+	printf("%4d:", id & TIMESTAMP_ID_MASK);
 	printf("%-50s", name);
 	print_norm(arch_convert_raw_ts_entry(stamp));
 	step_time = arch_convert_raw_ts_entry(stamp - prev_stamp);
@@ -589,19 +609,20 @@ static int compare_timestamp_entries(const void *a, const void *b)
 	return 0;
 }
 
-/* dump the timestamp table */
-static void dump_timestamps(int mach_readable)
+/*
+ * Map the timestamp table and return a copy sorted by time, which the caller
+ * has to free. The tick frequency is set up as a side effect.
+ */
+static struct timestamp_table *read_sorted_timestamps(void)
 {
 	const struct timestamp_table *tst_p;
 	struct timestamp_table *sorted_tst_p;
 	size_t size;
-	uint64_t prev_stamp;
-	uint64_t total_time;
 	struct mapping timestamp_mapping;
 
 	if (timestamps.tag != LB_TAG_TIMESTAMPS) {
 		fprintf(stderr, "No timestamps found in coreboot table.\n");
-		return;
+		return NULL;
 	}
 
 	size = sizeof(*tst_p);
@@ -611,8 +632,6 @@ static void dump_timestamps(int mach_readable)
 
 	timestamp_set_tick_freq(tst_p->tick_freq_mhz);
 
-	if (!mach_readable)
-		printf("%d entries total:\n\n", tst_p->num_entries);
 	size += tst_p->num_entries * sizeof(tst_p->entries[0]);
 
 	unmap_memory(&timestamp_mapping);
@@ -621,15 +640,6 @@ static void dump_timestamps(int mach_readable)
 	if (!tst_p)
 		die("Unable to map full timestamp table\n");
 
-	/* Report the base time within the table. */
-	prev_stamp = 0;
-	if (mach_readable)
-		timestamp_print_parseable_entry(0,  tst_p->base_time,
-						prev_stamp);
-	else
-		timestamp_print_entry(0,  tst_p->base_time, prev_stamp);
-	prev_stamp = tst_p->base_time;
-
 	sorted_tst_p = malloc(size);
 	if (!sorted_tst_p)
 		die("Failed to allocate memory");
@@ -638,6 +648,34 @@ static void dump_timestamps(int mach_readable)
 	qsort(&sorted_tst_p->entries[0], sorted_tst_p->num_entries,
 	      sizeof(struct timestamp_entry), compare_timestamp_entries);
 
+	unmap_memory(&timestamp_mapping);
+
+	return sorted_tst_p;
+}
+
+/* dump the timestamp table */
+static void dump_timestamps(int mach_readable)
+{
+	struct timestamp_table *sorted_tst_p;
+	uint64_t prev_stamp;
+	uint64_t total_time;
+
+	sorted_tst_p = read_sorted_timestamps();
+	if (!sorted_tst_p)
+		return;
+
+	if (!mach_readable)
+		printf("%d entries total:\n\n", sorted_tst_p->num_entries);
+
+	/* Report the base time within the table. */
+	prev_stamp = 0;
+	if (mach_readable)
+		timestamp_print_parseable_entry(0,  sorted_tst_p->base_time,
+						prev_stamp);
+	else
+		timestamp_print_entry(0,  sorted_tst_p->base_time, prev_stamp);
+	prev_stamp = sorted_tst_p->base_time;
+
 	total_time = 0;
 	for (uint32_t i = 0; i < sorted_tst_p->num_entries; i++) {
 		uint64_t stamp;
@@ -661,10 +699,170 @@ static void dump_timestamps(int mach_readable)
 		printf("\n");
 	}
 
-	unmap_memory(&timestamp_mapping);
 	free(sorted_tst_p);
 }
 
+/*
+ * Timestamp pairs that are exported as duration slices. The end of a slice is
+ * the first entry with the end ID recorded after the start on the same CPU.
+ * Slices nest naturally, for example decompression within loading a stage.
+ */
+static const struct {
+	uint32_t start;
+	uint32_t end;
+	const char *name;
+} timestamp_slices[] = {
+	{ TS_START_BOOTBLOCK, TS_END_BOOTBLOCK, "bootblock" },
+	{ TS_START_VBOOT, TS_END_VBOOT, "verstage" },
+	{ TS_START_ROMSTAGE, TS_END_ROMSTAGE, "romstage" },
+	{ TS_START_POSTCAR, TS_END_POSTCAR, "postcar" },
+	{ TS_START_RAMSTAGE, TS_SELFBOOT_JUMP, "ramstage" },
+	{ TS_START_RAMSTAGE, TS_ACPI_WAKE_JUMP, "ramstage" },
+	{ TS_START_COPYVER, TS_END_COPYVER, "load verstage" },
+	{ TS_START_COPYROM, TS_END_COPYROM, "load romstage" },
+	{ TS_START_COPYRAM, TS_END_COPYRAM, "load ramstage" },
+	{ TS_START_ULZMA, TS_END_ULZMA, "LZMA decompress" },
+	{ TS_START_ULZ4F, TS_END_ULZ4F, "LZ4 decompress" },
+	{ TS_START_UZSTD, TS_END_UZSTD, "Zstandard decompress" },
+	{ TS_BEFORE_INITRAM, TS_AFTER_INITRAM, "RAM initialization" },
+	{ TS_DEVICE_ENUMERATE, TS_DEVICE_CONFIGURE, "device enumeration" },
+	{ TS_DEVICE_CONFIGURE, TS_DEVICE_ENABLE, "device configuration" },
+	{ TS_DEVICE_ENABLE, TS_DEVICE_INITIALIZE, "device enable" },
+	{ TS_DEVICE_INITIALIZE, TS_DEVICE_DONE, "device initialization" },
+	{ TS_OPROM_INITIALIZE, TS_OPROM_END, "Option ROM" },
+	{ TS_WRITE_TABLES, TS_FINALIZE_CHIPS, "write tables" },
+	{ TS_LOAD_PAYLOAD, TS_SELFBOOT_JUMP, "load payload" },
+	{ TS_DELAY_START, TS_DELAY_END, "delay" },
+	{ TS_MEMORY_CLEAR_START, TS_MEMORY_CLEAR_END, "DRAM clear" },
+	{ TS_MEMTEST_START, TS_MEMTEST_END, "DRAM test" },
+	{ TS_START_TPMINIT, TS_END_TPMINIT, "TPM init" },
+	{ TS_START_VERIFY_SLOT, TS_END_VERIFY_SLOT, "verify slot" },
+	{ TS_START_HASH_BODY, TS_END_HASH_BODY, "hash body" },
+	{ TS_START_TPMPCR, TS_END_TPMPCR, "TPM PCR extend" },
+	{ TS_START_TPMLOCK, TS_END_TPMLOCK, "TPM lock" },
+	{ TS_START_EC_SYNC, TS_END_EC_SYNC, "EC sync" },
+	{ TS_START_COPYVPD, TS_END_COPYVPD_RW, "copy VPD" },
+	{ TS_AGESA_INIT_RESET_START, TS_AGESA_INIT_RESET_DONE, "AGESA InitReset" },
+	{ TS_AGESA_INIT_EARLY_START, TS_AGESA_INIT_EARLY_DONE, "AGESA InitEarly" },
+	{ TS_AGESA_INIT_POST_START, TS_AGESA_INIT_POST_DONE, "AGESA InitPost" },
+	{ TS_AGESA_INIT_ENV_START, TS_AGESA_INIT_ENV_DONE, "AGESA InitEnv" },
+	{ TS_AGESA_INIT_MID_START, TS_AGESA_INIT_MID_DONE, "AGESA InitMid" },
+	{ TS_AGESA_INIT_LATE_START, TS_AGESA_INIT_LATE_DONE, "AGESA InitLate" },
+	{ TS_AGESA_INIT_RTB_START, TS_AGESA_INIT_RTB_DONE, "AGESA InitRtb" },
+	{ TS_AGESA_INIT_RESUME_START, TS_AGESA_INIT_RESUME_DONE, "AGESA InitResume" },
+	{ TS_AGESA_S3_LATE_START, TS_AGESA_S3_LATE_DONE, "AGESA S3LateRestore" },
+	{ TS_AGESA_S3_FINAL_START, TS_AGESA_S3_FINAL_DONE, "AGESA S3FinalRestore" },
+	{ TS_ME_INFORM_DRAM_WAIT, TS_ME_INFORM_DRAM_DONE, "ME DRAM wait" },
+	{ TS_FSP_MEMORY_INIT_START, TS_FSP_MEMORY_INIT_END, "FspMemoryInit" },
+	{ TS_FSP_TEMP_RAM_EXIT_START, TS_FSP_TEMP_RAM_EXIT_END, "FspTempRamExit" },
+	{ TS_FSP_SILICON_INIT_START, TS_FSP_SILICON_INIT_END, "FspSiliconInit" },
+	{ TS_FSP_MULTI_PHASE_SI_INIT_START, TS_FSP_MULTI_PHASE_SI_INIT_END,
+		"FspMultiPhaseSiInit" },
+	{ TS_FSP_BEFORE_ENUMERATE, TS_FSP_AFTER_ENUMERATE,
+		"FspNotify(AfterPciEnumeration)" },
+	{ TS_FSP_BEFORE_FINALIZE, TS_FSP_AFTER_FINALIZE, "FspNotify(ReadyToBoot)" },
+	{ TS_FSP_BEFORE_END_OF_FIRMWARE, TS_FSP_AFTER_END_OF_FIRMWARE,
+		"FspNotify(EndOfFirmware)" },
+};
+
+static void print_json_string(const char *str)
+{
+	putchar('"');
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\')
+			printf("\\%c", *str);
+		else if ((unsigned char)*str < 0x20)
+			printf("\\u%04x", *str);
+		else
+			putchar(*str);
+	}
+	putchar('"');
+}
+
+static void print_trace_event(const char *name, char phase, uint32_t cpu, uint64_t ts,
+			      uint64_t dur, uint32_t id)
+{
+	printf(",\n  {\"name\": ");
+	print_json_string(name);
+	printf(", \"cat\": \"coreboot\", \"ph\": \"%c\", \"pid\": 0, \"tid\": %u, "
+	       "\"ts\": %llu", phase, cpu, (unsigned long long)ts);
+	if (phase == 'X')
+		printf(", \"dur\": %llu", (unsigned long long)dur);
+	else
+		printf(", \"s\": \"t\"");
+	printf(", \"args\": {\"id\": %u}}", id);
+}
+
+/* Export the timestamps in the Chrome trace event format, in microseconds. */
+static void dump_timestamps_trace(void)
+{
+	struct timestamp_table *tst;
+	uint8_t *paired;
+	uint32_t max_cpu = 0;
+
+	tst = read_sorted_timestamps();
+	if (!tst)
+		return;
+
+	paired = calloc(tst->num_entries ? tst->num_entries : 1, 1);
+	if (!paired)
+		die("Failed to allocate memory");
+
+	printf("{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+	printf("\n  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, "
+	       "\"args\": {\"name\": \"coreboot\"}}");
+
+	for (uint32_t i = 0; i < tst->num_entries; i++) {
+		const struct timestamp_entry *start = &tst->entries[i];
+		uint32_t cpu = start->entry_id >> TIMESTAMP_CPU_SHIFT;
+		uint32_t id = start->entry_id & TIMESTAMP_ID_MASK;
+
+		if (cpu > max_cpu)
+			max_cpu = cpu;
+
+		for (size_t k = 0; k < ARRAY_SIZE(timestamp_slices); k++) {
+			uint32_t end_id = timestamp_slices[k].end | cpu << TIMESTAMP_CPU_SHIFT;
+			uint32_t j;
+
+			if (timestamp_slices[k].start != id)
+				continue;
+
+			for (j = i + 1; j < tst->num_entries; j++)
+				if (tst->entries[j].entry_id == end_id)
+					break;
+			if (j == tst->num_entries)
+				continue;
+
+			print_trace_event(timestamp_slices[k].name, 'X', cpu,
+				arch_convert_raw_ts_entry(start->entry_stamp + tst->base_time),
+				arch_convert_raw_ts_entry(tst->entries[j].entry_stamp -
+							  start->entry_stamp),
+				id);
+			paired[i] = paired[j] = 1;
+		}
+	}
+
+	/* Everything that isn't part of a slice shows up as an instant. */
+	for (uint32_t i = 0; i < tst->num_entries; i++) {
+		const struct timestamp_entry *tse = &tst->entries[i];
+
+		if (paired[i])
+			continue;
+		print_trace_event(timestamp_name(tse->entry_id & TIMESTAMP_ID_MASK), 'i',
+			tse->entry_id >> TIMESTAMP_CPU_SHIFT,
+			arch_convert_raw_ts_entry(tse->entry_stamp + tst->base_time), 0,
+			tse->entry_id & TIMESTAMP_ID_MASK);
+	}
+
+	for (uint32_t cpu = 0; cpu <= max_cpu; cpu++)
+		printf(",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, "
+		       "\"tid\": %u, \"args\": {\"name\": \"CPU %u\"}}", cpu, cpu);
+	printf("\n]}\n");
+
+	free(paired);
+	free(tst);
+}
+
 /* dump the tcpa log table */
 static void dump_tcpa_log(void)
 {
@@ -706,6 +904,1087 @@ static void dump_tcpa_log(void)
 	unmap_memory(&tcpa_mapping);
 }
 
+struct dev_timing_summary {
+	const char *name;
+	uint64_t total;
+	/* Indexed by enum dev_timing_op */
+	uint64_t op_usecs[DEV_TIMING_FINAL + 1];
+};
+
+static int compare_dev_timing_summaries(const void *a, const void *b)
+{
+	const struct dev_timing_summary *sa = a;
+	const struct dev_timing_summary *sb = b;
+
+	if (sa->total < sb->total)
+		return 1;
+	else if (sa->total > sb->total)
+		return -1;
+
+	return strcmp(sa->name, sb->name);
+}
+
+/* dump the device timing table, slowest devices first */
+static void dump_dev_timing(void)
+{
+	static const char *const bs_phase[] = { "entry", "run", "exit" };
+	const struct dev_timing_table *dtt_p;
+	struct dev_timing_summary *summary;
+	struct mapping dev_timing_mapping;
+	size_t num_devs = 0;
+	uint64_t addr;
+	size_t size;
+
+	if (find_cbmem_entry(CBMEM_ID_DEV_TIMING, &addr, &size)) {
+		fprintf(stderr, "No device timing found in coreboot table.\n");
+		return;
+	}
+
+	dtt_p = map_memory(&dev_timing_mapping, addr, size);
+	if (!dtt_p)
+		die("Unable to map device timing table\n");
+
+	if (sizeof(*dtt_p) + dtt_p->num_entries * sizeof(dtt_p->entries[0]) > size)
+		die("Device timing table is corrupted\n");
+
+	summary = calloc(dtt_p->num_entries, sizeof(*summary));
+	if (dtt_p->num_entries && !summary)
+		die("Out of memory\n");
+
+	for (uint32_t i = 0; i < dtt_p->num_entries; i++) {
+		const struct dev_timing_entry *dte = &dtt_p->entries[i];
+		size_t j;
+
+		if (dte->op > DEV_TIMING_FINAL)
+			continue;
+
+		for (j = 0; j < num_devs; j++)
+			if (!strncmp(summary[j].name, dte->name,
+				     sizeof(dte->name)))
+				break;
+		if (j == num_devs) {
+			summary[j].name = strndup(dte->name, sizeof(dte->name));
+			if (!summary[j].name)
+				die("Out of memory\n");
+			num_devs++;
+		}
+		summary[j].op_usecs[dte->op] += dte->duration_usecs;
+		summary[j].total += dte->duration_usecs;
+	}
+
+	qsort(summary, num_devs, sizeof(*summary), compare_dev_timing_summaries);
+
+	printf("Slowest devices (usecs):\n\n");
+	printf("%-32s %10s %10s %10s %10s %10s %10s\n", "device", "total",
+	       "read_res", "set_res", "enable_res", "init", "final");
+	for (size_t j = 0; j < num_devs; j++) {
+		printf("%-32s %10" PRIu64, summary[j].name, summary[j].total);
+		for (int op = DEV_TIMING_READ_RESOURCES; op <= DEV_TIMING_FINAL; op++)
+			printf(" %10" PRIu64, summary[j].op_usecs[op]);
+		printf("\n");
+		free((void *)summary[j].name);
+	}
+	free(summary);
+
+	printf("\nBoot states (usecs):\n\n");
+	for (uint32_t i = 0; i < dtt_p->num_entries; i++) {
+		const struct dev_timing_entry *dte = &dtt_p->entries[i];
+
+		if (dte->op < DEV_TIMING_BS_ENTRY || dte->op > DEV_TIMING_BS_EXIT)
+			continue;
+
+		printf("%-32.*s %-5s %10u\n", (int)sizeof(dte->name), dte->name,
+		       bs_phase[dte->op - DEV_TIMING_BS_ENTRY],
+		       dte->duration_usecs);
+	}
+
+	if (dtt_p->dropped)
+		printf("\n%u records did not fit into the table.\n",
+		       dtt_p->dropped);
+
+	unmap_memory(&dev_timing_mapping);
+}
+
+/* print the CBFS files looked up during boot, in order of first lookup */
+static void dump_cbfs_access(void)
+{
+	const struct cbfs_access_trace *cat_p;
+	struct mapping cbfs_access_mapping;
+	uint64_t addr;
+	size_t size;
+
+	if (find_cbmem_entry(CBMEM_ID_CBFS_ACCESS, &addr, &size)) {
+		fprintf(stderr, "No CBFS access trace found in coreboot table.\n");
+		return;
+	}
+
+	cat_p = map_memory(&cbfs_access_mapping, addr, size);
+	if (!cat_p)
+		die("Unable to map CBFS access trace\n");
+
+	if (cat_p->used > cat_p->size ||
+	    sizeof(*cat_p) + cat_p->used > size ||
+	    (cat_p->used && cat_p->names[cat_p->used - 1] != '\0'))
+		die("CBFS access trace is corrupted\n");
+
+	for (uint32_t i = 0; i < cat_p->used; i += strlen(&cat_p->names[i]) + 1)
+		printf("%s\n", &cat_p->names[i]);
+
+	if (cat_p->dropped)
+		fprintf(stderr, "%u names did not fit into the trace.\n",
+			cat_p->dropped);
+
+	unmap_memory(&cbfs_access_mapping);
+}
+
+/* print the result of the ramstage DRAM test */
+static void dump_memtest(void)
+{
+	const struct memtest_result *mt_p;
+	struct mapping memtest_mapping;
+	uint64_t addr;
+	size_t size;
+
+	if (find_cbmem_entry(CBMEM_ID_MEMTEST, &addr, &size)) {
+		fprintf(stderr, "No DRAM test result found in coreboot table.\n");
+		return;
+	}
+
+	mt_p = map_memory(&memtest_mapping, addr, size);
+	if (!mt_p)
+		die("Unable to map DRAM test result\n");
+
+	if (size < sizeof(*mt_p) ||
+	    sizeof(*mt_p) + mt_p->num_entries * sizeof(mt_p->entries[0]) > size)
+		die("DRAM test result is corrupted\n");
+
+	printf("Tested %" PRIu64 " MiB in %u ms", mt_p->tested >> 20,
+	       mt_p->duration_us / 1000);
+	if (mt_p->duration_us)
+		printf(", %" PRIu64 " MiB/s memory traffic",
+		       (mt_p->tested >> 20) * mt_p->passes * 1000000 /
+		       mt_p->duration_us);
+	printf("\n");
+	if (mt_p->skipped)
+		printf("%" PRIu64 " MiB not tested\n", mt_p->skipped >> 20);
+
+	printf("%u errors\n", mt_p->errors);
+	for (uint32_t i = 0; i < mt_p->num_entries; i++)
+		printf("%016" PRIx64 ": expected %016" PRIx64
+		       ", got %016" PRIx64 "\n", mt_p->entries[i].addr,
+		       mt_p->entries[i].expected, mt_p->entries[i].actual);
+	if (mt_p->errors > mt_p->num_entries)
+		printf("%u more not recorded\n",
+		       mt_p->errors - mt_p->num_entries);
+
+	unmap_memory(&memtest_mapping);
+}
+
+/*
+ * Stage ELF files used to decode console messages that were stored in binary
+ * form, see commonlib/console_deferred_serialized.h.
+ */
+struct console_elf {
+	uint8_t *data;
+	size_t size;
+	int is_64;
+	uint64_t program;	/* Address of the _program symbol */
+};
+
+static const char *const deferred_stage_names[CBMEMC_DEFERRED_STAGE_MAX] = {
+	[CBMEMC_DEFERRED_BOOTBLOCK] = "bootblock",
+	[CBMEMC_DEFERRED_VERSTAGE] = "verstage",
+	[CBMEMC_DEFERRED_ROMSTAGE] = "romstage",
+	[CBMEMC_DEFERRED_POSTCAR] = "postcar",
+	[CBMEMC_DEFERRED_RAMSTAGE] = "ramstage",
+};
+
+static struct console_elf console_elfs[CBMEMC_DEFERRED_STAGE_MAX];
+static unsigned int deferred_undecoded;
+
+struct elf_section {
+	uint32_t type;
+	uint64_t flags;
+	uint64_t addr;
+	uint64_t offset;
+	uint64_t size;
+	uint32_t link;
+};
+
+static int elf_get_section(const struct console_elf *elf, unsigned int idx,
+			   struct elf_section *sec)
+{
+	if (elf->is_64) {
+		const Elf64_Ehdr *ehdr = (const Elf64_Ehdr *)elf->data;
+		const Elf64_Shdr *shdr;
+
+		if (idx >= ehdr->e_shnum ||
+		    ehdr->e_shoff + (idx + 1) * sizeof(*shdr) > elf->size)
+			return -1;
+		shdr = (const Elf64_Shdr *)(elf->data + ehdr->e_shoff) + idx;
+		sec->type = shdr->sh_type;
+		sec->flags = shdr->sh_flags;
+		sec->addr = shdr->sh_addr;
+		sec->offset = shdr->sh_offset;
+		sec->size = shdr->sh_size;
+		sec->link = shdr->sh_link;
+	} else {
+		const Elf32_Ehdr *ehdr = (const Elf32_Ehdr *)elf->data;
+		const Elf32_Shdr *shdr;
+
+		if (idx >= ehdr->e_shnum ||
+		    ehdr->e_shoff + (idx + 1) * sizeof(*shdr) > elf->size)
+			return -1;
+		shdr = (const Elf32_Shdr *)(elf->data + ehdr->e_shoff) + idx;
+		sec->type = shdr->sh_type;
+		sec->flags = shdr->sh_flags;
+		sec->addr = shdr->sh_addr;
+		sec->offset = shdr->sh_offset;
+		sec->size = shdr->sh_size;
+		sec->link = shdr->sh_link;
+	}
+
+	if (sec->type != SHT_NOBITS && sec->offset + sec->size > elf->size)
+		return -1;
+
+	return 0;
+}
+
+/* Return the value of the named symbol, or -1 if it can't be found. */
+static int elf_find_symbol(const struct console_elf *elf, const char *name,
+			   uint64_t *value)
+{
+	struct elf_section symtab, strtab;
+	size_t entsize = elf->is_64 ? sizeof(Elf64_Sym) : sizeof(Elf32_Sym);
+
+	for (unsigned int i = 0; !elf_get_section(elf, i, &symtab); i++) {
+		if (symtab.type != SHT_SYMTAB ||
+		    elf_get_section(elf, symtab.link, &strtab))
+			continue;
+
+		for (size_t off = 0; off + entsize <= symtab.size; off += entsize) {
+			const uint8_t *sym = elf->data + symtab.offset + off;
+			uint32_t sym_name;
+			uint64_t sym_value;
+
+			if (elf->is_64) {
+				sym_name = ((const Elf64_Sym *)sym)->st_name;
+				sym_value = ((const Elf64_Sym *)sym)->st_value;
+			} else {
+				sym_name = ((const Elf32_Sym *)sym)->st_name;
+				sym_value = ((const Elf32_Sym *)sym)->st_value;
+			}
+
+			if (sym_name >= strtab.size ||
+			    strncmp((const char *)elf->data + strtab.offset + sym_name,
+				    name, strtab.size - sym_name))
+				continue;
+
+			*value = sym_value;
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+/* Return the NUL terminated string at the given address in the ELF file. */
+static const char *elf_string(const struct console_elf *elf, uint64_t addr)
+{
+	struct elf_section sec;
+
+	for (unsigned int i = 0; !elf_get_section(elf, i, &sec); i++) {
+		const char *s;
+
+		if (!(sec.flags & SHF_ALLOC) || sec.type == SHT_NOBITS ||
+		    addr < sec.addr || addr >= sec.addr + sec.size)
+			continue;
+
+		s = (const char *)elf->data + sec.offset + (addr - sec.addr);
+		if (!memchr(s, '\0', sec.addr + sec.size - addr))
+			return NULL;
+		return s;
+	}
+
+	return NULL;
+}
+
+/*
+ * Load the ELF file of a stage. The stage is given as "STAGE=FILE" or taken
+ * from the start of the file name, like "ramstage.debug".
+ */
+static void load_console_elf(const char *arg)
+{
+	const char *path = arg, *eq = strchr(arg, '=');
+	struct console_elf *elf;
+	char *name;
+	FILE *f;
+	long size;
+	int stage;
+
+	name = strdup(arg);
+	if (!name)
+		die("Not enough memory for ELF file name.\n");
+	if (eq) {
+		name[eq - arg] = '\0';
+		path = eq + 1;
+	}
+
+	for (stage = 1; stage < CBMEMC_DEFERRED_STAGE_MAX; stage++) {
+		const char *s = deferred_stage_names[stage];
+
+		if (eq ? !strcmp(name, s) :
+			 !strncmp(basename(name), s, strlen(s)))
+			break;
+	}
+	free(name);
+	if (stage == CBMEMC_DEFERRED_STAGE_MAX) {
+		fprintf(stderr, "Can't tell which stage %s belongs to, "
+			"use STAGE=FILE.\n", arg);
+		exit(1);
+	}
+
+	elf = &console_elfs[stage];
+	f = fopen(path, "rb");
+	if (!f) {
+		perror(path);
+		exit(1);
+	}
+	if (fseek(f, 0, SEEK_END) || (size = ftell(f)) < 0 ||
+	    fseek(f, 0, SEEK_SET)) {
+		perror(path);
+		exit(1);
+	}
+	free(elf->data);
+	elf->size = size;
+	elf->data = malloc(elf->size);
+	if (!elf->data)
+		die("Not enough memory for ELF file.\n");
+	if (fread(elf->data, 1, elf->size, f) != elf->size) {
+		perror(path);
+		exit(1);
+	}
+	fclose(f);
+
+	if (elf->size < sizeof(Elf64_Ehdr) ||
+	    memcmp(elf->data, ELFMAG, SELFMAG) ||
+	    elf->data[EI_DATA] != ELFDATA2LSB) {
+		fprintf(stderr, "%s is not a little-endian ELF file.\n", path);
+		exit(1);
+	}
+	elf->is_64 = elf->data[EI_CLASS] == ELFCLASS64;
+
+	if (elf_find_symbol(elf, "_program", &elf->program)) {
+		fprintf(stderr, "%s has no _program symbol.\n", path);
+		exit(1);
+	}
+}
+
+struct deferred_in {
+	const uint8_t *p;
+	const uint8_t *end;
+	int error;
+};
+
+static uint64_t deferred_uleb(struct deferred_in *in)
+{
+	uint64_t val = 0;
+	unsigned int shift = 0;
+	uint8_t byte;
+
+	do {
+		if (in->p >= in->end || shift >= 64) {
+			in->error = 1;
+			return 0;
+		}
+		byte = *in->p++;
+		val |= (uint64_t)(byte & 0x7f) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+
+	return val;
+}
+
+static int64_t deferred_sleb(struct deferred_in *in)
+{
+	uint64_t val = deferred_uleb(in);
+
+	return (int64_t)(val >> 1) ^ -(int64_t)(val & 1);
+}
+
+#define ZEROPAD	1		/* pad with zero */
+#define SIGN	2		/* unsigned/signed long */
+#define PLUS	4		/* show plus */
+#define SPACE	8		/* space if plus */
+#define LEFT	16		/* left justified */
+#define SPECIAL	32		/* 0x */
+#define LARGE	64		/* use 'ABCDEF' instead of 'abcdef' */
+
+/* Same as number() in src/console/vtxprintf.c */
+static void deferred_number(FILE *out, unsigned long long num, int base,
+			    int size, int precision, int type)
+{
+	const char *digits = "0123456789abcdef";
+	long long snum = num;
+	char sign = 0, tmp[66];
+	int i = 0;
+
+	if (type & LARGE)
+		digits = "0123456789ABCDEF";
+	if (type & LEFT)
+		type &= ~ZEROPAD;
+	if (type & SIGN) {
+		if (snum < 0) {
+			sign = '-';
+			num = -snum;
+			size--;
+		} else if (type & PLUS) {
+			sign = '+';
+			size--;
+		} else if (type & SPACE) {
+			sign = ' ';
+			size--;
+		}
+	}
+	if (type & SPECIAL) {
+		if (base == 16)
+			size -= 2;
+		else if (base == 8)
+			size--;
+	}
+	if (num == 0)
+		tmp[i++] = '0';
+	while (num != 0) {
+		tmp[i++] = digits[num % base];
+		num /= base;
+	}
+	if (i > precision)
+		precision = i;
+	size -= precision;
+	if (!(type & (ZEROPAD | LEFT)))
+		while (size-- > 0)
+			fputc(' ', out);
+	if (sign)
+		fputc(sign, out);
+	if (type & SPECIAL) {
+		fputc('0', out);
+		if (base == 16)
+			fputc(type & LARGE ? 'X' : 'x', out);
+	}
+	if (!(type & LEFT))
+		while (size-- > 0)
+			fputc(type & ZEROPAD ? '0' : ' ', out);
+	while (i < precision--)
+		fputc('0', out);
+	while (i-- > 0)
+		fputc(tmp[i], out);
+	while (size-- > 0)
+		fputc(' ', out);
+}
+
+/* Same as vtxprintf(), but with the arguments taken from a binary record. */
+static int format_deferred(FILE *out, const char *fmt, struct deferred_in *in)
+{
+	int flags, field_width, precision, base, len;
+	unsigned long long num;
+	const char *s;
+	const uint8_t *nul;
+
+	for (; *fmt; ++fmt) {
+		if (*fmt != '%') {
+			fputc(*fmt, out);
+			continue;
+		}
+
+		flags = 0;
+		for (;;) {
+			++fmt;
+			if (*fmt == '-')
+				flags |= LEFT;
+			else if (*fmt == '+')
+				flags |= PLUS;
+			else if (*fmt == ' ')
+				flags |= SPACE;
+			else if (*fmt == '#')
+				flags |= SPECIAL;
+			else if (*fmt == '0')
+				flags |= ZEROPAD;
+			else
+				break;
+		}
+
+		field_width = -1;
+		if (isdigit(*fmt)) {
+			field_width = strtol(fmt, (char **)&fmt, 10);
+		} else if (*fmt == '*') {
+			++fmt;
+			field_width = deferred_sleb(in);
+			if (field_width < 0) {
+				field_width = -field_width;
+				flags |= LEFT;
+			}
+		}
+
+		precision = -1;
+		if (*fmt == '.') {
+			++fmt;
+			if (isdigit(*fmt)) {
+				precision = strtol(fmt, (char **)&fmt, 10);
+			} else if (*fmt == '*') {
+				++fmt;
+				precision = deferred_sleb(in);
+			}
+			if (precision < 0)
+				precision = 0;
+		}
+
+		/* The record already holds the value at its final width. */
+		if (*fmt == 'h' || *fmt == 'l' || *fmt == 'L' || *fmt == 'z' ||
+		    *fmt == 'j') {
+			++fmt;
+			if (*fmt == 'l' || *fmt == 'h')
+				++fmt;
+		}
+
+		base = 10;
+		switch (*fmt) {
+		case 'c':
+			if (in->p >= in->end)
+				return -1;
+			if (!(flags & LEFT))
+				while (--field_width > 0)
+					fputc(' ', out);
+			fputc(*in->p++, out);
+			while (--field_width > 0)
+				fputc(' ', out);
+			continue;
+		case 's':
+			/* The record only holds the characters to print. */
+			nul = memchr(in->p, '\0', in->end - in->p);
+			if (!nul)
+				return -1;
+			s = (const char *)in->p;
+			in->p = nul + 1;
+			len = nul - (const uint8_t *)s;
+			if (!(flags & LEFT))
+				while (len < field_width--)
+					fputc(' ', out);
+			fwrite(s, 1, len, out);
+			while (len < field_width--)
+				fputc(' ', out);
+			continue;
+		case 'p':
+			if (field_width == -1 && precision == -1)
+				precision = 2 * sizeof(uint32_t);
+			flags |= SPECIAL;
+			deferred_number(out, deferred_uleb(in), 16, field_width,
+					precision, flags);
+			continue;
+		case '%':
+			fputc('%', out);
+			continue;
+		case 'o':
+			base = 8;
+			break;
+		case 'X':
+			flags |= LARGE;
+			/* fall through */
+		case 'x':
+			base = 16;
+			break;
+		case 'd':
+		case 'i':
+			flags |= SIGN;
+			/* fall through */
+		case 'u':
+			break;
+		default:
+			fputc('%', out);
+			if (*fmt)
+				fputc(*fmt, out);
+			else
+				--fmt;
+			continue;
+		}
+
+		if (flags & SIGN)
+			num = deferred_sleb(in);
+		else
+			num = deferred_uleb(in);
+		deferred_number(out, num, base, field_width, precision, flags);
+	}
+
+	return in->error || in->p != in->end ? -1 : 0;
+}
+
+/*
+ * Decode the binary record at the start of buf into out. Returns the size of
+ * the record, or 0 if buf doesn't start with a valid record.
+ */
+static size_t decode_deferred(FILE *out, const uint8_t *buf, size_t avail)
+{
+	struct cbmemc_deferred_record rec;
+	struct deferred_in in;
+	const struct console_elf *elf;
+	const char *fmt;
+	size_t len, text_size;
+	char *text;
+	FILE *f;
+	int ret;
+
+	if (avail < sizeof(rec))
+		return 0;
+	memcpy(&rec, buf, sizeof(rec));
+	len = sizeof(rec) + rec.args_size;
+	if (len > avail || !rec.stage || rec.stage >= CBMEMC_DEFERRED_STAGE_MAX)
+		return 0;
+
+	elf = &console_elfs[rec.stage];
+	if (!elf->data) {
+		fprintf(out, "[%s+0x%x]", deferred_stage_names[rec.stage],
+			rec.fmt_offset);
+		deferred_undecoded++;
+		return len;
+	}
+
+	fmt = elf_string(elf, elf->program + rec.fmt_offset);
+	if (!fmt)
+		return 0;
+
+	/* Format into a separate buffer, the record might turn out invalid. */
+	f = open_memstream(&text, &text_size);
+	if (!f)
+		die("Not enough memory for console.\n");
+	in.p = buf + sizeof(rec);
+	in.end = buf + len;
+	in.error = 0;
+	ret = format_deferred(f, fmt, &in);
+	fclose(f);
+
+	if (!ret)
+		fwrite(text, 1, text_size, out);
+	free(text);
+
+	return ret ? 0 : len;
+}
+
+/*
+ * Merge the binary records from the CBMEM_ID_CONSOLE_DEFERRED area into the
+ * text of the console. console_c holds the text ring from its oldest byte on,
+ * the ring is cons_size bytes large and its cursor was at cursor.
+ */
+static char *merge_deferred(char *console_c, size_t *size, uint32_t cons_size,
+			    uint32_t cursor, int overflow)
+{
+	const struct cbmemc_deferred_area *area;
+	struct mapping deferred_mapping;
+	uint64_t addr, end, oldest, pos;
+	size_t area_size, used, i, len, text_size, prev = 0;
+	uint8_t *records;
+	char *text;
+	FILE *out;
+
+	if (find_cbmem_entry(CBMEM_ID_CONSOLE_DEFERRED, &addr, &area_size) ||
+	    area_size < sizeof(*area))
+		return console_c;
+
+	area = map_memory(&deferred_mapping, addr, area_size);
+	if (!area)
+		die("Unable to map binary console records.\n");
+
+	used = area->used;
+	if (used > area_size - sizeof(*area))
+		used = area_size - sizeof(*area);
+	end = (uint64_t)area->wraps * cons_size + cursor;
+	oldest = overflow && end > cons_size ? end - cons_size : 0;
+
+	records = malloc(used);
+	if (!records && used)
+		die("Not enough memory for console.\n");
+	aligned_memcpy(records, area->body, used);
+	unmap_memory(&deferred_mapping);
+
+	if (!used) {
+		free(records);
+		return console_c;
+	}
+
+	out = open_memstream(&text, &text_size);
+	if (!out)
+		die("Not enough memory for console.\n");
+
+	for (i = 0; i < used; i += len) {
+		struct cbmemc_deferred_record rec;
+
+		if (used - i < sizeof(rec))
+			break;
+		memcpy(&rec, records + i, sizeof(rec));
+		len = sizeof(rec) + rec.args_size;
+
+		/* Like the text around it, the message was overwritten. */
+		pos = (uint64_t)rec.wraps * cons_size + rec.cursor;
+		if (pos < oldest)
+			continue;
+
+		pos -= oldest;
+		if (pos > *size)
+			pos = *size;
+		if (pos > prev) {
+			fwrite(console_c + prev, 1, pos - prev, out);
+			prev = pos;
+		}
+
+		len = decode_deferred(out, records + i, used - i);
+		if (!len)
+			break;
+	}
+	fwrite(console_c + prev, 1, *size - prev, out);
+
+	fclose(out);
+	free(records);
+	free(console_c);
+	*size = text_size;
+
+	return text;
+}
+
+struct elf_function {
+	uint64_t addr;
+	uint64_t size;
+	const char *name;
+};
+
+static int compare_elf_functions(const void *a, const void *b)
+{
+	const struct elf_function *fa = a, *fb = b;
+
+	if (fa->addr != fb->addr)
+		return fa->addr < fb->addr ? -1 : 1;
+	return 0;
+}
+
+static size_t elf_functions(const struct console_elf *elf, struct elf_function **funcs)
+{
+	struct elf_section symtab, strtab;
+	size_t entsize = elf->is_64 ? sizeof(Elf64_Sym) : sizeof(Elf32_Sym);
+	size_t num = 0, max = 0;
+
+	*funcs = NULL;
+	for (unsigned int i = 0; !elf_get_section(elf, i, &symtab); i++) {
+		if (symtab.type != SHT_SYMTAB ||
+		    elf_get_section(elf, symtab.link, &strtab))
+			continue;
+
+		for (size_t off = 0; off + entsize <= symtab.size; off += entsize) {
+			const uint8_t *sym = elf->data + symtab.offset + off;
+			struct elf_function f;
+			uint32_t sym_name;
+			int type;
+
+			if (elf->is_64) {
+				const Elf64_Sym *s = (const Elf64_Sym *)sym;
+
+				sym_name = s->st_name;
+				type = ELF64_ST_TYPE(s->st_info);
+				f.addr = s->st_value;
+				f.size = s->st_size;
+			} else {
+				const Elf32_Sym *s = (const Elf32_Sym *)sym;
+
+				sym_name = s->st_name;
+				type = ELF32_ST_TYPE(s->st_info);
+				f.addr = s->st_value;
+				f.size = s->st_size;
+			}
+
+			if (type != STT_FUNC || !f.size || sym_name >= strtab.size ||
+			    !memchr(elf->data + strtab.offset + sym_name, '\0',
+				    strtab.size - sym_name))
+				continue;
+			f.name = (const char *)elf->data + strtab.offset + sym_name;
+
+			if (num == max) {
+				max = max ? 2 * max : 1024;
+				*funcs = realloc(*funcs, max * sizeof(**funcs));
+				if (!*funcs)
+					die("Out of memory\n");
+			}
+			(*funcs)[num++] = f;
+		}
+	}
+
+	qsort(*funcs, num, sizeof(**funcs), compare_elf_functions);
+
+	return num;
+}
+
+static const char *stage_pc_name(uint32_t pc, int is_return,
+				   const struct elf_function *funcs, size_t num_funcs,
+				   uint64_t program)
+{
+	static char name[32];
+	uint64_t addr = program + pc - (is_return ? 1 : 0);
+	size_t lo = 0, hi = num_funcs;
+
+	if (pc == PROFILE_PC_EXTERNAL)
+		return "[external]";
+
+	/* Find the last function starting at or below addr. */
+	while (lo < hi) {
+		size_t mid = (lo + hi) / 2;
+
+		if (funcs[mid].addr <= addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo && addr < funcs[lo - 1].addr + funcs[lo - 1].size)
+		return funcs[lo - 1].name;
+
+	snprintf(name, sizeof(name), "ramstage+0x%x", pc);
+	return name;
+}
+
+struct profile_stack {
+	char *stack;
+	unsigned int count;
+};
+
+static int compare_profile_stacks(const void *a, const void *b)
+{
+	const struct profile_stack *sa = a, *sb = b;
+
+	return strcmp(sa->stack, sb->stack);
+}
+
+static int compare_profile_counts(const void *a, const void *b)
+{
+	const struct profile_stack *sa = a, *sb = b;
+
+	if (sa->count != sb->count)
+		return sa->count < sb->count ? 1 : -1;
+	return strcmp(sa->stack, sb->stack);
+}
+
+/*
+ * Print the profiler samples as collapsed stacks, "caller;callee count" per
+ * line and most frequent first, the input format of flamegraph.pl.
+ */
+static void dump_profile(void)
+{
+	const struct console_elf *elf = &console_elfs[CBMEMC_DEFERRED_RAMSTAGE];
+	const struct profile_buffer *prof;
+	struct mapping profile_mapping;
+	struct elf_function *funcs = NULL;
+	struct profile_stack *stacks;
+	size_t num_funcs = 0, num_stacks = 0, unique = 0;
+	uint32_t num_samples;
+	uint64_t addr;
+	size_t size;
+
+	if (find_cbmem_entry(CBMEM_ID_PROFILE, &addr, &size)) {
+		fprintf(stderr, "No profiler samples found in coreboot table.\n");
+		return;
+	}
+
+	prof = map_memory(&profile_mapping, addr, size);
+	if (!prof)
+		die("Unable to map profiler samples\n");
+
+	num_samples = prof->total < prof->max_samples ? prof->total : prof->max_samples;
+	if (!prof->depth ||
+	    sizeof(*prof) + (uint64_t)prof->max_samples * prof->depth * sizeof(uint32_t) > size)
+		die("Profiler samples are corrupted\n");
+
+	if (elf->data)
+		num_funcs = elf_functions(elf, &funcs);
+	else
+		fprintf(stderr, "Pass the ramstage ELF with -E to get function names.\n");
+
+	fprintf(stderr, "%u samples every %u us, %u kept.\n", prof->total,
+		prof->period_us, num_samples);
+
+	stacks = calloc(num_samples ? num_samples : 1, sizeof(*stacks));
+	if (!stacks)
+		die("Out of memory\n");
+
+	for (uint32_t i = 0; i < num_samples; i++) {
+		const uint32_t *sample = &prof->samples[i * prof->depth];
+		size_t len = 0, depth = 0;
+		char *stack = NULL;
+
+		while (depth < prof->depth && sample[depth] != PROFILE_PC_NONE)
+			depth++;
+
+		/* Outermost caller first */
+		while (depth--) {
+			const char *name = stage_pc_name(sample[depth], depth > 0,
+							   funcs, num_funcs, elf->program);
+			size_t name_len = strlen(name);
+
+			stack = realloc(stack, len + name_len + 2);
+			if (!stack)
+				die("Out of memory\n");
+			if (len)
+				stack[len++] = ';';
+			memcpy(stack + len, name, name_len + 1);
+			len += name_len;
+		}
+
+		if (!stack)
+			continue;
+		stacks[num_stacks].stack = stack;
+		stacks[num_stacks++].count = 1;
+	}
+
+	/* Merge identical stacks. */
+	qsort(stacks, num_stacks, sizeof(*stacks), compare_profile_stacks);
+	for (size_t i = 0; i < num_stacks; i++) {
+		if (unique && !strcmp(stacks[unique - 1].stack, stacks[i].stack)) {
+			stacks[unique - 1].count++;
+			free(stacks[i].stack);
+			continue;
+		}
+		stacks[unique++] = stacks[i];
+	}
+
+	qsort(stacks, unique, sizeof(*stacks), compare_profile_counts);
+	for (size_t i = 0; i < unique; i++) {
+		printf("%s %u\n", stacks[i].stack, stacks[i].count);
+		free(stacks[i].stack);
+	}
+
+	free(stacks);
+	free(funcs);
+	unmap_memory(&profile_mapping);
+}
+
+struct function_time {
+	uint32_t func;
+	uint32_t calls;
+	uint64_t inclusive;
+	uint64_t exclusive;
+};
+
+struct function_frame {
+	uint32_t func;
+	uint64_t start;
+	uint64_t children;
+};
+
+static int compare_function_times(const void *a, const void *b)
+{
+	const struct function_time *ta = a, *tb = b;
+
+	if (ta->exclusive != tb->exclusive)
+		return ta->exclusive < tb->exclusive ? 1 : -1;
+	return ta->func < tb->func ? -1 : ta->func > tb->func;
+}
+
+static struct function_time *function_time_get(struct function_time **times, size_t *num,
+					       uint32_t func)
+{
+	for (size_t i = 0; i < *num; i++)
+		if ((*times)[i].func == func)
+			return &(*times)[i];
+
+	*times = realloc(*times, (*num + 1) * sizeof(**times));
+	if (!*times)
+		die("Out of memory\n");
+	memset(&(*times)[*num], 0, sizeof(**times));
+	(*times)[*num].func = func;
+
+	return &(*times)[(*num)++];
+}
+
+/* Print the time spent per function from the function entry/exit trace. */
+static void dump_function_trace(void)
+{
+	const struct console_elf *elf = &console_elfs[CBMEMC_DEFERRED_RAMSTAGE];
+	const struct function_trace_buffer *ft;
+	struct mapping trace_mapping;
+	struct elf_function *funcs = NULL;
+	struct function_time *times = NULL;
+	struct function_frame *stack;
+	size_t num_funcs = 0, num_times = 0, depth = 0;
+	uint32_t num, first, freq;
+	uint64_t addr;
+	size_t size;
+
+	if (find_cbmem_entry(CBMEM_ID_FUNCTION_TRACE, &addr, &size)) {
+		fprintf(stderr, "No function trace found in coreboot table.\n");
+		return;
+	}
+
+	ft = map_memory(&trace_mapping, addr, size);
+	if (!ft)
+		die("Unable to map function trace\n");
+
+	if (!ft->max_entries ||
+	    sizeof(*ft) + (uint64_t)ft->max_entries * sizeof(ft->entries[0]) > size)
+		die("Function trace is corrupted\n");
+
+	if (elf->data)
+		num_funcs = elf_functions(elf, &funcs);
+	else
+		fprintf(stderr, "Pass the ramstage ELF with -E to get function names.\n");
+
+	num = ft->total < ft->max_entries ? ft->total : ft->max_entries;
+	first = ft->total > ft->max_entries ? ft->total % ft->max_entries : 0;
+	freq = ft->tick_freq_mhz ? ft->tick_freq_mhz : 1;
+
+	stack = calloc(num ? num : 1, sizeof(*stack));
+	if (!stack)
+		die("Out of memory\n");
+
+	for (uint32_t i = 0; i < num; i++) {
+		const struct function_trace_entry *e =
+			&ft->entries[(first + i) % ft->max_entries];
+		uint32_t func = e->func & ~FUNCTION_TRACE_EXIT;
+		struct function_time *t;
+		uint64_t elapsed;
+		size_t d;
+
+		if (!(e->func & FUNCTION_TRACE_EXIT)) {
+			stack[depth].func = func;
+			stack[depth].start = e->stamp;
+			stack[depth++].children = 0;
+			continue;
+		}
+
+		/* Exits whose entry was overwritten, or was never seen, don't count. */
+		for (d = depth; d > 0 && stack[d - 1].func != func; d--)
+			;
+		if (!d)
+			continue;
+		depth = d - 1;
+
+		elapsed = e->stamp - stack[depth].start;
+		t = function_time_get(&times, &num_times, func);
+		t->calls++;
+		t->inclusive += elapsed;
+		if (elapsed > stack[depth].children)
+			t->exclusive += elapsed - stack[depth].children;
+		if (depth)
+			stack[depth - 1].children += elapsed;
+	}
+
+	qsort(times, num_times, sizeof(*times), compare_function_times);
+
+	printf("%u of %u events, %zu functions:\n\n", num, ft->total, num_times);
+	printf("%-40s %8s %14s %14s\n", "function", "calls", "inclusive (us)",
+	       "exclusive (us)");
+	for (size_t i = 0; i < num_times; i++)
+		printf("%-40s %8u %14" PRIu64 " %14" PRIu64 "\n",
+		       stage_pc_name(times[i].func, 0, funcs, num_funcs, elf->program),
+		       times[i].calls, times[i].inclusive / freq, times[i].exclusive / freq);
+
+	free(stack);
+	free(times);
+	free(funcs);
+	unmap_memory(&trace_mapping);
+}
+
 struct cbmem_console {
 	u32 size;
 	u32 cursor;
@@ -767,6 +2046,9 @@ static void dump_console(int one_boot_only)
 		aligned_memcpy(console_c, console_p->body, size);
 	}
 
+	console_c = merge_deferred(console_c, &size, console_p->size, cursor,
+				   console_p->cursor & CBMC_OVERFLOW);
+
 	/* Slight memory corruption may occur between reboots and give us a few
 	   unprintable characters like '\0'. Replace them with '?' on output. */
 	for (cursor = 0; cursor < size; cursor++)
@@ -805,6 +2087,11 @@ static void dump_console(int one_boot_only)
 	puts(console_c + cursor);
 	free(console_c);
 	unmap_memory(&console_mapping);
+
+	if (deferred_undecoded)
+		fprintf(stderr, "%u messages were stored in binary form, pass "
+			"the stage ELF files with -E to decode them.\n",
+			deferred_undecoded);
 }
 
 static void hexdump(unsigned long memory, int length)
@@ -1083,17 +2370,24 @@ static void print_version(void)
 
 static void print_usage(const char *name, int exit_code)
 {
-	printf("usage: %s [-cCltTLxVvh?]\n", name);
+	printf("usage: %s [-cCltTLDxVvh?] [-E ELF]...\n", name);
 	printf("\n"
 	     "   -c | --console:                   print cbmem console\n"
 	     "   -1 | --oneboot:                   print cbmem console for last boot only\n"
+	     "   -E | --console-elf [STAGE=]FILE:  decode binary console messages of a stage\n"
 	     "   -C | --coverage:                  dump coverage information\n"
 	     "   -l | --list:                      print cbmem table of contents\n"
 	     "   -x | --hexdump:                   print hexdump of cbmem area\n"
 	     "   -r | --rawdump ID:                print rawdump of specific ID (in hex) of cbtable\n"
 	     "   -t | --timestamps:                print timestamp information\n"
 	     "   -T | --parseable-timestamps:      print parseable timestamps\n"
+	     "   -j | --trace-timestamps:          print timestamps as Chrome trace JSON\n"
 	     "   -L | --tcpa-log                   print TCPA log\n"
+	     "   -D | --device-timing:             print device timing, slowest first\n"
+	     "   -P | --profile:                   print profiler samples as collapsed stacks\n"
+	     "   -F | --function-trace:            print time spent per traced function\n"
+	     "   -a | --cbfs-access:               print CBFS files in boot access order\n"
+	     "   -M | --memtest:                   print DRAM test result\n"
 	     "   -V | --verbose:                   verbose (debugging) output\n"
 	     "   -v | --version:                   print the version\n"
 	     "   -h | --help:                      print this help\n"
@@ -1226,7 +2520,13 @@ int main(int argc, char** argv)
 	int print_rawdump = 0;
 	int print_timestamps = 0;
 	int print_tcpa_log = 0;
+	int print_dev_timing = 0;
+	int print_profile = 0;
+	int print_function_trace = 0;
+	int print_cbfs_access = 0;
+	int print_memtest = 0;
 	int machine_readable_timestamps = 0;
+	int trace_timestamps = 0;
 	int one_boot_only = 0;
 	unsigned int rawdump_id = 0;
 
@@ -1234,11 +2534,18 @@ int main(int argc, char** argv)
 	static struct option long_options[] = {
 		{"console", 0, 0, 'c'},
 		{"oneboot", 0, 0, '1'},
+		{"console-elf", required_argument, 0, 'E'},
 		{"coverage", 0, 0, 'C'},
 		{"list", 0, 0, 'l'},
 		{"tcpa-log", 0, 0, 'L'},
+		{"device-timing", 0, 0, 'D'},
+		{"profile", 0, 0, 'P'},
+		{"function-trace", 0, 0, 'F'},
+		{"cbfs-access", 0, 0, 'a'},
+		{"memtest", 0, 0, 'M'},
 		{"timestamps", 0, 0, 't'},
 		{"parseable-timestamps", 0, 0, 'T'},
+		{"trace-timestamps", 0, 0, 'j'},
 		{"hexdump", 0, 0, 'x'},
 		{"rawdump", required_argument, 0, 'r'},
 		{"verbose", 0, 0, 'V'},
@@ -1246,7 +2553,7 @@ int main(int argc, char** argv)
 		{"help", 0, 0, 'h'},
 		{0, 0, 0, 0}
 	};
-	while ((opt = getopt_long(argc, argv, "c1CltTLxVvh?r:",
+	while ((opt = getopt_long(argc, argv, "c1E:CltTjLDPFaMxVvh?r:",
 				  long_options, &option_index)) != EOF) {
 		switch (opt) {
 		case 'c':
@@ -1258,6 +2565,9 @@ int main(int argc, char** argv)
 			one_boot_only = 1;
 			print_defaults = 0;
 			break;
+		case 'E':
+			load_console_elf(optarg);
+			break;
 		case 'C':
 			print_coverage = 1;
 			print_defaults = 0;
@@ -1270,6 +2580,26 @@ int main(int argc, char** argv)
 			print_tcpa_log = 1;
 			print_defaults = 0;
 			break;
+		case 'D':
+			print_dev_timing = 1;
+			print_defaults = 0;
+			break;
+		case 'P':
+			print_profile = 1;
+			print_defaults = 0;
+			break;
+		case 'F':
+			print_function_trace = 1;
+			print_defaults = 0;
+			break;
+		case 'a':
+			print_cbfs_access = 1;
+			print_defaults = 0;
+			break;
+		case 'M':
+			print_memtest = 1;
+			print_defaults = 0;
+			break;
 		case 'x':
 			print_hexdump = 1;
 			print_defaults = 0;
@@ -1288,6 +2618,11 @@ int main(int argc, char** argv)
 			machine_readable_timestamps = 1;
 			print_defaults = 0;
 			break;
+		case 'j':
+			print_timestamps = 1;
+			trace_timestamps = 1;
+			print_defaults = 0;
+			break;
 		case 'V':
 			verbose = 1;
 			break;
@@ -1397,12 +2732,29 @@ int main(int argc, char** argv)
 	if (print_rawdump)
 		dump_cbmem_raw(rawdump_id);
 
-	if (print_defaults || print_timestamps)
+	if (trace_timestamps)
+		dump_timestamps_trace();
+	else if (print_defaults || print_timestamps)
 		dump_timestamps(machine_readable_timestamps);
 
 	if (print_tcpa_log)
 		dump_tcpa_log();
 
+	if (print_dev_timing)
+		dump_dev_timing();
+
+	if (print_profile)
+		dump_profile();
+
+	if (print_function_trace)
+		dump_function_trace();
+
+	if (print_cbfs_access)
+		dump_cbfs_access();
+
+	if (print_memtest)
+		dump_memtest();
+
 	unmap_memory(&lbtable_mapping);
 
 	close(mem_fd);